@@ -253,6 +253,7 @@ DvzAlpha = ctypes.c_uint8
 # ===============================================================================
 
 DVZ_BUFFER_TYPE_COUNT = 6
+DVZ_SHAPE_MAX_LODS = 8
 DVZ_DEFAULT_FORMAT = 44
 CMAP_NAT = 144
 CMAP_USR_OFS = 144
@@ -383,6 +384,12 @@ class DvzPanzoomFlags(CtypesEnum):
     DVZ_PANZOOM_FLAGS_FIXED_Y = 0x20
 
 
+class DvzScaleType(CtypesEnum):
+    DVZ_SCALE_LINEAR = 0
+    DVZ_SCALE_LOG10 = 1
+    DVZ_SCALE_SYMLOG = 2
+
+
 class DvzCameraFlags(CtypesEnum):
     DVZ_CAMERA_FLAGS_PERSPECTIVE = 0x00
     DVZ_CAMERA_FLAGS_ORTHO = 0x01
@@ -392,10 +399,21 @@ class DvzVisualFlags(CtypesEnum):
     DVZ_VISUAL_FLAGS_DEFAULT = 0x000000
     DVZ_VISUAL_FLAGS_INDEXED = 0x010000
     DVZ_VISUAL_FLAGS_INDIRECT = 0x020000
+    DVZ_VISUAL_FLAGS_DOUBLE_PRECISION = 0x040000
+    DVZ_VISUAL_FLAGS_MASK = 0x080000
+    DVZ_VISUAL_FLAGS_QUANTIZED = 0x200000
     DVZ_VISUAL_FLAGS_VERTEX_MAPPABLE = 0x400000
     DVZ_VISUAL_FLAGS_INDEX_MAPPABLE = 0x800000
 
 
+class DvzMaskFlags(CtypesEnum):
+    DVZ_MASK_FLAGS_NONE = 0x00
+    DVZ_MASK_FLAGS_HIDDEN = 0x01
+    DVZ_MASK_FLAGS_SELECTED = 0x02
+    DVZ_MASK_FLAGS_HIGHLIGHTED = 0x04
+    DVZ_MASK_FLAGS_DIMMED = 0x08
+
+
 class DvzViewFlags(CtypesEnum):
     DVZ_VIEW_FLAGS_NONE = 0x0000
     DVZ_VIEW_FLAGS_STATIC = 0x0001
@@ -524,6 +542,8 @@ class DvzFormat(CtypesEnum):
     DVZ_FORMAT_B8G8R8A8_UNORM = 44
     DVZ_FORMAT_R16_UNORM = 70
     DVZ_FORMAT_R16_SNORM = 71
+    DVZ_FORMAT_R16_SFLOAT = 76
+    DVZ_FORMAT_R16G16B16A16_SNORM = 92
     DVZ_FORMAT_R32_UINT = 98
     DVZ_FORMAT_R32_SINT = 99
     DVZ_FORMAT_R32_SFLOAT = 100
@@ -723,6 +743,9 @@ class DvzMeshFlags(CtypesEnum):
     DVZ_MESH_FLAGS_LIGHTING = 0x0002
     DVZ_MESH_FLAGS_CONTOUR = 0x0004
     DVZ_MESH_FLAGS_ISOLINE = 0x0008
+    DVZ_MESH_FLAGS_OPTIMIZE = 0x0010
+    DVZ_MESH_FLAGS_FLAT = 0x0020
+    DVZ_MESH_FLAGS_WIREFRAME = 0x0040
 
 
 class DvzVolumeFlags(CtypesEnum):
@@ -732,6 +755,12 @@ class DvzVolumeFlags(CtypesEnum):
     DVZ_VOLUME_FLAGS_BACK_FRONT = 0x0004
 
 
+class DvzSurfaceFlags(CtypesEnum):
+    DVZ_SURFACE_FLAGS_NONE = 0x0000
+    DVZ_SURFACE_FLAGS_SCALAR = 0x0001
+    DVZ_SURFACE_FLAGS_LIGHTING = 0x0002
+
+
 class DvzEasing(CtypesEnum):
     DVZ_EASING_NONE = 0
     DVZ_EASING_IN_SINE = 1
@@ -791,6 +820,62 @@ class DvzDepthTest(CtypesEnum):
     DVZ_DEPTH_TEST_ENABLE = 1
 
 
+class DvzPngFilter(CtypesEnum):
+    DVZ_PNG_FILTER_NONE = 0
+    DVZ_PNG_FILTER_SUB = 1
+    DVZ_PNG_FILTER_UP = 2
+    DVZ_PNG_FILTER_AVERAGE = 3
+    DVZ_PNG_FILTER_PAETH = 4
+    DVZ_PNG_FILTER_ADAPTIVE = 5
+
+
+class DvzVideoFormat(CtypesEnum):
+    DVZ_VIDEO_FORMAT_Y4M = 0
+    DVZ_VIDEO_FORMAT_RGB = 1
+
+
+class DvzArrayFlags(CtypesEnum):
+    DVZ_ARRAY_FLAGS_NONE = 0x0000
+    DVZ_ARRAY_FLAGS_VECTOR = 0x0001
+
+
+class DvzDataType(CtypesEnum):
+    DVZ_DTYPE_NONE = 0
+    DVZ_DTYPE_CUSTOM = 1
+    DVZ_DTYPE_STR = 2
+    DVZ_DTYPE_CHAR = 3
+    DVZ_DTYPE_CVEC2 = 4
+    DVZ_DTYPE_CVEC3 = 5
+    DVZ_DTYPE_CVEC4 = 6
+    DVZ_DTYPE_USHORT = 7
+    DVZ_DTYPE_USVEC2 = 8
+    DVZ_DTYPE_USVEC3 = 9
+    DVZ_DTYPE_USVEC4 = 10
+    DVZ_DTYPE_SHORT = 11
+    DVZ_DTYPE_SVEC2 = 12
+    DVZ_DTYPE_SVEC3 = 13
+    DVZ_DTYPE_SVEC4 = 14
+    DVZ_DTYPE_UINT = 15
+    DVZ_DTYPE_UVEC2 = 16
+    DVZ_DTYPE_UVEC3 = 17
+    DVZ_DTYPE_UVEC4 = 18
+    DVZ_DTYPE_INT = 19
+    DVZ_DTYPE_IVEC2 = 20
+    DVZ_DTYPE_IVEC3 = 21
+    DVZ_DTYPE_IVEC4 = 22
+    DVZ_DTYPE_FLOAT = 23
+    DVZ_DTYPE_VEC2 = 24
+    DVZ_DTYPE_VEC3 = 25
+    DVZ_DTYPE_VEC4 = 26
+    DVZ_DTYPE_DOUBLE = 27
+    DVZ_DTYPE_DVEC2 = 28
+    DVZ_DTYPE_DVEC3 = 29
+    DVZ_DTYPE_DVEC4 = 30
+    DVZ_DTYPE_MAT2 = 31
+    DVZ_DTYPE_MAT3 = 32
+    DVZ_DTYPE_MAT4 = 33
+
+
 class DvzColormap(CtypesEnum):
     DVZ_CMAP_BINARY = 0
     DVZ_CMAP_HSV = 1
@@ -1134,13 +1219,24 @@ PANZOOM_FLAGS_NONE = 0x00
 PANZOOM_FLAGS_KEEP_ASPECT = 0x01
 PANZOOM_FLAGS_FIXED_X = 0x10
 PANZOOM_FLAGS_FIXED_Y = 0x20
+SCALE_LINEAR = 0
+SCALE_LOG10 = 1
+SCALE_SYMLOG = 2
 CAMERA_FLAGS_PERSPECTIVE = 0x00
 CAMERA_FLAGS_ORTHO = 0x01
 VISUAL_FLAGS_DEFAULT = 0x000000
 VISUAL_FLAGS_INDEXED = 0x010000
 VISUAL_FLAGS_INDIRECT = 0x020000
+VISUAL_FLAGS_DOUBLE_PRECISION = 0x040000
+VISUAL_FLAGS_MASK = 0x080000
+VISUAL_FLAGS_QUANTIZED = 0x200000
 VISUAL_FLAGS_VERTEX_MAPPABLE = 0x400000
 VISUAL_FLAGS_INDEX_MAPPABLE = 0x800000
+MASK_FLAGS_NONE = 0x00
+MASK_FLAGS_HIDDEN = 0x01
+MASK_FLAGS_SELECTED = 0x02
+MASK_FLAGS_HIGHLIGHTED = 0x04
+MASK_FLAGS_DIMMED = 0x08
 VIEW_FLAGS_NONE = 0x0000
 VIEW_FLAGS_STATIC = 0x0001
 DAT_FLAGS_NONE = 0x0000
@@ -1232,6 +1328,8 @@ FORMAT_R8G8B8A8_SINT = 42
 FORMAT_B8G8R8A8_UNORM = 44
 FORMAT_R16_UNORM = 70
 FORMAT_R16_SNORM = 71
+FORMAT_R16_SFLOAT = 76
+FORMAT_R16G16B16A16_SNORM = 92
 FORMAT_R32_UINT = 98
 FORMAT_R32_SINT = 99
 FORMAT_R32_SFLOAT = 100
@@ -1362,10 +1460,16 @@ MESH_FLAGS_TEXTURED = 0x0001
 MESH_FLAGS_LIGHTING = 0x0002
 MESH_FLAGS_CONTOUR = 0x0004
 MESH_FLAGS_ISOLINE = 0x0008
+MESH_FLAGS_OPTIMIZE = 0x0010
+MESH_FLAGS_FLAT = 0x0020
+MESH_FLAGS_WIREFRAME = 0x0040
 VOLUME_FLAGS_NONE = 0x0000
 VOLUME_FLAGS_RGBA = 0x0001
 VOLUME_FLAGS_COLORMAP = 0x0002
 VOLUME_FLAGS_BACK_FRONT = 0x0004
+SURFACE_FLAGS_NONE = 0x0000
+SURFACE_FLAGS_SCALAR = 0x0001
+SURFACE_FLAGS_LIGHTING = 0x0002
 EASING_NONE = 0
 EASING_IN_SINE = 1
 EASING_OUT_SINE = 2
@@ -1410,6 +1514,50 @@ VIEWPORT_CLIP_BOTTOM = 0x0004
 VIEWPORT_CLIP_LEFT = 0x0008
 DEPTH_TEST_DISABLE = 0
 DEPTH_TEST_ENABLE = 1
+PNG_FILTER_NONE = 0
+PNG_FILTER_SUB = 1
+PNG_FILTER_UP = 2
+PNG_FILTER_AVERAGE = 3
+PNG_FILTER_PAETH = 4
+PNG_FILTER_ADAPTIVE = 5
+VIDEO_FORMAT_Y4M = 0
+VIDEO_FORMAT_RGB = 1
+ARRAY_FLAGS_NONE = 0x0000
+ARRAY_FLAGS_VECTOR = 0x0001
+DTYPE_NONE = 0
+DTYPE_CUSTOM = 1
+DTYPE_STR = 2
+DTYPE_CHAR = 3
+DTYPE_CVEC2 = 4
+DTYPE_CVEC3 = 5
+DTYPE_CVEC4 = 6
+DTYPE_USHORT = 7
+DTYPE_USVEC2 = 8
+DTYPE_USVEC3 = 9
+DTYPE_USVEC4 = 10
+DTYPE_SHORT = 11
+DTYPE_SVEC2 = 12
+DTYPE_SVEC3 = 13
+DTYPE_SVEC4 = 14
+DTYPE_UINT = 15
+DTYPE_UVEC2 = 16
+DTYPE_UVEC3 = 17
+DTYPE_UVEC4 = 18
+DTYPE_INT = 19
+DTYPE_IVEC2 = 20
+DTYPE_IVEC3 = 21
+DTYPE_IVEC4 = 22
+DTYPE_FLOAT = 23
+DTYPE_VEC2 = 24
+DTYPE_VEC3 = 25
+DTYPE_VEC4 = 26
+DTYPE_DOUBLE = 27
+DTYPE_DVEC2 = 28
+DTYPE_DVEC3 = 29
+DTYPE_DVEC4 = 30
+DTYPE_MAT2 = 31
+DTYPE_MAT3 = 32
+DTYPE_MAT4 = 33
 CMAP_BINARY = 0
 CMAP_HSV = 1
 CMAP_CIVIDIS = 2
@@ -1698,6 +1846,14 @@ class DvzArcball(ctypes.Structure):
     pass
 
 
+class DvzArray(ctypes.Structure):
+    pass
+
+
+class DvzArrowFile(ctypes.Structure):
+    pass
+
+
 class DvzAtlas(ctypes.Structure):
     pass
 
@@ -1730,6 +1886,10 @@ class DvzFont(ctypes.Structure):
     pass
 
 
+class DvzFrameSink(ctypes.Structure):
+    pass
+
+
 class DvzGuiWindow(ctypes.Structure):
     pass
 
@@ -1818,6 +1978,12 @@ class DvzMVP(ctypes.Structure):
         ("model", ctypes.c_float * 16),
         ("view", ctypes.c_float * 16),
         ("proj", ctypes.c_float * 16),
+        ("offset_hi", ctypes.c_float * 4),
+        ("offset_lo", ctypes.c_float * 4),
+        ("scale_type", ctypes.c_int32 * 4),
+        ("scale_param", ctypes.c_float * 4),
+        ("scale_a", ctypes.c_float * 4),
+        ("scale_b", ctypes.c_float * 4),
     ]
 
 
@@ -1864,6 +2030,42 @@ class DvzShape(ctypes.Structure):
         ("d_right", ctypes.POINTER(ctypes.c_float * 3)),
         ("contour", ctypes.POINTER(ctypes.c_uint8 * 4)),
         ("index", ctypes.POINTER(ctypes.c_uint32)),
+        ("lod_count", ctypes.c_uint32),
+        ("lod_first", ctypes.c_uint32 * 8),
+        ("lod_index_count", ctypes.c_uint32 * 8),
+        ("lod_error", ctypes.c_float * 8),
+    ]
+
+
+class DvzIsolines(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("point_count", ctypes.c_uint32),
+        ("pos", ctypes.POINTER(ctypes.c_float * 3)),
+        ("path_count", ctypes.c_uint32),
+        ("path_lengths", ctypes.POINTER(ctypes.c_uint32)),
+        ("path_levels", ctypes.POINTER(ctypes.c_uint32)),
+    ]
+
+
+class DvzColormapLut(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("colors", (ctypes.c_uint8 * 4) * 256),
+        ("under", ctypes.c_uint8 * 4),
+        ("over", ctypes.c_uint8 * 4),
+        ("nan", ctypes.c_uint8 * 4),
+    ]
+
+
+class DvzArrowColumn(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("length", ctypes.c_uint64),
+        ("null_count", ctypes.c_uint64),
+        ("validity", ctypes.POINTER(ctypes.c_uint8)),
+        ("data", ctypes.c_void_p),
+        ("data_size", DvzSize),
     ]
 
 
@@ -1971,6 +2173,17 @@ class DvzTimerEvent(ctypes.Structure):
     ]
 
 
+class DvzReadbackEvent(ctypes.Structure):
+    _pack_ = 8
+    _fields_ = [
+        ("frame_idx", ctypes.c_uint64),
+        ("width", ctypes.c_uint32),
+        ("height", ctypes.c_uint32),
+        ("rgb", ctypes.POINTER(ctypes.c_uint8)),
+        ("user_data", ctypes.c_void_p),
+    ]
+
+
 class DvzRecorderViewport(ctypes.Structure):
     _pack_ = 8
     _fields_ = [
@@ -2226,6 +2439,7 @@ class DvzRequestBindIndex(ctypes.Structure):
     _fields_ = [
         ("dat", DvzId),
         ("offset", DvzSize),
+        ("index_size", DvzSize),
     ]
 
 
@@ -2331,6 +2545,8 @@ AtlasFont = DvzAtlasFont
 MVP = DvzMVP
 Viewport = DvzViewport
 Shape = DvzShape
+ColormapLut = DvzColormapLut
+ArrowColumn = DvzArrowColumn
 KeyboardEvent = DvzKeyboardEvent
 MouseButtonEvent = DvzMouseButtonEvent
 MouseWheelEvent = DvzMouseWheelEvent
@@ -2342,6 +2558,7 @@ WindowEvent = DvzWindowEvent
 FrameEvent = DvzFrameEvent
 GuiEvent = DvzGuiEvent
 TimerEvent = DvzTimerEvent
+ReadbackEvent = DvzReadbackEvent
 RecorderViewport = DvzRecorderViewport
 RecorderDraw = DvzRecorderDraw
 RecorderDrawIndexed = DvzRecorderDrawIndexed
@@ -2391,6 +2608,10 @@ keyboard = DvzAppKeyboardCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, Dv
 frame = DvzAppFrameCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzFrameEvent)
 timer = DvzAppTimerCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzTimerEvent)
 resize = DvzAppResizeCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzWindowEvent)
+readback = DvzServerReadbackCallback = ctypes.CFUNCTYPE(
+    None, P_(DvzServer), DvzId, DvzReadbackEvent)
+chunk = DvzChunkCallback = ctypes.CFUNCTYPE(
+    ctypes.c_int, DvzSize, DvzSize, ctypes.c_void_p, ctypes.c_void_p)
 DvzErrorCallback = ctypes.CFUNCTYPE(None, ctypes.c_char_p)
 
 # ===============================================================================
@@ -2623,6 +2844,140 @@ server_grab.argtypes = [
 ]
 server_grab.restype = ndpointer(dtype=np.uint8, ndim=1, ncol=1, flags="C_CONTIGUOUS")
 
+# Function dvz_server_pipeline()
+server_pipeline = dvz.dvz_server_pipeline
+server_pipeline.__doc__ = """
+Enable pipelined rendering, where several frames are rendered and downloaded at the same time.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+frames_in_flight : uint32_t
+    maximum number of frames submitted to the GPU and not yet passed to the
+    callback, from 1 to 16
+callback : DvzServerReadbackCallback
+    the callback receiving the downloaded frames, in order
+user_data : void*
+    the user data passed to the callback
+"""
+server_pipeline.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+    ctypes.c_uint32,  # uint32_t frames_in_flight
+    DvzServerReadbackCallback,  # DvzServerReadbackCallback callback
+    ctypes.c_void_p,  # void* user_data
+]
+
+# Function dvz_server_render()
+server_render = dvz.dvz_server_render
+server_render.__doc__ = """
+Submit a frame for rendering and download, without waiting for the GPU.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+canvas_id : DvzId
+    the canvas id
+flags : int
+    the render flags
+
+Returns
+-------
+type
+    the frame index, passed to the callback
+"""
+server_render.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+    DvzId,  # DvzId canvas_id
+    ctypes.c_int,  # int flags
+]
+server_render.restype = ctypes.c_uint64
+
+# Function dvz_server_poll()
+server_poll = dvz.dvz_server_poll
+server_poll.__doc__ = """
+Pass the frames that have finished rendering to the callback, without waiting for the GPU.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+
+Returns
+-------
+type
+    the number of frames passed to the callback
+"""
+server_poll.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+]
+server_poll.restype = ctypes.c_uint32
+
+# Function dvz_server_screenshot()
+server_screenshot = dvz.dvz_server_screenshot
+server_screenshot.__doc__ = """
+Render a canvas and save it to an image file in the background.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+canvas_id : DvzId
+    the canvas id
+filename : char*
+    path of the image file
+flags : int
+    the grab flags
+"""
+server_screenshot.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+    DvzId,  # DvzId canvas_id
+    ctypes.c_char_p,  # char* filename
+    ctypes.c_int,  # int flags
+]
+
+# Function dvz_server_png()
+server_png = dvz.dvz_server_png
+server_png.__doc__ = """
+Set the PNG compression of the next screenshots.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+level : int
+    compression level, from 0 (none) to 9 (best), or -1 for the fast encoder (default)
+filter : DvzPngFilter
+    the scanline filter, used with levels 0 to 9
+"""
+server_png.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+    ctypes.c_int,  # int level
+    DvzPngFilter,  # DvzPngFilter filter
+]
+
+# Function dvz_server_wait()
+server_wait = dvz.dvz_server_wait
+server_wait.__doc__ = """
+Wait until all pipelined frames have been passed to the callback, and all screenshots have
+been written.
+
+Parameters
+----------
+server : DvzServer*
+    the server
+
+Returns
+-------
+type
+    the number of screenshots that could not be written
+"""
+server_wait.argtypes = [
+    ctypes.POINTER(DvzServer),  # DvzServer* server
+]
+server_wait.restype = ctypes.c_uint32
+
 # Function dvz_scene_render()
 scene_render = dvz.dvz_scene_render
 scene_render.__doc__ = """
@@ -2652,214 +3007,584 @@ server_destroy.argtypes = [
     ctypes.POINTER(DvzServer),  # DvzServer* server
 ]
 
-# Function dvz_scene()
-scene = dvz.dvz_scene
-scene.__doc__ = """
-Create a scene.
+# Function dvz_frame_sink()
+frame_sink = dvz.dvz_frame_sink
+frame_sink.__doc__ = """
+Create a frame sink writing a video stream to a file or a named pipe.
 
 Parameters
 ----------
-batch : DvzBatch*
-    the batch
+path : char*
+    path of the file or the named pipe
+width : uint32_t
+    width of the frames
+height : uint32_t
+    height of the frames
+fps : double
+    number of frames per second, written in the YUV4MPEG2 header
+format : DvzVideoFormat
+    the video format
 
 Returns
 -------
 type
-    the scene
+    the frame sink, or NULL if the file could not be opened
 """
-scene.argtypes = [
-    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+frame_sink.argtypes = [
+    ctypes.c_char_p,  # char* path
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_double,  # double fps
+    DvzVideoFormat,  # DvzVideoFormat format
 ]
-scene.restype = ctypes.POINTER(DvzScene)
+frame_sink.restype = ctypes.POINTER(DvzFrameSink)
 
-# Function dvz_scene_batch()
-scene_batch = dvz.dvz_scene_batch
-scene_batch.__doc__ = """
-Return the batch from a scene.
+# Function dvz_frame_sink_fd()
+frame_sink_fd = dvz.dvz_frame_sink_fd
+frame_sink_fd.__doc__ = """
+Create a frame sink writing a video stream to a file descriptor, for example a pipe.
 
 Parameters
 ----------
-scene : DvzScene*
-    the scene
+fd : int
+    the file descriptor
+width : uint32_t
+    width of the frames
+height : uint32_t
+    height of the frames
+fps : double
+    number of frames per second, written in the YUV4MPEG2 header
+format : DvzVideoFormat
+    the video format
 
 Returns
 -------
 type
-    the batch
+    the frame sink, or NULL if the file descriptor is invalid
 """
-scene_batch.argtypes = [
-    ctypes.POINTER(DvzScene),  # DvzScene* scene
+frame_sink_fd.argtypes = [
+    ctypes.c_int,  # int fd
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_double,  # double fps
+    DvzVideoFormat,  # DvzVideoFormat format
 ]
-scene_batch.restype = ctypes.POINTER(DvzBatch)
+frame_sink_fd.restype = ctypes.POINTER(DvzFrameSink)
 
-# Function dvz_scene_run()
-scene_run = dvz.dvz_scene_run
-scene_run.__doc__ = """
-Start the event loop and render the scene in a window.
+# Function dvz_frame_sink_push()
+frame_sink_push = dvz.dvz_frame_sink_push
+frame_sink_push.__doc__ = """
+Queue a frame to be converted and written.
 
 Parameters
 ----------
-scene : DvzScene*
-    the scene
-app : DvzApp*
-    the app
-n_frames : uint64_t
-    the maximum number of frames, 0 for infinite loop
+sink : DvzFrameSink*
+    the frame sink
+pixels : uint8_t*
+    the frame, with width*height pixels
+components : uint32_t
+    number of bytes per pixel, 3 (RGB) or 4 (RGBA)
 """
-scene_run.argtypes = [
-    ctypes.POINTER(DvzScene),  # DvzScene* scene
-    ctypes.POINTER(DvzApp),  # DvzApp* app
-    ctypes.c_uint64,  # uint64_t n_frames
+frame_sink_push.argtypes = [
+    ctypes.POINTER(DvzFrameSink),  # DvzFrameSink* sink
+    ndpointer(dtype=np.uint8, flags="C_CONTIGUOUS"),  # uint8_t* pixels
+    ctypes.c_uint32,  # uint32_t components
 ]
 
-# Function dvz_scene_mouse()
-scene_mouse = dvz.dvz_scene_mouse
-scene_mouse.__doc__ = """
-Manually pass a mouse event to the scene.
+# Function dvz_frame_sink_wait()
+frame_sink_wait = dvz.dvz_frame_sink_wait
+frame_sink_wait.__doc__ = """
+Wait until all queued frames have been written.
 
 Parameters
 ----------
-scene : DvzScene*
-    the scene
-fig : DvzFigure*
-    the figure
-ev : DvzMouseEvent
-    the mouse event
+sink : DvzFrameSink*
+    the frame sink
+
+Returns
+-------
+type
+    0 if all frames have been written, or a non-zero value if a write failed
 """
-scene_mouse.argtypes = [
-    ctypes.POINTER(DvzScene),  # DvzScene* scene
-    ctypes.POINTER(DvzFigure),  # DvzFigure* fig
-    DvzMouseEvent,  # DvzMouseEvent ev
+frame_sink_wait.argtypes = [
+    ctypes.POINTER(DvzFrameSink),  # DvzFrameSink* sink
 ]
+frame_sink_wait.restype = ctypes.c_int
 
-# Function dvz_scene_destroy()
-scene_destroy = dvz.dvz_scene_destroy
-scene_destroy.__doc__ = """
-Destroy a scene.
+# Function dvz_frame_sink_destroy()
+frame_sink_destroy = dvz.dvz_frame_sink_destroy
+frame_sink_destroy.__doc__ = """
+Write the queued frames, close the stream, and destroy the frame sink.
 
 Parameters
 ----------
-scene : DvzScene*
-    the scene
+sink : DvzFrameSink*
+    the frame sink
 """
-scene_destroy.argtypes = [
-    ctypes.POINTER(DvzScene),  # DvzScene* scene
+frame_sink_destroy.argtypes = [
+    ctypes.POINTER(DvzFrameSink),  # DvzFrameSink* sink
 ]
 
-# Function dvz_mouse_move()
-mouse_move = dvz.dvz_mouse_move
-mouse_move.__doc__ = """
-Create a mouse move event.
+# Function dvz_array_npy()
+array_npy = dvz.dvz_array_npy
+array_npy.__doc__ = """
+Open a NumPy NPY file as an array, without copying the data.  The file is memory-mapped and the array data points into the mapping, so that the pages are only loaded from the page cache when they are accessed. The array is read-only: the functions modifying it log an error and leave it unchanged, and the mapping is released by dvz_array_destroy().  The NPY dtype is converted to the corresponding scalar data type. With DVZ_ARRAY_FLAGS_VECTOR, a last dimension of 2, 3 or 4 elements gives a vector data type instead. Unsupported dtypes give DVZ_DTYPE_CUSTOM items of the same size. The remaining dimensions go to `shape`, the last one varying the fastest, and Fortran-ordered arrays are opened as their C-ordered transpose.
 
 Parameters
 ----------
-mouse : DvzMouse*
-    the mouse
-pos : vec2
-    the cursor position, in pixels
-mods : int
-    the keyboard modifier flags
+filename : char*
+    path of the NPY file
+flags : int
+    the array flags
 
 Returns
 -------
 type
-    the generated mouse event
+    the array, or NULL if the file could not be opened
 """
-mouse_move.argtypes = [
-    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
-    ctypes.c_float * 2,  # vec2 pos
-    ctypes.c_int,  # int mods
+array_npy.argtypes = [
+    ctypes.c_char_p,  # char* filename
+    ctypes.c_int,  # int flags
 ]
-mouse_move.restype = DvzMouseEvent
+array_npy.restype = ctypes.POINTER(DvzArray)
 
-# Function dvz_mouse_press()
-mouse_press = dvz.dvz_mouse_press
-mouse_press.__doc__ = """
-Create a mouse press event.
+# Function dvz_array_csv()
+array_csv = dvz.dvz_array_csv
+array_csv.__doc__ = """
+Load columns of a CSV or TSV file into a new array.  The file is memory-mapped, split into chunks of lines that are parsed in parallel, and the selected columns are written into a new array with one item per non-empty row. For example, three columns and DVZ_DTYPE_VEC3 give an array of positions that can be passed to dvz_point_position(), four columns and DVZ_DTYPE_CVEC4 give an array of colors.  Floating-point values that are missing or cannot be parsed give NaN. Integer values are rounded and clamped to the range of the data type, and missing ones give 0. Quoted fields are supported but they may not contain delimiters or newlines.
 
 Parameters
 ----------
-mouse : DvzMouse*
-    the mouse
-button : DvzMouseButton
-    the mouse button (enum int)
-mods : int
-    the keyboard modifier flags
+filename : char*
+    path of the CSV file
+delimiter : char
+    the field delimiter, or 0 to detect it from the first row (comma, tab, or
+    semicolon)
+skip_rows : uint32_t
+    number of header rows to skip
+columns : uint32_t*
+    the indices of the columns, one per component of the data type
+dtype : DvzDataType
+    the data type of the array, a scalar or vector type of integers, floats or doubles
 
 Returns
 -------
 type
-    the generated mouse event
+    the array, or NULL if the file could not be opened
 """
-mouse_press.argtypes = [
-    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
-    DvzMouseButton,  # DvzMouseButton button
-    ctypes.c_int,  # int mods
+array_csv.argtypes = [
+    ctypes.c_char_p,  # char* filename
+    ctypes.c_char,  # char delimiter
+    ctypes.c_uint32,  # uint32_t skip_rows
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* columns
+    DvzDataType,  # DvzDataType dtype
 ]
-mouse_press.restype = DvzMouseEvent
+array_csv.restype = ctypes.POINTER(DvzArray)
 
-# Function dvz_mouse_release()
-mouse_release = dvz.dvz_mouse_release
-mouse_release.__doc__ = """
-Create a mouse release event.
+# Function dvz_array_arrow()
+array_arrow = dvz.dvz_array_arrow
+array_arrow.__doc__ = """
+Create a read-only view of a column of a record batch of an Arrow IPC file.  The array data points into the file mapping, which must stay open with the array: the array must be destroyed before dvz_arrow_close(). Numbers give the same data types as with dvz_array_npy(), fixed-size lists of 2, 3 or 4 numbers give vector data types. Booleans are copied into an array of 0 and 1 values.
 
 Parameters
 ----------
-mouse : DvzMouse*
-    the mouse
-button : DvzMouseButton
-    the mouse button (enum int)
-mods : int
-    the keyboard modifier flags
+arrow : DvzArrowFile*
+    the Arrow file opened with dvz_arrow_open()
+batch : uint32_t
+    the record batch index
+field : uint32_t
+    the column index
+mask : DvzArray** (out parameter)
+    if not NULL, receives a new DVZ_DTYPE_CHAR array with 1 for valid rows and 0
+    for null rows, or NULL if the column has no nulls
 
 Returns
 -------
 type
-    the generated mouse event
+    the array, or NULL if the column is not supported
 """
-mouse_release.argtypes = [
-    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
-    DvzMouseButton,  # DvzMouseButton button
-    ctypes.c_int,  # int mods
+array_arrow.argtypes = [
+    ctypes.POINTER(DvzArrowFile),  # DvzArrowFile* arrow
+    ctypes.c_uint32,  # uint32_t batch
+    ctypes.c_uint32,  # uint32_t field
+    ctypes.POINTER(ctypes.POINTER(DvzArray)),  # DvzArray** mask
 ]
-mouse_release.restype = DvzMouseEvent
+array_arrow.restype = ctypes.POINTER(DvzArray)
 
-# Function dvz_mouse_wheel()
-mouse_wheel = dvz.dvz_mouse_wheel
-mouse_wheel.__doc__ = """
-Create a mouse wheel event.
+# Function dvz_array_buffer()
+array_buffer = dvz.dvz_array_buffer
+array_buffer.__doc__ = """
+Return a pointer to the data of an array.  The items are contiguous, for example the pointer of a DVZ_DTYPE_VEC3 array returned by dvz_array_csv() can be passed to dvz_point_position() with dvz_array_count() items. The pointer is valid until the array is destroyed, and the data of read-only arrays must not be modified.
 
 Parameters
 ----------
-mouse : DvzMouse*
-    the mouse
-button : unknown
-    the mouse wheel direction (x, y)
-mods : int
-    the keyboard modifier flags
+array : DvzArray*
+    the array
 
 Returns
 -------
 type
-    the generated mouse event
+    the pointer to the array data
 """
-mouse_wheel.argtypes = [
-    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
-    ctypes.c_float * 2,  # vec2 dir
-    ctypes.c_int,  # int mods
+array_buffer.argtypes = [
+    ctypes.POINTER(DvzArray),  # DvzArray* array
 ]
-mouse_wheel.restype = DvzMouseEvent
+array_buffer.restype = ndpointer(flags="C_CONTIGUOUS")
 
-# Function dvz_mouse_event()
-mouse_event = dvz.dvz_mouse_event
-mouse_event.__doc__ = """
-Create a generic mouse event.
+# Function dvz_array_count()
+array_count = dvz.dvz_array_count
+array_count.__doc__ = """
+Return the number of items of an array.
 
 Parameters
 ----------
-mouse : DvzMouse*
-    the mouse
-ev : DvzMouseEvent
+array : DvzArray*
+    the array
+
+Returns
+-------
+type
+    the number of items
+"""
+array_count.argtypes = [
+    ctypes.POINTER(DvzArray),  # DvzArray* array
+]
+array_count.restype = ctypes.c_uint32
+
+# Function dvz_array_dtype()
+array_dtype = dvz.dvz_array_dtype
+array_dtype.__doc__ = """
+Return the data type of the items of an array.
+
+Parameters
+----------
+array : DvzArray*
+    the array
+
+Returns
+-------
+type
+    the data type
+"""
+array_dtype.argtypes = [
+    ctypes.POINTER(DvzArray),  # DvzArray* array
+]
+array_dtype.restype = DvzDataType
+
+# Function dvz_array_destroy()
+array_destroy = dvz.dvz_array_destroy
+array_destroy.__doc__ = """
+Destroy an array.  This function frees the allocated underlying data buffer, or releases the file mapping.
+
+Parameters
+----------
+array : DvzArray*
+    the array to destroy
+"""
+array_destroy.argtypes = [
+    ctypes.POINTER(DvzArray),  # DvzArray* array
+]
+
+# Function dvz_stream_gz()
+stream_gz = dvz.dvz_stream_gz
+stream_gz.__doc__ = """
+Decompress a GZIP file chunk by chunk, without holding the decompressed file in memory.  All chunks have the requested size, except the last one. Multi-member files are supported, and BGZF files (made of independent members with their compressed size in the header, as written by bgzip) are decompressed in parallel.
+
+Parameters
+----------
+filename : char*
+    path of the GZIP compressed file to open
+chunk_size : DvzSize
+    size of the chunks, or 0 for the default size (4 MB)
+callback : DvzChunkCallback
+    the callback called with each chunk
+user_data : void*
+    pointer passed to the callback
+
+Returns
+-------
+type
+    0 on success, a nonzero value on error or if the callback stopped the decompression
+"""
+stream_gz.argtypes = [
+    ctypes.c_char_p,  # char* filename
+    DvzSize,  # DvzSize chunk_size
+    DvzChunkCallback,  # DvzChunkCallback callback
+    ctypes.c_void_p,  # void* user_data
+]
+stream_gz.restype = ctypes.c_int
+
+# Function dvz_arrow_open()
+arrow_open = dvz.dvz_arrow_open
+arrow_open.__doc__ = """
+Open an Arrow IPC file (Feather v2) and parse its schema and record batches.  The file is memory-mapped and kept open until dvz_arrow_close(). Only little-endian files are supported. Columns with nested or variable-size types are listed in the schema, with a zero kind, but their values cannot be accessed.
+
+Parameters
+----------
+filename : char*
+    path of the Arrow file
+
+Returns
+-------
+type
+    the opened file, or NULL if the file is invalid
+"""
+arrow_open.argtypes = [
+    ctypes.c_char_p,  # char* filename
+]
+arrow_open.restype = ctypes.POINTER(DvzArrowFile)
+
+# Function dvz_arrow_column()
+arrow_column = dvz.dvz_arrow_column
+arrow_column.__doc__ = """
+Get a column of a record batch of an Arrow IPC file, without copying the data.  Numbers are stored as contiguous values (`components` values per row), booleans as a bitmap. Compressed record batches are not supported.
+
+Parameters
+----------
+arrow : DvzArrowFile*
+    the Arrow file
+batch : uint32_t
+    the record batch index
+field : uint32_t
+    the column index
+column : DvzArrowColumn* (out parameter)
+    the column, pointing into the file mapping
+
+Returns
+-------
+type
+    0 on success, a nonzero value if the column is invalid or unsupported
+"""
+arrow_column.argtypes = [
+    ctypes.POINTER(DvzArrowFile),  # DvzArrowFile* arrow
+    ctypes.c_uint32,  # uint32_t batch
+    ctypes.c_uint32,  # uint32_t field
+    ctypes.POINTER(DvzArrowColumn),  # DvzArrowColumn* column
+]
+arrow_column.restype = ctypes.c_int
+
+# Function dvz_arrow_close()
+arrow_close = dvz.dvz_arrow_close
+arrow_close.__doc__ = """
+Close an Arrow IPC file.
+
+Parameters
+----------
+arrow : DvzArrowFile*
+    the Arrow file
+"""
+arrow_close.argtypes = [
+    ctypes.POINTER(DvzArrowFile),  # DvzArrowFile* arrow
+]
+
+# Function dvz_scene()
+scene = dvz.dvz_scene
+scene.__doc__ = """
+Create a scene.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+
+Returns
+-------
+type
+    the scene
+"""
+scene.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+]
+scene.restype = ctypes.POINTER(DvzScene)
+
+# Function dvz_scene_batch()
+scene_batch = dvz.dvz_scene_batch
+scene_batch.__doc__ = """
+Return the batch from a scene.
+
+Parameters
+----------
+scene : DvzScene*
+    the scene
+
+Returns
+-------
+type
+    the batch
+"""
+scene_batch.argtypes = [
+    ctypes.POINTER(DvzScene),  # DvzScene* scene
+]
+scene_batch.restype = ctypes.POINTER(DvzBatch)
+
+# Function dvz_scene_run()
+scene_run = dvz.dvz_scene_run
+scene_run.__doc__ = """
+Start the event loop and render the scene in a window.
+
+Parameters
+----------
+scene : DvzScene*
+    the scene
+app : DvzApp*
+    the app
+n_frames : uint64_t
+    the maximum number of frames, 0 for infinite loop
+"""
+scene_run.argtypes = [
+    ctypes.POINTER(DvzScene),  # DvzScene* scene
+    ctypes.POINTER(DvzApp),  # DvzApp* app
+    ctypes.c_uint64,  # uint64_t n_frames
+]
+
+# Function dvz_scene_mouse()
+scene_mouse = dvz.dvz_scene_mouse
+scene_mouse.__doc__ = """
+Manually pass a mouse event to the scene.
+
+Parameters
+----------
+scene : DvzScene*
+    the scene
+fig : DvzFigure*
+    the figure
+ev : DvzMouseEvent
+    the mouse event
+"""
+scene_mouse.argtypes = [
+    ctypes.POINTER(DvzScene),  # DvzScene* scene
+    ctypes.POINTER(DvzFigure),  # DvzFigure* fig
+    DvzMouseEvent,  # DvzMouseEvent ev
+]
+
+# Function dvz_scene_destroy()
+scene_destroy = dvz.dvz_scene_destroy
+scene_destroy.__doc__ = """
+Destroy a scene.
+
+Parameters
+----------
+scene : DvzScene*
+    the scene
+"""
+scene_destroy.argtypes = [
+    ctypes.POINTER(DvzScene),  # DvzScene* scene
+]
+
+# Function dvz_mouse_move()
+mouse_move = dvz.dvz_mouse_move
+mouse_move.__doc__ = """
+Create a mouse move event.
+
+Parameters
+----------
+mouse : DvzMouse*
+    the mouse
+pos : vec2
+    the cursor position, in pixels
+mods : int
+    the keyboard modifier flags
+
+Returns
+-------
+type
+    the generated mouse event
+"""
+mouse_move.argtypes = [
+    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
+    ctypes.c_float * 2,  # vec2 pos
+    ctypes.c_int,  # int mods
+]
+mouse_move.restype = DvzMouseEvent
+
+# Function dvz_mouse_press()
+mouse_press = dvz.dvz_mouse_press
+mouse_press.__doc__ = """
+Create a mouse press event.
+
+Parameters
+----------
+mouse : DvzMouse*
+    the mouse
+button : DvzMouseButton
+    the mouse button (enum int)
+mods : int
+    the keyboard modifier flags
+
+Returns
+-------
+type
+    the generated mouse event
+"""
+mouse_press.argtypes = [
+    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
+    DvzMouseButton,  # DvzMouseButton button
+    ctypes.c_int,  # int mods
+]
+mouse_press.restype = DvzMouseEvent
+
+# Function dvz_mouse_release()
+mouse_release = dvz.dvz_mouse_release
+mouse_release.__doc__ = """
+Create a mouse release event.
+
+Parameters
+----------
+mouse : DvzMouse*
+    the mouse
+button : DvzMouseButton
+    the mouse button (enum int)
+mods : int
+    the keyboard modifier flags
+
+Returns
+-------
+type
+    the generated mouse event
+"""
+mouse_release.argtypes = [
+    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
+    DvzMouseButton,  # DvzMouseButton button
+    ctypes.c_int,  # int mods
+]
+mouse_release.restype = DvzMouseEvent
+
+# Function dvz_mouse_wheel()
+mouse_wheel = dvz.dvz_mouse_wheel
+mouse_wheel.__doc__ = """
+Create a mouse wheel event.
+
+Parameters
+----------
+mouse : DvzMouse*
+    the mouse
+button : unknown
+    the mouse wheel direction (x, y)
+mods : int
+    the keyboard modifier flags
+
+Returns
+-------
+type
+    the generated mouse event
+"""
+mouse_wheel.argtypes = [
+    ctypes.POINTER(DvzMouse),  # DvzMouse* mouse
+    ctypes.c_float * 2,  # vec2 dir
+    ctypes.c_int,  # int mods
+]
+mouse_wheel.restype = DvzMouseEvent
+
+# Function dvz_mouse_event()
+mouse_event = dvz.dvz_mouse_event
+mouse_event.__doc__ = """
+Create a generic mouse event.
+
+Parameters
+----------
+mouse : DvzMouse*
+    the mouse
+ev : DvzMouseEvent
     the mouse event
 """
 mouse_event.argtypes = [
@@ -3168,6 +3893,35 @@ panel_mvpmat.argtypes = [
     ctypes.c_float * 16,  # mat4 proj
 ]
 
+# Function dvz_panel_scale()
+panel_scale = dvz.dvz_panel_scale
+panel_scale.__doc__ = """
+Set the scale of one axis of a panel, applied to the positions in the vertex shader.  The panel must have a controller (panzoom, ortho...). The positions of the visuals should be uploaded in data coordinates, and the axes of the panel compute their ticks in the scaled space. See `dvz_mvp_scale()`.
+
+Parameters
+----------
+panel : DvzPanel*
+    the panel
+dim : uint32_t
+    the axis (0 for x, 1 for y, 2 for z)
+type : DvzScaleType
+    the scale type
+param : double
+    the scale parameter (linear threshold for symlog, ignored otherwise)
+domain : dvec2
+    the data values mapped to the range (must be positive on a log10 axis)
+range : vec2
+    the corresponding coordinates, typically normalized device coordinates
+"""
+panel_scale.argtypes = [
+    ctypes.POINTER(DvzPanel),  # DvzPanel* panel
+    ctypes.c_uint32,  # uint32_t dim
+    DvzScaleType,  # DvzScaleType type
+    ctypes.c_double,  # double param
+    ctypes.c_double * 2,  # dvec2 domain
+    ctypes.c_float * 2,  # vec2 range
+]
+
 # Function dvz_panel_resize()
 panel_resize = dvz.dvz_panel_resize
 panel_resize.__doc__ = """
@@ -3830,6 +4584,23 @@ visual_tex.argtypes = [
     ctypes.c_uint32 * 3,  # uvec3 offset
 ]
 
+# Function dvz_visual_mask_slot()
+visual_mask_slot = dvz.dvz_visual_mask_slot
+visual_mask_slot.__doc__ = """
+Declare the slot of the per-item mask storage buffer of a visual created with `DVZ_VISUAL_FLAGS_MASK`.  The buffer is created and bound when the visual is allocated. Its layout is described in mask.glsl.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+slot_idx : uint32_t
+    the slot index
+"""
+visual_mask_slot.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t slot_idx
+]
+
 # Function dvz_visual_alloc()
 visual_alloc = dvz.dvz_visual_alloc
 visual_alloc.__doc__ = """
@@ -3867,16 +4638,103 @@ tr : DvzTransform*
 vertex_attr : uint32_t
     the vertex attribute on which the transform applies to
 """
-visual_transform.argtypes = [
+visual_transform.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzTransform),  # DvzTransform* tr
+    ctypes.c_uint32,  # uint32_t vertex_attr
+]
+
+# Function dvz_visual_data()
+visual_data = dvz.dvz_visual_data
+visual_data.__doc__ = """
+Set visual data.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+attr_idx : uint32_t
+    the attribute index
+first : uint32_t
+    the index of the first item to set
+count : uint32_t
+    the number of items to set
+data : void*
+    a pointer to the data buffer
+"""
+visual_data.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t attr_idx
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(flags="C_CONTIGUOUS"),  # void* data
+]
+
+# Function dvz_visual_data_double()
+visual_data_double = dvz.dvz_visual_data_double
+visual_data_double.__doc__ = """
+Set double precision visual data, split into high and low single precision parts.  With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the high parts go to the first attribute and the low parts to the second one, so that the vertex shader can recover the positions with about twice the single precision. Otherwise, only the first attribute is set with the rounded values.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+attr_idx : uint32_t
+    the index of the attribute receiving the high parts
+attr_lo : uint32_t
+    the index of the attribute receiving the low parts
+first : uint32_t
+    the index of the first item to set
+count : uint32_t
+    the number of items to set
+data : dvec3*
+    a pointer to the double precision data
+"""
+visual_data_double.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t attr_idx
+    ctypes.c_uint32,  # uint32_t attr_lo
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* data
+]
+
+# Function dvz_visual_data_box()
+visual_data_box = dvz.dvz_visual_data_box
+visual_data_box.__doc__ = """
+Normalize double-precision positions into a target box and set them as visual data.  This is equivalent to `dvz_box_normalize()` followed by `dvz_visual_data()`, but the single-precision positions are written directly into the visual's vertex buffer, without any intermediate array. The attribute must be a vec3 attribute.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+attr_idx : uint32_t
+    the attribute index
+first : uint32_t
+    the index of the first item to set
+count : uint32_t
+    the number of items to set
+source : DvzBox
+    the source box, in data coordinates
+target : DvzBox
+    the target box, typically in normalized coordinates
+pos : dvec3*
+    the positions to normalize (double precision)
+"""
+visual_data_box.argtypes = [
     ctypes.POINTER(DvzVisual),  # DvzVisual* visual
-    ctypes.POINTER(DvzTransform),  # DvzTransform* tr
-    ctypes.c_uint32,  # uint32_t vertex_attr
+    ctypes.c_uint32,  # uint32_t attr_idx
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    DvzBox,  # DvzBox source
+    DvzBox,  # DvzBox target
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* pos
 ]
 
-# Function dvz_visual_data()
-visual_data = dvz.dvz_visual_data
-visual_data.__doc__ = """
-Set visual data.
+# Function dvz_visual_quantize()
+visual_quantize = dvz.dvz_visual_quantize
+visual_quantize.__doc__ = """
+Set visual data into a quantized vertex attribute.  The attribute format determines the conversion: `DVZ_FORMAT_R16G16B16A16_SNORM` for vec3 positions, `DVZ_FORMAT_R16_SNORM` for scalars in [-1, +1], and `DVZ_FORMAT_R16_SFLOAT` for half-precision scalars. The vertex shader receives the decoded float values.  Positions are stored relative to the bounding box of all the positions of the visual, which is passed to the vertex shader to decode them. Updating a range of positions outside of the current box grows it and requantizes the other positions from their source values, which the visual retains in double precision.
 
 Parameters
 ----------
@@ -3888,15 +4746,18 @@ first : uint32_t
     the index of the first item to set
 count : uint32_t
     the number of items to set
-data : void*
-    a pointer to the data buffer
+scale : float
+    the factor applied to the values before quantization
+data : float*
+    the float values (3 floats per item for positions, 1 otherwise)
 """
-visual_data.argtypes = [
+visual_quantize.argtypes = [
     ctypes.POINTER(DvzVisual),  # DvzVisual* visual
     ctypes.c_uint32,  # uint32_t attr_idx
     ctypes.c_uint32,  # uint32_t first
     ctypes.c_uint32,  # uint32_t count
-    ndpointer(flags="C_CONTIGUOUS"),  # void* data
+    ctypes.c_float,  # float scale
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* data
 ]
 
 # Function dvz_visual_quads()
@@ -3948,6 +4809,52 @@ visual_index.argtypes = [
     ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # DvzIndex* data
 ]
 
+# Function dvz_visual_mask()
+visual_mask = dvz.dvz_visual_mask
+visual_mask.__doc__ = """
+Set the mask states of a range of items.  The states are resolved in the vertex shader, so that hiding, selecting or highlighting items only uploads the modified bytes of the mask buffer (rounded to 4-byte words), without touching the vertex buffers. The visual must have been created with `DVZ_VISUAL_FLAGS_MASK`.  Only the point and marker visuals read the mask: the other visuals ignore `DVZ_VISUAL_FLAGS_MASK` with a warning, and this function then logs an error and does nothing.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first item to set
+count : uint32_t
+    the number of items to set
+bits : uint8_t*
+    the states of the items, a combination of DvzMaskFlags for each item
+"""
+visual_mask.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.uint8, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint8_t* bits
+]
+
+# Function dvz_visual_mask_style()
+visual_mask_style = dvz.dvz_visual_mask_style
+visual_mask_style.__doc__ = """
+Set how the mask states are rendered.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+selected_color : vec4
+    the RGB color of the selected items
+highlight_scale : float
+    the size factor of the highlighted items
+dimmed_alpha : float
+    the alpha factor of the dimmed items
+"""
+visual_mask_style.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float * 4,  # vec4 selected_color
+    ctypes.c_float,  # float highlight_scale
+    ctypes.c_float,  # float dimmed_alpha
+]
+
 # Function dvz_visual_param()
 visual_param = dvz.dvz_visual_param
 visual_param.__doc__ = """
@@ -4066,6 +4973,147 @@ colormap_array.argtypes = [
     ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* out
 ]
 
+# Function dvz_colormap_lut()
+colormap_lut = dvz.dvz_colormap_lut
+colormap_lut.__doc__ = """
+Resolve a colormap into a contiguous lookup table, for fast bulk colormapping.
+
+Parameters
+----------
+cmap : DvzColormap
+    the colormap
+lut : DvzColormapLut* (out parameter)
+    the lookup table
+"""
+colormap_lut.argtypes = [
+    DvzColormap,  # DvzColormap cmap
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+]
+
+# Function dvz_colormap_lut_nan()
+colormap_lut_nan = dvz.dvz_colormap_lut_nan
+colormap_lut_nan.__doc__ = """
+Set the color of the NaN values in a colormap lookup table.
+
+Parameters
+----------
+lut : DvzColormapLut*
+    the lookup table
+color : DvzColor
+    the color of the NaN values
+"""
+colormap_lut_nan.argtypes = [
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+    DvzColor,  # DvzColor color
+]
+
+# Function dvz_colormap_lut_clip()
+colormap_lut_clip = dvz.dvz_colormap_lut_clip
+colormap_lut_clip.__doc__ = """
+Set the colors of the out-of-range values in a colormap lookup table.
+
+Parameters
+----------
+lut : DvzColormapLut*
+    the lookup table
+under : DvzColor
+    the color of the values below vmin
+over : DvzColor
+    the color of the values above vmax
+"""
+colormap_lut_clip.argtypes = [
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+    DvzColor,  # DvzColor under
+    DvzColor,  # DvzColor over
+]
+
+# Function dvz_colormap_lut_float()
+colormap_lut_float = dvz.dvz_colormap_lut_float
+colormap_lut_float.__doc__ = """
+Fetch colors from a colormap lookup table and an array of float values (multithreaded).
+
+Parameters
+----------
+lut : DvzColormapLut*
+    the lookup table
+count : uint32_t
+    the number of values
+values : float*
+    pointer to the array of float numbers
+vmin : float
+    the minimum value
+vmax : float
+    the maximum value
+out : DvzColor* (out parameter)
+    the fetched colors
+"""
+colormap_lut_float.argtypes = [
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_float,  # float vmin
+    ctypes.c_float,  # float vmax
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* out
+]
+
+# Function dvz_colormap_lut_double()
+colormap_lut_double = dvz.dvz_colormap_lut_double
+colormap_lut_double.__doc__ = """
+Fetch colors from a colormap lookup table and an array of double values (multithreaded).
+
+Parameters
+----------
+lut : DvzColormapLut*
+    the lookup table
+count : uint32_t
+    the number of values
+values : double*
+    pointer to the array of double numbers
+vmin : double
+    the minimum value
+vmax : double
+    the maximum value
+out : DvzColor* (out parameter)
+    the fetched colors
+"""
+colormap_lut_double.argtypes = [
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # double* values
+    ctypes.c_double,  # double vmin
+    ctypes.c_double,  # double vmax
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* out
+]
+
+# Function dvz_colormap_lut_int()
+colormap_lut_int = dvz.dvz_colormap_lut_int
+colormap_lut_int.__doc__ = """
+Fetch colors from a colormap lookup table and an array of integer values (multithreaded).
+
+Parameters
+----------
+lut : DvzColormapLut*
+    the lookup table
+count : uint32_t
+    the number of values
+values : int32_t*
+    pointer to the array of int32 numbers
+vmin : int32_t
+    the minimum value
+vmax : int32_t
+    the maximum value
+out : DvzColor* (out parameter)
+    the fetched colors
+"""
+colormap_lut_int.argtypes = [
+    ctypes.POINTER(DvzColormapLut),  # DvzColormapLut* lut
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.int32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # int32_t* values
+    ctypes.c_int32,  # int32_t vmin
+    ctypes.c_int32,  # int32_t vmax
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* out
+]
+
 # Function dvz_compute_normals()
 compute_normals = dvz.dvz_compute_normals
 compute_normals.__doc__ = """
@@ -4160,6 +5208,76 @@ shape_unindex.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_shape_optimize()
+shape_optimize = dvz.dvz_shape_optimize
+shape_optimize.__doc__ = """
+Reorder the triangles and vertices of an indexed shape for faster rendering.
+
+The triangles are reordered for the GPU vertex cache, then by clusters to reduce overdraw, and
+the vertices are renumbered in the order in which they are used. The shape is modified in
+place, the set of triangles is unchanged. Trailing indices that do not form a full triangle
+are kept at the end.
+
+Parameters
+----------
+shape : DvzShape*
+    the shape
+"""
+shape_optimize.argtypes = [
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+]
+
+# Function dvz_shape_simplify()
+shape_simplify = dvz.dvz_shape_simplify
+shape_simplify.__doc__ = """
+Simplify an indexed shape in place by collapsing edges with the smallest quadric error.
+
+The vertices are kept, only the index buffer is modified. The result is deterministic and
+does not depend on the number of threads.
+
+Parameters
+----------
+shape : DvzShape*
+    the shape
+ratio : float
+    the target fraction of triangles to keep, between 0 and 1
+
+Returns
+-------
+type
+    the simplification error, relative to the radius of the shape's bounding sphere
+"""
+shape_simplify.argtypes = [
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_float,  # float ratio
+]
+shape_simplify.restype = ctypes.c_float
+
+# Function dvz_shape_lod()
+shape_lod = dvz.dvz_shape_lod
+shape_lod.__doc__ = """
+Compute levels of detail of an indexed shape.
+
+Each level is simplified from the previous one. The levels share the vertices of the shape,
+and their indices are concatenated in the shape's index buffer (see the `lod_*` fields). The
+mesh visual selects the level to draw at every frame depending on the on-screen size of the
+shape.
+
+Parameters
+----------
+shape : DvzShape*
+    the shape
+lod_count : uint32_t
+    the number of levels, at most DVZ_SHAPE_MAX_LODS
+ratios : float*
+    the fraction of triangles of each level, from the finest to the coarsest
+"""
+shape_lod.argtypes = [
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_uint32,  # uint32_t lod_count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* ratios
+]
+
 # Function dvz_shape_destroy()
 shape_destroy = dvz.dvz_shape_destroy
 shape_destroy.__doc__ = """
@@ -4369,6 +5487,38 @@ shape_polygon.argtypes = [
 ]
 shape_polygon.restype = DvzShape
 
+# Function dvz_shape_polygons()
+shape_polygons = dvz.dvz_shape_polygons
+shape_polygons.__doc__ = """
+Create a single shape out of many polygons with holes, triangulated in parallel.
+
+Parameters
+----------
+polygon_count : uint32_t
+    the number of polygons
+polygon_offsets : uint32_t*
+    the index of the first ring of each polygon (polygon_count + 1 values)
+ring_offsets : uint32_t*
+    the index of the first point of each ring (ring_count + 1 values)
+points : dvec2*
+    the 2D positions of the points of all rings
+colors : DvzColor*
+    the color of each polygon
+
+Returns
+-------
+type
+    the shape
+"""
+shape_polygons.argtypes = [
+    ctypes.c_uint32,  # uint32_t polygon_count
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* polygon_offsets
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* ring_offsets
+    ndpointer(dtype=np.double, ndim=2, ncol=2, flags="C_CONTIGUOUS"),  # dvec2* points
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* colors
+]
+shape_polygons.restype = DvzShape
+
 # Function dvz_shape_surface()
 shape_surface = dvz.dvz_shape_surface
 shape_surface.__doc__ = """
@@ -4410,6 +5560,117 @@ shape_surface.argtypes = [
 ]
 shape_surface.restype = DvzShape
 
+# Function dvz_shape_isosurface()
+shape_isosurface = dvz.dvz_shape_isosurface
+shape_isosurface.__doc__ = """
+Create an isosurface shape from a 3D grid of values with marching cubes.
+
+The values are stored as in dvz_tex_volume(), with the x index varying the fastest, and the
+grid point (x, y, z) is at o + x * u + y * v + z * w. The mesh is watertight, the normals are
+computed from the value gradients and point towards the values lower than the level. The
+volume is processed in parallel by bricks, and the bricks whose value range does not contain
+the level are skipped.
+
+Parameters
+----------
+width : uint32_t
+    the number of values along x
+height : uint32_t
+    the number of values along y
+depth : uint32_t
+    the number of values along z
+volume : float*
+    a pointer to width*height*depth values
+level : float
+    the isosurface level
+ranges : vec2*
+    the value ranges of the bricks from dvz_isosurface_ranges(), or NULL
+o : vec3
+    the origin
+u : vec3
+    the vector between two consecutive values along x
+v : vec3
+    the vector between two consecutive values along y
+w : vec3
+    the vector between two consecutive values along z
+color : DvzColor
+    the color of the isosurface
+
+Returns
+-------
+type
+    the shape
+"""
+shape_isosurface.argtypes = [
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_uint32,  # uint32_t depth
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* volume
+    ctypes.c_float,  # float level
+    ndpointer(dtype=np.float32, ndim=2, ncol=2, flags="C_CONTIGUOUS"),  # vec2* ranges
+    ctypes.c_float * 3,  # vec3 o
+    ctypes.c_float * 3,  # vec3 u
+    ctypes.c_float * 3,  # vec3 v
+    ctypes.c_float * 3,  # vec3 w
+    DvzColor,  # DvzColor color
+]
+shape_isosurface.restype = DvzShape
+
+# Function dvz_isosurface_bricks()
+isosurface_bricks = dvz.dvz_isosurface_bricks
+isosurface_bricks.__doc__ = """
+Return the number of bricks processed by dvz_shape_isosurface() for a given volume shape.
+
+Parameters
+----------
+width : uint32_t
+    the number of values along x
+height : uint32_t
+    the number of values along y
+depth : uint32_t
+    the number of values along z
+
+Returns
+-------
+type
+    the number of bricks
+"""
+isosurface_bricks.argtypes = [
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_uint32,  # uint32_t depth
+]
+isosurface_bricks.restype = ctypes.c_uint32
+
+# Function dvz_isosurface_ranges()
+isosurface_ranges = dvz.dvz_isosurface_ranges
+isosurface_ranges.__doc__ = """
+Compute the minimum and maximum value of each brick of a volume, ignoring NaN values.
+
+The ranges can be passed to dvz_shape_isosurface() to skip the empty bricks without scanning
+the whole volume every time the level changes.
+
+Parameters
+----------
+width : uint32_t
+    the number of values along x
+height : uint32_t
+    the number of values along y
+depth : uint32_t
+    the number of values along z
+volume : float*
+    a pointer to width*height*depth values
+ranges : vec2*
+    the value range of each brick, dvz_isosurface_bricks() values
+"""
+isosurface_ranges.argtypes = [
+    ctypes.c_uint32,  # uint32_t width
+    ctypes.c_uint32,  # uint32_t height
+    ctypes.c_uint32,  # uint32_t depth
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* volume
+    ndpointer(dtype=np.float32, ndim=2, ncol=2, flags="C_CONTIGUOUS"),  # vec2* ranges
+]
+
 # Function dvz_shape_cube()
 shape_cube = dvz.dvz_shape_cube
 shape_cube.__doc__ = """
@@ -4512,29 +5773,138 @@ Parameters
 shape : DvzShape*
     the shape
 """
-shape_normalize.argtypes = [
+shape_normalize.argtypes = [
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+]
+
+# Function dvz_shape_obj()
+shape_obj = dvz.dvz_shape_obj
+shape_obj.__doc__ = """
+Load a .obj shape.
+
+The shape is cached in a .dvzmesh file next to the original file, and later loads read the
+cache as long as the OBJ file is unchanged. Set DVZ_MESH_CACHE=0 to disable the cache.
+
+Parameters
+----------
+file_path : char*
+    the path to the .obj file
+
+Returns
+-------
+type
+    the shape
+"""
+shape_obj.argtypes = [
+    ctypes.c_char_p,  # char* file_path
+]
+shape_obj.restype = DvzShape
+
+# Function dvz_shape_save()
+shape_save = dvz.dvz_shape_save
+shape_save.__doc__ = """
+Save a shape to a binary .dvzmesh file.
+
+The file contains the vertex arrays, the index buffer and the levels of detail of the shape, in
+64-byte aligned sections. Unless DVZ_MESH_CACHE=0, OBJ files loaded with dvz_shape_obj() are
+cached in this format next to the original file.
+
+Parameters
+----------
+shape : DvzShape*
+    the shape
+file_path : char*
+    the path to the .dvzmesh file
+
+Returns
+-------
+type
+    0 on success
+"""
+shape_save.argtypes = [
     ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_char_p,  # char* file_path
 ]
+shape_save.restype = ctypes.c_int
 
-# Function dvz_shape_obj()
-shape_obj = dvz.dvz_shape_obj
-shape_obj.__doc__ = """
-Load a .obj shape.
+# Function dvz_shape_load()
+shape_load = dvz.dvz_shape_load
+shape_load.__doc__ = """
+Load a shape from a binary .dvzmesh file.
 
 Parameters
 ----------
 file_path : char*
-    the path to the .obj file
+    the path to the .dvzmesh file
 
 Returns
 -------
 type
-    the shape
+    the shape, with no vertices if the file could not be loaded
 """
-shape_obj.argtypes = [
+shape_load.argtypes = [
     ctypes.c_char_p,  # char* file_path
 ]
-shape_obj.restype = DvzShape
+shape_load.restype = DvzShape
+
+# Function dvz_isolines()
+isolines = dvz.dvz_isolines
+isolines.__doc__ = """
+Compute the isolines of a 2D grid of values with marching squares, for several levels at once.
+
+The grid point (i, j) is at o + i * u + j * v, and the isolines are split into polylines that
+can be passed to dvz_path_position() or dvz_path_isolines(). Closed polylines end with their
+first point, grid cells with NaN values are skipped.
+
+Parameters
+----------
+row_count : uint32_t
+    number of rows
+col_count : uint32_t
+    number of cols
+values : float*
+    a pointer to row_count*col_count values
+level_count : uint32_t
+    the number of levels
+levels : float*
+    the levels
+o : vec3
+    the origin
+u : vec3
+    the unit vector parallel to each column
+v : vec3
+    the unit vector parallel to each row
+
+Returns
+-------
+type
+    the isolines, to be destroyed with dvz_isolines_destroy()
+"""
+isolines.argtypes = [
+    ctypes.c_uint32,  # uint32_t row_count
+    ctypes.c_uint32,  # uint32_t col_count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+    ctypes.c_uint32,  # uint32_t level_count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* levels
+    ctypes.c_float * 3,  # vec3 o
+    ctypes.c_float * 3,  # vec3 u
+    ctypes.c_float * 3,  # vec3 v
+]
+isolines.restype = DvzIsolines
+
+# Function dvz_isolines_destroy()
+isolines_destroy = dvz.dvz_isolines_destroy
+isolines_destroy.__doc__ = """
+Destroy isolines.
+
+Parameters
+----------
+isolines : DvzIsolines*
+    the isolines
+"""
+isolines_destroy.argtypes = [
+    ctypes.POINTER(DvzIsolines),  # DvzIsolines* isolines
+]
 
 # Function dvz_basic()
 basic = dvz.dvz_basic
@@ -4815,6 +6185,32 @@ point_position.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_point_position_double()
+point_position_double = dvz.dvz_point_position_double
+point_position_double.__doc__ = """
+Set the point positions in double precision.  With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the positions are stored as double-single pairs and keep about twice the single precision on the GPU.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first item to update
+count : uint32_t
+    the number of items to update
+values : dvec3*
+    the 3D positions of the items to update, in double precision
+flags : int
+    the data update flags
+"""
+point_position_double.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* values
+    ctypes.c_int,  # int flags
+]
+
 # Function dvz_point_color()
 point_color = dvz.dvz_point_color
 point_color.__doc__ = """
@@ -4984,6 +6380,32 @@ marker_position.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_marker_position_double()
+marker_position_double = dvz.dvz_marker_position_double
+marker_position_double.__doc__ = """
+Set the marker positions in double precision.  With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the positions are stored as double-single pairs and keep about twice the single precision on the GPU.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first item to update
+count : uint32_t
+    the number of items to update
+values : dvec3*
+    the 3D positions of the items to update, in double precision
+flags : int
+    the data update flags
+"""
+marker_position_double.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* values
+    ctypes.c_int,  # int flags
+]
+
 # Function dvz_marker_size()
 marker_size = dvz.dvz_marker_size
 marker_size.__doc__ = """
@@ -5202,6 +6624,35 @@ segment_position.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_segment_position_double()
+segment_position_double = dvz.dvz_segment_position_double
+segment_position_double.__doc__ = """
+Set the segment positions in double precision.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first item to update
+count : uint32_t
+    the number of items to update
+initial : dvec3*
+    the initial 3D positions of the segments, in double precision
+terminal : dvec3*
+    the terminal 3D positions of the segments, in double precision
+flags : int
+    the data update flags
+"""
+segment_position_double.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* initial
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* terminal
+    ctypes.c_int,  # int flags
+]
+
 # Function dvz_segment_shift()
 segment_shift = dvz.dvz_segment_shift
 segment_shift.__doc__ = """
@@ -5378,6 +6829,35 @@ path_position.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_path_position_double()
+path_position_double = dvz.dvz_path_position_double
+path_position_double.__doc__ = """
+Set the path positions in double precision.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+point_count : uint32_t
+    the total number of points across all paths
+positions : dvec3*
+    the path point positions, in double precision
+path_count : uint32_t
+    the number of different paths
+path_lengths : uint32_t*
+    the number of points in each path
+flags : int
+    the data update flags
+"""
+path_position_double.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t point_count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* positions
+    ctypes.c_uint32,  # uint32_t path_count
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* path_lengths
+    ctypes.c_int,  # int flags
+]
+
 # Function dvz_path_color()
 path_color = dvz.dvz_path_color
 path_color.__doc__ = """
@@ -5404,6 +6884,28 @@ path_color.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_path_isolines()
+path_isolines = dvz.dvz_path_isolines
+path_isolines.__doc__ = """
+Set the path positions and colors from isolines computed with dvz_isolines().
+
+This function allocates the visual, there is no need to call dvz_path_alloc().
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+isolines : DvzIsolines*
+    the isolines
+level_colors : DvzColor*
+    the color of each level, or NULL to leave the colors unchanged
+"""
+path_isolines.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzIsolines),  # DvzIsolines* isolines
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* level_colors
+]
+
 # Function dvz_path_linewidth()
 path_linewidth = dvz.dvz_path_linewidth
 path_linewidth.__doc__ = """
@@ -6774,6 +8276,29 @@ mesh_contour.argtypes = [
     ctypes.c_int,  # int flags
 ]
 
+# Function dvz_mesh_edges()
+mesh_edges = dvz.dvz_mesh_edges
+mesh_edges.__doc__ = """
+Set the edges drawn by a wireframe mesh.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual, created with the DVZ_MESH_FLAGS_WIREFRAME flag
+first : uint32_t
+    the index of the first face to update
+count : uint32_t
+    the number of faces to update
+values : uint8_t*
+    for each face, bit c is 1 if the edge opposite to corner c is drawn
+"""
+mesh_edges.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.uint8, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint8_t* values
+]
+
 # Function dvz_mesh_texture()
 mesh_texture = dvz.dvz_mesh_texture
 mesh_texture.__doc__ = """
@@ -6937,64 +8462,211 @@ mesh_linewidth.argtypes = [
     ctypes.c_float,  # float linewidth
 ]
 
-# Function dvz_mesh_density()
-mesh_density = dvz.dvz_mesh_density
-mesh_density.__doc__ = """
-Set the number of isolines
+# Function dvz_mesh_density()
+mesh_density = dvz.dvz_mesh_density
+mesh_density.__doc__ = """
+Set the number of isolines
+
+Parameters
+----------
+visual : DvzVisual*
+    the mesh
+count : uint32_t
+    the number of isolines
+"""
+mesh_density.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t count
+]
+
+# Function dvz_mesh_shape()
+mesh_shape = dvz.dvz_mesh_shape
+mesh_shape.__doc__ = """
+Create a mesh out of a shape.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+shape : DvzShape*
+    the shape
+flags : int
+    the visual creation flags
+
+Returns
+-------
+type
+    the mesh
+"""
+mesh_shape.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_int,  # int flags
+]
+mesh_shape.restype = ctypes.POINTER(DvzVisual)
+
+# Function dvz_mesh_reshape()
+mesh_reshape = dvz.dvz_mesh_reshape
+mesh_reshape.__doc__ = """
+Update a mesh once a shape has been updated.
+
+Parameters
+----------
+visual : DvzVisual*
+    the mesh
+shape : DvzShape*
+    the shape
+"""
+mesh_reshape.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+]
+
+# Function dvz_instanced()
+instanced = dvz.dvz_instanced
+instanced.__doc__ = """
+Create an instanced mesh visual, drawing many copies of a single shape in one draw call.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+flags : int
+    the visual creation flags
+
+Returns
+-------
+type
+    the visual
+"""
+instanced.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    ctypes.c_int,  # int flags
+]
+instanced.restype = ctypes.POINTER(DvzVisual)
+
+# Function dvz_instanced_alloc()
+instanced_alloc = dvz.dvz_instanced_alloc
+instanced_alloc.__doc__ = """
+Upload the shape and allocate the instances.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+shape : DvzShape*
+    the shape drawn for every instance
+instance_count : uint32_t
+    the number of instances
+"""
+instanced_alloc.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_uint32,  # uint32_t instance_count
+]
+
+# Function dvz_instanced_position()
+instanced_position = dvz.dvz_instanced_position
+instanced_position.__doc__ = """
+Set the instance positions.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first instance to update
+count : uint32_t
+    the number of instances to update
+values : vec3*
+    the 3D positions of the instances
+flags : int
+    the data update flags
+"""
+instanced_position.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # vec3* values
+    ctypes.c_int,  # int flags
+]
+
+# Function dvz_instanced_rotation()
+instanced_rotation = dvz.dvz_instanced_rotation
+instanced_rotation.__doc__ = """
+Set the instance rotations.
 
 Parameters
 ----------
 visual : DvzVisual*
-    the mesh
+    the visual
+first : uint32_t
+    the index of the first instance to update
 count : uint32_t
-    the number of isolines
+    the number of instances to update
+values : vec4*
+    the rotations of the instances, as quaternions (x, y, z, w)
+flags : int
+    the data update flags
 """
-mesh_density.argtypes = [
+instanced_rotation.argtypes = [
     ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
     ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # vec4* values
+    ctypes.c_int,  # int flags
 ]
 
-# Function dvz_mesh_shape()
-mesh_shape = dvz.dvz_mesh_shape
-mesh_shape.__doc__ = """
-Create a mesh out of a shape.
+# Function dvz_instanced_scale()
+instanced_scale = dvz.dvz_instanced_scale
+instanced_scale.__doc__ = """
+Set the instance scales.
 
 Parameters
 ----------
-batch : DvzBatch*
-    the batch
-shape : DvzShape*
-    the shape
+visual : DvzVisual*
+    the visual
+first : uint32_t
+    the index of the first instance to update
+count : uint32_t
+    the number of instances to update
+values : vec3*
+    the scaling factors of the instances along each axis
 flags : int
-    the visual creation flags
-
-Returns
--------
-type
-    the mesh
+    the data update flags
 """
-mesh_shape.argtypes = [
-    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
-    ctypes.POINTER(DvzShape),  # DvzShape* shape
+instanced_scale.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.float32, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # vec3* values
     ctypes.c_int,  # int flags
 ]
-mesh_shape.restype = ctypes.POINTER(DvzVisual)
 
-# Function dvz_mesh_reshape()
-mesh_reshape = dvz.dvz_mesh_reshape
-mesh_reshape.__doc__ = """
-Update a mesh once a shape has been updated.
+# Function dvz_instanced_color()
+instanced_color = dvz.dvz_instanced_color
+instanced_color.__doc__ = """
+Set the instance colors, multiplied with the shape colors.
 
 Parameters
 ----------
 visual : DvzVisual*
-    the mesh
-shape : DvzShape*
-    the shape
+    the visual
+first : uint32_t
+    the index of the first instance to update
+count : uint32_t
+    the number of instances to update
+values : DvzColor*
+    the colors of the instances
+flags : int
+    the data update flags
 """
-mesh_reshape.argtypes = [
+instanced_color.argtypes = [
     ctypes.POINTER(DvzVisual),  # DvzVisual* visual
-    ctypes.POINTER(DvzShape),  # DvzShape* shape
+    ctypes.c_uint32,  # uint32_t first
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.uint8, ndim=2, ncol=4, flags="C_CONTIGUOUS"),  # DvzColor* values
+    ctypes.c_int,  # int flags
 ]
 
 # Function dvz_sphere()
@@ -7492,6 +9164,190 @@ slice_alpha.argtypes = [
     ctypes.c_float,  # float alpha
 ]
 
+# Function dvz_surface()
+surface = dvz.dvz_surface
+surface.__doc__ = """
+Create a surface visual (a heightmap stored in a texture, meshed on the GPU).
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+flags : int
+    the visual creation flags
+
+Returns
+-------
+type
+    the visual
+"""
+surface.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    ctypes.c_int,  # int flags
+]
+surface.restype = ctypes.POINTER(DvzVisual)
+
+# Function dvz_surface_alloc()
+surface_alloc = dvz.dvz_surface_alloc
+surface_alloc.__doc__ = """
+Allocate memory for a visual, and create the height texture (and the scalar texture with
+`DVZ_SURFACE_FLAGS_SCALAR`). The surface is flat until the heights are set.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+row_count : uint32_t
+    number of rows
+col_count : uint32_t
+    number of cols
+"""
+surface_alloc.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t row_count
+    ctypes.c_uint32,  # uint32_t col_count
+]
+
+# Function dvz_surface_grid()
+surface_grid = dvz.dvz_surface_grid
+surface_grid.__doc__ = """
+Set the grid geometry, with the same convention as `dvz_shape_surface()`. The heights are
+along the normal vector `u x v`.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+o : vec3
+    the origin
+u : vec3
+    the vector between two consecutive rows
+v : vec3
+    the vector between two consecutive columns
+"""
+surface_grid.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float * 3,  # vec3 o
+    ctypes.c_float * 3,  # vec3 u
+    ctypes.c_float * 3,  # vec3 v
+]
+
+# Function dvz_surface_heights()
+surface_heights = dvz.dvz_surface_heights
+surface_heights.__doc__ = """
+Update the heights in a rectangular region of the grid (a single texture upload).
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+row : uint32_t
+    the first row to update
+col : uint32_t
+    the first column to update
+row_count : uint32_t
+    the number of rows to update
+col_count : uint32_t
+    the number of columns to update
+heights : float*
+    a pointer to row_count*col_count height values (floats)
+"""
+surface_heights.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t row
+    ctypes.c_uint32,  # uint32_t col
+    ctypes.c_uint32,  # uint32_t row_count
+    ctypes.c_uint32,  # uint32_t col_count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* heights
+]
+
+# Function dvz_surface_scalar()
+surface_scalar = dvz.dvz_surface_scalar
+surface_scalar.__doc__ = """
+Update the scalar values in a rectangular region of the grid, used with the colormap instead
+of the heights (requires `DVZ_SURFACE_FLAGS_SCALAR`).
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+row : uint32_t
+    the first row to update
+col : uint32_t
+    the first column to update
+row_count : uint32_t
+    the number of rows to update
+col_count : uint32_t
+    the number of columns to update
+values : float*
+    a pointer to row_count*col_count scalar values (floats)
+"""
+surface_scalar.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_uint32,  # uint32_t row
+    ctypes.c_uint32,  # uint32_t col
+    ctypes.c_uint32,  # uint32_t row_count
+    ctypes.c_uint32,  # uint32_t col_count
+    ndpointer(dtype=np.float32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # float* values
+]
+
+# Function dvz_surface_colormap()
+surface_colormap = dvz.dvz_surface_colormap
+surface_colormap.__doc__ = """
+Set the surface colormap.
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+cmap : DvzColormap
+    the colormap
+vmin : float
+    the value mapped to the first color of the colormap
+vmax : float
+    the value mapped to the last color of the colormap
+"""
+surface_colormap.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    DvzColormap,  # DvzColormap cmap
+    ctypes.c_float,  # float vmin
+    ctypes.c_float,  # float vmax
+]
+
+# Function dvz_surface_light_dir()
+surface_light_dir = dvz.dvz_surface_light_dir
+surface_light_dir.__doc__ = """
+Set the surface light direction (requires `DVZ_SURFACE_FLAGS_LIGHTING`).
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+dir : vec3
+    the light direction
+"""
+surface_light_dir.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float * 3,  # vec3 dir
+]
+
+# Function dvz_surface_light_params()
+surface_light_params = dvz.dvz_surface_light_params
+surface_light_params.__doc__ = """
+Set the surface light parameters (requires `DVZ_SURFACE_FLAGS_LIGHTING`).
+
+Parameters
+----------
+visual : DvzVisual*
+    the visual
+params : vec4
+    the light parameters (vec4 ambient, diffuse, specular, exponent)
+"""
+surface_light_params.argtypes = [
+    ctypes.POINTER(DvzVisual),  # DvzVisual* visual
+    ctypes.c_float * 4,  # vec4 params
+]
+
 # Function dvz_resample()
 resample = dvz.dvz_resample
 resample.__doc__ = """
@@ -8276,6 +10132,32 @@ box_normalize.argtypes = [
     ndpointer(dtype=np.float32, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # vec3* out
 ]
 
+# Function dvz_box_normalize_double()
+box_normalize_double = dvz.dvz_box_normalize_double
+box_normalize_double.__doc__ = """
+Normalize 3D input positions into a target box, keeping double precision.  This is meant to be used with the double precision visuals (see `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`), whose data does not need to be normalized again when zooming in.
+
+Parameters
+----------
+source : DvzBox
+    the source box, in data coordinates
+target : DvzBox
+    the target box, typically in normalized coordinates
+count : uint32_t
+    the number of positions to normalize
+pos : dvec3*
+    the positions to normalize (double precision)
+out : dvec3* (out parameter)
+    pointer to an array with the normalized positions to compute (double precision)
+"""
+box_normalize_double.argtypes = [
+    DvzBox,  # DvzBox source
+    DvzBox,  # DvzBox target
+    ctypes.c_uint32,  # uint32_t count
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* pos
+    ndpointer(dtype=np.double, ndim=2, ncol=3, flags="C_CONTIGUOUS"),  # dvec3* out
+]
+
 # Function dvz_box_normalize_2D()
 box_normalize_2D = dvz.dvz_box_normalize_2D
 box_normalize_2D.__doc__ = """
@@ -9491,7 +11373,7 @@ app : DvzApp*
 canvas_id : DvzId
     the ID of the canvas
 filename : char*
-    the path to the PNG file with the screenshot
+    the path to the image file, PNG or, depending on the extension, PPM or QOI
 """
 app_screenshot.argtypes = [
     ctypes.POINTER(DvzApp),  # DvzApp* app
@@ -9742,6 +11624,41 @@ earcut.argtypes = [
 ]
 earcut.restype = ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS")
 
+# Function dvz_earcut_polygons()
+earcut_polygons = dvz.dvz_earcut_polygons
+earcut_polygons.__doc__ = """
+Triangulate many polygons with holes in parallel, in a single index buffer.
+
+Parameters
+----------
+polygon_count : uint32_t
+    the number of polygons
+polygon_offsets : uint32_t*
+    the index of the first ring of each polygon (polygon_count + 1 values)
+ring_offsets : uint32_t*
+    the index of the first point of each ring (ring_count + 1 values)
+points : dvec2*
+    the 2D positions of the points of all rings
+out_index_count : uint32_t* (out parameter)
+    the computed index count
+out_index_offsets : uint32_t* (out parameter)
+    if not NULL, the index of the first index of each polygon
+
+Returns
+-------
+type
+    the computed indices, referring to the points array (must be FREED by the caller)
+"""
+earcut_polygons.argtypes = [
+    ctypes.c_uint32,  # uint32_t polygon_count
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* polygon_offsets
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* ring_offsets
+    ndpointer(dtype=np.double, ndim=2, ncol=2, flags="C_CONTIGUOUS"),  # dvec2* points
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* out_index_count
+    ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS"),  # uint32_t* out_index_offsets
+]
+earcut_polygons.restype = ndpointer(dtype=np.uint32, ndim=1, ncol=1, flags="C_CONTIGUOUS")
+
 # Function dvz_rand_byte()
 rand_byte = dvz.dvz_rand_byte
 rand_byte.__doc__ = """
@@ -10196,6 +12113,52 @@ mvp_default.argtypes = [
 ]
 mvp_default.restype = DvzMVP
 
+# Function dvz_mvp_offset()
+mvp_offset = dvz.dvz_mvp_offset
+mvp_offset.__doc__ = """
+Set the offset of a DvzMVP struct, with respect to which the positions are transformed.  The offset is stored as a pair of single precision numbers whose sum approximates the double precision value. Visuals created with `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION` subtract it from their double-single positions in the vertex shader before applying the MVP matrices.
+
+Parameters
+----------
+mvp : DvzMVP*
+    the MVP
+offset : dvec3
+    the offset, in double precision
+"""
+mvp_offset.argtypes = [
+    ctypes.POINTER(DvzMVP),  # DvzMVP* mvp
+    ctypes.c_double * 3,  # dvec3 offset
+]
+
+# Function dvz_mvp_scale()
+mvp_scale = dvz.dvz_mvp_scale
+mvp_scale.__doc__ = """
+Set the scale of one axis of a DvzMVP struct, applied to the positions in the vertex shader.  On a log10 or symlog axis, the positions are transformed with the scale function, and the transformed domain is mapped linearly to the range. The positions should then be uploaded in data coordinates. Symlog is linear in [-param, +param] and logarithmic outside. On a log10 axis, the primitives with a nonpositive coordinate are discarded. Changing the scale only requires a uniform update.
+
+Parameters
+----------
+mvp : DvzMVP*
+    the MVP
+dim : uint32_t
+    the axis (0 for x, 1 for y, 2 for z)
+type : DvzScaleType
+    the scale type
+param : double
+    the scale parameter (linear threshold for symlog, ignored otherwise)
+domain : dvec2
+    the data values mapped to the range (must be positive on a log10 axis)
+range : vec2
+    the corresponding coordinates, typically normalized device coordinates
+"""
+mvp_scale.argtypes = [
+    ctypes.POINTER(DvzMVP),  # DvzMVP* mvp
+    ctypes.c_uint32,  # uint32_t dim
+    DvzScaleType,  # DvzScaleType type
+    ctypes.c_double,  # double param
+    ctypes.c_double * 2,  # dvec2 domain
+    ctypes.c_float * 2,  # vec2 range
+]
+
 # Function dvz_viewport_default()
 viewport_default = dvz.dvz_viewport_default
 viewport_default.__doc__ = """
@@ -11347,6 +13310,38 @@ bind_index.argtypes = [
 ]
 bind_index.restype = DvzRequest
 
+# Function dvz_bind_index_size()
+bind_index_size = dvz.dvz_bind_index_size
+bind_index_size.__doc__ = """
+Create a request for associating an index dat with 16-bit or 32-bit indices to a graphics pipe.
+
+Parameters
+----------
+batch : DvzBatch*
+    the batch
+graphics : DvzId
+    the id of the graphics pipe
+dat : DvzId
+    the id of the dat with the index data
+offset : DvzSize
+    the offset within the dat
+index_size : DvzSize
+    the size of each index, 2 (uint16) or 4 (uint32) bytes
+
+Returns
+-------
+type
+    the request
+"""
+bind_index_size.argtypes = [
+    ctypes.POINTER(DvzBatch),  # DvzBatch* batch
+    DvzId,  # DvzId graphics
+    DvzId,  # DvzId dat
+    DvzSize,  # DvzSize offset
+    DvzSize,  # DvzSize index_size
+]
+bind_index_size.restype = DvzRequest
+
 # Function dvz_bind_dat()
 bind_dat = dvz.dvz_bind_dat
 bind_dat.__doc__ = """
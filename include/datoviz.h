@@ -52,6 +52,9 @@ Datoviz is still an early stage library and the API may change at any time.
 
 typedef struct DvzApp DvzApp;
 typedef struct DvzServer DvzServer;
+typedef struct DvzFrameSink DvzFrameSink;
+typedef struct DvzArray DvzArray;
+typedef struct DvzArrowFile DvzArrowFile;
 typedef struct DvzBatch DvzBatch;
 typedef struct DvzMouse DvzMouse;
 typedef struct DvzKeyboard DvzKeyboard;
@@ -69,6 +72,7 @@ typedef struct DvzOrtho DvzOrtho;
 typedef struct DvzParams DvzParams;
 
 typedef struct DvzShape DvzShape;
+typedef struct DvzIsolines DvzIsolines;
 typedef struct DvzFont DvzFont;
 typedef struct DvzAtlas DvzAtlas;
 typedef struct DvzTex DvzTex;
@@ -229,6 +233,90 @@ dvz_server_resize(DvzServer* server, DvzId canvas_id, uint32_t width, uint32_t h
 DVZ_EXPORT uint8_t* dvz_server_grab(DvzServer* server, DvzId canvas_id, int flags);
 
 
+
+/**
+ * Enable pipelined rendering, where several frames are rendered and downloaded at the same time.
+ *
+ * With dvz_server_render(), the next frames are submitted to the GPU while the previous ones are
+ * rendered, downloaded and passed to the callback, instead of waiting for each frame as with
+ * dvz_server_grab().
+ *
+ * @param server the server
+ * @param frames_in_flight maximum number of frames submitted to the GPU and not yet passed to the
+ *      callback, from 1 to 16
+ * @param callback the callback receiving the downloaded frames, in order
+ * @param user_data the user data passed to the callback
+ */
+DVZ_EXPORT void dvz_server_pipeline(
+    DvzServer* server, uint32_t frames_in_flight, DvzServerReadbackCallback callback,
+    void* user_data);
+
+
+
+/**
+ * Submit a frame for rendering and download, without waiting for the GPU.
+ *
+ * When all frames are in flight, the oldest one is downloaded and passed to the callback first.
+ *
+ * @param server the server
+ * @param canvas_id the canvas id
+ * @param flags the render flags
+ * @returns the frame index, passed to the callback
+ */
+DVZ_EXPORT uint64_t dvz_server_render(DvzServer* server, DvzId canvas_id, int flags);
+
+
+
+/**
+ * Pass the frames that have finished rendering to the callback, without waiting for the GPU.
+ *
+ * @param server the server
+ * @returns the number of frames passed to the callback
+ */
+DVZ_EXPORT uint32_t dvz_server_poll(DvzServer* server);
+
+
+
+
+/**
+ * Render a canvas and save it to an image file in the background.
+ *
+ * The image is encoded and written by a pool of threads, so that the next frames can be rendered
+ * in the meantime. The format depends on the file extension: `.ppm` (raw RGB), `.qoi`, or PNG
+ * otherwise. The function blocks when too many images are waiting to be written.
+ *
+ * @param server the server
+ * @param canvas_id the canvas id
+ * @param filename path of the image file
+ * @param flags the grab flags
+ */
+DVZ_EXPORT void
+dvz_server_screenshot(DvzServer* server, DvzId canvas_id, const char* filename, int flags);
+
+
+
+/**
+ * Set the PNG compression of the next screenshots.
+ *
+ * @param server the server
+ * @param level compression level, from 0 (none) to 9 (best), or -1 for the fast encoder (default)
+ * @param filter the scanline filter, used with levels 0 to 9
+ */
+DVZ_EXPORT void dvz_server_png(DvzServer* server, int level, DvzPngFilter filter);
+
+
+
+/**
+ * Wait until all pipelined frames have been passed to the callback, and all screenshots have
+ * been written.
+ *
+ * @param server the server
+ * @returns the number of screenshots that could not be written
+ */
+DVZ_EXPORT uint32_t dvz_server_wait(DvzServer* server);
+
+
+
 /**
  * Placeholder.
  *
@@ -247,6 +335,259 @@ DVZ_EXPORT void dvz_server_destroy(DvzServer* server);
 
 
 
+/*************************************************************************************************/
+/*  Frame sink                                                                                   */
+/*************************************************************************************************/
+
+/**
+ * Create a frame sink writing a video stream to a file or a named pipe.
+ *
+ * The frames are converted and written by a background thread, so that an external encoder can
+ * read them, for example `ffmpeg -i video.y4m` or `ffmpeg -f rawvideo -pix_fmt rgb24`. Opening a
+ * named pipe blocks until a reader opens it.
+ *
+ * @param path path of the file or the named pipe
+ * @param width width of the frames
+ * @param height height of the frames
+ * @param fps number of frames per second, written in the YUV4MPEG2 header
+ * @param format the video format
+ * @returns the frame sink, or NULL if the file could not be opened
+ */
+DVZ_EXPORT DvzFrameSink* dvz_frame_sink(
+    const char* path, uint32_t width, uint32_t height, double fps, DvzVideoFormat format);
+
+
+
+/**
+ * Create a frame sink writing a video stream to a file descriptor, for example a pipe.
+ *
+ * The file descriptor is duplicated, the caller remains responsible for closing it.
+ *
+ * @param fd the file descriptor
+ * @param width width of the frames
+ * @param height height of the frames
+ * @param fps number of frames per second, written in the YUV4MPEG2 header
+ * @param format the video format
+ * @returns the frame sink, or NULL if the file descriptor is invalid
+ */
+DVZ_EXPORT DvzFrameSink* dvz_frame_sink_fd(
+    int fd, uint32_t width, uint32_t height, double fps, DvzVideoFormat format);
+
+
+
+/**
+ * Queue a frame to be converted and written.
+ *
+ * The frame is copied, so that the buffer can be reused as soon as the function returns, for
+ * example the image passed to a DvzServerReadbackCallback. The function blocks while the queue
+ * is full.
+ *
+ * @param sink the frame sink
+ * @param pixels the frame, with width*height pixels
+ * @param components number of bytes per pixel, 3 (RGB) or 4 (RGBA)
+ */
+DVZ_EXPORT void
+dvz_frame_sink_push(DvzFrameSink* sink, const uint8_t* pixels, uint32_t components);
+
+
+
+/**
+ * Wait until all queued frames have been written.
+ *
+ * @param sink the frame sink
+ * @returns 0 if all frames have been written, or a non-zero value if a write failed
+ */
+DVZ_EXPORT int dvz_frame_sink_wait(DvzFrameSink* sink);
+
+
+
+/**
+ * Write the queued frames, close the stream, and destroy the frame sink.
+ *
+ * @param sink the frame sink
+ */
+DVZ_EXPORT void dvz_frame_sink_destroy(DvzFrameSink* sink);
+
+
+
+/*************************************************************************************************/
+/*  Arrays                                                                                       */
+/*************************************************************************************************/
+
+/**
+ * Open a NumPy NPY file as an array, without copying the data.
+ *
+ * The file is memory-mapped and the array data points into the mapping, so that the pages are
+ * only loaded from the page cache when they are accessed. The array is read-only: the functions
+ * modifying it log an error and leave it unchanged, and the mapping is released by
+ * dvz_array_destroy().
+ *
+ * The NPY dtype is converted to the corresponding scalar data type. With DVZ_ARRAY_FLAGS_VECTOR,
+ * a last dimension of 2, 3 or 4 elements gives a vector data type instead. Unsupported dtypes
+ * give DVZ_DTYPE_CUSTOM items of the same size. The remaining dimensions go to `shape`, the last
+ * one varying the fastest, and Fortran-ordered arrays are opened as their C-ordered transpose.
+ *
+ * @param filename path of the NPY file
+ * @param flags the array flags
+ * @returns the array, or NULL if the file could not be opened
+ */
+DVZ_EXPORT DvzArray* dvz_array_npy(const char* filename, int flags);
+
+
+
+/**
+ * Load columns of a CSV or TSV file into a new array.
+ *
+ * The file is memory-mapped, split into chunks of lines that are parsed in parallel, and the
+ * selected columns are written into a new array with one item per non-empty row. For example,
+ * three columns and DVZ_DTYPE_VEC3 give an array of positions that can be passed to
+ * dvz_point_position(), four columns and DVZ_DTYPE_CVEC4 give an array of colors.
+ *
+ * Floating-point values that are missing or cannot be parsed give NaN. Integer values are rounded
+ * and clamped to the range of the data type, and missing ones give 0. Quoted fields are supported
+ * but they may not contain delimiters or newlines.
+ *
+ * @param filename path of the CSV file
+ * @param delimiter the field delimiter, or 0 to detect it from the first row (comma, tab, or
+ *      semicolon)
+ * @param skip_rows number of header rows to skip
+ * @param columns the indices of the columns, one per component of the data type
+ * @param dtype the data type of the array, a scalar or vector type of integers, floats or doubles
+ * @returns the array, or NULL if the file could not be opened
+ */
+DVZ_EXPORT DvzArray* dvz_array_csv(
+    const char* filename, char delimiter, uint32_t skip_rows, const uint32_t* columns,
+    DvzDataType dtype);
+
+
+
+/**
+ * Create a read-only view of a column of a record batch of an Arrow IPC file.
+ *
+ * The array data points into the file mapping, which must stay open with the array: the array
+ * must be destroyed before dvz_arrow_close(). Numbers give the same data types as with
+ * dvz_array_npy(), fixed-size lists of 2, 3 or 4 numbers give vector data types. Booleans are
+ * copied into an array of 0 and 1 values.
+ *
+ * @param arrow the Arrow file opened with dvz_arrow_open()
+ * @param batch the record batch index
+ * @param field the column index
+ * @param[out] mask if not NULL, receives a new DVZ_DTYPE_CHAR array with 1 for valid rows and 0
+ *      for null rows, or NULL if the column has no nulls
+ * @returns the array, or NULL if the column is not supported
+ */
+DVZ_EXPORT DvzArray*
+dvz_array_arrow(DvzArrowFile* arrow, uint32_t batch, uint32_t field, DvzArray** mask);
+
+
+
+/**
+ * Return a pointer to the data of an array.
+ *
+ * The items are contiguous, for example the pointer of a DVZ_DTYPE_VEC3 array returned by
+ * dvz_array_csv() can be passed to dvz_point_position() with dvz_array_count() items. The pointer
+ * is valid until the array is destroyed, and the data of read-only arrays must not be modified.
+ *
+ * @param array the array
+ * @returns the pointer to the array data
+ */
+DVZ_EXPORT void* dvz_array_buffer(DvzArray* array);
+
+
+
+/**
+ * Return the number of items of an array.
+ *
+ * @param array the array
+ * @returns the number of items
+ */
+DVZ_EXPORT uint32_t dvz_array_count(DvzArray* array);
+
+
+
+/**
+ * Return the data type of the items of an array.
+ *
+ * @param array the array
+ * @returns the data type
+ */
+DVZ_EXPORT DvzDataType dvz_array_dtype(DvzArray* array);
+
+
+
+/**
+ * Destroy an array.
+ *
+ * This function frees the allocated underlying data buffer, or releases the file mapping.
+ *
+ * @param array the array to destroy
+ */
+DVZ_EXPORT void dvz_array_destroy(DvzArray* array);
+
+
+
+/*************************************************************************************************/
+/*  File I/O                                                                                     */
+/*************************************************************************************************/
+
+/**
+ * Decompress a GZIP file chunk by chunk, without holding the decompressed file in memory.
+ *
+ * All chunks have the requested size, except the last one. Multi-member files are supported,
+ * and BGZF files (made of independent members with their compressed size in the header, as
+ * written by bgzip) are decompressed in parallel.
+ *
+ * @param filename path of the GZIP compressed file to open
+ * @param chunk_size size of the chunks, or 0 for the default size (4 MB)
+ * @param callback the callback called with each chunk
+ * @param user_data pointer passed to the callback
+ * @returns 0 on success, a nonzero value on error or if the callback stopped the decompression
+ */
+DVZ_EXPORT int dvz_stream_gz(
+    const char* filename, DvzSize chunk_size, DvzChunkCallback callback, void* user_data);
+
+
+
+/**
+ * Open an Arrow IPC file (Feather v2) and parse its schema and record batches.
+ *
+ * The file is memory-mapped and kept open until dvz_arrow_close(). Only little-endian files are
+ * supported. Columns with nested or variable-size types are listed in the schema, with a zero
+ * kind, but their values cannot be accessed.
+ *
+ * @param filename path of the Arrow file
+ * @returns the opened file, or NULL if the file is invalid
+ */
+DVZ_EXPORT DvzArrowFile* dvz_arrow_open(const char* filename);
+
+
+
+/**
+ * Get a column of a record batch of an Arrow IPC file, without copying the data.
+ *
+ * Numbers are stored as contiguous values (`components` values per row), booleans as a
+ * bitmap. Compressed record batches are not supported.
+ *
+ * @param arrow the Arrow file
+ * @param batch the record batch index
+ * @param field the column index
+ * @param[out] column the column, pointing into the file mapping
+ * @returns 0 on success, a nonzero value if the column is invalid or unsupported
+ */
+DVZ_EXPORT int
+dvz_arrow_column(DvzArrowFile* arrow, uint32_t batch, uint32_t field, DvzArrowColumn* column);
+
+
+
+/**
+ * Close an Arrow IPC file.
+ *
+ * @param arrow the Arrow file
+ */
+DVZ_EXPORT void dvz_arrow_close(DvzArrowFile* arrow);
+
+
+
 /*************************************************************************************************/
 /*************************************************************************************************/
 /*  Scene API                                                                                    */
@@ -537,6 +878,25 @@ DVZ_EXPORT void dvz_panel_mvpmat(DvzPanel* panel, mat4 model, mat4 view, mat4 pr
 
 
 
+/**
+ * Set the scale of one axis of a panel, applied to the positions in the vertex shader.
+ *
+ * The panel must have a controller (panzoom, ortho...). The positions of the visuals should be
+ * uploaded in data coordinates, and the axes of the panel compute their ticks in the scaled space.
+ * See `dvz_mvp_scale()`.
+ *
+ * @param panel the panel
+ * @param dim the axis (0 for x, 1 for y, 2 for z)
+ * @param type the scale type
+ * @param param the scale parameter (linear threshold for symlog, ignored otherwise)
+ * @param domain the data values mapped to the range (must be positive on a log10 axis)
+ * @param range the corresponding coordinates, typically normalized device coordinates
+ */
+DVZ_EXPORT void dvz_panel_scale(
+    DvzPanel* panel, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range);
+
+
+
 /**
  * Resize a panel.
  *
@@ -918,6 +1278,20 @@ dvz_visual_tex(DvzVisual* visual, uint32_t slot_idx, DvzId tex, DvzId sampler, u
 
 
 
+/**
+ * Declare the slot of the per-item mask storage buffer of a visual created with
+ * `DVZ_VISUAL_FLAGS_MASK`.
+ *
+ * The buffer is created and bound when the visual is allocated. Its layout is described in
+ * mask.glsl.
+ *
+ * @param visual the visual
+ * @param slot_idx the slot index
+ */
+DVZ_EXPORT void dvz_visual_mask_slot(DvzVisual* visual, uint32_t slot_idx);
+
+
+
 /*************************************************************************************************/
 /*  Visual creation                                                                              */
 /*************************************************************************************************/
@@ -964,6 +1338,72 @@ dvz_visual_data(DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t c
 
 
 
+/**
+ * Set double precision visual data, split into high and low single precision parts.
+ *
+ * With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the high parts go to the first attribute and the low
+ * parts to the second one, so that the vertex shader can recover the positions with about twice
+ * the single precision. Otherwise, only the first attribute is set with the rounded values.
+ *
+ * @param visual the visual
+ * @param attr_idx the index of the attribute receiving the high parts
+ * @param attr_lo the index of the attribute receiving the low parts
+ * @param first the index of the first item to set
+ * @param count the number of items to set
+ * @param data a pointer to the double precision data
+ */
+DVZ_EXPORT void dvz_visual_data_double(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t attr_lo, uint32_t first, uint32_t count,
+    dvec3* data);
+
+
+
+/**
+ * Normalize double-precision positions into a target box and set them as visual data.
+ *
+ * This is equivalent to `dvz_box_normalize()` followed by `dvz_visual_data()`, but the
+ * single-precision positions are written directly into the visual's vertex buffer, without any
+ * intermediate array. The attribute must be a vec3 attribute.
+ *
+ * @param visual the visual
+ * @param attr_idx the attribute index
+ * @param first the index of the first item to set
+ * @param count the number of items to set
+ * @param source the source box, in data coordinates
+ * @param target the target box, typically in normalized coordinates
+ * @param pos the positions to normalize (double precision)
+ */
+DVZ_EXPORT void dvz_visual_data_box(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, DvzBox source,
+    DvzBox target, dvec3* pos);
+
+
+
+/**
+ * Set visual data into a quantized vertex attribute.
+ *
+ * The attribute format determines the conversion: `DVZ_FORMAT_R16G16B16A16_SNORM` for vec3
+ * positions, `DVZ_FORMAT_R16_SNORM` for scalars in [-1, +1], and `DVZ_FORMAT_R16_SFLOAT` for
+ * half-precision scalars. The vertex shader receives the decoded float values.
+ *
+ * Positions are stored relative to the bounding box of all the positions of the visual, which is
+ * passed to the vertex shader to decode them. Updating a range of positions outside of the
+ * current box grows it and requantizes the other positions from their source values, which the
+ * visual retains in double precision.
+ *
+ * @param visual the visual
+ * @param attr_idx the attribute index
+ * @param first the index of the first item to set
+ * @param count the number of items to set
+ * @param scale the factor applied to the values before quantization
+ * @param data the float values (3 floats per item for positions, 1 otherwise)
+ */
+DVZ_EXPORT void dvz_visual_quantize(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, float scale,
+    float* data);
+
+
+
 /**
  * Set visual data as quads.
  *
@@ -992,6 +1432,38 @@ dvz_visual_index(DvzVisual* visual, uint32_t first, uint32_t count, DvzIndex* da
 
 
 
+/**
+ * Set the mask states of a range of items.
+ *
+ * The states are resolved in the vertex shader, so that hiding, selecting or highlighting items
+ * only uploads the modified bytes of the mask buffer (rounded to 4-byte words), without touching
+ * the vertex buffers. The visual must have been created with `DVZ_VISUAL_FLAGS_MASK`.
+ *
+ * Only the point and marker visuals read the mask: the other visuals ignore
+ * `DVZ_VISUAL_FLAGS_MASK` with a warning, and this function then logs an error and does nothing.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to set
+ * @param count the number of items to set
+ * @param bits the states of the items, a combination of DvzMaskFlags for each item
+ */
+DVZ_EXPORT void dvz_visual_mask(DvzVisual* visual, uint32_t first, uint32_t count, uint8_t* bits);
+
+
+
+/**
+ * Set how the mask states are rendered.
+ *
+ * @param visual the visual
+ * @param selected_color the RGB color of the selected items
+ * @param highlight_scale the size factor of the highlighted items
+ * @param dimmed_alpha the alpha factor of the dimmed items
+ */
+DVZ_EXPORT void dvz_visual_mask_style(
+    DvzVisual* visual, vec4 selected_color, float highlight_scale, float dimmed_alpha);
+
+
+
 /**
  * Set a visual parameter value.
  *
@@ -1060,6 +1532,84 @@ DVZ_EXPORT void dvz_colormap_array(
 
 
 
+/**
+ * Resolve a colormap into a contiguous lookup table, for fast bulk colormapping.
+ *
+ * @param cmap the colormap
+ * @param[out] lut the lookup table
+ */
+DVZ_EXPORT void dvz_colormap_lut(DvzColormap cmap, DvzColormapLut* lut);
+
+
+
+/**
+ * Set the color of the NaN values in a colormap lookup table.
+ *
+ * @param lut the lookup table
+ * @param color the color of the NaN values
+ */
+DVZ_EXPORT void dvz_colormap_lut_nan(DvzColormapLut* lut, DvzColor color);
+
+
+
+/**
+ * Set the colors of the out-of-range values in a colormap lookup table.
+ *
+ * @param lut the lookup table
+ * @param under the color of the values below vmin
+ * @param over the color of the values above vmax
+ */
+DVZ_EXPORT void dvz_colormap_lut_clip(DvzColormapLut* lut, DvzColor under, DvzColor over);
+
+
+
+/**
+ * Fetch colors from a colormap lookup table and an array of float values (multithreaded).
+ *
+ * @param lut the lookup table
+ * @param count the number of values
+ * @param values pointer to the array of float numbers
+ * @param vmin the minimum value
+ * @param vmax the maximum value
+ * @param[out] out the fetched colors
+ */
+DVZ_EXPORT void dvz_colormap_lut_float(
+    DvzColormapLut* lut, uint32_t count, float* values, float vmin, float vmax, DvzColor* out);
+
+
+
+/**
+ * Fetch colors from a colormap lookup table and an array of double values (multithreaded).
+ *
+ * @param lut the lookup table
+ * @param count the number of values
+ * @param values pointer to the array of double numbers
+ * @param vmin the minimum value
+ * @param vmax the maximum value
+ * @param[out] out the fetched colors
+ */
+DVZ_EXPORT void dvz_colormap_lut_double(
+    DvzColormapLut* lut, uint32_t count, double* values, double vmin, double vmax,
+    DvzColor* out);
+
+
+
+/**
+ * Fetch colors from a colormap lookup table and an array of integer values (multithreaded).
+ *
+ * @param lut the lookup table
+ * @param count the number of values
+ * @param values pointer to the array of int32 numbers
+ * @param vmin the minimum value
+ * @param vmax the maximum value
+ * @param[out] out the fetched colors
+ */
+DVZ_EXPORT void dvz_colormap_lut_int(
+    DvzColormapLut* lut, uint32_t count, int32_t* values, int32_t vmin, int32_t vmax,
+    DvzColor* out);
+
+
+
 /*************************************************************************************************/
 /*  Shape functions                                                                              */
 /*************************************************************************************************/
@@ -1121,6 +1671,50 @@ DVZ_EXPORT void dvz_shape_unindex(DvzShape* shape, int flags);
 
 
 
+/**
+ * Reorder the triangles and vertices of an indexed shape for faster rendering.
+ *
+ * The triangles are reordered for the GPU vertex cache, then by clusters to reduce overdraw, and
+ * the vertices are renumbered in the order in which they are used. The shape is modified in
+ * place, the set of triangles is unchanged. Trailing indices that do not form a full triangle
+ * are kept at the end.
+ *
+ * @param shape the shape
+ */
+DVZ_EXPORT void dvz_shape_optimize(DvzShape* shape);
+
+
+
+/**
+ * Simplify an indexed shape in place by collapsing edges with the smallest quadric error.
+ *
+ * The vertices are kept, only the index buffer is modified. The result is deterministic and
+ * does not depend on the number of threads.
+ *
+ * @param shape the shape
+ * @param ratio the target fraction of triangles to keep, between 0 and 1
+ * @returns the simplification error, relative to the radius of the shape's bounding sphere
+ */
+DVZ_EXPORT float dvz_shape_simplify(DvzShape* shape, float ratio);
+
+
+
+/**
+ * Compute levels of detail of an indexed shape.
+ *
+ * Each level is simplified from the previous one. The levels share the vertices of the shape,
+ * and their indices are concatenated in the shape's index buffer (see the `lod_*` fields). The
+ * mesh visual selects the level to draw at every frame depending on the on-screen size of the
+ * shape.
+ *
+ * @param shape the shape
+ * @param lod_count the number of levels, at most DVZ_SHAPE_MAX_LODS
+ * @param ratios the fraction of triangles of each level, from the finest to the coarsest
+ */
+DVZ_EXPORT void dvz_shape_lod(DvzShape* shape, uint32_t lod_count, float* ratios);
+
+
+
 /**
  * Destroy a shape.
  *
@@ -1239,8 +1833,27 @@ DVZ_EXPORT DvzShape dvz_shape_disc(uint32_t count, DvzColor color);
  * @param color the polygon color
  * @returns the shape
  */
-DVZ_EXPORT
-DvzShape dvz_shape_polygon(uint32_t count, const dvec2* points, DvzColor color);
+DVZ_EXPORT
+DvzShape dvz_shape_polygon(uint32_t count, const dvec2* points, DvzColor color);
+
+
+
+/**
+ * Create a single shape out of many polygons with holes, triangulated in parallel.
+ *
+ * The rings are described as in `dvz_earcut_polygons()`: the first ring of each polygon is the
+ * outer ring, the others are holes.
+ *
+ * @param polygon_count the number of polygons
+ * @param polygon_offsets the index of the first ring of each polygon (polygon_count + 1 values)
+ * @param ring_offsets the index of the first point of each ring (ring_count + 1 values)
+ * @param points the 2D positions of the points of all rings
+ * @param colors the color of each polygon
+ * @returns the shape
+ */
+DVZ_EXPORT DvzShape dvz_shape_polygons(
+    uint32_t polygon_count, const uint32_t* polygon_offsets, const uint32_t* ring_offsets,
+    const dvec2* points, DvzColor* colors);
 
 
 
@@ -1269,6 +1882,63 @@ DvzShape dvz_shape_surface(
 
 
 
+/**
+ * Create an isosurface shape from a 3D grid of values with marching cubes.
+ *
+ * The values are stored as in dvz_tex_volume(), with the x index varying the fastest, and the
+ * grid point (x, y, z) is at o + x * u + y * v + z * w. The mesh is watertight, the normals are
+ * computed from the value gradients and point towards the values lower than the level. The
+ * volume is processed in parallel by bricks, and the bricks whose value range does not contain
+ * the level are skipped.
+ *
+ * @param width the number of values along x
+ * @param height the number of values along y
+ * @param depth the number of values along z
+ * @param volume a pointer to width*height*depth values
+ * @param level the isosurface level
+ * @param ranges the value ranges of the bricks from dvz_isosurface_ranges(), or NULL
+ * @param o the origin
+ * @param u the vector between two consecutive values along x
+ * @param v the vector between two consecutive values along y
+ * @param w the vector between two consecutive values along z
+ * @param color the color of the isosurface
+ * @returns the shape
+ */
+DVZ_EXPORT DvzShape dvz_shape_isosurface(
+    uint32_t width, uint32_t height, uint32_t depth, const float* volume, float level,
+    vec2* ranges, vec3 o, vec3 u, vec3 v, vec3 w, DvzColor color);
+
+
+
+/**
+ * Return the number of bricks processed by dvz_shape_isosurface() for a given volume shape.
+ *
+ * @param width the number of values along x
+ * @param height the number of values along y
+ * @param depth the number of values along z
+ * @returns the number of bricks
+ */
+DVZ_EXPORT uint32_t dvz_isosurface_bricks(uint32_t width, uint32_t height, uint32_t depth);
+
+
+
+/**
+ * Compute the minimum and maximum value of each brick of a volume, ignoring NaN values.
+ *
+ * The ranges can be passed to dvz_shape_isosurface() to skip the empty bricks without scanning
+ * the whole volume every time the level changes.
+ *
+ * @param width the number of values along x
+ * @param height the number of values along y
+ * @param depth the number of values along z
+ * @param volume a pointer to width*height*depth values
+ * @param[out] ranges the value range of each brick, dvz_isosurface_bricks() values
+ */
+DVZ_EXPORT void dvz_isosurface_ranges(
+    uint32_t width, uint32_t height, uint32_t depth, const float* volume, vec2* ranges);
+
+
+
 /**
  * Create a cube shape.
  *
@@ -1325,6 +1995,9 @@ DVZ_EXPORT void dvz_shape_normalize(DvzShape* shape);
 /**
  * Load a .obj shape.
  *
+ * The shape is cached in a .dvzmesh file next to the original file, and later loads read the
+ * cache as long as the OBJ file is unchanged. Set DVZ_MESH_CACHE=0 to disable the cache.
+ *
  * @param file_path the path to the .obj file
  * @returns the shape
  */
@@ -1332,6 +2005,67 @@ DVZ_EXPORT DvzShape dvz_shape_obj(const char* file_path);
 
 
 
+/**
+ * Save a shape to a binary .dvzmesh file.
+ *
+ * The file contains the vertex arrays, the index buffer and the levels of detail of the shape, in
+ * 64-byte aligned sections. Unless DVZ_MESH_CACHE=0, OBJ files loaded with dvz_shape_obj() are
+ * cached in this format next to the original file.
+ *
+ * @param shape the shape
+ * @param file_path the path to the .dvzmesh file
+ * @returns 0 on success
+ */
+DVZ_EXPORT int dvz_shape_save(DvzShape* shape, const char* file_path);
+
+
+
+/**
+ * Load a shape from a binary .dvzmesh file.
+ *
+ * @param file_path the path to the .dvzmesh file
+ * @returns the shape, with no vertices if the file could not be loaded
+ */
+DVZ_EXPORT DvzShape dvz_shape_load(const char* file_path);
+
+
+
+/*************************************************************************************************/
+/*  Isolines                                                                                     */
+/*************************************************************************************************/
+
+/**
+ * Compute the isolines of a 2D grid of values with marching squares, for several levels at once.
+ *
+ * The grid point (i, j) is at o + i * u + j * v, and the isolines are split into polylines that
+ * can be passed to dvz_path_position() or dvz_path_isolines(). Closed polylines end with their
+ * first point, grid cells with NaN values are skipped.
+ *
+ * @param row_count number of rows
+ * @param col_count number of cols
+ * @param values a pointer to row_count*col_count values
+ * @param level_count the number of levels
+ * @param levels the levels
+ * @param o the origin
+ * @param u the unit vector parallel to each column
+ * @param v the unit vector parallel to each row
+ * @returns the isolines, to be destroyed with dvz_isolines_destroy()
+ */
+DVZ_EXPORT DvzIsolines dvz_isolines(
+    uint32_t row_count, uint32_t col_count, const float* values, //
+    uint32_t level_count, const float* levels, vec3 o, vec3 u, vec3 v);
+
+
+
+/**
+ * Destroy isolines.
+ *
+ * @param isolines the isolines
+ */
+DVZ_EXPORT void dvz_isolines_destroy(DvzIsolines* isolines);
+
+
+
 /*************************************************************************************************/
 /*  Basic visual                                                                                 */
 /*************************************************************************************************/
@@ -1492,6 +2226,23 @@ dvz_point_position(DvzVisual* visual, uint32_t first, uint32_t count, vec3* valu
 
 
 
+/**
+ * Set the point positions in double precision.
+ *
+ * With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the positions are stored as double-single pairs and
+ * keep about twice the single precision on the GPU.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the 3D positions of the items to update, in double precision
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_point_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* values, int flags);
+
+
+
 /**
  * Set the point colors.
  *
@@ -1591,6 +2342,23 @@ dvz_marker_position(DvzVisual* visual, uint32_t first, uint32_t count, vec3* val
 
 
 
+/**
+ * Set the marker positions in double precision.
+ *
+ * With `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`, the positions are stored as double-single pairs and
+ * keep about twice the single precision on the GPU.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param values the 3D positions of the items to update, in double precision
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_marker_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* values, int flags);
+
+
+
 /**
  * Set the marker sizes.
  *
@@ -1714,6 +2482,22 @@ DVZ_EXPORT void dvz_segment_position(
 
 
 
+/**
+ * Set the segment positions in double precision.
+ *
+ * @param visual the visual
+ * @param first the index of the first item to update
+ * @param count the number of items to update
+ * @param initial the initial 3D positions of the segments, in double precision
+ * @param terminal the terminal 3D positions of the segments, in double precision
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_segment_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* initial, dvec3* terminal,
+    int flags);
+
+
+
 /**
  * Set the segment shift.
  *
@@ -1813,6 +2597,22 @@ DVZ_EXPORT void dvz_path_position(
 
 
 
+/**
+ * Set the path positions in double precision.
+ *
+ * @param visual the visual
+ * @param point_count the total number of points across all paths
+ * @param positions the path point positions, in double precision
+ * @param path_count the number of different paths
+ * @param path_lengths the number of points in each path
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_path_position_double(
+    DvzVisual* visual, uint32_t point_count, dvec3* positions, //
+    uint32_t path_count, uint32_t* path_lengths, int flags);
+
+
+
 /**
  * Set the path colors.
  *
@@ -1827,6 +2627,20 @@ dvz_path_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* valu
 
 
 
+/**
+ * Set the path positions and colors from isolines computed with dvz_isolines().
+ *
+ * This function allocates the visual, there is no need to call dvz_path_alloc().
+ *
+ * @param visual the visual
+ * @param isolines the isolines
+ * @param level_colors the color of each level, or NULL to leave the colors unchanged
+ */
+DVZ_EXPORT void
+dvz_path_isolines(DvzVisual* visual, DvzIsolines* isolines, DvzColor* level_colors);
+
+
+
 /**
  * Set the path line width.
  *
@@ -2595,6 +3409,18 @@ dvz_mesh_contour(DvzVisual* visual, uint32_t first, uint32_t count, cvec4* value
 
 
 
+/**
+ * Set the edges drawn by a wireframe mesh.
+ *
+ * @param visual the visual, created with the DVZ_MESH_FLAGS_WIREFRAME flag
+ * @param first the index of the first face to update
+ * @param count the number of faces to update
+ * @param values for each face, bit c is 1 if the edge opposite to corner c is drawn
+ */
+DVZ_EXPORT void dvz_mesh_edges(DvzVisual* visual, uint32_t first, uint32_t count, uint8_t* values);
+
+
+
 /**
  * Assign a 2D texture to a mesh visual.
  *
@@ -2611,6 +3437,9 @@ DVZ_EXPORT void dvz_mesh_texture(
 /**
  * Set the mesh indices.
  *
+ * Meshes with fewer than 65536 vertices store their indices in a 16-bit index buffer, the indices
+ * are converted automatically.
+ *
  * @param visual the visual
  * @param first the index of the first item to update
  * @param count the number of items to update
@@ -2720,6 +3549,94 @@ DVZ_EXPORT void dvz_mesh_reshape(DvzVisual* visual, DvzShape* shape);
 
 
 
+/*************************************************************************************************/
+/*  Instanced mesh                                                                               */
+/*************************************************************************************************/
+
+/**
+ * Create an instanced mesh visual, drawing many copies of a single shape in one draw call.
+ *
+ * Use the `DVZ_VISUAL_FLAGS_INDEXED` flag if the shape has indices. The `DVZ_MESH_FLAGS_LIGHTING`
+ * and `DVZ_MESH_FLAGS_FLAT` flags are supported, the lights are set with the `dvz_mesh_light_*()`
+ * functions.
+ *
+ * @param batch the batch
+ * @param flags the visual creation flags
+ * @returns the visual
+ */
+DVZ_EXPORT DvzVisual* dvz_instanced(DvzBatch* batch, int flags);
+
+
+
+/**
+ * Upload the shape and allocate the instances. The shape is copied and can be destroyed
+ * afterwards. The new instances have no translation, no rotation, a unit scale and a white color.
+ *
+ * @param visual the visual
+ * @param shape the shape drawn for every instance
+ * @param instance_count the number of instances
+ */
+DVZ_EXPORT void
+dvz_instanced_alloc(DvzVisual* visual, DvzShape* shape, uint32_t instance_count);
+
+
+
+/**
+ * Set the instance positions.
+ *
+ * @param visual the visual
+ * @param first the index of the first instance to update
+ * @param count the number of instances to update
+ * @param values the 3D positions of the instances
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_instanced_position(
+    DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags);
+
+
+
+/**
+ * Set the instance rotations.
+ *
+ * @param visual the visual
+ * @param first the index of the first instance to update
+ * @param count the number of instances to update
+ * @param values the rotations of the instances, as quaternions (x, y, z, w)
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_instanced_rotation(
+    DvzVisual* visual, uint32_t first, uint32_t count, vec4* values, int flags);
+
+
+
+/**
+ * Set the instance scales.
+ *
+ * @param visual the visual
+ * @param first the index of the first instance to update
+ * @param count the number of instances to update
+ * @param values the scaling factors of the instances along each axis
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void
+dvz_instanced_scale(DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags);
+
+
+
+/**
+ * Set the instance colors, multiplied with the shape colors.
+ *
+ * @param visual the visual
+ * @param first the index of the first instance to update
+ * @param count the number of instances to update
+ * @param values the colors of the instances
+ * @param flags the data update flags
+ */
+DVZ_EXPORT void dvz_instanced_color(
+    DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* values, int flags);
+
+
+
 /*************************************************************************************************/
 /*  Sphere                                                                                  */
 /*************************************************************************************************/
@@ -2996,6 +3913,111 @@ DVZ_EXPORT void dvz_slice_alpha(DvzVisual* visual, float alpha);
 
 
 
+/*************************************************************************************************/
+/*  Surface                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Create a surface visual (a heightmap stored in a texture, meshed on the GPU).
+ *
+ * @param batch the batch
+ * @param flags the visual creation flags
+ * @returns the visual
+ */
+DVZ_EXPORT DvzVisual* dvz_surface(DvzBatch* batch, int flags);
+
+
+
+/**
+ * Allocate memory for a visual, and create the height texture (and the scalar texture with
+ * `DVZ_SURFACE_FLAGS_SCALAR`). The surface is flat until the heights are set.
+ *
+ * @param visual the visual
+ * @param row_count number of rows
+ * @param col_count number of cols
+ */
+DVZ_EXPORT void dvz_surface_alloc(DvzVisual* visual, uint32_t row_count, uint32_t col_count);
+
+
+
+/**
+ * Set the grid geometry, with the same convention as `dvz_shape_surface()`. The heights are
+ * along the normal vector `u x v`.
+ *
+ * @param visual the visual
+ * @param o the origin
+ * @param u the vector between two consecutive rows
+ * @param v the vector between two consecutive columns
+ */
+DVZ_EXPORT void dvz_surface_grid(DvzVisual* visual, vec3 o, vec3 u, vec3 v);
+
+
+
+/**
+ * Update the heights in a rectangular region of the grid (a single texture upload).
+ *
+ * @param visual the visual
+ * @param row the first row to update
+ * @param col the first column to update
+ * @param row_count the number of rows to update
+ * @param col_count the number of columns to update
+ * @param heights a pointer to row_count*col_count height values (floats)
+ */
+DVZ_EXPORT void dvz_surface_heights(
+    DvzVisual* visual, uint32_t row, uint32_t col, uint32_t row_count, uint32_t col_count,
+    float* heights);
+
+
+
+/**
+ * Update the scalar values in a rectangular region of the grid, used with the colormap instead
+ * of the heights (requires `DVZ_SURFACE_FLAGS_SCALAR`).
+ *
+ * @param visual the visual
+ * @param row the first row to update
+ * @param col the first column to update
+ * @param row_count the number of rows to update
+ * @param col_count the number of columns to update
+ * @param values a pointer to row_count*col_count scalar values (floats)
+ */
+DVZ_EXPORT void dvz_surface_scalar(
+    DvzVisual* visual, uint32_t row, uint32_t col, uint32_t row_count, uint32_t col_count,
+    float* values);
+
+
+
+/**
+ * Set the surface colormap.
+ *
+ * @param visual the visual
+ * @param cmap the colormap
+ * @param vmin the value mapped to the first color of the colormap
+ * @param vmax the value mapped to the last color of the colormap
+ */
+DVZ_EXPORT void dvz_surface_colormap(DvzVisual* visual, DvzColormap cmap, float vmin, float vmax);
+
+
+
+/**
+ * Set the surface light direction (requires `DVZ_SURFACE_FLAGS_LIGHTING`).
+ *
+ * @param visual the visual
+ * @param dir the light direction
+ */
+DVZ_EXPORT void dvz_surface_light_dir(DvzVisual* visual, vec3 dir);
+
+
+
+/**
+ * Set the surface light parameters (requires `DVZ_SURFACE_FLAGS_LIGHTING`).
+ *
+ * @param visual the visual
+ * @param params the light parameters (vec4 ambient, diffuse, specular, exponent)
+ */
+DVZ_EXPORT void dvz_surface_light_params(DvzVisual* visual, vec4 params);
+
+
+
 /*************************************************************************************************/
 /*************************************************************************************************/
 /*  Interactivity API                                                                            */
@@ -3450,6 +4472,24 @@ dvz_box_normalize(DvzBox source, DvzBox target, uint32_t count, dvec3* pos, vec3
 
 
 
+/**
+ * Normalize 3D input positions into a target box, keeping double precision.
+ *
+ * This is meant to be used with the double precision visuals (see
+ * `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION`), whose data does not need to be normalized again when
+ * zooming in.
+ *
+ * @param source the source box, in data coordinates
+ * @param target the target box, typically in normalized coordinates
+ * @param count the number of positions to normalize
+ * @param pos the positions to normalize (double precision)
+ * @param[out] out pointer to an array with the normalized positions to compute (double precision)
+ */
+DVZ_EXPORT void
+dvz_box_normalize_double(DvzBox source, DvzBox target, uint32_t count, dvec3* pos, dvec3* out);
+
+
+
 /**
  * Normalize 2D input positions into a target box.
  *
@@ -124,6 +124,15 @@ int dvz_cond_signal(DvzCond* cond);
 
 
 
+/**
+ * Signal a cond to all the threads waiting for it.
+ *
+ * @param cond the cond
+ */
+int dvz_cond_broadcast(DvzCond* cond);
+
+
+
 /**
  * Wait until a cond is signaled.
  *
@@ -26,11 +26,33 @@
 /*  Typedefs                                                                                     */
 /*************************************************************************************************/
 
+typedef struct DvzBoardReadback DvzBoardReadback;
+
 // Forward declarations.
 typedef struct DvzRecorder DvzRecorder;
 
 
 
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// Readback of a rendered board image, so that several frames can be rendered and downloaded
+// without waiting for the GPU after each frame.
+struct DvzBoardReadback
+{
+    DvzGpu* gpu;
+    DvzCanvas* board; // board being rendered and copied, NULL if the readback is available
+    uint64_t frame_idx;
+    uint32_t width, height;
+
+    DvzImages staging; // host-visible image the board image is copied to
+    DvzCommands cmds;  // copy commands, submitted after the board commands
+    DvzFences fences;  // signaled when the frame has been rendered and copied
+};
+
+
+
 EXTERN_C_ON
 
 /*************************************************************************************************/
@@ -161,6 +183,47 @@ void dvz_board_download(DvzCanvas* board, DvzSize size, uint8_t* rgb);
 
 
 
+/**
+ * Submit the board commands followed by a copy of the rendered image, without waiting.
+ *
+ * The readback needs to be available. Its staging image is (re)created to match the board size.
+ *
+ * @param board the board
+ * @param readback the readback
+ */
+void dvz_board_readback_submit(DvzCanvas* board, DvzBoardReadback* readback);
+
+
+
+/**
+ * Return whether a submitted readback has completed.
+ *
+ * @param readback the readback
+ * @returns whether the image can be downloaded without waiting for the GPU
+ */
+bool dvz_board_readback_ready(DvzBoardReadback* readback);
+
+
+
+/**
+ * Wait for a submitted readback and download its image, which makes the readback available.
+ *
+ * @param readback the readback
+ * @param rgb an already-allocated buffer with width*height*3 bytes
+ */
+void dvz_board_readback_download(DvzBoardReadback* readback, uint8_t* rgb);
+
+
+
+/**
+ * Destroy a readback.
+ *
+ * @param readback the readback
+ */
+void dvz_board_readback_destroy(DvzBoardReadback* readback);
+
+
+
 /**
  * Destroy a board.
  *
@@ -21,11 +21,95 @@
 #include <stdint.h>
 
 #include "_macros.h"
+#include "datoviz.h"
 #include "datoviz_math.h"
 #include "fileio.h"
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_NPY_MAX_DIMS 8
+
+// Default size of the chunks passed to the callback of dvz_stream_gz().
+#define DVZ_GZ_CHUNK_SIZE (4 * 1024 * 1024)
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzNpyHeader DvzNpyHeader;
+typedef struct DvzArrowField DvzArrowField;
+typedef struct DvzArrowBatch DvzArrowBatch;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzNpyHeader
+{
+    uint32_t version;                 // NPY format major version (1, 2 or 3)
+    char kind;                        // NumPy dtype kind ('f', 'i', 'u', 'b', ...)
+    uint32_t item_size;               // size of each element, in bytes
+    bool big_endian;                  // whether the elements are stored in big-endian order
+    bool fortran_order;               // whether the first axis varies the fastest
+    uint32_t ndim;                    // number of dimensions (0 for a scalar)
+    uint64_t shape[DVZ_NPY_MAX_DIMS]; // size of each dimension
+    uint64_t element_count;           // total number of elements
+    DvzSize data_offset;              // offset of the array data in the file, in bytes
+    DvzSize data_size;                // size of the array data, in bytes
+};
+
+
+
+// Top-level column of the schema of an Arrow IPC file.
+struct DvzArrowField
+{
+    const char* name;         // column name, pointing into the file mapping
+    char kind;                // 'f', 'i', 'u', 'b' for bit-packed booleans, 0 if unsupported
+    uint32_t item_size;       // size of each value, in bytes (0 for booleans)
+    uint32_t components;      // number of values per row, > 1 for fixed-size lists of numbers
+    uint32_t node;            // index of the field node of the column in the record batches
+    uint32_t validity_buffer; // index of the validity buffer of the column
+    uint32_t data_buffer;     // index of the buffer holding the values of the column
+};
+
+
+
+// Record batch of an Arrow IPC file, pointing into the file mapping.
+struct DvzArrowBatch
+{
+    uint64_t length;        // number of rows
+    const uint8_t* body;    // message body holding the buffers
+    DvzSize body_size;      // size of the message body
+    uint32_t node_count;    // number of field nodes (16 bytes each: length, null count)
+    const uint8_t* nodes;   // field nodes
+    uint32_t buffer_count;  // number of buffers (16 bytes each: offset in the body, size)
+    const uint8_t* buffers; // buffers
+    bool compressed;        // whether the buffers are compressed
+};
+
+
+
+// Memory-mapped Arrow IPC file (Feather v2).
+struct DvzArrowFile
+{
+    void* mapping;
+    DvzSize size;
+    uint32_t field_count;
+    DvzArrowField* fields;
+    uint32_t batch_count;
+    DvzArrowBatch* batches;
+};
+
+
+
 /*************************************************************************************************/
 /*  Generic file I/O utils                                                                       */
 /*************************************************************************************************/
@@ -55,6 +139,42 @@ void* dvz_read_file(const char* filename, DvzSize* size);
 
 
 
+/**
+ * Map a file in memory, read-only.
+ *
+ * @param filename path of the file to open
+ * @param[out] size of the file
+ * @returns pointer to the mapped file contents, to be released with dvz_file_unmap()
+ */
+void* dvz_file_map(const char* filename, DvzSize* size);
+
+
+
+/**
+ * Release a file mapped with dvz_file_map().
+ *
+ * @param data the pointer returned by dvz_file_map()
+ * @param size the size of the file
+ */
+void dvz_file_unmap(void* data, DvzSize size);
+
+
+
+/**
+ * Parse the header of a NumPy NPY file (format versions 1, 2 and 3).
+ *
+ * Only the first bytes of the file are needed, up to the end of the header, but the data size
+ * is checked against the passed size.
+ *
+ * @param size the size of the buffer
+ * @param npy_bytes the contents of the NPY file
+ * @param[out] header the parsed header
+ * @returns 0 on success, a nonzero value if the header is invalid or unsupported
+ */
+int dvz_npy_header(DvzSize size, const char* npy_bytes, DvzNpyHeader* header);
+
+
+
 /**
  * Read a NumPy NPY file.
  *
@@ -153,6 +273,41 @@ int dvz_make_png(uint32_t width, uint32_t height, const uint8_t* rgb, DvzSize* s
 
 
 
+/**
+ * Compress an image to PNG with a given compression level and filter.
+ *
+ * A negative level uses the fast encoder of dvz_make_png(), which ignores the filter. Levels
+ * 0 to 9 use zlib, and fall back to the fast encoder if Datoviz was built without zlib.
+ *
+ * @param width width of the image
+ * @param height height of the image
+ * @param rgb pointer to an array of 24-bit RGB values
+ * @param level compression level, from 0 (none) to 9 (best), or -1 for the fast encoder
+ * @param filter the scanline filter
+ * @param[out] size the size of the buffer
+ * @param[out] out the PNG buffer, to be freed by the caller
+ * @returns 0 on success
+ */
+int dvz_encode_png(
+    uint32_t width, uint32_t height, const uint8_t* rgb, int level, DvzPngFilter filter,
+    DvzSize* size, void** out);
+
+
+
+/**
+ * Compress an image to QOI (Quite OK Image format), a fast lossless format.
+ *
+ * @param width width of the image
+ * @param height height of the image
+ * @param rgb pointer to an array of 24-bit RGB values
+ * @param[out] size the size of the buffer
+ * @param[out] out the QOI buffer, to be freed by the caller
+ * @returns 0 on success
+ */
+int dvz_make_qoi(uint32_t width, uint32_t height, const uint8_t* rgb, DvzSize* size, void** out);
+
+
+
 /**
  * Load a PNG image.
  *
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Video frame sink                                                                             */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_FRAMESINK
+#define DVZ_HEADER_FRAMESINK
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "_macros.h"
+#include "_mutex.h"
+#include "_obj.h"
+#include "_thread_utils.h"
+#include "datoviz.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Maximum number of frames waiting to be converted and written.
+#define DVZ_FRAME_SINK_QUEUE_SIZE 4
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzFrameSink
+{
+    DvzObject obj;
+    FILE* fp;
+    DvzVideoFormat format;
+    uint32_t width, height;
+    uint32_t fps_num, fps_den;
+
+    // Ring buffer of the frames waiting for the thread, with width*height*4 bytes each.
+    uint8_t* frames[DVZ_FRAME_SINK_QUEUE_SIZE];
+    uint32_t components[DVZ_FRAME_SINK_QUEUE_SIZE];
+    uint32_t first, count;
+
+    DvzSize out_size;
+    uint8_t* out; // converted frame, only used by the thread
+
+    uint64_t written; // number of frames written
+    bool error;       // a write failed, the next frames are discarded
+    bool stop;
+
+    DvzThread* thread;
+    DvzMutex lock;
+    DvzCond cond_push; // a frame has been written, there is room in the queue
+    DvzCond cond_pop;  // a frame has been queued, or the sink is stopping
+    DvzCond cond_idle; // all frames have been written
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Convert an RGB or RGBA image to planar YUV 4:2:0 (BT.601, limited range).
+ *
+ * The chroma planes have ceil(width/2) x ceil(height/2) values, each one is the average of a
+ * block of 2x2 pixels.
+ *
+ * @param width width of the image
+ * @param height height of the image
+ * @param pixels the image, with 3 (RGB) or 4 (RGBA) bytes per pixel
+ * @param components number of bytes per pixel, 3 or 4
+ * @param[out] yuv the Y, U, and V planes, one after the other
+ */
+void dvz_rgb_yuv420(
+    uint32_t width, uint32_t height, const uint8_t* pixels, uint32_t components, uint8_t* yuv);
+
+
+
+/**
+ * Return the size of a YUV 4:2:0 frame.
+ *
+ * @param width width of the image
+ * @param height height of the image
+ * @returns the size in bytes of the Y, U, and V planes
+ */
+DvzSize dvz_yuv420_size(uint32_t width, uint32_t height);
+
+
+
+EXTERN_C_OFF
+
+#endif
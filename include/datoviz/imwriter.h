@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Asynchronous image writer                                                                    */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_IMWRITER
+#define DVZ_HEADER_IMWRITER
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdint.h>
+
+#include "_macros.h"
+#include "_mutex.h"
+#include "_obj.h"
+#include "_thread_utils.h"
+#include "fileio.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Default maximum number of images waiting to be written, per thread.
+#define DVZ_IMWRITER_QUEUE_SIZE 4
+
+#define DVZ_IMWRITER_MAX_THREADS 64
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzImageWriter DvzImageWriter;
+typedef struct DvzImageFrame DvzImageFrame;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzImageFrame
+{
+    char* filename;
+    uint32_t width, height;
+    uint8_t* rgb;
+};
+
+
+
+struct DvzImageWriter
+{
+    DvzObject obj;
+
+    uint32_t thread_count;
+    DvzThread* threads[DVZ_IMWRITER_MAX_THREADS];
+
+    // Ring buffer of the images waiting for a thread.
+    uint32_t capacity;
+    DvzImageFrame* frames;
+    uint32_t first, count;
+
+    uint32_t pending; // images waiting or being written
+    uint32_t errors;  // failed writes since the last dvz_image_writer_wait()
+    bool stop;
+
+    int png_level;
+    DvzPngFilter png_filter;
+
+    DvzMutex lock;
+    DvzCond cond_push; // an image has been written, there is room in the queue
+    DvzCond cond_pop;  // an image has been queued, or the writer is stopping
+    DvzCond cond_idle; // all images have been written
+};
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Encode and write an image to a file, on the calling thread.
+ *
+ * The image format depends on the file extension: `.ppm` (raw RGB), `.qoi`, or PNG otherwise.
+ *
+ * @param filename path of the image file
+ * @param width width of the image
+ * @param height height of the image
+ * @param rgb pointer to an array of 24-bit RGB values
+ * @param png_level PNG compression level, from 0 (none) to 9 (best), or -1 for the fast encoder
+ * @param png_filter the PNG scanline filter, used with levels 0 to 9
+ * @returns 0 on success, a nonzero value if the image could not be written
+ */
+int dvz_write_image(
+    const char* filename, uint32_t width, uint32_t height, const uint8_t* rgb, int png_level,
+    DvzPngFilter png_filter);
+
+
+
+/**
+ * Create an image writer, a pool of threads encoding and writing images in the background.
+ *
+ * The image format depends on the file extension: `.ppm` (raw RGB), `.qoi`, or PNG otherwise.
+ *
+ * @param thread_count number of threads, or 0 for half the number of processors
+ * @param capacity maximum number of images waiting or being written, or 0 for a default value.
+ *      dvz_image_writer_push() blocks when this number is reached, which bounds the memory usage
+ *      when images are produced faster than they are written.
+ * @returns the image writer
+ */
+DvzImageWriter* dvz_image_writer(uint32_t thread_count, uint32_t capacity);
+
+
+
+/**
+ * Set the PNG compression level and filter of the next images.
+ *
+ * @param writer the image writer
+ * @param level compression level, from 0 (none) to 9 (best), or -1 for the fast encoder (default)
+ * @param filter the scanline filter, used with levels 0 to 9
+ */
+void dvz_image_writer_png(DvzImageWriter* writer, int level, DvzPngFilter filter);
+
+
+
+/**
+ * Queue an image to be written to a file.
+ *
+ * The image is copied, so that the buffer can be reused as soon as the function returns. The
+ * function blocks while the writer is full.
+ *
+ * @param writer the image writer
+ * @param filename path of the image file
+ * @param width width of the image
+ * @param height height of the image
+ * @param rgb pointer to an array of 24-bit RGB values
+ */
+void dvz_image_writer_push(
+    DvzImageWriter* writer, const char* filename, uint32_t width, uint32_t height,
+    const uint8_t* rgb);
+
+
+
+/**
+ * Wait until all queued images have been written.
+ *
+ * @param writer the image writer
+ * @returns the number of images that could not be written since the last call
+ */
+uint32_t dvz_image_writer_wait(DvzImageWriter* writer);
+
+
+
+/**
+ * Write the queued images, stop the threads, and destroy the image writer.
+ *
+ * @param writer the image writer
+ */
+void dvz_image_writer_destroy(DvzImageWriter* writer);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -88,6 +88,7 @@ struct DvzPipe
 
     // Index buffer.
     DvzPipeBinding index_binding;
+    VkIndexType index_type;
 
     // Dat resources.
     bool descriptors_set[DVZ_MAX_BINDINGS];
@@ -145,8 +146,10 @@ void dvz_pipe_vertex(DvzPipe* pipe, uint32_t binding_idx, DvzDat* dat_vertex, Dv
  *
  * @param pipe the pipe
  * @param dat the dat with the index buffer
+ * @param offset the offset within the dat, in bytes
+ * @param index_size the size of each index, 2 (uint16) or 4 (uint32) bytes
  */
-void dvz_pipe_index(DvzPipe* pipe, DvzDat* dat_index, DvzSize offset);
+void dvz_pipe_index(DvzPipe* pipe, DvzDat* dat_index, DvzSize offset, DvzSize index_size);
 
 
 
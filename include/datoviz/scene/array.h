@@ -19,6 +19,7 @@
 /*************************************************************************************************/
 
 #include "common.h"
+#include "datoviz.h"
 
 
 
@@ -34,55 +35,6 @@ typedef struct DvzArray DvzArray;
 /*  Enums                                                                                        */
 /*************************************************************************************************/
 
-// Data types.
-typedef enum
-{
-    DVZ_DTYPE_NONE,
-    DVZ_DTYPE_CUSTOM, // used for structured arrays (aka record arrays)
-    DVZ_DTYPE_STR,    // 64 bits, pointer
-
-    DVZ_DTYPE_CHAR, // 8 bits, unsigned int
-    DVZ_DTYPE_CVEC2,
-    DVZ_DTYPE_CVEC3,
-    DVZ_DTYPE_CVEC4,
-
-    DVZ_DTYPE_USHORT, // 16 bits, unsigned int
-    DVZ_DTYPE_USVEC2,
-    DVZ_DTYPE_USVEC3,
-    DVZ_DTYPE_USVEC4,
-
-    DVZ_DTYPE_SHORT, // 16 bits, signed int
-    DVZ_DTYPE_SVEC2,
-    DVZ_DTYPE_SVEC3,
-    DVZ_DTYPE_SVEC4,
-
-    DVZ_DTYPE_UINT, // 32 bits, unsigned int
-    DVZ_DTYPE_UVEC2,
-    DVZ_DTYPE_UVEC3,
-    DVZ_DTYPE_UVEC4,
-
-    DVZ_DTYPE_INT, // 32 bits, signed int
-    DVZ_DTYPE_IVEC2,
-    DVZ_DTYPE_IVEC3,
-    DVZ_DTYPE_IVEC4,
-
-    DVZ_DTYPE_FLOAT, // 32 bits float
-    DVZ_DTYPE_VEC2,
-    DVZ_DTYPE_VEC3,
-    DVZ_DTYPE_VEC4,
-
-    DVZ_DTYPE_DOUBLE, // 64 bits double
-    DVZ_DTYPE_DVEC2,
-    DVZ_DTYPE_DVEC3,
-    DVZ_DTYPE_DVEC4,
-
-    DVZ_DTYPE_MAT2, // matrices of floats
-    DVZ_DTYPE_MAT3,
-    DVZ_DTYPE_MAT4,
-} DvzDataType;
-
-
-
 // Array copy types.
 typedef enum
 {
@@ -110,6 +62,11 @@ struct DvzArray
     // 3D arrays
     uint32_t ndims; // 1, 2, or 3
     uvec3 shape;    // only for 3D arrays
+
+    // Read-only file mapping holding the data, if any (see dvz_array_npy()). The mapping size is
+    // 0 if the mapping is owned by another object (see dvz_array_arrow()).
+    void* mapping;
+    DvzSize mapping_size;
 };
 
 
@@ -191,6 +148,7 @@ dvz_array_3D(uint32_t ndims, uint32_t width, uint32_t height, uint32_t depth, Dv
 
 
 
+
 /**
  * Resize an existing array.
  *
@@ -333,17 +291,6 @@ void dvz_array_print(DvzArray* array);
 
 
 
-/**
- * Destroy an array.
- *
- * This function frees the allocated underlying data buffer.
- *
- * @param array the array to destroy
- */
-void dvz_array_destroy(DvzArray* array);
-
-
-
 /*************************************************************************************************/
 /*  Inline functions                                                                             */
 /*************************************************************************************************/
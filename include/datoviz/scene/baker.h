@@ -20,6 +20,7 @@
 #include "_enums.h"
 #include "_log.h"
 #include "datoviz_math.h"
+#include "datoviz_types.h"
 #include "scene/dual.h"
 
 
@@ -40,6 +41,15 @@ typedef struct DvzArray DvzArray;
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Visuals with fewer vertices than this use 16-bit indices.
+#define DVZ_BAKER_INDEX16_MAX_VERTICES 65536
+
+
+
 /*************************************************************************************************/
 /*  Enums                                                                                        */
 /*************************************************************************************************/
@@ -88,7 +98,9 @@ struct DvzBaker
     DvzBakerAttr vertex_attrs[DVZ_MAX_VERTEX_ATTRS];
     DvzBakerVertex vertex_bindings[DVZ_MAX_VERTEX_BINDINGS];
 
-    DvzDual index; // index buffer
+    DvzDual index;      // index buffer
+    DvzSize index_size; // 2 (uint16) or 4 (uint32) bytes per index
+    bool index32;       // always use 32-bit indices
     bool index_shared;
     DvzDual indirect; // indirect buffer
 };
@@ -207,6 +219,29 @@ void dvz_baker_repeat(
 
 
 
+/**
+ * Normalize double-precision positions into a target box and write them, in single precision,
+ * directly into a vec3 vertex attribute, or quantized into a snorm16x4 attribute (in which case
+ * the target box should be within [-1, +1]).
+ */
+void dvz_baker_normalize(
+    DvzBaker* baker, uint32_t attr_idx, uint32_t first, uint32_t count, uint32_t repeats,
+    DvzBox source, DvzBox target, dvec3* pos);
+
+
+
+/**
+ * Quantize float values, multiplied by a scaling factor, into a compact vertex attribute.
+ *
+ * Supported formats: R16G16B16A16_SNORM (vec3 input, clamped to [-1, +1], w set to 0),
+ * R16_SNORM (float input, clamped to [-1, +1]), and R16_SFLOAT (half-precision float).
+ */
+void dvz_baker_quantize(
+    DvzBaker* baker, uint32_t attr_idx, uint32_t first, uint32_t count, uint32_t repeats,
+    DvzFormat format, float scale, float* values);
+
+
+
 /**
  *
  */
@@ -215,6 +250,7 @@ void dvz_baker_quads(
 
 
 
+// The indices are converted to uint16 when the index buffer uses 16-bit indices.
 /**
  *
  */
@@ -114,12 +114,14 @@ void dvz_dual_destroy(DvzDual* dual);
 
 DvzDual dvz_dual_vertex(DvzBatch* batch, uint32_t vertex_count, DvzSize vertex_size, int flags);
 
-DvzDual dvz_dual_index(DvzBatch* batch, uint32_t index_count, int flags);
+DvzDual dvz_dual_index(DvzBatch* batch, uint32_t index_count, DvzSize index_size, int flags);
 
 DvzDual dvz_dual_indirect(DvzBatch* batch, bool indexed);
 
 DvzDual dvz_dual_dat(DvzBatch* batch, DvzSize item_size, int flags);
 
+DvzDual dvz_dual_storage(DvzBatch* batch, uint32_t count, DvzSize item_size, int flags);
+
 
 
 EXTERN_C_OFF
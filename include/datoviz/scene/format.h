@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Number formatting                                                                             */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_FORMAT
+#define DVZ_HEADER_FORMAT
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_log.h"
+#include "datoviz_math.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Maximum number of digits after the decimal point.
+#define DVZ_FORMAT_MAX_PRECISION 15
+
+// Maximum number of characters written by the formatting functions, including the trailing 0.
+#define DVZ_FORMAT_MAX_LENGTH 24
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+// Equivalent to printf("%.<precision>f"), locale-independent and allocation-free.
+// The output buffer must have at least DVZ_FORMAT_MAX_LENGTH bytes. Values whose fixed-point
+// representation would not fit are written in scientific notation.
+// Return the number of characters written, excluding the trailing 0.
+uint32_t dvz_format_fixed(double value, uint32_t precision, char* out);
+
+
+
+// Equivalent to printf("%.<precision>e"), locale-independent and allocation-free.
+uint32_t dvz_format_scientific(double value, uint32_t precision, char* out);
+
+
+
+// Shortest decimal representation that parses back to the same double, laid out like "%g".
+uint32_t dvz_format_shortest(double value, char* out);
+
+
+
+EXTERN_C_OFF
+
+#endif
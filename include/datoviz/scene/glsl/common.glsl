@@ -21,9 +21,22 @@
 #define DVZ_VIEWPORT_CLIP_BOTTOM    0x4
 #define DVZ_VIEWPORT_CLIP_LEFT      0x8
 
+// Quantized vertex attributes.
+#define DVZ_SPECIALIZATION_QUANTIZE 18
+#define DVZ_QUANTIZE_ANGLE          0x1
+
 // Specialization constants.
 layout(constant_id = DVZ_SPECIALIZATION_TRANSFORM) const int TRANSFORM_FLAGS = 0;
 layout(constant_id = DVZ_SPECIALIZATION_VIEWPORT) const int VIEWPORT_FLAGS = 0;
+layout(constant_id = DVZ_SPECIALIZATION_QUANTIZE) const int QUANTIZE_FLAGS = 0;
+
+
+// Axis scales.
+#define DVZ_SCALE_LINEAR 0
+#define DVZ_SCALE_LOG10  1
+#define DVZ_SCALE_SYMLOG 2
+#define LOG10_2          0.30102999566398120
+#define SCALE_NAN        uintBitsToFloat(0x7fc00000u) // image of the nonpositive log values
 
 
 // colormaps
@@ -64,6 +77,12 @@ layout(std140, binding = 0) uniform MVP
     mat4 model;
     mat4 view;
     mat4 proj;
+    vec4 offset_hi; // positions are relative to this offset, split as a double-single pair
+    vec4 offset_lo;
+    ivec4 scale_type; // per-axis scale: pos = scale_a * f(pos) + scale_b on nonlinear axes
+    vec4 scale_param; // symlog linear threshold
+    vec4 scale_a;
+    vec4 scale_b;
     // float time;
 }
 mvp;
@@ -183,10 +202,88 @@ mat4 get_rotation_matrix(vec3 axis, float angle)
 
 
 
+/*************************************************************************************************/
+/*  Double-single arithmetic                                                                     */
+/*************************************************************************************************/
+
+// Compute (a_hi + a_lo) - (b_hi + b_lo) with a double-single (two-sum) subtraction, rounded to
+// single precision at the very end. The result is accurate when the two operands are close, even
+// if their magnitude is large. The precise qualifier prevents the compiler from reassociating or
+// fusing the operations, which would cancel out the error terms.
+vec3 ds_sub(vec3 a_hi, vec3 a_lo, vec3 b_hi, vec3 b_lo)
+{
+    precise vec3 s = a_hi - b_hi;
+    precise vec3 v = s - a_hi;
+    precise vec3 e = (a_hi - (s - v)) - (b_hi + v);
+    e += a_lo - b_lo;
+    return s + e;
+}
+
+
+
+// Position relative to the MVP offset.
+vec3 relative_pos(vec3 pos_hi, vec3 pos_lo)
+{
+    return ds_sub(pos_hi, pos_lo, mvp.offset_hi.xyz, mvp.offset_lo.xyz);
+}
+
+
+
+vec3 relative_pos(vec3 pos) { return relative_pos(pos, vec3(0)); }
+
+
+
+/*************************************************************************************************/
+/*  Quantized attributes                                                                         */
+/*************************************************************************************************/
+
+// Quantized angles are stored as snorm16 values of angle / pi.
+float decode_angle(float angle)
+{
+    return (QUANTIZE_FLAGS & DVZ_QUANTIZE_ANGLE) != 0 ? angle * 3.14159265358979323846 : angle;
+}
+
+
+
 /*************************************************************************************************/
 /*  Transforms                                                                                   */
 /*************************************************************************************************/
 
+// The nonpositive values map to NaN, which propagates to the clip position: the primitives with
+// such a vertex are discarded rather than stretched towards the edge of the view.
+float scale_log10(float x) { return x > 0 ? log2(x) * LOG10_2 : SCALE_NAN; }
+
+
+
+// Linear in [-c, c], logarithmic outside, continuous at the threshold.
+float scale_symlog(float x, float c)
+{
+    float a = abs(x) / c;
+    return a <= 1 ? x / c : sign(x) * (1 + log2(a) * LOG10_2);
+}
+
+
+
+// Apply the per-axis scales. On the nonlinear axes, the double-single low part is folded into
+// the high part as the precision gain would be lost in the logarithm anyway. The fixed axes are
+// left untouched as transform_fixed() replaces them with the original position.
+void transform_scale(inout vec3 pos_hi, inout vec3 pos_lo)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        int type = mvp.scale_type[i];
+        if (type == DVZ_SCALE_LINEAR || (TRANSFORM_FLAGS & (DVZ_TRANSFORM_FIXED_X << i)) != 0)
+            continue;
+        float x = pos_hi[i] + pos_lo[i];
+        float y = type == DVZ_SCALE_LOG10 ? scale_log10(x) : scale_symlog(x, mvp.scale_param[i]);
+        pos_hi[i] = mvp.scale_a[i] * y + mvp.scale_b[i];
+        pos_lo[i] = 0;
+    }
+}
+
+
+
+// NOTE: the position must be relative to the MVP offset, see transform_data().
 vec4 transform_mvp(vec3 pos)
 {
     mat4 MVP = mvp.proj * mvp.view * mvp.model;
@@ -196,6 +293,19 @@ vec4 transform_mvp(vec3 pos)
 
 
 
+// Data coordinates to clip coordinates: axis scales, MVP offset, and MVP matrices.
+vec4 transform_data(vec3 pos_hi, vec3 pos_lo)
+{
+    transform_scale(pos_hi, pos_lo);
+    return transform_mvp(relative_pos(pos_hi, pos_lo));
+}
+
+
+
+vec4 transform_data(vec3 pos) { return transform_data(pos, vec3(0)); }
+
+
+
 vec4 transform_fixed(vec4 tr, vec3 pos)
 {
     // Fixed axes.
@@ -255,9 +365,9 @@ vec4 transform_shift(vec4 tr, vec2 shift)
 
 
 
-vec4 transform(vec3 pos, vec2 shift)
+vec4 transform(vec3 pos, vec3 pos_lo, vec2 shift)
 {
-    vec4 tr = transform_mvp(pos);
+    vec4 tr = transform_data(pos, pos_lo);
     tr = transform_fixed(tr, pos);
     tr = transform_margins(tr);
     tr = transform_shift(tr, shift);
@@ -267,6 +377,15 @@ vec4 transform(vec3 pos, vec2 shift)
 
 
 
+vec4 transform(vec3 pos, vec2 shift) { return transform(pos, vec3(0), shift); }
+
+
+
+// Double-single positions, used by the double precision visual variants.
+vec4 transform_double(vec3 pos_hi, vec3 pos_lo) { return transform(pos_hi, pos_lo, vec2(0, 0)); }
+
+
+
 // vec4 transform(vec3 pos, vec2 shift) { return transform(pos, shift, 0); }
 
 
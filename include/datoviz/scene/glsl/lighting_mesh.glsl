@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// NOTE: requires common.glsl and params_mesh.glsl.
+
+
+
+// Face normal in model space, from the screen-space derivatives of the position, facing the
+// viewer.
+vec3 face_normal(vec3 pos)
+{
+    vec3 pos_tr = (mvp.model * vec4(relative_pos(pos), 1.0)).xyz;
+    vec3 normal = normalize(cross(dFdx(pos_tr), dFdy(pos_tr)));
+    vec3 view_dir = -mvp.view[3].xyz - pos_tr;
+    return dot(normal, view_dir) < 0 ? -normal : normal;
+}
+
+
+
+// Phong lighting with up to 4 lights.
+vec3 mesh_lighting(vec3 pos, vec3 normal, vec3 color)
+{
+    vec3 light_dir, light_color, ambient, diffuse, view_dir, reflect_dir, specular;
+    vec4 lpar;
+    float diff, spec, view_facing;
+
+    vec3 out_color = vec3(0);
+    vec3 pos_tr = ((mvp.model * vec4(relative_pos(pos), 1.0))).xyz;
+    view_dir = normalize(-mvp.view[3].xyz - pos_tr);
+
+    for (int i = 0; i < 4; i++)
+    {
+        // Light position and params.
+        lpar = params.light_params[i];
+        if (length(lpar) == 0)
+            continue;
+
+        // Light direction.
+        // TODO OPTIM: normalize on the CPU instead, in dvz_mesh_light_dir()
+        light_dir = normalize(params.light_dir[i].xyz);
+
+        // Color.
+        light_color = params.light_color[i].xyz;
+        ambient = light_color;
+
+        // Diffuse component.
+        view_facing = max(dot(normal, view_dir), 0.0);
+        diff = max(dot(normal, -light_dir), 0.0);
+        diffuse = diff * view_facing * light_color;
+
+        // Specular component.
+        reflect_dir = reflect(light_dir, normal);
+        spec = pow(max(dot(view_dir, reflect_dir), 0.0), lpar.w);
+        specular = spec * view_facing * light_color;
+
+        // Total color.
+        out_color += (lpar.x * ambient + lpar.y * diffuse + lpar.z * specular) * color;
+    }
+    return out_color;
+}
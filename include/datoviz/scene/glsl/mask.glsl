@@ -0,0 +1,50 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+/*************************************************************************************************/
+/*  Per-item state mask, resolved in the vertex shader                                           */
+/*************************************************************************************************/
+
+// NOTE: must correspond to DvzMaskFlags in datoviz_enums.h
+#define DVZ_MASK_FLAGS_HIDDEN      0x01
+#define DVZ_MASK_FLAGS_SELECTED    0x02
+#define DVZ_MASK_FLAGS_HIGHLIGHTED 0x04
+#define DVZ_MASK_FLAGS_DIMMED      0x08
+
+#ifndef MASK_BINDING
+#define MASK_BINDING USER_BINDING
+#endif
+
+layout(std430, binding = MASK_BINDING) readonly buffer Mask
+{
+    vec4 selected_color;
+    vec4 params; // highlight size scale, dimmed alpha scale, *, *
+    uint states[]; // one byte per item, four items per word
+}
+mask;
+
+
+
+uint mask_state(uint item) { return (mask.states[item >> 2] >> (8 * (item & 3))) & 0xFF; }
+
+
+
+// Apply the state of an item to its vertex: hidden items are moved out of the clip volume.
+void mask_apply(uint item, inout vec4 position, inout vec4 color, inout float size)
+{
+    uint state = mask_state(item);
+    if (state == 0)
+        return;
+
+    if ((state & DVZ_MASK_FLAGS_HIDDEN) != 0)
+        position = vec4(2, 2, 2, 1);
+    if ((state & DVZ_MASK_FLAGS_SELECTED) != 0)
+        color.rgb = mask.selected_color.rgb;
+    if ((state & DVZ_MASK_FLAGS_HIGHLIGHTED) != 0)
+        size *= mask.params.x;
+    if ((state & DVZ_MASK_FLAGS_DIMMED) != 0)
+        color.a *= mask.params.y;
+}
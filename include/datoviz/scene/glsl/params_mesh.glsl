@@ -11,5 +11,8 @@ layout(std140, binding = USER_BINDING) uniform MeshParams
     mat4 light_params; /* ambient, diffuse, specular, exponent */
     vec4 stroke;       // r, g, b, stroke-width
     int isoline_count; // number of isolines
+    uint face_offset;   // index of the first drawn face, added to gl_PrimitiveID
+    uint index_size;    // 4 bytes per index, 0 if the mesh is not indexed
+    uint vertex_stride; // vertex size, in 4-byte words
 }
 params;
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+layout(std140, binding = USER_BINDING) uniform SurfaceParams
+{
+    vec4 origin;       /* x, y, z, *** */
+    vec4 u;            /* step between two consecutive rows */
+    vec4 v;            /* step between two consecutive columns */
+    vec4 light_dir;    /* x, y, z, *** */
+    vec4 light_params; /* ambient, diffuse, specular, exponent */
+    vec4 range;        /* vmin, vmax, ***, *** */
+    ivec4 grid;        /* row count, column count, colormap, *** */
+}
+params;
+
+layout(binding = (USER_BINDING + 1)) uniform sampler2D tex_heights;
+layout(binding = (USER_BINDING + 2)) uniform sampler2D tex_scalar;
@@ -0,0 +1,26 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+/*************************************************************************************************/
+/*  Quantized positions, decoded in the vertex shader                                            */
+/*************************************************************************************************/
+
+#ifndef QUANTIZE_BINDING
+#define QUANTIZE_BINDING USER_BINDING
+#endif
+
+// NOTE: must correspond to DvzQuantizeParams in visual.h
+layout(std140, binding = QUANTIZE_BINDING) uniform Quantize
+{
+    vec4 scale;  // half extent of the box of the positions
+    vec4 offset; // center of the box of the positions
+}
+quantize;
+
+
+
+// The snorm16 positions are in [-1, +1] relative to the box of all the positions of the visual.
+vec3 dequantize(vec3 pos) { return pos * quantize.scale.xyz + quantize.offset.xyz; }
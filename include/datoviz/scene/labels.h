@@ -71,7 +71,7 @@ struct DvzLabelFormat
     uint32_t precision;
     int32_t exponent;
     double offset;
-    char tick_format[12];
+    bool scientific;
 };
 
 
@@ -99,6 +99,14 @@ uint32_t dvz_labels_generate(
 
 
 
+// Generate the labels of arbitrary tick values (for example on a nonlinear axis), without
+// exponent or offset factoring. Return the total number of glyphs.
+uint32_t dvz_labels_from_values(
+    DvzLabels* labels, DvzTicksFormat format, uint32_t precision, //
+    uint32_t count, double* values);
+
+
+
 char* dvz_labels_string(DvzLabels* labels);
 
 
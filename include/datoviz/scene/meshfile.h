@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Binary mesh files                                                                             */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_MESHFILE
+#define DVZ_HEADER_MESHFILE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_log.h"
+#include "datoviz_math.h"
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_MESHFILE_EXTENSION ".dvzmesh"
+#define DVZ_MESHFILE_VERSION   1
+
+// Alignment of each section of the file, in bytes.
+#define DVZ_MESHFILE_ALIGNMENT 64
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+// Write a shape to a .dvzmesh file. The source size and modification time are stored in the
+// header when the file is a cache of another file, 0 otherwise. Return 0 on success.
+int dvz_meshfile_write(
+    DvzShape* shape, const char* file_path, uint64_t source_size, uint64_t source_mtime);
+
+
+
+// Read a .dvzmesh file into a shape. If the source size or modification time are not 0, they must
+// match the ones stored in the file. Return false if the file is missing, invalid, or stale.
+bool dvz_meshfile_read(
+    const char* file_path, uint64_t source_size, uint64_t source_mtime, DvzShape* shape);
+
+
+
+// Size and modification time of a file, in nanoseconds where the platform supports it, return
+// false if the file does not exist.
+bool dvz_meshfile_stamp(const char* file_path, uint64_t* size, uint64_t* mtime);
+
+
+
+EXTERN_C_OFF
+
+#endif
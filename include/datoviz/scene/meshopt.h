@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Mesh optimization                                                                             */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_MESHOPT
+#define DVZ_HEADER_MESHOPT
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_log.h"
+#include "datoviz_math.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Size of the LRU vertex cache modeled by the vertex cache optimizer.
+#define DVZ_MESHOPT_VCACHE_SIZE 32
+
+// Maximum ACMR degradation accepted when splitting the mesh into clusters to reduce overdraw.
+#define DVZ_MESHOPT_OVERDRAW_THRESHOLD 1.05f
+
+
+
+EXTERN_C_ON
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+// Reorder the triangles to maximize the post-transform vertex cache hits (Tom Forsyth's linear
+// speed algorithm). The output buffer may be the same as the input buffer.
+void dvz_meshopt_vcache(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, DvzIndex* out);
+
+
+
+// Reorder clusters of triangles so that the outward-facing ones are drawn first, reducing
+// overdraw. The input should be already optimized for the vertex cache: it is split at cache
+// restarts, and wherever the cluster ACMR stays within `threshold` times the original one.
+void dvz_meshopt_overdraw(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, vec3* pos,
+    float threshold, DvzIndex* out);
+
+
+
+// Renumber the vertices in the order in which the indices reference them, for sequential vertex
+// fetching. The indices are remapped in place, and `remap[old_vertex] = new_vertex` is filled
+// with vertex_count values (unreferenced vertices go to the end).
+// Return the number of referenced vertices.
+uint32_t
+dvz_meshopt_fetch(uint32_t index_count, DvzIndex* index, uint32_t vertex_count, uint32_t* remap);
+
+
+
+// Vertex-triangle adjacency in compressed form: the triangles around vertex v are
+// faces[offsets[v]] to faces[offsets[v + 1] - 1], in increasing order. `offsets` needs
+// vertex_count + 1 values, `faces` needs index_count values.
+void dvz_meshopt_adjacency(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, uint32_t* offsets,
+    uint32_t* faces);
+
+
+
+// Simplify a mesh down to about `target_index_count` indices with quadric-error edge collapses.
+// The vertices are not modified, the output indices reference a subset of them. The output
+// buffer may be the same as the input buffer, and needs to hold index_count values.
+// Return the number of output indices, and the largest collapse error in `out_error`, as a
+// distance in data coordinates.
+uint32_t dvz_meshopt_simplify(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, vec3* pos,
+    uint32_t target_index_count, float* out_error, DvzIndex* out);
+
+
+
+// Bounding sphere (center and radius) centered on the bounding box of the vertices.
+void dvz_meshopt_sphere(uint32_t vertex_count, vec3* pos, vec4 sphere);
+
+
+
+// Border edges of the triangles, the edges that belong to a single triangle. For each triangle,
+// bit c of out[triangle] is set if the edge opposite to its corner c is a border edge.
+void dvz_meshopt_borders(uint32_t index_count, const DvzIndex* index, uint8_t* out);
+
+
+
+// Average cache miss ratio (number of transformed vertices per triangle) with a FIFO cache.
+float dvz_meshopt_acmr(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, uint32_t cache_size);
+
+
+
+EXTERN_C_OFF
+
+#endif
@@ -34,6 +34,9 @@
 
 #define DVZ_SPECIALIZATION_VIEWPORT 17
 
+#define DVZ_SPECIALIZATION_QUANTIZE 18
+#define DVZ_QUANTIZE_ANGLE          0x1
+
 
 
 /*************************************************************************************************/
@@ -51,6 +54,30 @@ EXTERN_C_ON
 /*  Functions                                                                                    */
 /*************************************************************************************************/
 
+/**
+ * Apply an axis scale function to a value, on the CPU, as done in the vertex shader.
+ *
+ * @param type the scale type
+ * @param param the scale parameter (linear threshold for symlog)
+ * @param x the value
+ * @returns the scaled value, NaN for a nonpositive value on a log10 axis
+ */
+double dvz_scale_apply(DvzScaleType type, double param, double x);
+
+
+
+/**
+ * Inverse of an axis scale function.
+ *
+ * @param type the scale type
+ * @param param the scale parameter (linear threshold for symlog)
+ * @param y the scaled value
+ * @returns the value
+ */
+double dvz_scale_inverse(DvzScaleType type, double param, double y);
+
+
+
 /**
  */
 void dvz_mvp_apply(DvzMVP* mvp, vec4 point, vec4 out);
@@ -42,10 +42,11 @@ struct DvzOrtho
     vec2 viewport_size;
     int flags;
 
-    vec2 pan;
-    vec2 pan_center;
-    float zoom;
-    vec2 zoom_center;
+    // NOTE: double precision, as the pan goes into the split MVP offset (see dvz_mvp_offset()).
+    dvec2 pan;
+    dvec2 pan_center;
+    double zoom;
+    dvec2 zoom_center;
 };
 
 
@@ -45,10 +45,11 @@ struct DvzPanzoom
     vec2 zlim;
     int flags;
 
-    vec2 pan;
-    vec2 pan_center;
-    vec2 zoom;
-    vec2 zoom_center;
+    // NOTE: double precision, as the pan goes into the split MVP offset (see dvz_mvp_offset()).
+    dvec2 pan;
+    dvec2 pan_center;
+    dvec2 zoom;
+    dvec2 zoom_center;
     // DvzMVP mvp;
 };
 
@@ -80,7 +80,10 @@ struct DvzTicks
     int flags;
     double range_size; // size in pixels between the two ends of the axis
     double glyph_size; // average size of a glyph
-    double dmin, dmax; // requested min and max of the range
+    double dmin, dmax; // requested min and max of the range, in the scaled space
+
+    DvzScaleType scale; // on log10 and symlog axes, the ticks are computed in the scaled space
+    double scale_param; // linear threshold for symlog
 
     double lmin, lmax, lstep; // computed min and max of the ticks
     DvzTicksFormat format;    // computed tick format
@@ -116,6 +119,12 @@ void dvz_ticks_size(DvzTicks* ticks, double range_size, double glyph_size);
 
 
 
+void dvz_ticks_scale(DvzTicks* ticks, DvzScaleType type, double param);
+
+
+
+// dmin and dmax are in data coordinates. On nonlinear axes, lmin, lmax, and lstep are in the
+// scaled space, where the ticks are regularly spaced (integer decades when possible).
 bool dvz_ticks_compute(DvzTicks* ticks, double dmin, double dmax, uint32_t requested_count);
 
 
@@ -124,6 +133,11 @@ uint32_t dvz_ticks_range(DvzTicks* ticks, double* lmin, double* lmax, double* ls
 
 
 
+// Fill at most count tick values, in data coordinates, and return the number of values written.
+uint32_t dvz_ticks_values(DvzTicks* ticks, uint32_t count, double* values);
+
+
+
 DvzTicksFormat dvz_ticks_format(DvzTicks* ticks);
 
 
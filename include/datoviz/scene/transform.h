@@ -87,6 +87,21 @@ void dvz_transform_update(DvzTransform* tr);
 
 
 
+/**
+ * Set the scale of one axis of the transform MVP, and emit the uniform update.
+ *
+ * @param tr the transform
+ * @param dim the axis (0 for x, 1 for y, 2 for z)
+ * @param type the scale type
+ * @param param the scale parameter (linear threshold for symlog)
+ * @param domain the data values mapped to the range
+ * @param range the corresponding coordinates
+ */
+void dvz_transform_scale(
+    DvzTransform* tr, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range);
+
+
+
 /**
  *
  */
@@ -41,18 +41,23 @@
 
 typedef struct DvzVisual DvzVisual;
 typedef struct DvzVisualAttr DvzVisualAttr;
+typedef struct DvzQuantizeParams DvzQuantizeParams;
 
 // Forward declarations.
 typedef struct DvzBatch DvzBatch;
 typedef struct DvzBaker DvzBaker;
 typedef struct DvzView DvzView;
 typedef struct DvzTransform DvzTransform;
+typedef struct DvzArray DvzArray;
 
 // Visual draw callback function.
 typedef void (*DvzVisualCallback)(
     DvzVisual* visual, DvzId canvas, //
     uint32_t first, uint32_t count, uint32_t first_instance, uint32_t instance_count);
 
+// Visual level of detail callback function, called when the level of detail changes.
+typedef void (*DvzVisualLodCallback)(DvzVisual* visual, uint32_t level);
+
 
 
 /*************************************************************************************************/
@@ -91,6 +96,15 @@ struct DvzVisualAttr
 
 
 
+// Decoding of the quantized positions in the vertex shader: pos = snorm * scale + offset.
+struct DvzQuantizeParams
+{
+    vec4 scale;  // half extent of the box of the positions
+    vec4 offset; // center of the box of the positions
+};
+
+
+
 struct DvzVisual
 {
     DvzObject obj;
@@ -110,6 +124,21 @@ struct DvzVisual
     DvzParams* params[DVZ_MAX_BINDINGS]; // dats
     DvzId texs[DVZ_MAX_BINDINGS];        // texs
 
+    // Per-item mask: a header with the mask style, then one byte per item, in a storage buffer.
+    uint32_t mask_slot; // 0 if the visual has no mask
+    DvzDual mask;
+
+    // Quantized positions, stored in snorm16 relative to the box of all the positions.
+    uint32_t quantize_slot; // 0 if the visual is not quantized
+    DvzBox quantize_box;
+    DvzArray* quantize_source; // dvec3 source positions, requantized when the box grows
+
+    // Per-face edge flags of wireframe meshes, one byte per face, in a storage buffer.
+    DvzDual edges;
+
+    // Per-instance transforms and colors of instanced meshes, in a storage buffer.
+    DvzDual instances;
+
     // Data.
     uint32_t item_count;
     uint32_t vertex_count;
@@ -117,6 +146,16 @@ struct DvzVisual
     uint32_t group_count;
     uint32_t* group_sizes;
 
+    // Levels of detail: ranges of the index buffer, the one to draw is selected at every frame.
+    uint32_t lod_count;
+    uint32_t lod_level;
+    uint32_t lod_first[DVZ_SHAPE_MAX_LODS];
+    uint32_t lod_index_count[DVZ_SHAPE_MAX_LODS];
+    float lod_error[DVZ_SHAPE_MAX_LODS]; // relative to the bounding sphere radius
+    vec4 lod_sphere;                     // bounding sphere center and radius
+    DvzTransform* lod_transform;         // transform of the view, to select the level of detail
+    DvzVisualLodCallback lod_callback;
+
     // Drawing.
     uint32_t draw_first;     // first item (offset).
     uint32_t draw_count;     // number of items to draw.
@@ -170,6 +209,20 @@ void dvz_visual_viewport(DvzVisual* visual, DvzViewport* viewport); // update th
 
 
 
+/**
+ * Declare the slot of the uniform used to decode the positions of a visual created with
+ * `DVZ_VISUAL_FLAGS_QUANTIZED`.
+ *
+ * The uniform has the DvzQuantizeParams layout (see quantize.glsl) and is updated whenever the
+ * box of the positions changes.
+ *
+ * @param visual the visual
+ * @param slot_idx the slot index
+ */
+void dvz_visual_quantize_slot(DvzVisual* visual, uint32_t slot_idx);
+
+
+
 /*************************************************************************************************/
 /*  Visual drawing internal functions                                                            */
 /*************************************************************************************************/
@@ -213,6 +266,59 @@ void dvz_visual_callback(DvzVisual* visual, DvzVisualCallback callback);
 
 
 
+/*************************************************************************************************/
+/*  Visual levels of detail                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Set the levels of detail of an indexed visual, as ranges of its index buffer.
+ *
+ * @param visual the visual
+ * @param lod_count the number of levels, from the finest to the coarsest
+ * @param first the first index of each level
+ * @param index_count the number of indices of each level
+ * @param error the simplification error of each level, relative to the bounding sphere radius
+ * @param sphere the bounding sphere center and radius, in data coordinates
+ */
+void dvz_visual_lod(
+    DvzVisual* visual, uint32_t lod_count, uint32_t* first, uint32_t* index_count, float* error,
+    vec4 sphere);
+
+
+
+/**
+ * Select the coarsest level of detail whose error is below one pixel on screen.
+ *
+ * @param visual the visual
+ * @param mvp the MVP
+ * @param size the size of the view, in framebuffer pixels
+ * @returns the level of detail
+ */
+uint32_t dvz_visual_lod_select(DvzVisual* visual, DvzMVP* mvp, vec2 size);
+
+
+
+/**
+ * Select the level of detail with the visual's transform and view.
+ *
+ * @param visual the visual
+ * @returns whether the level of detail has changed, in which case the commands must be recorded
+ * again
+ */
+bool dvz_visual_lod_update(DvzVisual* visual);
+
+
+
+/**
+ * Set a function called when the level of detail of the visual changes.
+ *
+ * @param visual the visual
+ * @param callback the callback
+ */
+void dvz_visual_lod_callback(DvzVisual* visual, DvzVisualLodCallback callback);
+
+
+
 /*************************************************************************************************/
 /*  Utils                                                                                        */
 /*************************************************************************************************/
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Instanced mesh                                                                                */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_INSTANCED
+#define DVZ_HEADER_INSTANCED
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "../viewport.h"
+#include "../visual.h"
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzInstancedVertex DvzInstancedVertex;
+typedef struct DvzInstancedItem DvzInstancedItem;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+typedef struct DvzVisual DvzVisual;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzInstancedVertex
+{
+    vec3 pos;       /* position */
+    vec3 normal;    /* normal vector */
+    DvzColor color; /* color rgba */
+};
+
+
+
+// NOTE: must correspond to the Instance struct in graphics_instanced.vert (std430).
+struct DvzInstancedItem
+{
+    vec4 pos;      /* x, y, z, *** */
+    vec4 rotation; /* quaternion x, y, z, w */
+    vec4 scale;    /* x, y, z, *** */
+    vec4 color;    /* r, g, b, a, multiplied with the vertex colors */
+};
+
+
+
+#endif
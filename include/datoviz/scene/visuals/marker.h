@@ -27,6 +27,7 @@
 /*************************************************************************************************/
 
 typedef struct DvzMarkerVertex DvzMarkerVertex;
+typedef struct DvzMarkerVertexQuantized DvzMarkerVertexQuantized;
 typedef struct DvzMarkerParams DvzMarkerParams;
 
 // Forward declarations.
@@ -55,6 +56,17 @@ struct DvzMarkerVertex
 
 
 
+// Vertex layout with DVZ_VISUAL_FLAGS_QUANTIZED.
+struct DvzMarkerVertexQuantized
+{
+    int16_t pos[4]; /* position, snorm16 in the box of the positions */
+    uint16_t size;  /* size, half-precision float */
+    int16_t angle;  /* angle / pi, snorm16 */
+    DvzColor color; /* color */
+};
+
+
+
 struct DvzMarkerParams
 {
     vec4 edge_color;
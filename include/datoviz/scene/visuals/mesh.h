@@ -28,6 +28,8 @@
 
 typedef struct DvzMeshColorVertex DvzMeshColorVertex;
 typedef struct DvzMeshTexturedVertex DvzMeshTexturedVertex;
+typedef struct DvzMeshWireframeColorVertex DvzMeshWireframeColorVertex;
+typedef struct DvzMeshWireframeTexturedVertex DvzMeshWireframeTexturedVertex;
 typedef struct DvzMeshParams DvzMeshParams;
 
 // Forward declarations.
@@ -67,6 +69,23 @@ struct DvzMeshTexturedVertex
 
 
 
+// Compact vertices of the wireframe mode, which does not use the isoline and contour attributes.
+struct DvzMeshWireframeColorVertex
+{
+    vec3 pos;       /* position */
+    vec3 normal;    /* normal vector */
+    DvzColor color; /* color rgba */
+};
+
+struct DvzMeshWireframeTexturedVertex
+{
+    vec3 pos;       /* position */
+    vec3 normal;    /* normal vector */
+    vec4 texcoords; /* u, v, *, a */
+};
+
+
+
 struct DvzMeshParams
 {
     mat4 light_dir;         /* x, y, z, *** */
@@ -74,6 +93,9 @@ struct DvzMeshParams
     mat4 light_params;      /* ambient, diffuse, specular, exponent */
     vec4 stroke;            /* r, g, b, stroke width */
     uint32_t isoline_count; /* number of isolines */
+    uint32_t face_offset;   /* index of the first drawn face, added to gl_PrimitiveID */
+    uint32_t index_size;    /* 4 bytes per index, 0 if the mesh is not indexed */
+    uint32_t vertex_stride; /* vertex size, in 4-byte words */
 };
 
 
@@ -85,6 +107,9 @@ typedef enum
     DVZ_MESH_PARAMS_LIGHT_PARAMS,
     DVZ_MESH_PARAMS_STROKE,
     DVZ_MESH_PARAMS_ISOLINE_COUNT,
+    DVZ_MESH_PARAMS_FACE_OFFSET,
+    DVZ_MESH_PARAMS_INDEX_SIZE,
+    DVZ_MESH_PARAMS_VERTEX_STRIDE,
 } DvzMeshParamsEnum;
 
 
@@ -27,6 +27,7 @@
 /*************************************************************************************************/
 
 typedef struct DvzPointVertex DvzPointVertex;
+typedef struct DvzPointVertexQuantized DvzPointVertexQuantized;
 
 // Forward declarations.
 typedef struct DvzBatch DvzBatch;
@@ -53,4 +54,15 @@ struct DvzPointVertex
 
 
 
+// Vertex layout with DVZ_VISUAL_FLAGS_QUANTIZED.
+struct DvzPointVertexQuantized
+{
+    int16_t pos[4]; /* position, snorm16 in the box of the positions */
+    DvzColor color; /* color */
+    uint16_t size;  /* size, half-precision float */
+    uint16_t _pad;
+};
+
+
+
 #endif
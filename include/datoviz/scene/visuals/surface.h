@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/* Surface                                                                                       */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_SURFACE
+#define DVZ_HEADER_SURFACE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "../viewport.h"
+#include "../visual.h"
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzSurfaceParams DvzSurfaceParams;
+
+// Forward declarations.
+typedef struct DvzBatch DvzBatch;
+typedef struct DvzVisual DvzVisual;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// NOTE: must correspond to params_surface.glsl (std140).
+struct DvzSurfaceParams
+{
+    vec4 origin;       /* x, y, z, *** */
+    vec4 u;            /* step between two consecutive rows */
+    vec4 v;            /* step between two consecutive columns */
+    vec4 light_dir;    /* x, y, z, *** */
+    vec4 light_params; /* ambient, diffuse, specular, exponent */
+    vec4 range;        /* vmin, vmax, ***, *** */
+    ivec4 grid;        /* row count, column count, colormap, *** */
+};
+
+
+
+typedef enum
+{
+    DVZ_SURFACE_PARAMS_ORIGIN,
+    DVZ_SURFACE_PARAMS_U,
+    DVZ_SURFACE_PARAMS_V,
+    DVZ_SURFACE_PARAMS_LIGHT_DIR,
+    DVZ_SURFACE_PARAMS_LIGHT_PARAMS,
+    DVZ_SURFACE_PARAMS_RANGE,
+    DVZ_SURFACE_PARAMS_GRID,
+} DvzSurfaceParamsEnum;
+
+
+
+#endif
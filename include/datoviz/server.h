@@ -17,6 +17,16 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include "datoviz_types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_SERVER_MAX_FRAMES 16
+
 
 
 /*************************************************************************************************/
@@ -32,6 +42,8 @@ typedef struct DvzRenderer DvzRenderer;
 typedef struct DvzBatch DvzBatch;
 typedef struct DvzMouse DvzMouse;
 typedef struct DvzKeyboard DvzKeyboard;
+typedef struct DvzImageWriter DvzImageWriter;
+typedef struct DvzBoardReadback DvzBoardReadback;
 
 
 
@@ -47,6 +59,19 @@ struct DvzServer
     DvzBatch* batch;
     DvzMouse* mouse;
     DvzKeyboard* keyboard;
+    DvzImageWriter* writer; // created on the first call to dvz_server_screenshot()
+
+    // Pipelined rendering: ring buffer of the frames being rendered and downloaded.
+    // frames_in_flight is the number of readbacks, the maximum number of frames submitted to the
+    // GPU and not yet passed to the callback, and count is the current number of such frames.
+    uint32_t frames_in_flight;
+    DvzBoardReadback* readbacks;
+    uint32_t first, count;
+    uint64_t frame_idx; // index of the next frame
+    uint8_t* rgb;       // RGB buffer passed to the callback
+    DvzSize rgb_size;
+    DvzServerReadbackCallback callback;
+    void* callback_data;
 };
 
 
@@ -257,6 +257,7 @@ struct DvzCommands
     uint32_t count;
     VkCommandBuffer cmds[DVZ_MAX_COMMAND_BUFFERS_PER_SET];
     bool blocked[DVZ_MAX_COMMAND_BUFFERS_PER_SET]; // if true, no need to refill it in the FRAME
+    VkCommandBufferUsageFlags usage;               // passed when the recording begins
 };
 
 
@@ -845,6 +846,15 @@ void dvz_swapchain_destroy(DvzSwapchain* swapchain);
  */
 DvzCommands dvz_commands(DvzGpu* gpu, uint32_t queue, uint32_t count);
 
+/**
+ * Set the usage flags of a set of command buffers, used when their recording begins.
+ *
+ * @param cmds the set of command buffers
+ * @param usage the usage flags, for example `VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT` for
+ *      command buffers that may be pending several times
+ */
+void dvz_commands_usage(DvzCommands* cmds, VkCommandBufferUsageFlags usage);
+
 /**
  * Start recording a command buffer.
  *
@@ -2239,9 +2249,11 @@ void dvz_cmd_bind_vertex_buffer(
  * @param idx the index of the command buffer to record
  * @param br the buffer regions
  * @param offset the offset within the buffer regions, in bytes
+ * @param index_type the index type (16-bit or 32-bit unsigned integers)
  */
 void dvz_cmd_bind_index_buffer(
-    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset);
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset,
+    VkIndexType index_type);
 
 /**
  * Direct draw.
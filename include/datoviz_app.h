@@ -198,7 +198,7 @@ DVZ_EXPORT void dvz_app_submit(DvzApp* app);
  *
  * @param app the app
  * @param canvas_id the ID of the canvas
- * @param filename the path to the PNG file with the screenshot
+ * @param filename the path to the image file, PNG or, depending on the extension, PPM or QOI
  */
 DVZ_EXPORT void dvz_app_screenshot(DvzApp* app, DvzId canvas_id, const char* filename);
 
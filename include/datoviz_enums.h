@@ -160,6 +160,17 @@ typedef enum
 
 
 
+// Axis scale, applied to the positions in the vertex shader.
+// NOTE: must correspond to values in common.glsl
+typedef enum
+{
+    DVZ_SCALE_LINEAR,
+    DVZ_SCALE_LOG10,
+    DVZ_SCALE_SYMLOG,
+} DvzScaleType;
+
+
+
 // Camera flags.
 typedef enum
 {
@@ -176,6 +187,9 @@ typedef enum
     DVZ_VISUAL_FLAGS_DEFAULT = 0x000000,
     DVZ_VISUAL_FLAGS_INDEXED = 0x010000,
     DVZ_VISUAL_FLAGS_INDIRECT = 0x020000,
+    DVZ_VISUAL_FLAGS_DOUBLE_PRECISION = 0x040000, // point, marker, segment, and path only
+    DVZ_VISUAL_FLAGS_MASK = 0x080000,             // point and marker only
+    DVZ_VISUAL_FLAGS_QUANTIZED = 0x200000,        // point and marker only
 
     DVZ_VISUAL_FLAGS_VERTEX_MAPPABLE = 0x400000,
     DVZ_VISUAL_FLAGS_INDEX_MAPPABLE = 0x800000,
@@ -183,6 +197,19 @@ typedef enum
 
 
 
+// Per-item mask states, see dvz_visual_mask().
+// NOTE: must correspond to values in mask.glsl
+typedef enum
+{
+    DVZ_MASK_FLAGS_NONE = 0x00,
+    DVZ_MASK_FLAGS_HIDDEN = 0x01,
+    DVZ_MASK_FLAGS_SELECTED = 0x02,
+    DVZ_MASK_FLAGS_HIGHLIGHTED = 0x04,
+    DVZ_MASK_FLAGS_DIMMED = 0x08,
+} DvzMaskFlags;
+
+
+
 // View flags (panel_visual).
 typedef enum
 {
@@ -381,6 +408,8 @@ typedef enum
     DVZ_FORMAT_B8G8R8A8_UNORM = 44,
     DVZ_FORMAT_R16_UNORM = 70,
     DVZ_FORMAT_R16_SNORM = 71,
+    DVZ_FORMAT_R16_SFLOAT = 76,
+    DVZ_FORMAT_R16G16B16A16_SNORM = 92,
     DVZ_FORMAT_R32_UINT = 98,
     DVZ_FORMAT_R32_SINT = 99,
     DVZ_FORMAT_R32_SFLOAT = 100,
@@ -664,6 +693,9 @@ typedef enum
     DVZ_SHAPE_OTHER,
 } DvzShapeType;
 
+// Maximum number of levels of detail of a shape (see dvz_shape_lod()).
+#define DVZ_SHAPE_MAX_LODS 8
+
 
 
 // Contour flags.
@@ -686,6 +718,9 @@ typedef enum
     DVZ_MESH_FLAGS_LIGHTING = 0x0002,
     DVZ_MESH_FLAGS_CONTOUR = 0x0004,
     DVZ_MESH_FLAGS_ISOLINE = 0x0008,
+    DVZ_MESH_FLAGS_OPTIMIZE = 0x0010,  // optimize the shape in dvz_mesh_reshape()
+    DVZ_MESH_FLAGS_FLAT = 0x0020,      // flat shading, face normals computed in the shader
+    DVZ_MESH_FLAGS_WIREFRAME = 0x0040, // triangle edges drawn without unindexing the mesh
 } DvzMeshFlags;
 
 
@@ -701,6 +736,16 @@ typedef enum
 
 
 
+// Surface flags.
+typedef enum
+{
+    DVZ_SURFACE_FLAGS_NONE = 0x0000,
+    DVZ_SURFACE_FLAGS_SCALAR = 0x0001, // colormap the scalar texture instead of the heights
+    DVZ_SURFACE_FLAGS_LIGHTING = 0x0002,
+} DvzSurfaceFlags;
+
+
+
 // Easing.
 typedef enum
 {
@@ -780,6 +825,86 @@ typedef enum
 
 
 
+// PNG filter applied to the scanlines before compression.
+typedef enum
+{
+    DVZ_PNG_FILTER_NONE,
+    DVZ_PNG_FILTER_SUB,
+    DVZ_PNG_FILTER_UP,
+    DVZ_PNG_FILTER_AVERAGE,
+    DVZ_PNG_FILTER_PAETH,
+    DVZ_PNG_FILTER_ADAPTIVE, // best filter of each scanline, chosen with a heuristic
+} DvzPngFilter;
+
+
+
+// Video format of a frame sink.
+typedef enum
+{
+    DVZ_VIDEO_FORMAT_Y4M, // YUV4MPEG2 stream, with 4:2:0 chroma subsampling
+    DVZ_VIDEO_FORMAT_RGB, // raw 24-bit RGB frames, without header
+} DvzVideoFormat;
+
+
+
+// Array flags.
+typedef enum
+{
+    DVZ_ARRAY_FLAGS_NONE = 0x0000,
+    DVZ_ARRAY_FLAGS_VECTOR = 0x0001, // a last dimension of 2, 3 or 4 gives a vector data type
+} DvzArrayFlags;
+
+
+
+// Data types.
+typedef enum
+{
+    DVZ_DTYPE_NONE,
+    DVZ_DTYPE_CUSTOM, // used for structured arrays (aka record arrays)
+    DVZ_DTYPE_STR,    // 64 bits, pointer
+
+    DVZ_DTYPE_CHAR, // 8 bits, unsigned int
+    DVZ_DTYPE_CVEC2,
+    DVZ_DTYPE_CVEC3,
+    DVZ_DTYPE_CVEC4,
+
+    DVZ_DTYPE_USHORT, // 16 bits, unsigned int
+    DVZ_DTYPE_USVEC2,
+    DVZ_DTYPE_USVEC3,
+    DVZ_DTYPE_USVEC4,
+
+    DVZ_DTYPE_SHORT, // 16 bits, signed int
+    DVZ_DTYPE_SVEC2,
+    DVZ_DTYPE_SVEC3,
+    DVZ_DTYPE_SVEC4,
+
+    DVZ_DTYPE_UINT, // 32 bits, unsigned int
+    DVZ_DTYPE_UVEC2,
+    DVZ_DTYPE_UVEC3,
+    DVZ_DTYPE_UVEC4,
+
+    DVZ_DTYPE_INT, // 32 bits, signed int
+    DVZ_DTYPE_IVEC2,
+    DVZ_DTYPE_IVEC3,
+    DVZ_DTYPE_IVEC4,
+
+    DVZ_DTYPE_FLOAT, // 32 bits float
+    DVZ_DTYPE_VEC2,
+    DVZ_DTYPE_VEC3,
+    DVZ_DTYPE_VEC4,
+
+    DVZ_DTYPE_DOUBLE, // 64 bits double
+    DVZ_DTYPE_DVEC2,
+    DVZ_DTYPE_DVEC3,
+    DVZ_DTYPE_DVEC4,
+
+    DVZ_DTYPE_MAT2, // matrices of floats
+    DVZ_DTYPE_MAT3,
+    DVZ_DTYPE_MAT4,
+} DvzDataType;
+
+
+
 /*************************************************************************************************/
 /*  Defaults                                                                                     */
 /*************************************************************************************************/
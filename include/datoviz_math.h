@@ -649,6 +649,28 @@ dvz_earcut(uint32_t point_count, const dvec2* polygon, uint32_t* out_index_count
 
 
 
+/**
+ * Triangulate many polygons with holes in parallel, in a single index buffer.
+ *
+ * The points of all rings are concatenated. Ring `r` has the points `ring_offsets[r]` to
+ * `ring_offsets[r + 1] - 1`. Polygon `p` has the rings `polygon_offsets[p]` to
+ * `polygon_offsets[p + 1] - 1`, the first one is the outer ring and the others are holes.
+ *
+ * @param polygon_count the number of polygons
+ * @param polygon_offsets the index of the first ring of each polygon (polygon_count + 1 values)
+ * @param ring_offsets the index of the first point of each ring (ring_count + 1 values)
+ * @param points the 2D positions of the points of all rings
+ * @param[out] out_index_count the computed index count
+ * @param[out] out_index_offsets if not NULL, the index of the first index of each polygon
+ * (polygon_count + 1 values)
+ * @returns the computed indices, referring to the points array (must be FREED by the caller)
+ */
+DVZ_EXPORT DvzIndex* dvz_earcut_polygons(
+    uint32_t polygon_count, const uint32_t* polygon_offsets, const uint32_t* ring_offsets,
+    const dvec2* points, uint32_t* out_index_count, uint32_t* out_index_offsets);
+
+
+
 /*************************************************************************************************/
 /*  Random number generation                                                                     */
 /*************************************************************************************************/
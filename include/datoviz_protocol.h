@@ -120,6 +120,41 @@ DVZ_EXPORT DvzMVP dvz_mvp_default(void);
 
 
 
+/**
+ * Set the offset of a DvzMVP struct, with respect to which the positions are transformed.
+ *
+ * The offset is stored as a pair of single precision numbers whose sum approximates the double
+ * precision value. Visuals created with `DVZ_VISUAL_FLAGS_DOUBLE_PRECISION` subtract it from
+ * their double-single positions in the vertex shader before applying the MVP matrices.
+ *
+ * @param mvp the MVP
+ * @param offset the offset, in double precision
+ */
+DVZ_EXPORT void dvz_mvp_offset(DvzMVP* mvp, dvec3 offset);
+
+
+
+/**
+ * Set the scale of one axis of a DvzMVP struct, applied to the positions in the vertex shader.
+ *
+ * On a log10 or symlog axis, the positions are transformed with the scale function, and the
+ * transformed domain is mapped linearly to the range. The positions should then be uploaded in
+ * data coordinates. Symlog is linear in [-param, +param] and logarithmic outside. On a log10
+ * axis, the primitives with a nonpositive coordinate are discarded. Changing the scale only
+ * requires a uniform update.
+ *
+ * @param mvp the MVP
+ * @param dim the axis (0 for x, 1 for y, 2 for z)
+ * @param type the scale type
+ * @param param the scale parameter (linear threshold for symlog, ignored otherwise)
+ * @param domain the data values mapped to the range (must be positive on a log10 axis)
+ * @param range the corresponding coordinates, typically normalized device coordinates
+ */
+DVZ_EXPORT void
+dvz_mvp_scale(DvzMVP* mvp, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range);
+
+
+
 /**
  * Return a default viewport
  *
@@ -741,6 +776,21 @@ DVZ_EXPORT DvzRequest dvz_bind_index(DvzBatch* batch, DvzId pipe, DvzId dat, Dvz
 
 
 
+/**
+ * Create a request for associating an index dat with 16-bit or 32-bit indices to a graphics pipe.
+ *
+ * @param batch the batch
+ * @param graphics the id of the graphics pipe
+ * @param dat the id of the dat with the index data
+ * @param offset the offset within the dat
+ * @param index_size the size of each index, 2 (uint16) or 4 (uint32) bytes
+ * @returns the request
+ */
+DVZ_EXPORT DvzRequest dvz_bind_index_size(
+    DvzBatch* batch, DvzId graphics, DvzId dat, DvzSize offset, DvzSize index_size);
+
+
+
 /**
  * Create a request for associating a dat to a pipe's slot.
  *
@@ -32,10 +32,13 @@
 /*************************************************************************************************/
 
 typedef struct DvzShape DvzShape;
+typedef struct DvzIsolines DvzIsolines;
 typedef struct DvzMVP DvzMVP;
 typedef struct DvzViewport DvzViewport;
 typedef struct _VkViewport _VkViewport;
 typedef struct DvzBox DvzBox;
+typedef struct DvzColormapLut DvzColormapLut;
+typedef struct DvzArrowColumn DvzArrowColumn;
 typedef struct DvzAtlasFont DvzAtlasFont;
 
 typedef struct DvzKeyboardEvent DvzKeyboardEvent;
@@ -51,6 +54,7 @@ typedef struct DvzFrameEvent DvzFrameEvent;
 typedef struct DvzGuiEvent DvzGuiEvent;
 typedef struct DvzTimerEvent DvzTimerEvent;
 typedef struct DvzRequestsEvent DvzRequestsEvent;
+typedef struct DvzReadbackEvent DvzReadbackEvent;
 
 // Requests.
 typedef struct DvzRequestBoard DvzRequestBoard;
@@ -102,6 +106,7 @@ typedef struct DvzRecorderCommand DvzRecorderCommand;
 typedef struct DvzTimerItem DvzTimerItem;
 typedef struct DvzGuiWindow DvzGuiWindow;
 typedef struct DvzApp DvzApp;
+typedef struct DvzServer DvzServer;
 typedef struct DvzAtlas DvzAtlas;
 typedef struct DvzFont DvzFont;
 typedef struct DvzList DvzList;
@@ -114,6 +119,11 @@ typedef void (*DvzAppKeyboardCallback)(DvzApp* app, DvzId window_id, DvzKeyboard
 typedef void (*DvzAppFrameCallback)(DvzApp* app, DvzId window_id, DvzFrameEvent ev);
 typedef void (*DvzAppTimerCallback)(DvzApp* app, DvzId window_id, DvzTimerEvent ev);
 typedef void (*DvzAppResizeCallback)(DvzApp* app, DvzId window_id, DvzWindowEvent ev);
+typedef void (*DvzServerReadbackCallback)(DvzServer* server, DvzId canvas_id, DvzReadbackEvent ev);
+
+// Callback receiving the decompressed chunks, in order, with their offset in the decompressed
+// stream. The chunk pointer is only valid during the call. Return a nonzero value to stop.
+typedef int (*DvzChunkCallback)(DvzSize offset, DvzSize size, const void* chunk, void* user_data);
 
 
 
@@ -137,6 +147,18 @@ struct DvzMVP
     mat4 view;
     mat4 proj;
 
+    // Positions are relative to this offset, whose double precision value is split into a high
+    // and a low single precision part (see dvz_mvp_offset()).
+    vec4 offset_hi;
+    vec4 offset_lo;
+
+    // Per-axis scale (see dvz_mvp_scale()), applied to the positions before the offset: on the
+    // nonlinear axes, pos = scale_a * f(pos) + scale_b where f is log10 or symlog.
+    ivec4 scale_type;
+    vec4 scale_param;
+    vec4 scale_a;
+    vec4 scale_b;
+
     // float time;
 };
 
@@ -196,6 +218,13 @@ struct DvzShape
                      // edge, 2 if it is a corner, 4 if it should be oriented differently
     DvzIndex* index; // the index buffer
 
+    // Levels of detail, from the finest to the coarsest (see dvz_shape_lod()): ranges of the
+    // index buffer, and simplification errors relative to the bounding sphere radius.
+    uint32_t lod_count;
+    uint32_t lod_first[DVZ_SHAPE_MAX_LODS];
+    uint32_t lod_index_count[DVZ_SHAPE_MAX_LODS];
+    float lod_error[DVZ_SHAPE_MAX_LODS];
+
     // UGLY HACK: this seems to be necessary to ensure struct size equality between C and ctypes
     // (just checkstructs), maybe some alignment issue.
     // double _;
@@ -203,6 +232,17 @@ struct DvzShape
 
 
 
+struct DvzIsolines
+{
+    uint32_t point_count;   // total number of points
+    vec3* pos;              // 3D positions of the points, polyline after polyline
+    uint32_t path_count;    // number of polylines
+    uint32_t* path_lengths; // number of points in each polyline
+    uint32_t* path_levels;  // index of the level of each polyline
+};
+
+
+
 struct DvzBox
 {
     double xmin, xmax, ymin, ymax, zmin, zmax;
@@ -210,6 +250,28 @@ struct DvzBox
 
 
 
+struct DvzColormapLut
+{
+    DvzColor colors[256]; // the colormap resolved as a contiguous lookup table
+    DvzColor under;       // color of the values below vmin (first color by default)
+    DvzColor over;        // color of the values above vmax (last color by default)
+    DvzColor nan;         // color of the NaN values (first color by default)
+};
+
+
+
+// Column of a record batch of an Arrow IPC file, pointing into the file mapping.
+struct DvzArrowColumn
+{
+    uint64_t length;         // number of rows
+    uint64_t null_count;     // number of null values
+    const uint8_t* validity; // validity bitmap (bit i set if row i is not null), NULL if no nulls
+    const void* data;        // values
+    DvzSize data_size;       // size of the values, in bytes
+};
+
+
+
 /*************************************************************************************************/
 /*  Events                                                                                       */
 /*************************************************************************************************/
@@ -300,6 +362,15 @@ struct DvzTimerEvent
     void* user_data;
 };
 
+struct DvzReadbackEvent
+{
+    uint64_t frame_idx;
+    uint32_t width;
+    uint32_t height;
+    uint8_t* rgb; // only valid during the callback
+    void* user_data;
+};
+
 
 
 /*************************************************************************************************/
@@ -518,6 +589,7 @@ struct DvzRequestBindIndex
 {
     DvzId dat;
     DvzSize offset;
+    DvzSize index_size; // 2 (uint16) or 4 (uint32) bytes
 };
 
 struct DvzRequestBindDat
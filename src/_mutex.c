@@ -101,6 +101,15 @@ int dvz_cond_signal(DvzCond* cond)
 
 
 
+int dvz_cond_broadcast(DvzCond* cond)
+{
+    ANN(cond);
+    // return tct_cnd_broadcast(cond);
+    return pthread_cond_broadcast(cond);
+}
+
+
+
 int dvz_cond_wait(DvzCond* cond, DvzMutex* mutex)
 {
     ANN(cond);
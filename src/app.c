@@ -22,6 +22,7 @@
 #include "fileio.h"
 #include "gui.h"
 #include "host.h"
+#include "imwriter.h"
 #include "presenter.h"
 #include "render_utils.h"
 #include "renderer.h"
@@ -511,32 +512,30 @@ void dvz_app_screenshot(DvzApp* app, DvzId canvas_id, const char* filename)
 
     ASSERT(canvas_id != DVZ_ID_NONE);
 
+    DvzCanvas* canvas = dvz_renderer_canvas(rd, canvas_id);
+    ANN(canvas);
+    uint8_t* rgb = NULL;
+
     if (app->host->backend == DVZ_BACKEND_GLFW)
     {
-        DvzCanvas* canvas = dvz_renderer_canvas(rd, canvas_id);
-        ANN(canvas);
-
         // Get the canvas image buffer.
-        uint8_t* rgb = dvz_canvas_download(canvas);
-
-        // Save to a PNG.
-        dvz_write_png(filename, canvas->width, canvas->height, rgb);
+        rgb = dvz_canvas_download(canvas);
     }
     else if (app->host->backend == DVZ_BACKEND_OFFSCREEN)
     {
-        DvzCanvas* board = dvz_renderer_canvas(rd, canvas_id);
-        ANN(board);
-
         // Get the board image buffer.
-        uint8_t* rgb = dvz_board_alloc(board);
-        dvz_board_download(board, board->size, rgb);
-
-        // Save to a PNG.
-        dvz_write_png(filename, board->width, board->height, rgb);
-        // dvz_board_free(board);
+        rgb = dvz_board_alloc(canvas);
+        dvz_board_download(canvas, canvas->size, rgb);
+    }
+    if (rgb == NULL)
+        return;
 
+    // Encode and save the image on this thread, as the caller may read the file right away. The
+    // format depends on the file extension.
+    int res = dvz_write_image(
+        filename, canvas->width, canvas->height, rgb, -1, DVZ_PNG_FILTER_NONE);
+    if (res == 0)
         log_info("screenshot saved to %s (%s)", filename, pretty_size(dvz_file_size(filename)));
-    }
 }
 
 
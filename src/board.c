@@ -45,6 +45,9 @@ dvz_board(DvzGpu* gpu, DvzRenderpass* renderpass, uint32_t width, uint32_t heigh
     // dvz_board_clear_color(&board, DVZ_DEFAULT_CLEAR_COLOR);
 
     board.cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+    // NOTE: with pipelined rendering, the board commands are pending once per frame in flight,
+    // see dvz_board_readback_submit().
+    dvz_commands_usage(&board.cmds, VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
 
     dvz_obj_init(&board.obj);
     return board;
@@ -251,3 +254,168 @@ void dvz_board_destroy(DvzCanvas* board)
     dvz_board_free(board);
     dvz_obj_destroyed(&board->obj);
 }
+
+
+
+/*************************************************************************************************/
+/*  Readback                                                                                     */
+/*************************************************************************************************/
+
+static void _readback_create(DvzCanvas* board, DvzBoardReadback* readback)
+{
+    ANN(board);
+    ANN(readback);
+
+    DvzGpu* gpu = board->gpu;
+    ANN(gpu);
+
+    if (readback->gpu == NULL)
+    {
+        readback->gpu = gpu;
+        // NOTE: the copy commands are submitted with the board commands, on the render queue.
+        readback->cmds = dvz_commands(gpu, DVZ_DEFAULT_QUEUE_RENDER, 1);
+        readback->fences = dvz_fences(gpu, 1, true);
+    }
+    ASSERT(readback->gpu == gpu);
+
+    if (readback->width == board->width && readback->height == board->height)
+        return;
+
+    log_debug("creating %dx%d readback staging image", board->width, board->height);
+    if (readback->width > 0)
+        dvz_images_destroy(&readback->staging);
+
+    readback->staging = dvz_images(gpu, VK_IMAGE_TYPE_2D, 1);
+    dvz_images_format(&readback->staging, (VkFormat)board->format);
+    dvz_images_size(&readback->staging, (uvec3){board->width, board->height, 1});
+    dvz_images_tiling(&readback->staging, VK_IMAGE_TILING_LINEAR);
+    dvz_images_usage(&readback->staging, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    dvz_images_layout(&readback->staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    dvz_images_queue_access(&readback->staging, DVZ_DEFAULT_QUEUE_RENDER);
+    dvz_images_vma_usage(&readback->staging, VMA_MEMORY_USAGE_CPU_ONLY);
+    dvz_images_create(&readback->staging);
+
+    readback->width = board->width;
+    readback->height = board->height;
+}
+
+
+
+void dvz_board_readback_submit(DvzCanvas* board, DvzBoardReadback* readback)
+{
+    ANN(board);
+    ANN(readback);
+    ASSERT(board->obj.type == DVZ_OBJECT_TYPE_BOARD);
+    ASSERT(readback->board == NULL);
+
+    _readback_create(board, readback);
+    DvzGpu* gpu = board->gpu;
+    DvzCommands* cmds = &readback->cmds;
+
+    // The staging image is no longer in use once the fence has been signaled.
+    dvz_fences_wait(&readback->fences, 0);
+    dvz_cmd_reset(cmds, 0);
+    dvz_cmd_begin(cmds, 0);
+
+    // Wait for the render pass before copying the board image.
+    DvzBarrier src_barrier = dvz_barrier(gpu);
+    dvz_barrier_stages(
+        &src_barrier, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+    dvz_barrier_images(&src_barrier, &board->render.images);
+    dvz_barrier_images_layout(
+        &src_barrier, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    dvz_barrier_images_access(
+        &src_barrier, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    dvz_cmd_barrier(cmds, 0, &src_barrier);
+
+    DvzBarrier barrier = dvz_barrier(gpu);
+    dvz_barrier_stages(&barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    dvz_barrier_images(&barrier, &readback->staging);
+    dvz_barrier_images_layout(
+        &barrier, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    dvz_barrier_images_access(&barrier, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    dvz_cmd_barrier(cmds, 0, &barrier);
+
+    dvz_cmd_copy_image(cmds, 0, &board->render.images, &readback->staging);
+
+    // Make the copy visible to the host.
+    dvz_barrier_stages(&barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    dvz_barrier_images_layout(
+        &barrier, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    dvz_barrier_images_access(&barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+    dvz_cmd_barrier(cmds, 0, &barrier);
+
+    // The next frames may be submitted before this one has completed. Their render pass must wait
+    // for the copy of the board image, and for the depth writes of this frame.
+    DvzBarrier dst_barrier = dvz_barrier(gpu);
+    dvz_barrier_stages(
+        &dst_barrier, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    dvz_barrier_images(&dst_barrier, &board->render.images);
+    dvz_barrier_images_layout(
+        &dst_barrier, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    dvz_barrier_images_access(&dst_barrier, 0, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    dvz_barrier_images(&dst_barrier, &board->render.depth);
+    dvz_barrier_images_layout(
+        &dst_barrier, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    dvz_barrier_images_access(
+        &dst_barrier, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+    dvz_barrier_images_aspect(&dst_barrier, VK_IMAGE_ASPECT_DEPTH_BIT);
+    dvz_cmd_barrier(cmds, 0, &dst_barrier);
+    dvz_cmd_end(cmds, 0);
+
+    // Render and copy in a single submission, the fence is signaled when both are done.
+    DvzSubmit submit = dvz_submit(gpu);
+    dvz_submit_commands(&submit, &board->cmds);
+    dvz_submit_commands(&submit, cmds);
+    dvz_submit_send(&submit, 0, &readback->fences, 0);
+
+    readback->board = board;
+}
+
+
+
+bool dvz_board_readback_ready(DvzBoardReadback* readback)
+{
+    ANN(readback);
+    if (readback->board == NULL)
+        return true;
+    return dvz_fences_ready(&readback->fences, 0);
+}
+
+
+
+void dvz_board_readback_download(DvzBoardReadback* readback, uint8_t* rgb)
+{
+    ANN(readback);
+    ANN(rgb);
+    ANN(readback->board);
+
+    dvz_fences_wait(&readback->fences, 0);
+
+    // NOTE: the GPU image is in RGBA but it is converted into RGB here, see dvz_board_download().
+    dvz_images_download(&readback->staging, 0, 1, true, false, rgb);
+    readback->board = NULL;
+}
+
+
+
+void dvz_board_readback_destroy(DvzBoardReadback* readback)
+{
+    ANN(readback);
+    if (readback->gpu == NULL)
+        return;
+    log_trace("destroy board readback");
+
+    dvz_fences_wait(&readback->fences, 0);
+    if (readback->width > 0)
+        dvz_images_destroy(&readback->staging);
+    dvz_fences_destroy(&readback->fences);
+    dvz_commands_destroy(&readback->cmds);
+    memset(readback, 0, sizeof(DvzBoardReadback));
+}
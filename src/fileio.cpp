@@ -12,6 +12,14 @@
 #include <zlib.h>
 #endif
 
+#if OS_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 
 
 /*************************************************************************************************/
@@ -62,197 +70,607 @@ void* dvz_read_file(const char* filename, DvzSize* size)
 
 
 
-char* dvz_read_npy(const char* filename, DvzSize* size)
+void* dvz_file_map(const char* filename, DvzSize* size)
 {
-    /* Tiny NPY reader that requires the user to know in advance the data type of the file. */
-
-    /* The returned pointer must be freed by the caller. */
-    char* buffer = NULL;
+    ANN(filename);
+    void* data = NULL;
     DvzSize length = 0;
-    int nread = 0, err = 0;
 
-    FILE* f = fopen(filename, "rb");
-    if (!f)
+#if OS_WINDOWS
+    HANDLE file = CreateFileA(
+        filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    LARGE_INTEGER file_size = {};
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
     {
-        log_error("the file %s does not exist", filename);
+        length = (DvzSize)file_size.QuadPart;
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL)
+        {
+            // NOTE: the view keeps the mapping alive after the handles are closed.
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
         return NULL;
+    struct stat st = {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        length = (DvzSize)st.st_size;
+        data = mmap(NULL, (size_t)length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+            data = NULL;
     }
+    close(fd);
+#endif
 
-    // Determine the total file size.
-    fseek(f, 0, SEEK_END);
-    length = (DvzSize)ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    // const uint32_t MAGIC_SIZE = 6;
-    // char magic[MAGIC_SIZE];
-
-    // // Read NPY header.
-    // nread = fread(magic, sizeof(char), MAGIC_SIZE, f);
-    // if (!nread)
-    //     goto error;
-
-    // TODO: check the magic
-    // TODO: check the version numbers
-
-    // Determine the header size.
-    uint16_t header_len = 0;
-    err = fseek(f, 8, SEEK_SET);
-    if (err)
-        goto error;
-    nread = fread(&header_len, sizeof(uint16_t), 1, f);
-    if (!nread)
-        goto error;
-    log_trace("npy file header size is %d bytes", header_len);
-    ASSERT(header_len > 0);
-    header_len += 10; // NOTE: the header len does NOT include the 10 bytes with the magic string,
-                      // the version, the header length
-
-    // Jump to the beginning of the data buffer.
-    fseek(f, 0, header_len);
-    length -= header_len;
+    if (data == NULL)
+    {
+        log_error("unable to map the file %s", filename);
+        return NULL;
+    }
     if (size != NULL)
         *size = length;
-    err = fseek(f, header_len, SEEK_SET);
-    if (err)
-        goto error;
+    return data;
+}
 
-    // Read the data buffer.
-    buffer = (char*)calloc((size_t)length, 1);
-    ANN(buffer);
-    fread(buffer, 1, (size_t)length, f);
-    fclose(f);
 
-    return buffer;
 
-error:
-    log_error("unable to read the NPY file %s", filename);
+void dvz_file_unmap(void* data, DvzSize size)
+{
+    if (data == NULL)
+        return;
+#if OS_WINDOWS
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, (size_t)size);
+#endif
+}
+
+
+
+// Return a pointer to the value of a key in the NPY header dictionary, or NULL.
+static const char* _npy_key(const char* header, const char* end, const char* key)
+{
+    size_t key_len = strlen(key);
+    for (const char* c = header; c + key_len + 2 < end; c++)
+    {
+        if ((*c == '\'' || *c == '"') && memcmp(c + 1, key, key_len) == 0 &&
+            c[key_len + 1] == *c)
+        {
+            // Skip the closing quote, the colon and the spaces.
+            c += key_len + 2;
+            while (c < end && (*c == ' ' || *c == ':'))
+                c++;
+            return c < end ? c : NULL;
+        }
+    }
     return NULL;
 }
 
 
 
-char* dvz_parse_npy(DvzSize size, char* npy_bytes)
+int dvz_npy_header(DvzSize size, const char* npy_bytes, DvzNpyHeader* header)
 {
-    // Ensure the buffer is valid
-    if (size < 10 || npy_bytes == NULL)
+    ANN(header);
+    memset(header, 0, sizeof(DvzNpyHeader));
+    if (npy_bytes == NULL || size < 10 || memcmp(npy_bytes, "\x93NUMPY", 6) != 0)
     {
-        return NULL;
+        log_error("invalid NPY file");
+        return 1;
     }
 
-    // Check the .npy magic string
-    if (memcmp(npy_bytes, "\x93NUMPY", 6) != 0)
+    // The header length is stored on 2 bytes in version 1, and on 4 bytes in versions 2 and 3.
+    header->version = (uint8_t)npy_bytes[6];
+    DvzSize header_len = 0;
+    DvzSize preamble = 0;
+    if (header->version == 1)
     {
-        return NULL;
+        header_len = (uint8_t)npy_bytes[8] | ((DvzSize)(uint8_t)npy_bytes[9] << 8);
+        preamble = 10;
+    }
+    else if ((header->version == 2 || header->version == 3) && size >= 12)
+    {
+        for (uint32_t i = 0; i < 4; i++)
+            header_len |= (DvzSize)(uint8_t)npy_bytes[8 + i] << (8 * i);
+        preamble = 12;
     }
+    else
+    {
+        log_error("unsupported NPY format version %d", header->version);
+        return 1;
+    }
+    header->data_offset = preamble + header_len;
+    if (header->data_offset > size)
+    {
+        log_error("truncated NPY header");
+        return 1;
+    }
+    const char* dict = npy_bytes + preamble;
+    const char* end = npy_bytes + header->data_offset;
 
-    // Extract the header length (at byte 8 and 9 for v1.0/1.1)
-    uint16_t header_len = *(uint16_t*)((uint64_t)npy_bytes + 8);
+    // dtype, for instance '<f4'. Structured dtypes (lists) are not supported.
+    const char* descr = _npy_key(dict, end, "descr");
+    if (descr == NULL || (*descr != '\'' && *descr != '"') || descr + 4 >= end)
+    {
+        log_error("unsupported NPY dtype");
+        return 1;
+    }
+    char order = descr[1];
+    header->kind = descr[2];
+    header->item_size = (uint32_t)strtoul(descr + 3, NULL, 10);
+    header->big_endian = order == '>' && header->item_size > 1;
+    if (header->item_size == 0 || (order != '<' && order != '>' && order != '|' && order != '='))
+    {
+        log_error("unsupported NPY dtype");
+        return 1;
+    }
 
-    // Calculate the offset of the array data
-    DvzSize data_offset = 10 + header_len;
+    // Memory order.
+    const char* fortran_order = _npy_key(dict, end, "fortran_order");
+    header->fortran_order = fortran_order != NULL && *fortran_order == 'T';
 
-    // Ensure the offset is within bounds
-    if (data_offset > size)
+    // Shape, for instance (3, 4) or (3,) or () for a scalar.
+    const char* shape = _npy_key(dict, end, "shape");
+    if (shape == NULL || *shape != '(')
     {
-        return NULL;
+        log_error("invalid NPY shape");
+        return 1;
+    }
+    header->element_count = 1;
+    for (const char* c = shape + 1; c < end && *c != ')';)
+    {
+        if (*c == ' ' || *c == ',' || *c == 'L')
+        {
+            c++;
+            continue;
+        }
+        char* next = NULL;
+        uint64_t dim = strtoull(c, &next, 10);
+        if (next == c || header->ndim == DVZ_NPY_MAX_DIMS)
+        {
+            log_error("invalid or unsupported NPY shape");
+            return 1;
+        }
+        header->shape[header->ndim++] = dim;
+        header->element_count *= dim;
+        c = next;
+    }
+
+    header->data_size = header->element_count * header->item_size;
+    if (header->data_offset + header->data_size > size)
+    {
+        log_error("truncated NPY data");
+        return 1;
     }
+    return 0;
+}
 
-    // Calculate the size of the array data
-    DvzSize array_data_size = size - data_offset;
 
-    // Allocate memory for the output buffer
-    char* array_data = (char*)malloc(array_data_size);
-    if (array_data == NULL)
+
+char* dvz_read_npy(const char* filename, DvzSize* size)
+{
+    /* The returned pointer must be freed by the caller. */
+
+    // NOTE: the file is mapped so that the array data is copied only once, from the page cache.
+    DvzSize file_size = 0;
+    char* bytes = (char*)dvz_file_map(filename, &file_size);
+    if (bytes == NULL)
     {
+        log_error("unable to read the NPY file %s", filename);
         return NULL;
     }
 
+    DvzNpyHeader header = {};
+    char* buffer = NULL;
+    if (dvz_npy_header(file_size, bytes, &header) == 0)
+    {
+        buffer = (char*)malloc(MAX(1, header.data_size));
+        ANN(buffer);
+        memcpy(buffer, bytes + header.data_offset, header.data_size);
+        if (size != NULL)
+            *size = header.data_size;
+    }
+    else
+    {
+        log_error("unable to read the NPY file %s", filename);
+    }
+
+    dvz_file_unmap(bytes, file_size);
+    return buffer;
+}
+
+
+
+char* dvz_parse_npy(DvzSize size, char* npy_bytes)
+{
+    DvzNpyHeader header = {};
+    if (dvz_npy_header(size, npy_bytes, &header) != 0)
+        return NULL;
+
     // Copy the array data to the output buffer
-    memcpy(array_data, npy_bytes + data_offset, array_data_size);
+    char* array_data = (char*)malloc(MAX(1, header.data_size));
+    if (array_data == NULL)
+    {
+        return NULL;
+    }
+    memcpy(array_data, npy_bytes + header.data_offset, header.data_size);
 
     return array_data;
 }
 
 
 
-char* dvz_read_gz(const char* filename, DvzSize* size)
+#if HAS_ZLIB
+
+// Maximum number of decompressed bytes processed in parallel at once with BGZF files.
+#define GZ_WINDOW_SIZE (64 * 1024 * 1024)
+
+// zlib counts the input bytes with 32-bit integers.
+#define GZ_MAX_INPUT (1024 * 1024 * 1024)
+
+typedef struct GzBlock GzBlock;
+typedef struct GzBuffer GzBuffer;
+
+struct GzBlock
 {
+    DvzSize offset;      // offset of the compressed member in the file
+    DvzSize size;        // size of the compressed member
+    DvzSize output_size; // size of the decompressed member
+};
 
-#if HAS_ZLIB
-    if (!filename || !size)
+struct GzBuffer
+{
+    char* data;
+    DvzSize size;
+    DvzSize capacity;
+};
+
+
+
+// Return the list of members of a BGZF file, or NULL if the file is not a valid BGZF file.
+static GzBlock* _bgzf_blocks(const uint8_t* bytes, DvzSize size, uint32_t* out_count)
+{
+    ANN(bytes);
+    ANN(out_count);
+
+    uint32_t count = 0, capacity = 0;
+    GzBlock* blocks = NULL;
+    DvzSize offset = 0;
+    while (offset < size)
     {
-        fprintf(stderr, "Error: Invalid arguments.\n");
-        return NULL;
+        // Gzip header with the FEXTRA flag.
+        const uint8_t* h = bytes + offset;
+        if (size - offset < 18 || h[0] != 0x1f || h[1] != 0x8b || h[2] != 8 || !(h[3] & 4))
+            break;
+
+        // Look for the BC subfield holding the compressed member size minus 1.
+        uint32_t xlen = (uint32_t)h[10] | ((uint32_t)h[11] << 8);
+        DvzSize block_size = 0;
+        for (uint32_t k = 12; k + 4 <= 12 + xlen && offset + k + 4 <= size;)
+        {
+            uint32_t slen = (uint32_t)h[k + 2] | ((uint32_t)h[k + 3] << 8);
+            if (h[k] == 'B' && h[k + 1] == 'C' && slen == 2 && offset + k + 6 <= size)
+                block_size = ((DvzSize)h[k + 4] | ((DvzSize)h[k + 5] << 8)) + 1;
+            k += 4 + slen;
+        }
+        if (block_size < 26 || offset + block_size > size)
+            break;
+
+        if (count == capacity)
+        {
+            capacity = capacity > 0 ? 2 * capacity : 1024;
+            blocks = (GzBlock*)realloc(blocks, capacity * sizeof(GzBlock));
+            ANN(blocks);
+        }
+        const uint8_t* isize = h + block_size - 4;
+        blocks[count].offset = offset;
+        blocks[count].size = block_size;
+        blocks[count].output_size = (DvzSize)isize[0] | ((DvzSize)isize[1] << 8) |
+                                    ((DvzSize)isize[2] << 16) | ((DvzSize)isize[3] << 24);
+        count++;
+        offset += block_size;
     }
-    ANN(filename);
-    ANN(size);
 
-    // Open the gzip file for reading
-    gzFile gz_file = gzopen(filename, "rb");
-    if (gz_file == NULL)
+    if (offset != size || count == 0)
     {
-        perror("Failed to open gzip file");
+        FREE(blocks);
         return NULL;
     }
+    *out_count = count;
+    return blocks;
+}
+
+
 
-    // Allocate an initial buffer to decompress the file into memory
-    size_t buffer_size = 1024 * 1024; // Start with 1 MB
-    char* buffer = (char*)malloc(buffer_size);
-    if (buffer == NULL)
+// Decompress the gzip members in order, on a single thread.
+static int _gz_sequential(
+    const uint8_t* bytes, DvzSize size, DvzSize chunk_size, DvzChunkCallback callback,
+    void* user_data)
+{
+    z_stream strm = {};
+    // NOTE: 32 enables the automatic detection of the gzip or zlib header.
+    if (inflateInit2(&strm, 15 + 32) != Z_OK)
+        return 1;
+
+    uint8_t* chunk = (uint8_t*)malloc(chunk_size);
+    ANN(chunk);
+    DvzSize input = 0, offset = 0, filled = 0;
+    int ret = Z_OK, res = 0;
+    while (res == 0)
     {
-        perror("Failed to allocate memory");
-        gzclose(gz_file);
-        return NULL;
+        if (strm.avail_in == 0 && input < size)
+        {
+            strm.next_in = (Bytef*)(bytes + input);
+            strm.avail_in = (uInt)MIN(size - input, (DvzSize)GZ_MAX_INPUT);
+            input += strm.avail_in;
+        }
+        strm.next_out = chunk + filled;
+        strm.avail_out = (uInt)(chunk_size - filled);
+        ret = inflate(&strm, Z_NO_FLUSH);
+        filled = chunk_size - strm.avail_out;
+
+        if (filled == chunk_size)
+        {
+            res = callback(offset, filled, chunk, user_data);
+            offset += filled;
+            filled = 0;
+        }
+
+        if (ret == Z_STREAM_END)
+        {
+            // Next member, if any (trailing zero padding is ignored).
+            if ((strm.avail_in == 0 && input == size) ||
+                (strm.avail_in > 0 && strm.next_in[0] != 0x1f))
+                break;
+            inflateReset(&strm);
+        }
+        else if (ret == Z_BUF_ERROR && strm.avail_in == 0 && input == size)
+        {
+            log_error("truncated gzip file");
+            res = 1;
+        }
+        else if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            log_error("gzip decompression error (%d)", ret);
+            res = 1;
+        }
     }
 
-    size_t buffer_used = 0;
+    if (res == 0 && filled > 0)
+        res = callback(offset, filled, chunk, user_data);
+
+    inflateEnd(&strm);
+    FREE(chunk);
+    return res;
+}
+
+
 
-    // Read and decompress the gzip file into the buffer
-    while (1)
+static bool _gz_inflate_block(const uint8_t* input, GzBlock* block, uint8_t* output)
+{
+    z_stream strm = {};
+    // NOTE: 16 to decode the gzip header and check the CRC.
+    if (inflateInit2(&strm, 15 + 16) != Z_OK)
+        return false;
+    strm.next_in = (Bytef*)(input + block->offset);
+    strm.avail_in = (uInt)block->size;
+    strm.next_out = output;
+    strm.avail_out = (uInt)block->output_size;
+    int ret = inflate(&strm, Z_FINISH);
+    bool ok = ret == Z_STREAM_END && strm.total_out == block->output_size;
+    inflateEnd(&strm);
+    return ok;
+}
+
+
+
+// Decompress the BGZF members in parallel, by windows of consecutive members.
+static int _gz_parallel(
+    const uint8_t* bytes, uint32_t block_count, GzBlock* blocks, DvzSize chunk_size,
+    DvzChunkCallback callback, void* user_data)
+{
+    uint8_t* chunk = (uint8_t*)malloc(chunk_size);
+    DvzSize* offsets = (DvzSize*)calloc(block_count + 1, sizeof(DvzSize));
+    uint8_t* window = NULL;
+    DvzSize window_capacity = 0;
+    DvzSize offset = 0, filled = 0;
+    int res = 0;
+
+    for (uint32_t b0 = 0, b1 = 0; b0 < block_count && res == 0; b0 = b1)
     {
-        // Expand the buffer if necessary
-        if (buffer_used + 4096 > buffer_size)
+        // Members of the window.
+        offsets[b0] = 0;
+        for (b1 = b0; b1 < block_count && (b1 == b0 || offsets[b1] < GZ_WINDOW_SIZE); b1++)
+            offsets[b1 + 1] = offsets[b1] + blocks[b1].output_size;
+        DvzSize window_size = offsets[b1];
+        if (window_size > window_capacity)
+        {
+            window_capacity = window_size;
+            window = (uint8_t*)realloc(window, window_capacity);
+            ANN(window);
+        }
+
+        int error = 0;
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int64_t b = b0; b < (int64_t)b1; b++)
         {
-            buffer_size *= 2;
-            char* new_buffer = (char*)realloc(buffer, buffer_size);
-            if (new_buffer == NULL)
+            if (!_gz_inflate_block(bytes, &blocks[b], window + offsets[b]))
             {
-                perror("Failed to reallocate memory");
-                free(buffer);
-                gzclose(gz_file);
-                return NULL;
+#if HAS_OPENMP
+#pragma omp atomic write
+#endif
+                error = 1;
             }
-            buffer = new_buffer;
         }
-
-        // Read data from the gzip file
-        int bytes_read = gzread(gz_file, buffer + buffer_used, 4096);
-        if (bytes_read < 0)
+        if (error)
         {
-            fprintf(stderr, "Decompression error: %s\n", gzerror(gz_file, NULL));
-            free(buffer);
-            gzclose(gz_file);
-            return NULL;
+            log_error("BGZF decompression error");
+            res = 1;
+            break;
         }
 
-        if (bytes_read == 0)
+        // Pass the window to the callback in chunks, without copy when the chunks are aligned.
+        DvzSize pos = 0;
+        while (pos < window_size && res == 0)
         {
-            // End of file reached
-            break;
+            DvzSize n = MIN(chunk_size - filled, window_size - pos);
+            if (filled == 0 && n == chunk_size)
+            {
+                res = callback(offset, chunk_size, window + pos, user_data);
+                offset += chunk_size;
+            }
+            else
+            {
+                memcpy(chunk + filled, window + pos, n);
+                filled += n;
+                if (filled == chunk_size)
+                {
+                    res = callback(offset, chunk_size, chunk, user_data);
+                    offset += chunk_size;
+                    filled = 0;
+                }
+            }
+            pos += n;
         }
+    }
+
+    if (res == 0 && filled > 0)
+        res = callback(offset, filled, chunk, user_data);
+
+    FREE(chunk);
+    FREE(offsets);
+    FREE(window);
+    return res;
+}
 
-        buffer_used += (size_t)bytes_read;
+
+
+static int _gz_stream(
+    const uint8_t* bytes, DvzSize size, DvzSize chunk_size, DvzChunkCallback callback,
+    void* user_data)
+{
+    if (chunk_size == 0)
+        chunk_size = DVZ_GZ_CHUNK_SIZE;
+    // NOTE: zlib counts the output bytes with 32-bit integers.
+    chunk_size = MIN(chunk_size, (DvzSize)GZ_MAX_INPUT);
+
+    uint32_t block_count = 0;
+    GzBlock* blocks = _bgzf_blocks(bytes, size, &block_count);
+    int res = 0;
+    if (blocks != NULL)
+    {
+        log_debug("decompressing %d BGZF blocks in parallel", block_count);
+        res = _gz_parallel(bytes, block_count, blocks, chunk_size, callback, user_data);
     }
+    else
+    {
+        res = _gz_sequential(bytes, size, chunk_size, callback, user_data);
+    }
+    FREE(blocks);
+    return res;
+}
 
-    gzclose(gz_file);
 
-    // Set the size of the decompressed data
-    if (size != NULL)
+
+static int _gz_append(DvzSize offset, DvzSize size, const void* chunk, void* user_data)
+{
+    GzBuffer* buffer = (GzBuffer*)user_data;
+    ANN(buffer);
+    if (offset + size > buffer->capacity)
     {
-        *size = (DvzSize)buffer_used;
+        while (offset + size > buffer->capacity)
+            buffer->capacity *= 2;
+        buffer->data = (char*)realloc(buffer->data, buffer->capacity);
+        ANN(buffer->data);
     }
+    memcpy(buffer->data + offset, chunk, size);
+    buffer->size = offset + size;
+    return 0;
+}
 
-    return buffer;
+#endif
+
+
+
+int dvz_stream_gz(
+    const char* filename, DvzSize chunk_size, DvzChunkCallback callback, void* user_data)
+{
+    ANN(filename);
+    ANN(callback);
+
+#if HAS_ZLIB
+    DvzSize size = 0;
+    uint8_t* bytes = (uint8_t*)dvz_file_map(filename, &size);
+    if (bytes == NULL)
+        return 1;
+    int res = _gz_stream(bytes, size, chunk_size, callback, user_data);
+    dvz_file_unmap(bytes, size);
+    return res;
+#else
+    log_error(
+        "unable to load .gz file, Datoviz was not built with zlib support. Please activate " //
+        "CMake option DATOVIZ_WITH_ZLIB");
+    return 1;
+#endif
+}
+
+
+
+char* dvz_read_gz(const char* filename, DvzSize* size)
+{
+
+#if HAS_ZLIB
+    if (!filename || !size)
+    {
+        fprintf(stderr, "Error: Invalid arguments.\n");
+        return NULL;
+    }
+    ANN(filename);
+    ANN(size);
+
+    DvzSize file_size = 0;
+    uint8_t* bytes = (uint8_t*)dvz_file_map(filename, &file_size);
+    if (bytes == NULL)
+    {
+        log_error("failed to open gzip file %s", filename);
+        return NULL;
+    }
+
+    // Initial buffer size from the uncompressed size of the last member (modulo 2^32).
+    DvzSize capacity = 1024 * 1024;
+    if (file_size >= 4)
+    {
+        const uint8_t* isize = bytes + file_size - 4;
+        capacity = MAX(
+            capacity, (DvzSize)isize[0] | ((DvzSize)isize[1] << 8) | ((DvzSize)isize[2] << 16) |
+                          ((DvzSize)isize[3] << 24));
+    }
+    GzBuffer buffer = {};
+    buffer.capacity = capacity;
+    buffer.data = (char*)malloc(capacity);
+    ANN(buffer.data);
+
+    int res = _gz_stream(bytes, file_size, 0, _gz_append, &buffer);
+    dvz_file_unmap(bytes, file_size);
+    if (res != 0)
+    {
+        log_error("failed to decompress gzip file %s", filename);
+        FREE(buffer.data);
+        return NULL;
+    }
+
+    // Set the size of the decompressed data
+    *size = buffer.size;
+    return buffer.data;
 
 #else
 
@@ -279,6 +697,523 @@ int dvz_write_bytes(const char* filename, const char* mode, DvzSize size, const
 
 
 
+/*************************************************************************************************/
+/*  Arrow file I/O                                                                               */
+/*************************************************************************************************/
+
+// Message header and type identifiers, see Message.fbs and Schema.fbs in the Arrow format.
+#define ARROW_MAGIC                "ARROW1"
+#define ARROW_CONTINUATION         0xFFFFFFFF
+#define ARROW_MESSAGE_RECORD_BATCH 3
+#define ARROW_MAX_DEPTH            64
+
+typedef enum
+{
+    ARROW_TYPE_NULL = 1,
+    ARROW_TYPE_INT = 2,
+    ARROW_TYPE_FLOAT = 3,
+    ARROW_TYPE_BINARY = 4,
+    ARROW_TYPE_UTF8 = 5,
+    ARROW_TYPE_BOOL = 6,
+    ARROW_TYPE_DECIMAL = 7,
+    ARROW_TYPE_DATE = 8,
+    ARROW_TYPE_TIME = 9,
+    ARROW_TYPE_TIMESTAMP = 10,
+    ARROW_TYPE_INTERVAL = 11,
+    ARROW_TYPE_LIST = 12,
+    ARROW_TYPE_STRUCT = 13,
+    ARROW_TYPE_UNION = 14,
+    ARROW_TYPE_FIXED_SIZE_BINARY = 15,
+    ARROW_TYPE_FIXED_SIZE_LIST = 16,
+    ARROW_TYPE_MAP = 17,
+    ARROW_TYPE_DURATION = 18,
+    ARROW_TYPE_LARGE_BINARY = 19,
+    ARROW_TYPE_LARGE_UTF8 = 20,
+    ARROW_TYPE_LARGE_LIST = 21,
+    ARROW_TYPE_RUN_END_ENCODED = 22,
+    ARROW_TYPE_BINARY_VIEW = 23,
+    ARROW_TYPE_UTF8_VIEW = 24,
+    ARROW_TYPE_LIST_VIEW = 25,
+    ARROW_TYPE_LARGE_LIST_VIEW = 26,
+} ArrowType;
+
+typedef struct FbTable FbTable;
+
+// Flatbuffers table, with the buffer bounds.
+struct FbTable
+{
+    const uint8_t* buf;
+    DvzSize size;
+    DvzSize pos;
+    DvzSize vtable;
+    uint32_t vtable_size; // 0 if the table is invalid or absent
+};
+
+
+
+// NOTE: Arrow files are read on little-endian hosts only, as the data is exposed without copy.
+static inline int64_t _read_int(const uint8_t* p, uint32_t size)
+{
+    switch (size)
+    {
+    case 1:
+        return (int8_t)p[0];
+    case 2:
+    {
+        int16_t v = 0;
+        memcpy(&v, p, 2);
+        return v;
+    }
+    case 4:
+    {
+        int32_t v = 0;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    default:
+    {
+        int64_t v = 0;
+        memcpy(&v, p, 8);
+        return v;
+    }
+    }
+}
+
+
+
+static inline uint32_t _read_u32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+
+
+static FbTable _fb_table(const uint8_t* buf, DvzSize size, DvzSize pos)
+{
+    FbTable table = {buf, size, pos, 0, 0};
+    if (pos == 0 || pos + 4 > size)
+        return table;
+    int64_t vtable = (int64_t)pos - _read_int(buf + pos, 4);
+    if (vtable < 0 || (DvzSize)vtable + 4 > size)
+        return table;
+    uint32_t vtable_size = (uint32_t)(uint16_t)_read_int(buf + vtable, 2);
+    if (vtable_size < 4 || (DvzSize)vtable + vtable_size > size)
+        return table;
+    table.vtable = (DvzSize)vtable;
+    table.vtable_size = vtable_size;
+    return table;
+}
+
+
+
+// Position of a field of a table in the buffer, 0 if the field is absent.
+static DvzSize _fb_field(FbTable* table, uint32_t field, uint32_t size)
+{
+    if (4 + 2 * field + 2 > table->vtable_size)
+        return 0;
+    DvzSize offset = (uint16_t)_read_int(table->buf + table->vtable + 4 + 2 * field, 2);
+    if (offset == 0 || table->pos + offset + size > table->size)
+        return 0;
+    return table->pos + offset;
+}
+
+
+
+static int64_t _fb_scalar(FbTable* table, uint32_t field, uint32_t size, int64_t value)
+{
+    DvzSize pos = _fb_field(table, field, size);
+    return pos > 0 ? _read_int(table->buf + pos, size) : value;
+}
+
+
+
+// Position of the object (table, vector, string) referenced by a field, 0 if absent.
+static DvzSize _fb_ref(FbTable* table, uint32_t field)
+{
+    DvzSize pos = _fb_field(table, field, 4);
+    if (pos == 0)
+        return 0;
+    DvzSize ref = pos + _read_u32(table->buf + pos);
+    return ref < table->size ? ref : 0;
+}
+
+
+
+static FbTable _fb_subtable(FbTable* table, uint32_t field)
+{
+    return _fb_table(table->buf, table->size, _fb_ref(table, field));
+}
+
+
+
+// Position of the first element of a vector, with the number of elements.
+static DvzSize _fb_vector(FbTable* table, uint32_t field, DvzSize item_size, uint32_t* count)
+{
+    *count = 0;
+    DvzSize ref = _fb_ref(table, field);
+    if (ref == 0 || ref + 4 > table->size)
+        return 0;
+    uint32_t n = _read_u32(table->buf + ref);
+    if (ref + 4 + n * item_size > table->size)
+        return 0;
+    *count = n;
+    return ref + 4;
+}
+
+
+
+static FbTable _fb_vector_table(FbTable* table, DvzSize vector, uint32_t index)
+{
+    DvzSize pos = vector + 4 * index;
+    return _fb_table(table->buf, table->size, pos + _read_u32(table->buf + pos));
+}
+
+
+
+static const char* _fb_string(FbTable* table, uint32_t field)
+{
+    DvzSize ref = _fb_ref(table, field);
+    if (ref == 0 || ref + 4 > table->size)
+        return "";
+    DvzSize len = _read_u32(table->buf + ref);
+    // NOTE: flatbuffers strings are null-terminated.
+    if (ref + 4 + len >= table->size || table->buf[ref + 4 + len] != 0)
+        return "";
+    return (const char*)(table->buf + ref + 4);
+}
+
+
+
+// Count the field nodes and buffers of a field and of its children, in depth-first order.
+static bool _arrow_walk(FbTable* field, uint32_t* node_count, uint32_t* buffer_count, int depth)
+{
+    if (field->vtable_size == 0 || depth > ARROW_MAX_DEPTH)
+        return false;
+
+    // NOTE: dictionary-encoded fields store the integer indices.
+    if (_fb_ref(field, 4) != 0)
+    {
+        *node_count += 1;
+        *buffer_count += 2;
+        return true;
+    }
+
+    uint32_t buffers = 0;
+    int64_t type = _fb_scalar(field, 2, 1, 0);
+    switch (type)
+    {
+    case ARROW_TYPE_NULL:
+    case ARROW_TYPE_RUN_END_ENCODED:
+        buffers = 0;
+        break;
+    case ARROW_TYPE_STRUCT:
+    case ARROW_TYPE_FIXED_SIZE_LIST:
+        buffers = 1;
+        break;
+    case ARROW_TYPE_INT:
+    case ARROW_TYPE_FLOAT:
+    case ARROW_TYPE_BOOL:
+    case ARROW_TYPE_DECIMAL:
+    case ARROW_TYPE_DATE:
+    case ARROW_TYPE_TIME:
+    case ARROW_TYPE_TIMESTAMP:
+    case ARROW_TYPE_INTERVAL:
+    case ARROW_TYPE_FIXED_SIZE_BINARY:
+    case ARROW_TYPE_DURATION:
+    case ARROW_TYPE_LIST:
+    case ARROW_TYPE_MAP:
+    case ARROW_TYPE_LARGE_LIST:
+        buffers = 2;
+        break;
+    case ARROW_TYPE_BINARY:
+    case ARROW_TYPE_UTF8:
+    case ARROW_TYPE_LARGE_BINARY:
+    case ARROW_TYPE_LARGE_UTF8:
+    case ARROW_TYPE_LIST_VIEW:
+    case ARROW_TYPE_LARGE_LIST_VIEW:
+        buffers = 3;
+        break;
+    case ARROW_TYPE_UNION:
+    {
+        // Sparse unions have a type buffer, dense unions an offset buffer in addition.
+        FbTable desc = _fb_subtable(field, 3);
+        buffers = _fb_scalar(&desc, 0, 2, 0) == 1 ? 2 : 1;
+        break;
+    }
+    default:
+        // NOTE: the view types have a variable number of buffers.
+        log_error("unsupported Arrow type %d", (int)type);
+        return false;
+    }
+    *node_count += 1;
+    *buffer_count += buffers;
+
+    uint32_t child_count = 0;
+    DvzSize children = _fb_vector(field, 5, 4, &child_count);
+    for (uint32_t i = 0; i < child_count; i++)
+    {
+        FbTable child = _fb_vector_table(field, children, i);
+        if (!_arrow_walk(&child, node_count, buffer_count, depth + 1))
+            return false;
+    }
+    return true;
+}
+
+
+
+// Parse the type of a field holding numbers or booleans, the kind is 0 for other types.
+static void _arrow_type(FbTable* field, DvzArrowField* out)
+{
+    out->kind = 0;
+    out->item_size = 0;
+    out->components = 1;
+    out->data_buffer = out->validity_buffer + 1;
+    if (_fb_ref(field, 4) != 0)
+        return;
+
+    int64_t type = _fb_scalar(field, 2, 1, 0);
+    FbTable desc = _fb_subtable(field, 3);
+    if (type == ARROW_TYPE_INT)
+    {
+        int64_t bit_width = _fb_scalar(&desc, 0, 4, 0);
+        if (bit_width != 8 && bit_width != 16 && bit_width != 32 && bit_width != 64)
+            return;
+        out->kind = _fb_scalar(&desc, 1, 1, 0) != 0 ? 'i' : 'u';
+        out->item_size = (uint32_t)bit_width / 8;
+    }
+    else if (type == ARROW_TYPE_FLOAT)
+    {
+        // Half, single, double precision.
+        int64_t precision = _fb_scalar(&desc, 0, 2, 0);
+        if (precision < 0 || precision > 2)
+            return;
+        out->kind = 'f';
+        out->item_size = 2u << precision;
+    }
+    else if (type == ARROW_TYPE_BOOL)
+    {
+        out->kind = 'b';
+    }
+    else if (type == ARROW_TYPE_FIXED_SIZE_LIST)
+    {
+        // Fixed-size lists of numbers, e.g. positions, are exposed as vectors.
+        int64_t list_size = _fb_scalar(&desc, 0, 4, 0);
+        uint32_t child_count = 0;
+        DvzSize children = _fb_vector(field, 5, 4, &child_count);
+        if (child_count != 1 || list_size <= 0 || list_size > UINT32_MAX)
+            return;
+        FbTable child = _fb_vector_table(field, children, 0);
+        DvzArrowField value = {};
+        _arrow_type(&child, &value);
+        if (value.kind == 0 || value.kind == 'b' || value.components != 1)
+            return;
+        out->kind = value.kind;
+        out->item_size = value.item_size;
+        out->components = (uint32_t)list_size;
+
+        // The values are in the data buffer of the child, after the validity buffers.
+        out->data_buffer = out->validity_buffer + 2;
+    }
+}
+
+
+
+// Parse the record batch message at the given offset in the file.
+static bool
+_arrow_batch(const uint8_t* bytes, DvzSize size, const uint8_t* block, DvzArrowBatch* batch)
+{
+    int64_t offset = _read_int(block, 8);
+    int64_t meta_size = _read_int(block + 8, 4);
+    int64_t body_size = _read_int(block + 16, 8);
+    if (offset < 8 || meta_size < 8 || body_size < 0 ||
+        (DvzSize)offset + (DvzSize)meta_size + (DvzSize)body_size > size)
+        return false;
+
+    // Encapsulated message: optional continuation marker, metadata size, flatbuffer.
+    const uint8_t* meta = bytes + offset;
+    DvzSize prefix = _read_u32(meta) == ARROW_CONTINUATION ? 8 : 4;
+    FbTable root = _fb_table(meta + prefix, (DvzSize)meta_size - prefix, _read_u32(meta + prefix));
+    if (_fb_scalar(&root, 1, 1, 0) != ARROW_MESSAGE_RECORD_BATCH)
+        return false;
+    FbTable header = _fb_subtable(&root, 2);
+    if (header.vtable_size == 0)
+        return false;
+
+    batch->length = (uint64_t)_fb_scalar(&header, 0, 8, 0);
+    batch->body = bytes + offset + meta_size;
+    batch->body_size = (DvzSize)body_size;
+    DvzSize nodes = _fb_vector(&header, 1, 16, &batch->node_count);
+    DvzSize buffers = _fb_vector(&header, 2, 16, &batch->buffer_count);
+    batch->nodes = header.buf + nodes;
+    batch->buffers = header.buf + buffers;
+    batch->compressed = _fb_ref(&header, 3) != 0;
+    return true;
+}
+
+
+
+// Buffer of a record batch, NULL if it is absent or out of bounds.
+static const uint8_t* _arrow_buffer(DvzArrowBatch* batch, uint32_t index, DvzSize* size)
+{
+    *size = 0;
+    if (index >= batch->buffer_count)
+        return NULL;
+    int64_t offset = _read_int(batch->buffers + 16 * index, 8);
+    int64_t length = _read_int(batch->buffers + 16 * index + 8, 8);
+    if (offset < 0 || length <= 0 || (DvzSize)offset + (DvzSize)length > batch->body_size)
+        return NULL;
+    *size = (DvzSize)length;
+    return batch->body + offset;
+}
+
+
+
+DvzArrowFile* dvz_arrow_open(const char* filename)
+{
+    ANN(filename);
+
+    DvzSize size = 0;
+    uint8_t* bytes = (uint8_t*)dvz_file_map(filename, &size);
+    if (bytes == NULL)
+        return NULL;
+
+    // File layout: magic, padding, stream, footer, footer size, magic.
+    DvzArrowFile* arrow = (DvzArrowFile*)calloc(1, sizeof(DvzArrowFile));
+    ANN(arrow);
+    arrow->mapping = bytes;
+    arrow->size = size;
+    int64_t footer_size = size >= 18 ? _read_int(bytes + size - 10, 4) : 0;
+    if (size < 18 || memcmp(bytes, ARROW_MAGIC, 6) != 0 ||
+        memcmp(bytes + size - 6, ARROW_MAGIC, 6) != 0 || footer_size < 4 ||
+        (DvzSize)footer_size > size - 18)
+    {
+        log_error("invalid Arrow file %s", filename);
+        dvz_arrow_close(arrow);
+        return NULL;
+    }
+    const uint8_t* footer_bytes = bytes + size - 10 - footer_size;
+    FbTable footer = _fb_table(footer_bytes, (DvzSize)footer_size, _read_u32(footer_bytes));
+    FbTable schema = _fb_subtable(&footer, 1);
+    if (schema.vtable_size == 0 || _fb_scalar(&schema, 0, 2, 0) != 0)
+    {
+        log_error("invalid or big-endian Arrow file %s", filename);
+        dvz_arrow_close(arrow);
+        return NULL;
+    }
+
+    // Schema: the field nodes and buffers of each column in the record batches.
+    uint32_t node_count = 0, buffer_count = 0;
+    DvzSize fields = _fb_vector(&schema, 1, 4, &arrow->field_count);
+    arrow->fields = (DvzArrowField*)calloc(MAX(1, arrow->field_count), sizeof(DvzArrowField));
+    ANN(arrow->fields);
+    for (uint32_t i = 0; i < arrow->field_count; i++)
+    {
+        FbTable field = _fb_vector_table(&schema, fields, i);
+        arrow->fields[i].node = node_count;
+        arrow->fields[i].validity_buffer = buffer_count;
+        if (!_arrow_walk(&field, &node_count, &buffer_count, 0))
+        {
+            log_error("unable to parse the schema of the Arrow file %s", filename);
+            dvz_arrow_close(arrow);
+            return NULL;
+        }
+        arrow->fields[i].name = _fb_string(&field, 0);
+        _arrow_type(&field, &arrow->fields[i]);
+    }
+
+    // Record batches: offset (8 bytes), metadata size (4 bytes and padding), body size (8 bytes).
+    DvzSize blocks = _fb_vector(&footer, 3, 24, &arrow->batch_count);
+    arrow->batches = (DvzArrowBatch*)calloc(MAX(1, arrow->batch_count), sizeof(DvzArrowBatch));
+    ANN(arrow->batches);
+    for (uint32_t i = 0; i < arrow->batch_count; i++)
+    {
+        DvzArrowBatch* batch = &arrow->batches[i];
+        if (!_arrow_batch(bytes, size, footer_bytes + blocks + 24 * i, batch) ||
+            batch->node_count < node_count || batch->buffer_count < buffer_count)
+        {
+            log_error("invalid record batch %d in the Arrow file %s", i, filename);
+            dvz_arrow_close(arrow);
+            return NULL;
+        }
+    }
+
+    log_debug(
+        "opened Arrow file %s with %d columns and %d record batches", filename,
+        arrow->field_count, arrow->batch_count);
+    return arrow;
+}
+
+
+
+int dvz_arrow_column(DvzArrowFile* arrow, uint32_t batch, uint32_t field, DvzArrowColumn* column)
+{
+    ANN(arrow);
+    ANN(column);
+    memset(column, 0, sizeof(DvzArrowColumn));
+
+    if (batch >= arrow->batch_count || field >= arrow->field_count)
+    {
+        log_error("invalid Arrow record batch %d or column %d", batch, field);
+        return 1;
+    }
+    DvzArrowBatch* b = &arrow->batches[batch];
+    DvzArrowField* f = &arrow->fields[field];
+    if (f->kind == 0)
+    {
+        log_error("unsupported type of the Arrow column %s", f->name);
+        return 1;
+    }
+    if (b->compressed)
+    {
+        log_error("compressed Arrow record batches are not supported");
+        return 1;
+    }
+
+    column->length = (uint64_t)_read_int(b->nodes + 16 * f->node, 8);
+    column->null_count = (uint64_t)_read_int(b->nodes + 16 * f->node + 8, 8);
+    DvzSize bitmap_size = (column->length + 7) / 8;
+
+    // The validity bitmap may be omitted when there are no nulls.
+    DvzSize size = 0;
+    column->validity = _arrow_buffer(b, f->validity_buffer, &size);
+    if (column->null_count == 0)
+        column->validity = NULL;
+    else if (column->validity == NULL || size < bitmap_size)
+    {
+        log_error("invalid validity bitmap of the Arrow column %s", f->name);
+        return 1;
+    }
+
+    DvzSize expected = f->kind == 'b' ? bitmap_size : column->length * f->components * f->item_size;
+    column->data = _arrow_buffer(b, f->data_buffer, &size);
+    // NOTE: the Arrow format aligns the buffers on 8 bytes.
+    if (expected > 0 && (column->data == NULL || size < expected ||
+                         (f->item_size > 0 && (uintptr_t)column->data % f->item_size != 0)))
+    {
+        log_error("invalid data buffer of the Arrow column %s", f->name);
+        return 1;
+    }
+    column->data_size = expected;
+    return 0;
+}
+
+
+
+void dvz_arrow_close(DvzArrowFile* arrow)
+{
+    if (arrow == NULL)
+        return;
+    if (arrow->mapping != NULL)
+        dvz_file_unmap(arrow->mapping, arrow->size);
+    FREE(arrow->fields);
+    FREE(arrow->batches);
+    FREE(arrow);
+}
+
+
+
 /*************************************************************************************************/
 /*  Image file I/O utils                                                                         */
 /*************************************************************************************************/
@@ -408,6 +1343,259 @@ int dvz_make_png(uint32_t width, uint32_t height, const uint8_t* rgb, DvzSize* s
 
 
 
+#if HAS_ZLIB
+static inline void _write_be32(uint8_t* dst, uint32_t value)
+{
+    for (uint32_t i = 0; i < 4; i++)
+        dst[i] = (uint8_t)(value >> (24 - 8 * i));
+}
+
+
+
+// Write a PNG chunk with its length and CRC, return the end of the chunk.
+static uint8_t* _png_chunk(uint8_t* dst, const char* type, const uint8_t* data, uint32_t size)
+{
+    // NOTE: the data may already be in place, after the chunk header.
+    _write_be32(dst, size);
+    memcpy(dst + 4, type, 4);
+    if (size > 0 && data != dst + 8)
+        memmove(dst + 8, data, size);
+    _write_be32(dst + 8 + size, (uint32_t)crc32(0, dst + 4, 4 + size));
+    return dst + 12 + size;
+}
+
+
+
+static inline uint8_t _paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return (uint8_t)(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+}
+
+
+
+// Filter a scanline, `prev` is the previous unfiltered scanline or NULL for the first one.
+static void _png_filter(
+    DvzPngFilter filter, uint32_t row_size, const uint8_t* row, const uint8_t* prev,
+    uint8_t* out)
+{
+    out[0] = (uint8_t)filter;
+    out++;
+    for (uint32_t i = 0; i < row_size; i++)
+    {
+        int a = i >= 3 ? row[i - 3] : 0;
+        int b = prev != NULL ? prev[i] : 0;
+        int c = i >= 3 && prev != NULL ? prev[i - 3] : 0;
+        switch (filter)
+        {
+        case DVZ_PNG_FILTER_SUB:
+            out[i] = (uint8_t)(row[i] - a);
+            break;
+        case DVZ_PNG_FILTER_UP:
+            out[i] = (uint8_t)(row[i] - b);
+            break;
+        case DVZ_PNG_FILTER_AVERAGE:
+            out[i] = (uint8_t)(row[i] - (a + b) / 2);
+            break;
+        case DVZ_PNG_FILTER_PAETH:
+            out[i] = (uint8_t)(row[i] - _paeth(a, b, c));
+            break;
+        default:
+            out[i] = row[i];
+            break;
+        }
+    }
+}
+#endif
+
+
+
+int dvz_encode_png(
+    uint32_t width, uint32_t height, const uint8_t* rgb, int level, DvzPngFilter filter,
+    DvzSize* size, void** out)
+{
+    ANN(rgb);
+    ANN(size);
+    ANN(out);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+#if HAS_ZLIB
+    if (level >= 0)
+    {
+        // Filtered scanlines, each one preceded by its filter type.
+        uint32_t row_size = 3 * width;
+        DvzSize raw_size = (DvzSize)height * (row_size + 1);
+        uint8_t* raw = (uint8_t*)malloc(raw_size);
+        uint8_t* tmp = (uint8_t*)malloc(row_size + 1);
+        ANN(raw);
+        ANN(tmp);
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const uint8_t* row = rgb + (DvzSize)y * row_size;
+            const uint8_t* prev = y > 0 ? row - row_size : NULL;
+            uint8_t* dst = raw + (DvzSize)y * (row_size + 1);
+            if (filter != DVZ_PNG_FILTER_ADAPTIVE)
+            {
+                _png_filter(filter, row_size, row, prev, dst);
+                continue;
+            }
+
+            // Minimum sum of absolute differences heuristic, as in libpng.
+            uint64_t best = UINT64_MAX;
+            for (int f = DVZ_PNG_FILTER_NONE; f <= DVZ_PNG_FILTER_PAETH; f++)
+            {
+                _png_filter((DvzPngFilter)f, row_size, row, prev, tmp);
+                uint64_t sum = 0;
+                for (uint32_t i = 1; i <= row_size; i++)
+                    sum += (uint64_t)abs((int8_t)tmp[i]);
+                if (sum < best)
+                {
+                    best = sum;
+                    memcpy(dst, tmp, row_size + 1);
+                }
+            }
+        }
+        FREE(tmp);
+
+        z_stream strm = {};
+        int strategy = filter == DVZ_PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+        if (deflateInit2(&strm, MIN(level, 9), Z_DEFLATED, 15, 8, strategy) != Z_OK)
+        {
+            FREE(raw);
+            return 1;
+        }
+        DvzSize bound = deflateBound(&strm, (uLong)raw_size);
+        uint8_t* png = (uint8_t*)malloc(8 + 25 + 12 + bound + 12);
+        ANN(png);
+
+        // Signature and header.
+        memcpy(png, "\x89PNG\r\n\x1a\n", 8);
+        // Size, 8-bit depth, RGB, default compression, filtering and interlacing.
+        uint8_t ihdr[13] = {0, 0, 0, 0, 0, 0, 0, 0, 8, 2, 0, 0, 0};
+        _write_be32(ihdr, width);
+        _write_be32(ihdr + 4, height);
+        uint8_t* end = _png_chunk(png + 8, "IHDR", ihdr, 13);
+
+        // Compressed data, written in place after the IDAT chunk header.
+        strm.next_in = raw;
+        strm.avail_in = (uInt)raw_size;
+        strm.next_out = end + 8;
+        strm.avail_out = (uInt)bound;
+        int ret = deflate(&strm, Z_FINISH);
+        uint32_t idat_size = (uint32_t)strm.total_out;
+        deflateEnd(&strm);
+        FREE(raw);
+        if (ret != Z_STREAM_END)
+        {
+            FREE(png);
+            return 1;
+        }
+        end = _png_chunk(end, "IDAT", end + 8, idat_size);
+        end = _png_chunk(end, "IEND", NULL, 0);
+
+        *size = (DvzSize)(end - png);
+        *out = png;
+        return 0;
+    }
+#endif
+
+    return dvz_make_png(width, height, rgb, size, out);
+}
+
+
+
+int dvz_make_qoi(uint32_t width, uint32_t height, const uint8_t* rgb, DvzSize* size, void** out)
+{
+    ANN(rgb);
+    ANN(size);
+    ANN(out);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    // Header (14 bytes), at most 4 bytes per pixel, end marker (8 bytes).
+    DvzSize count = (DvzSize)width * height;
+    uint8_t* qoi = (uint8_t*)malloc(14 + 4 * count + 8);
+    ANN(qoi);
+    // Header: magic, big-endian width and height, 3 channels, sRGB.
+    memcpy(qoi, "qoif", 4);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        qoi[4 + i] = (uint8_t)(width >> (24 - 8 * i));
+        qoi[8 + i] = (uint8_t)(height >> (24 - 8 * i));
+    }
+    qoi[12] = 3;
+    qoi[13] = 0;
+    DvzSize n = 14;
+
+    // NOTE: the alpha channel is always 255, the unused index entries have a zero alpha.
+    uint8_t index[64][4] = {{0}};
+    uint8_t prev[3] = {0, 0, 0};
+    uint32_t run = 0;
+    for (DvzSize i = 0; i < count; i++)
+    {
+        const uint8_t* px = rgb + 3 * i;
+        if (px[0] == prev[0] && px[1] == prev[1] && px[2] == prev[2])
+        {
+            run++;
+            if (run == 62 || i == count - 1)
+            {
+                qoi[n++] = (uint8_t)(0xC0 | (run - 1)); // QOI_OP_RUN
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0)
+        {
+            qoi[n++] = (uint8_t)(0xC0 | (run - 1));
+            run = 0;
+        }
+
+        uint32_t h = (px[0] * 3u + px[1] * 5u + px[2] * 7u + 255 * 11u) % 64;
+        if (index[h][0] == px[0] && index[h][1] == px[1] && index[h][2] == px[2] &&
+            index[h][3] == 255)
+        {
+            qoi[n++] = (uint8_t)h; // QOI_OP_INDEX
+        }
+        else
+        {
+            memcpy(index[h], px, 3);
+            index[h][3] = 255;
+            int8_t dr = (int8_t)(px[0] - prev[0]);
+            int8_t dg = (int8_t)(px[1] - prev[1]);
+            int8_t db = (int8_t)(px[2] - prev[2]);
+            int8_t dr_dg = (int8_t)(dr - dg);
+            int8_t db_dg = (int8_t)(db - dg);
+            if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+            {
+                // QOI_OP_DIFF
+                qoi[n++] = (uint8_t)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+            }
+            else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8)
+            {
+                qoi[n++] = (uint8_t)(0x80 | (dg + 32)); // QOI_OP_LUMA
+                qoi[n++] = (uint8_t)((dr_dg + 8) << 4 | (db_dg + 8));
+            }
+            else
+            {
+                qoi[n++] = 0xFE; // QOI_OP_RGB
+                memcpy(qoi + n, px, 3);
+                n += 3;
+            }
+        }
+        memcpy(prev, px, 3);
+    }
+
+    memcpy(qoi + n, "\0\0\0\0\0\0\0\1", 8);
+    n += 8;
+    *size = n;
+    *out = qoi;
+    return 0;
+}
+
+
+
 uint8_t* dvz_load_png(DvzSize size, unsigned char* bytes, uint32_t* width, uint32_t* height)
 {
     ASSERT(size > 0);
@@ -419,10 +1607,10 @@ uint8_t* dvz_load_png(DvzSize size, unsigned char* bytes, uint32_t* width, uint3
     std::vector<uint8_t> image_data;
     uint32_t img_width, img_height;
     uint32_t channels;
-    bool success =
+    int res =
         fpng::fpng_decode_memory(bytes, size, image_data, img_width, img_height, channels, 3);
 
-    if (!success)
+    if (res != fpng::FPNG_DECODE_SUCCESS)
     {
         fprintf(stderr, "Failed to decode PNG image\n");
         return NULL;
@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Video frame sink                                                                             */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "framesink.h"
+#include "_log.h"
+
+#if OS_WINDOWS
+#include <io.h>
+#define dup    _dup
+#define fdopen _fdopen
+#else
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define Y4M_FRAME_HEADER "FRAME\n"
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+// BT.601 limited range, with 8-bit fixed-point coefficients. The chroma values are computed from
+// the sums of 2x2 pixels. The offsets keep the intermediate values positive.
+static inline uint8_t _luma(int32_t r, int32_t g, int32_t b)
+{
+    return (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+
+
+static inline uint8_t _chroma_u(int32_t r4, int32_t g4, int32_t b4)
+{
+    return (uint8_t)((-38 * r4 - 74 * g4 + 112 * b4 + 128 * 1024 + 512) >> 10);
+}
+
+
+
+static inline uint8_t _chroma_v(int32_t r4, int32_t g4, int32_t b4)
+{
+    return (uint8_t)((112 * r4 - 94 * g4 - 18 * b4 + 128 * 1024 + 512) >> 10);
+}
+
+
+
+// Luma of a row of pixels. The loops below are written without branches so that they are
+// vectorized when the number of components is a constant, see dvz_rgb_yuv420().
+static inline void _luma_row(uint32_t width, const uint8_t* row, uint32_t c, uint8_t* y)
+{
+#if HAS_OPENMP
+#pragma omp simd
+#endif
+    for (int64_t i = 0; i < (int64_t)width; i++)
+        y[i] = _luma(row[c * i + 0], row[c * i + 1], row[c * i + 2]);
+}
+
+
+
+// Sums of the pixels of two rows, one array per channel.
+static inline void _sum_rows(
+    uint32_t width, const uint8_t* row0, const uint8_t* row1, uint32_t c, //
+    uint16_t* r, uint16_t* g, uint16_t* b)
+{
+#if HAS_OPENMP
+#pragma omp simd
+#endif
+    for (int64_t i = 0; i < (int64_t)width; i++)
+    {
+        r[i] = (uint16_t)(row0[c * i + 0] + row1[c * i + 0]);
+        g[i] = (uint16_t)(row0[c * i + 1] + row1[c * i + 1]);
+        b[i] = (uint16_t)(row0[c * i + 2] + row1[c * i + 2]);
+    }
+}
+
+
+
+// Chroma of pairs of columns, from the sums of two rows.
+static void _chroma_row(
+    uint32_t cw, const uint16_t* r, const uint16_t* g, const uint16_t* b, uint8_t* u, uint8_t* v)
+{
+#if HAS_OPENMP
+#pragma omp simd
+#endif
+    for (int64_t i = 0; i < (int64_t)cw; i++)
+    {
+        int32_t r4 = r[2 * i] + r[2 * i + 1];
+        int32_t g4 = g[2 * i] + g[2 * i + 1];
+        int32_t b4 = b[2 * i] + b[2 * i + 1];
+        u[i] = _chroma_u(r4, g4, b4);
+        v[i] = _chroma_v(r4, g4, b4);
+    }
+}
+
+
+
+static inline void _yuv420_rows(
+    uint32_t width, const uint8_t* row0, const uint8_t* row1, uint32_t c, //
+    uint16_t* sums, uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v)
+{
+    // NOTE: sums has 3 arrays of width + 1 values, the last one is used with an odd width.
+    uint32_t n = width + 1;
+    uint16_t* r = sums;
+    uint16_t* g = sums + n;
+    uint16_t* b = sums + 2 * n;
+
+    _luma_row(width, row0, c, y0);
+    if (row1 != row0)
+        _luma_row(width, row1, c, y1);
+
+    _sum_rows(width, row0, row1, c, r, g, b);
+    if (width % 2 == 1)
+    {
+        // Odd width: the last column is duplicated.
+        r[width] = r[width - 1];
+        g[width] = g[width - 1];
+        b[width] = b[width - 1];
+    }
+    _chroma_row((width + 1) / 2, r, g, b, u, v);
+}
+
+
+
+static bool _write(DvzFrameSink* sink, DvzSize size, const void* data)
+{
+    ANN(sink);
+    ANN(sink->fp);
+    return fwrite(data, 1, size, sink->fp) == size;
+}
+
+
+
+static bool _write_frame(DvzFrameSink* sink, const uint8_t* pixels, uint32_t components)
+{
+    ANN(sink);
+    ANN(pixels);
+
+    uint32_t width = sink->width, height = sink->height;
+    const uint8_t* data = pixels;
+    DvzSize size = (DvzSize)width * height * 3;
+
+    if (sink->format == DVZ_VIDEO_FORMAT_Y4M)
+    {
+        dvz_rgb_yuv420(width, height, pixels, components, sink->out);
+        data = sink->out;
+        size = dvz_yuv420_size(width, height);
+        if (!_write(sink, strlen(Y4M_FRAME_HEADER), Y4M_FRAME_HEADER))
+            return false;
+    }
+    else if (components == 4)
+    {
+        // Drop the alpha channel.
+        DvzSize n = (DvzSize)width * height;
+        for (DvzSize i = 0; i < n; i++)
+        {
+            sink->out[3 * i + 0] = pixels[4 * i + 0];
+            sink->out[3 * i + 1] = pixels[4 * i + 1];
+            sink->out[3 * i + 2] = pixels[4 * i + 2];
+        }
+        data = sink->out;
+    }
+
+    // NOTE: the frames are flushed one by one so that the reader gets them as soon as possible.
+    return _write(sink, size, data) && fflush(sink->fp) == 0;
+}
+
+
+
+static bool _write_header(DvzFrameSink* sink)
+{
+    ANN(sink);
+    ANN(sink->fp);
+    if (sink->format != DVZ_VIDEO_FORMAT_Y4M)
+        return true;
+
+    // NOTE: C420jpeg means that the chroma samples are centered between the 2x2 pixels.
+    return fprintf(
+               sink->fp, "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C420jpeg\n", sink->width,
+               sink->height, sink->fps_num, sink->fps_den) > 0 &&
+           fflush(sink->fp) == 0;
+}
+
+
+
+static void* _frame_sink_thread(void* user_data)
+{
+    DvzFrameSink* sink = (DvzFrameSink*)user_data;
+    ANN(sink);
+
+#if !OS_WINDOWS
+    // When the reader closes the pipe, writing fails with EPIPE instead of killing the process.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+#endif
+
+    // The header is written by the thread too, as the reader may already be gone.
+    if (!_write_header(sink))
+    {
+        log_error("unable to write the video header, discarding the frames");
+        dvz_mutex_lock(&sink->lock);
+        sink->error = true;
+        dvz_mutex_unlock(&sink->lock);
+    }
+
+    while (true)
+    {
+        dvz_mutex_lock(&sink->lock);
+        while (sink->count == 0 && !sink->stop)
+            dvz_cond_wait(&sink->cond_pop, &sink->lock);
+        if (sink->count == 0)
+        {
+            // The sink is stopping and the queue is empty.
+            dvz_mutex_unlock(&sink->lock);
+            break;
+        }
+        // NOTE: the frame stays in the queue while it is being written, so that its buffer is not
+        // reused in the meantime.
+        uint8_t* frame = sink->frames[sink->first];
+        uint32_t components = sink->components[sink->first];
+        bool error = sink->error;
+        dvz_mutex_unlock(&sink->lock);
+
+        // Convert and write the frame outside of the lock. After an error, the frames are
+        // discarded.
+        bool ok = !error && _write_frame(sink, frame, components);
+        if (!error && !ok)
+            log_error("unable to write a video frame, discarding the next frames");
+
+        dvz_mutex_lock(&sink->lock);
+        sink->first = (sink->first + 1) % DVZ_FRAME_SINK_QUEUE_SIZE;
+        sink->count--;
+        sink->written += ok ? 1 : 0;
+        sink->error |= !ok;
+        dvz_cond_signal(&sink->cond_push);
+        if (sink->count == 0)
+            dvz_cond_broadcast(&sink->cond_idle);
+        dvz_mutex_unlock(&sink->lock);
+    }
+    return NULL;
+}
+
+
+
+static DvzFrameSink* _frame_sink(
+    FILE* fp, uint32_t width, uint32_t height, double fps, DvzVideoFormat format)
+{
+    ANN(fp);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    DvzFrameSink* sink = (DvzFrameSink*)calloc(1, sizeof(DvzFrameSink));
+    ANN(sink);
+    sink->fp = fp;
+    sink->format = format;
+    sink->width = width;
+    sink->height = height;
+
+    // Frame rate as a fraction.
+    fps = fps > 0 ? fps : 30;
+    sink->fps_num = (uint32_t)round(fps * 1000);
+    sink->fps_den = 1000;
+    while (sink->fps_num % 10 == 0 && sink->fps_den % 10 == 0)
+    {
+        sink->fps_num /= 10;
+        sink->fps_den /= 10;
+    }
+
+    DvzSize frame_size = (DvzSize)width * height * 4;
+    for (uint32_t i = 0; i < DVZ_FRAME_SINK_QUEUE_SIZE; i++)
+    {
+        sink->frames[i] = (uint8_t*)malloc(frame_size);
+        ANN(sink->frames[i]);
+    }
+    sink->out_size = format == DVZ_VIDEO_FORMAT_Y4M ? dvz_yuv420_size(width, height)
+                                                     : (DvzSize)width * height * 3;
+    sink->out = (uint8_t*)malloc(sink->out_size);
+    ANN(sink->out);
+
+    sink->lock = dvz_mutex();
+    sink->cond_push = dvz_cond();
+    sink->cond_pop = dvz_cond();
+    sink->cond_idle = dvz_cond();
+    sink->thread = dvz_thread(_frame_sink_thread, sink);
+
+    log_debug(
+        "created %s frame sink with %dx%d frames", format == DVZ_VIDEO_FORMAT_Y4M ? "Y4M" : "RGB",
+        width, height);
+    dvz_obj_created(&sink->obj);
+    return sink;
+}
+
+
+
+/*************************************************************************************************/
+/*  Conversion                                                                                   */
+/*************************************************************************************************/
+
+DvzSize dvz_yuv420_size(uint32_t width, uint32_t height)
+{
+    DvzSize chroma = (DvzSize)((width + 1) / 2) * ((height + 1) / 2);
+    return (DvzSize)width * height + 2 * chroma;
+}
+
+
+
+void dvz_rgb_yuv420(
+    uint32_t width, uint32_t height, const uint8_t* pixels, uint32_t components, uint8_t* yuv)
+{
+    ANN(pixels);
+    ANN(yuv);
+    ASSERT(components == 3 || components == 4);
+
+    DvzSize stride = (DvzSize)width * components;
+    uint32_t cw = (width + 1) / 2, ch = (height + 1) / 2;
+    uint8_t* y = yuv;
+    uint8_t* u = y + (DvzSize)width * height;
+    uint8_t* v = u + (DvzSize)cw * ch;
+    uint16_t* sums = (uint16_t*)calloc(3 * (width + 1), sizeof(uint16_t));
+    ANN(sums);
+
+    for (uint32_t j = 0; j < ch; j++)
+    {
+        // Odd height: the last row is duplicated.
+        uint32_t j0 = 2 * j, j1 = MIN(2 * j + 1, height - 1);
+        const uint8_t* row0 = &pixels[j0 * stride];
+        const uint8_t* row1 = &pixels[j1 * stride];
+        uint8_t* y0 = &y[(DvzSize)j0 * width];
+        uint8_t* y1 = &y[(DvzSize)j1 * width];
+        uint8_t* uj = &u[(DvzSize)j * cw];
+        uint8_t* vj = &v[(DvzSize)j * cw];
+
+        // NOTE: constant number of components so that the loops are vectorized.
+        if (components == 3)
+            _yuv420_rows(width, row0, row1, 3, sums, y0, y1, uj, vj);
+        else
+            _yuv420_rows(width, row0, row1, 4, sums, y0, y1, uj, vj);
+    }
+
+    FREE(sums);
+}
+
+
+
+/*************************************************************************************************/
+/*  Frame sink                                                                                   */
+/*************************************************************************************************/
+
+DvzFrameSink* dvz_frame_sink(
+    const char* path, uint32_t width, uint32_t height, double fps, DvzVideoFormat format)
+{
+    ANN(path);
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        log_error("unable to open %s", path);
+        return NULL;
+    }
+    return _frame_sink(fp, width, height, fps, format);
+}
+
+
+
+DvzFrameSink*
+dvz_frame_sink_fd(int fd, uint32_t width, uint32_t height, double fps, DvzVideoFormat format)
+{
+    // NOTE: the file descriptor is duplicated as closing the stream closes its file descriptor.
+    int dup_fd = fd >= 0 ? dup(fd) : -1;
+    FILE* fp = dup_fd >= 0 ? fdopen(dup_fd, "wb") : NULL;
+    if (fp == NULL)
+    {
+        log_error("invalid file descriptor %d", fd);
+        return NULL;
+    }
+    return _frame_sink(fp, width, height, fps, format);
+}
+
+
+
+void dvz_frame_sink_push(DvzFrameSink* sink, const uint8_t* pixels, uint32_t components)
+{
+    ANN(sink);
+    ANN(pixels);
+    ASSERT(components == 3 || components == 4);
+
+    // Back-pressure: wait until a frame has been written if the queue is full.
+    dvz_mutex_lock(&sink->lock);
+    while (sink->count == DVZ_FRAME_SINK_QUEUE_SIZE)
+        dvz_cond_wait(&sink->cond_push, &sink->lock);
+    uint32_t idx = (sink->first + sink->count) % DVZ_FRAME_SINK_QUEUE_SIZE;
+    dvz_mutex_unlock(&sink->lock);
+
+    // The free buffer is not used by the thread, it can be filled outside of the lock.
+    memcpy(sink->frames[idx], pixels, (DvzSize)sink->width * sink->height * components);
+
+    dvz_mutex_lock(&sink->lock);
+    sink->components[idx] = components;
+    sink->count++;
+    dvz_cond_signal(&sink->cond_pop);
+    dvz_mutex_unlock(&sink->lock);
+}
+
+
+
+int dvz_frame_sink_wait(DvzFrameSink* sink)
+{
+    ANN(sink);
+    dvz_mutex_lock(&sink->lock);
+    while (sink->count > 0)
+        dvz_cond_wait(&sink->cond_idle, &sink->lock);
+    int res = sink->error ? 1 : 0;
+    dvz_mutex_unlock(&sink->lock);
+    return res;
+}
+
+
+
+void dvz_frame_sink_destroy(DvzFrameSink* sink)
+{
+    ANN(sink);
+
+    // The thread writes the remaining frames before stopping.
+    dvz_mutex_lock(&sink->lock);
+    sink->stop = true;
+    dvz_cond_broadcast(&sink->cond_pop);
+    dvz_mutex_unlock(&sink->lock);
+    dvz_thread_join(sink->thread);
+    log_debug("frame sink closed after %" PRIu64 " frames", sink->written);
+
+    fclose(sink->fp);
+    dvz_mutex_destroy(&sink->lock);
+    dvz_cond_destroy(&sink->cond_push);
+    dvz_cond_destroy(&sink->cond_pop);
+    dvz_cond_destroy(&sink->cond_idle);
+    for (uint32_t i = 0; i < DVZ_FRAME_SINK_QUEUE_SIZE; i++)
+        FREE(sink->frames[i]);
+    FREE(sink->out);
+    dvz_obj_destroyed(&sink->obj);
+    FREE(sink);
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Asynchronous image writer                                                                    */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <ctype.h>
+
+#include "imwriter.h"
+#include "_log.h"
+#include "datoviz_math.h"
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static bool _has_extension(const char* filename, const char* ext)
+{
+    size_t n = strlen(filename), k = strlen(ext);
+    if (n < k)
+        return false;
+    for (size_t i = 0; i < k; i++)
+        if (tolower(filename[n - k + i]) != ext[i])
+            return false;
+    return true;
+}
+
+
+
+static void* _writer_thread(void* user_data)
+{
+    DvzImageWriter* writer = (DvzImageWriter*)user_data;
+    ANN(writer);
+
+    while (true)
+    {
+        dvz_mutex_lock(&writer->lock);
+        while (writer->count == 0 && !writer->stop)
+            dvz_cond_wait(&writer->cond_pop, &writer->lock);
+        if (writer->count == 0)
+        {
+            // The writer is stopping and the queue is empty.
+            dvz_mutex_unlock(&writer->lock);
+            break;
+        }
+        DvzImageFrame frame = writer->frames[writer->first];
+        writer->first = (writer->first + 1) % writer->capacity;
+        writer->count--;
+        int png_level = writer->png_level;
+        DvzPngFilter png_filter = writer->png_filter;
+        dvz_mutex_unlock(&writer->lock);
+
+        // Encode and write the image outside of the lock.
+        int res = dvz_write_image(
+            frame.filename, frame.width, frame.height, frame.rgb, png_level, png_filter);
+        if (res != 0)
+            log_error("unable to write the image %s", frame.filename);
+        else
+            log_trace("image %s written", frame.filename);
+        FREE(frame.filename);
+        FREE(frame.rgb);
+
+        dvz_mutex_lock(&writer->lock);
+        writer->errors += res != 0 ? 1 : 0;
+        writer->pending--;
+        dvz_cond_signal(&writer->cond_push);
+        if (writer->pending == 0)
+            dvz_cond_broadcast(&writer->cond_idle);
+        dvz_mutex_unlock(&writer->lock);
+    }
+    return NULL;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+int dvz_write_image(
+    const char* filename, uint32_t width, uint32_t height, const uint8_t* rgb, int png_level,
+    DvzPngFilter png_filter)
+{
+    ANN(filename);
+    ANN(rgb);
+
+    if (_has_extension(filename, ".ppm"))
+        return dvz_write_ppm(filename, width, height, rgb);
+
+    DvzSize size = 0;
+    void* bytes = NULL;
+    int res = 0;
+    if (_has_extension(filename, ".qoi"))
+        res = dvz_make_qoi(width, height, rgb, &size, &bytes);
+    else
+        res = dvz_encode_png(width, height, rgb, png_level, png_filter, &size, &bytes);
+    if (res == 0)
+        res = dvz_write_bytes(filename, "wb", size, (const uint8_t*)bytes);
+    FREE(bytes);
+    return res;
+}
+
+
+
+DvzImageWriter* dvz_image_writer(uint32_t thread_count, uint32_t capacity)
+{
+    DvzImageWriter* writer = (DvzImageWriter*)calloc(1, sizeof(DvzImageWriter));
+    ANN(writer);
+
+    if (thread_count == 0)
+        thread_count = (uint32_t)MAX(1, dvz_num_procs() / 2);
+    thread_count = MIN(thread_count, DVZ_IMWRITER_MAX_THREADS);
+    if (capacity == 0)
+        capacity = DVZ_IMWRITER_QUEUE_SIZE * thread_count;
+    log_debug("creating image writer with %d threads and %d images", thread_count, capacity);
+
+    writer->capacity = capacity;
+    writer->frames = (DvzImageFrame*)calloc(capacity, sizeof(DvzImageFrame));
+    ANN(writer->frames);
+    writer->png_level = -1;
+    writer->png_filter = DVZ_PNG_FILTER_NONE;
+
+    writer->lock = dvz_mutex();
+    writer->cond_push = dvz_cond();
+    writer->cond_pop = dvz_cond();
+    writer->cond_idle = dvz_cond();
+
+    writer->thread_count = thread_count;
+    for (uint32_t i = 0; i < thread_count; i++)
+        writer->threads[i] = dvz_thread(_writer_thread, writer);
+
+    dvz_obj_created(&writer->obj);
+    return writer;
+}
+
+
+
+void dvz_image_writer_png(DvzImageWriter* writer, int level, DvzPngFilter filter)
+{
+    ANN(writer);
+    dvz_mutex_lock(&writer->lock);
+    writer->png_level = MIN(level, 9);
+    writer->png_filter = filter;
+    dvz_mutex_unlock(&writer->lock);
+}
+
+
+
+void dvz_image_writer_push(
+    DvzImageWriter* writer, const char* filename, uint32_t width, uint32_t height,
+    const uint8_t* rgb)
+{
+    ANN(writer);
+    ANN(filename);
+    ANN(rgb);
+    ASSERT(width > 0);
+    ASSERT(height > 0);
+
+    // Copy the image before waiting for room in the queue.
+    DvzImageFrame frame = {0};
+    DvzSize size = (DvzSize)width * height * 3;
+    frame.filename = (char*)malloc(strlen(filename) + 1);
+    ANN(frame.filename);
+    strcpy(frame.filename, filename);
+    frame.width = width;
+    frame.height = height;
+    frame.rgb = (uint8_t*)malloc(size);
+    ANN(frame.rgb);
+    memcpy(frame.rgb, rgb, size);
+
+    // Back-pressure: wait until an image has been written if the writer is full.
+    dvz_mutex_lock(&writer->lock);
+    while (writer->pending >= writer->capacity)
+        dvz_cond_wait(&writer->cond_push, &writer->lock);
+    writer->frames[(writer->first + writer->count) % writer->capacity] = frame;
+    writer->count++;
+    writer->pending++;
+    dvz_cond_signal(&writer->cond_pop);
+    dvz_mutex_unlock(&writer->lock);
+}
+
+
+
+uint32_t dvz_image_writer_wait(DvzImageWriter* writer)
+{
+    ANN(writer);
+    dvz_mutex_lock(&writer->lock);
+    while (writer->pending > 0)
+        dvz_cond_wait(&writer->cond_idle, &writer->lock);
+    uint32_t errors = writer->errors;
+    writer->errors = 0;
+    dvz_mutex_unlock(&writer->lock);
+    return errors;
+}
+
+
+
+void dvz_image_writer_destroy(DvzImageWriter* writer)
+{
+    ANN(writer);
+
+    // The threads write the remaining images before stopping.
+    dvz_mutex_lock(&writer->lock);
+    writer->stop = true;
+    dvz_cond_broadcast(&writer->cond_pop);
+    dvz_mutex_unlock(&writer->lock);
+    for (uint32_t i = 0; i < writer->thread_count; i++)
+        dvz_thread_join(writer->threads[i]);
+
+    dvz_mutex_destroy(&writer->lock);
+    dvz_cond_destroy(&writer->cond_push);
+    dvz_cond_destroy(&writer->cond_pop);
+    dvz_cond_destroy(&writer->cond_idle);
+    FREE(writer->frames);
+    dvz_obj_destroyed(&writer->obj);
+    FREE(writer);
+}
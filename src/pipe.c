@@ -119,12 +119,14 @@ void dvz_pipe_vertex(DvzPipe* pipe, uint32_t binding_idx, DvzDat* dat_vertex, Dv
 
 
 
-void dvz_pipe_index(DvzPipe* pipe, DvzDat* dat_index, DvzSize offset)
+void dvz_pipe_index(DvzPipe* pipe, DvzDat* dat_index, DvzSize offset, DvzSize index_size)
 {
     ANN(pipe);
     ANN(dat_index);
+    ASSERT(index_size == 2 || index_size == 4);
     pipe->index_binding.dat = dat_index;
     pipe->index_binding.offset = offset;
+    pipe->index_type = index_size == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
 }
 
 
@@ -281,13 +283,16 @@ static DvzGraphics* _pre_draw(DvzPipe* pipe, DvzCommands* cmds, uint32_t idx)
         brs[i] = dat->br;
         offsets[i] = pipe->vertex_bindings[i].offset;
     }
-    dvz_cmd_bind_vertex_buffer(cmds, idx, count, brs, offsets);
+    // NOTE: some graphics pipelines have no vertex buffer and only use gl_VertexIndex.
+    if (count > 0)
+        dvz_cmd_bind_vertex_buffer(cmds, idx, count, brs, offsets);
 
     // Index buffer.
     if (pipe->index_binding.dat != NULL)
     {
         dvz_cmd_bind_index_buffer(
-            cmds, idx, pipe->index_binding.dat->br, pipe->index_binding.offset);
+            cmds, idx, pipe->index_binding.dat->br, pipe->index_binding.offset,
+            pipe->index_type);
     }
 
     // TODO: dynamic uniform buffer index
@@ -54,6 +54,8 @@ static DvzGpu* make_gpu(DvzHost* host)
     _default_queues(gpu, true);
     INIT(VkPhysicalDeviceFeatures, f);
     f.independentBlend = true;
+    // NOTE: needed for gl_PrimitiveID in fragment shaders (mesh wireframe).
+    f.geometryShader = gpu->device_features.geometryShader;
     dvz_gpu_request_features(gpu, f);
 
     if (host->backend == DVZ_BACKEND_GLFW)
@@ -39,6 +39,10 @@
     }                                                                                             \
     ANN(n);
 
+// SPIR-V opcode and capability used to detect gl_PrimitiveID in fragment shaders.
+#define SPIRV_OP_CAPABILITY       17
+#define SPIRV_CAPABILITY_GEOMETRY 2
+
 
 
 /*************************************************************************************************/
@@ -217,6 +221,28 @@ static void* _canvas_delete(DvzRenderer* rd, DvzRequest req, void* user_data)
 /*  Shaders                                                                                      */
 /*************************************************************************************************/
 
+// Whether a SPIR-V module declares a capability. The OpCapability instructions come first, right
+// after the 5-word header.
+static bool _spirv_capability(DvzSize size, const uint32_t* buffer, uint32_t capability)
+{
+    ANN(buffer);
+
+    uint32_t n = (uint32_t)(size / sizeof(uint32_t));
+    uint32_t i = 5;
+    while (i + 1 < n)
+    {
+        uint32_t word_count = buffer[i] >> 16;
+        if ((buffer[i] & 0xFFFF) != SPIRV_OP_CAPABILITY || word_count < 2)
+            break;
+        if (buffer[i + 1] == capability)
+            return true;
+        i += word_count;
+    }
+    return false;
+}
+
+
+
 static void* _shader_create(DvzRenderer* rd, DvzRequest req, void* user_data)
 {
     ANN(rd);
@@ -398,6 +424,16 @@ static void* _graphics_shader(DvzRenderer* rd, DvzRequest req, void* user_data)
     }
     else if (format == DVZ_SHADER_SPIRV)
     {
+        // gl_PrimitiveID in a fragment shader (mesh wireframe) requires the geometryShader
+        // feature, which is only requested when the device supports it.
+        if (shader->type == DVZ_SHADER_FRAGMENT && !rd->gpu->requested_features.geometryShader &&
+            _spirv_capability(shader->size, shader->buffer, SPIRV_CAPABILITY_GEOMETRY))
+        {
+            log_error("the fragment shader requires the geometryShader feature, which is not "
+                      "supported by the GPU, discarding it");
+            return NULL;
+        }
+
         // NOTE: we assume VkShaderStageFlagBits and DvzShaderType match.
         dvz_graphics_shader_spirv(
             graphics, (VkShaderStageFlagBits)shader->type, shader->size, shader->buffer);
@@ -536,7 +572,10 @@ static void* _graphics_bind_index(DvzRenderer* rd, DvzRequest req, void* user_da
     if (_is_dat_valid(dat))
     {
         // Link the two.
-        dvz_pipe_index(pipe, dat, req.content.bind_index.offset);
+        // NOTE: a zero index size means 32-bit indices.
+        DvzSize index_size = req.content.bind_index.index_size;
+        dvz_pipe_index(
+            pipe, dat, req.content.bind_index.offset, index_size > 0 ? index_size : 4);
     }
 
     return NULL;
@@ -546,10 +546,12 @@ static void _print_bind_index(DvzRequest* req)
         "  id: 0x%" PRIx64 "\n"
         "  content:\n"
         "    dat: 0x%" PRIx64 "\n"
-        "    offset: %" PRId64 "\n",
-        req->id,                     //
-        req->content.bind_index.dat, //
-        req->content.bind_index.offset);
+        "    offset: %" PRId64 "\n"
+        "    index_size: %" PRId64 "\n",
+        req->id,                        //
+        req->content.bind_index.dat,    //
+        req->content.bind_index.offset, //
+        req->content.bind_index.index_size);
 }
 
 
@@ -1909,10 +1911,25 @@ dvz_bind_vertex(DvzBatch* batch, DvzId graphics, uint32_t binding_idx, DvzId dat
 
 DvzRequest dvz_bind_index(DvzBatch* batch, DvzId graphics, DvzId dat, DvzSize offset)
 {
+    return dvz_bind_index_size(batch, graphics, dat, offset, sizeof(DvzIndex));
+}
+
+
+
+DvzRequest dvz_bind_index_size(
+    DvzBatch* batch, DvzId graphics, DvzId dat, DvzSize offset, DvzSize index_size)
+{
+    if (index_size != 2 && index_size != 4)
+    {
+        log_error("invalid index size %d, falling back to 32-bit indices", index_size);
+        index_size = 4;
+    }
+
     CREATE_REQUEST(BIND, INDEX);
     req.id = graphics;
     req.content.bind_index.dat = dat;
     req.content.bind_index.offset = offset;
+    req.content.bind_index.index_size = index_size;
 
     IF_VERBOSE
     _print_bind_index(&req);
@@ -79,8 +79,9 @@ static inline VkBufferUsageFlags _find_buffer_usage(DvzBufferType type)
         break;
 
     case DVZ_BUFFER_TYPE_INDEX:
-        usage = TRANSFERABLE | //
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        usage = TRANSFERABLE |                     //
+                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | //
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         break;
 
     case DVZ_BUFFER_TYPE_STORAGE:
@@ -661,9 +662,14 @@ static inline DvzSize _format_size(DvzFormat format)
 
     case DVZ_FORMAT_R16_UNORM:
     case DVZ_FORMAT_R16_SNORM:
+    case DVZ_FORMAT_R16_SFLOAT:
         return 1 * 2;
         break;
 
+    case DVZ_FORMAT_R16G16B16A16_SNORM:
+        return 4 * 2;
+        break;
+
     case DVZ_FORMAT_R32_UINT:
     case DVZ_FORMAT_R32_SINT:
     case DVZ_FORMAT_R32_SFLOAT:
@@ -16,6 +16,23 @@
 /*************************************************************************************************/
 
 #include "scene/array.h"
+#include "fileio.h"
+
+#if HAS_OPENMP
+#include <omp.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Number of bytes of a CSV file parsed by each parallel task.
+#define CSV_CHUNK_SIZE (1024 * 1024)
+
+// Maximum number of characters of a CSV value parsed with strtod().
+#define CSV_MAX_NUMBER 64
 
 
 
@@ -199,6 +216,53 @@ static inline void _cast(DvzDataType target_dtype, void* dst, DvzDataType source
 
 
 
+// Scalar data type from a NumPy-like kind ('f', 'i', 'u', 'b') and item size, DVZ_DTYPE_CUSTOM if
+// there is no corresponding data type.
+static DvzDataType _scalar_dtype(char kind, uint32_t item_size)
+{
+    if ((kind == 'u' || kind == 'b') && item_size == 1)
+        return DVZ_DTYPE_CHAR;
+    else if (kind == 'u' && item_size == 2)
+        return DVZ_DTYPE_USHORT;
+    else if (kind == 'i' && item_size == 2)
+        return DVZ_DTYPE_SHORT;
+    else if (kind == 'u' && item_size == 4)
+        return DVZ_DTYPE_UINT;
+    else if (kind == 'i' && item_size == 4)
+        return DVZ_DTYPE_INT;
+    else if (kind == 'f' && item_size == 4)
+        return DVZ_DTYPE_FLOAT;
+    else if (kind == 'f' && item_size == 8)
+        return DVZ_DTYPE_DOUBLE;
+    return DVZ_DTYPE_CUSTOM;
+}
+
+
+
+// Unpack a bitmap into an array of 0 and 1 values.
+static DvzArray* _unpack_bits(uint32_t count, const uint8_t* bits)
+{
+    DvzArray* arr = _create_array(count, DVZ_DTYPE_CHAR, 1);
+    uint8_t* values = (uint8_t*)arr->data;
+    for (uint32_t i = 0; i < count; i++)
+        values[i] = (bits[i / 8] >> (i % 8)) & 1;
+    return arr;
+}
+
+
+
+// Memory-mapped arrays are read-only: log an error and return true if the array is mapped.
+static bool _is_mapped(DvzArray* array)
+{
+    ANN(array);
+    if (array->mapping == NULL)
+        return false;
+    log_error("a memory-mapped array is read-only");
+    return true;
+}
+
+
+
 // Fill the remaining of an array with the last non-empty value.
 static void
 _repeat_last(uint32_t old_item_count, DvzSize item_size, void* data, uint32_t item_count)
@@ -218,6 +282,208 @@ _repeat_last(uint32_t old_item_count, DvzSize item_size, void* data, uint32_t it
 
 
 
+// Powers of ten that are exactly representable as doubles.
+static const double CSV_POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+
+// Parse a CSV value, return NaN if the value is empty or invalid.
+static double _csv_number(const char* s, const char* e)
+{
+    // Strip the spaces and the quotes.
+    while (s < e && (*s == ' ' || *s == '"'))
+        s++;
+    while (e > s && (e[-1] == ' ' || e[-1] == '"' || e[-1] == '\r'))
+        e--;
+    if (s == e)
+        return NAN;
+
+    const char* c = s;
+    bool negative = *c == '-';
+    if (*c == '-' || *c == '+')
+        c++;
+
+    // Mantissa digits, the ones beyond 19 digits are dropped.
+    uint64_t mantissa = 0;
+    int32_t exponent = 0, digits = 0;
+    bool any = false;
+    for (; c < e && *c >= '0' && *c <= '9'; c++, any = true)
+    {
+        if (digits < 19)
+            mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+        else
+            exponent++;
+        digits += mantissa > 0 ? 1 : 0;
+    }
+    if (c < e && *c == '.')
+    {
+        for (c++; c < e && *c >= '0' && *c <= '9'; c++, any = true)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+                exponent--;
+            }
+            digits += mantissa > 0 ? 1 : 0;
+        }
+    }
+    if (any && c < e && (*c == 'e' || *c == 'E'))
+    {
+        const char* x = c + 1;
+        bool x_negative = x < e && *x == '-';
+        if (x < e && (*x == '-' || *x == '+'))
+            x++;
+        int32_t value = 0;
+        bool x_any = false;
+        for (; x < e && *x >= '0' && *x <= '9'; x++, x_any = true)
+            value = MIN(value * 10 + (*x - '0'), 100000);
+        if (x_any)
+        {
+            exponent += x_negative ? -value : value;
+            c = x;
+        }
+    }
+
+    // Fast path: the mantissa and the power of ten are exact doubles, so that the result is
+    // correctly rounded (Clinger's algorithm).
+    if (any && c == e && digits <= 19 && mantissa <= (1ull << 53) && abs(exponent) <= 22)
+    {
+        double value = (double)mantissa;
+        value = exponent < 0 ? value / CSV_POW10[-exponent] : value * CSV_POW10[exponent];
+        return negative ? -value : value;
+    }
+
+    // Slow path for long mantissas, large exponents, and special values (nan, inf).
+    char buffer[CSV_MAX_NUMBER] = {0};
+    if (e - s >= CSV_MAX_NUMBER)
+        return NAN;
+    memcpy(buffer, s, (size_t)(e - s));
+    char* end = NULL;
+    double value = strtod(buffer, &end);
+    return end == buffer + (e - s) ? value : NAN;
+}
+
+
+
+// Store a parsed CSV value into an array component with the given scalar data type. Integer
+// types are rounded and clamped, missing values give 0.
+static inline void _csv_store(DvzDataType scalar, void* dst, uint32_t k, double value)
+{
+    if (scalar == DVZ_DTYPE_FLOAT)
+    {
+        ((float*)dst)[k] = (float)value;
+        return;
+    }
+    else if (scalar == DVZ_DTYPE_DOUBLE)
+    {
+        ((double*)dst)[k] = value;
+        return;
+    }
+
+    value = isnan(value) ? 0 : round(value);
+    switch (scalar)
+    {
+    case DVZ_DTYPE_CHAR:
+        ((uint8_t*)dst)[k] = (uint8_t)CLIP(value, 0, UINT8_MAX);
+        break;
+    case DVZ_DTYPE_USHORT:
+        ((uint16_t*)dst)[k] = (uint16_t)CLIP(value, 0, UINT16_MAX);
+        break;
+    case DVZ_DTYPE_SHORT:
+        ((int16_t*)dst)[k] = (int16_t)CLIP(value, INT16_MIN, INT16_MAX);
+        break;
+    case DVZ_DTYPE_UINT:
+        ((uint32_t*)dst)[k] = (uint32_t)CLIP(value, 0, UINT32_MAX);
+        break;
+    case DVZ_DTYPE_INT:
+        ((int32_t*)dst)[k] = (int32_t)CLIP(value, INT32_MIN, INT32_MAX);
+        break;
+    default:
+        break;
+    }
+}
+
+
+
+// Whether a CSV line has any content.
+static inline bool _csv_row(const char* s, const char* e)
+{
+    for (; s < e; s++)
+        if (*s != ' ' && *s != '\r' && *s != '\t')
+            return true;
+    return false;
+}
+
+
+
+// Number of rows in a chunk of a CSV file.
+static uint64_t _csv_count(const char* s, const char* e)
+{
+    uint64_t count = 0;
+    while (s < e)
+    {
+        const char* eol = (const char*)memchr(s, '\n', (size_t)(e - s));
+        eol = eol != NULL ? eol : e;
+        count += _csv_row(s, eol) ? 1 : 0;
+        s = eol + 1;
+    }
+    return count;
+}
+
+
+
+// Parse the selected columns of the rows of a chunk of a CSV file.
+static void _csv_parse(
+    const char* s, const char* e, char delimiter, uint32_t n, const uint32_t* columns,
+    DvzDataType scalar, DvzSize item_size, uint8_t* out)
+{
+    uint32_t last = 0;
+    for (uint32_t k = 0; k < n; k++)
+        last = MAX(last, columns[k]);
+
+    while (s < e)
+    {
+        const char* eol = (const char*)memchr(s, '\n', (size_t)(e - s));
+        eol = eol != NULL ? eol : e;
+        if (!_csv_row(s, eol))
+        {
+            s = eol + 1;
+            continue;
+        }
+
+        // Missing fields are NaN.
+        for (uint32_t k = 0; k < n; k++)
+            _csv_store(scalar, out, k, NAN);
+
+        const char* field = s;
+        for (uint32_t column = 0; column <= last && field <= eol; column++)
+        {
+            const char* end = (const char*)memchr(field, delimiter, (size_t)(eol - field));
+            end = end != NULL ? end : eol;
+            double value = NAN;
+            bool parsed = false;
+            for (uint32_t k = 0; k < n; k++)
+            {
+                if (columns[k] != column)
+                    continue;
+                if (!parsed)
+                    value = _csv_number(field, end);
+                parsed = true;
+                _csv_store(scalar, out, k, value);
+            }
+            field = end + 1;
+        }
+
+        out += item_size;
+        s = eol + 1;
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -250,6 +516,8 @@ DvzArray* dvz_array_copy(DvzArray* arr)
     memcpy(arr_new, arr, sizeof(DvzArray));
     arr_new->data = malloc(arr->buffer_size);
     memcpy(arr_new->data, arr->data, arr->buffer_size);
+    arr_new->mapping = NULL;
+    arr_new->mapping_size = 0;
     return arr_new;
 }
 
@@ -342,6 +610,268 @@ dvz_array_3D(uint32_t ndims, uint32_t width, uint32_t height, uint32_t depth, Dv
 
 
 
+/**
+ * Open a NumPy NPY file as an array, without copying the data.
+ *
+ * @param filename path of the NPY file
+ * @param flags the array flags
+ * @returns the array, or NULL if the file could not be opened
+ */
+DvzArray* dvz_array_npy(const char* filename, int flags)
+{
+    ANN(filename);
+
+    DvzSize size = 0;
+    char* bytes = (char*)dvz_file_map(filename, &size);
+    if (bytes == NULL)
+        return NULL;
+
+    DvzNpyHeader header = {0};
+    if (dvz_npy_header(size, bytes, &header) != 0)
+    {
+        log_error("unable to open the NPY file %s", filename);
+        dvz_file_unmap(bytes, size);
+        return NULL;
+    }
+    if (header.big_endian)
+    {
+        log_error("big-endian NPY files are not supported: %s", filename);
+        dvz_file_unmap(bytes, size);
+        return NULL;
+    }
+
+    DvzDataType dtype = _scalar_dtype(header.kind, header.item_size);
+
+    // The memory layout of a Fortran-ordered array is the one of its C-ordered transpose.
+    uint64_t shape[DVZ_NPY_MAX_DIMS] = {0};
+    uint32_t ndim = header.ndim;
+    for (uint32_t i = 0; i < ndim; i++)
+        shape[i] = header.shape[header.fortran_order ? ndim - 1 - i : i];
+
+    // Vector data type: the enum values of the vector types follow the scalar type.
+    DvzSize item_size = header.item_size;
+    bool vector = (flags & DVZ_ARRAY_FLAGS_VECTOR) != 0;
+    if (vector && dtype != DVZ_DTYPE_CUSTOM && ndim >= 2 && shape[ndim - 1] >= 2 &&
+        shape[ndim - 1] <= 4)
+    {
+        dtype = (DvzDataType)(dtype + shape[ndim - 1] - 1);
+        item_size *= shape[ndim - 1];
+        ndim--;
+    }
+
+    uint64_t item_count = item_size > 0 ? header.data_size / item_size : 0;
+    if (item_count > UINT32_MAX)
+    {
+        log_error("too many items in the NPY file %s", filename);
+        dvz_file_unmap(bytes, size);
+        return NULL;
+    }
+
+    DvzArray* arr = _create_array(0, dtype, item_size);
+    arr->item_count = (uint32_t)item_count;
+    arr->buffer_size = header.data_size;
+    arr->data = bytes + header.data_offset;
+    arr->mapping = bytes;
+    arr->mapping_size = size;
+
+    // Shape, with the last dimension varying the fastest. Dimensions beyond the third one are
+    // merged into the third one.
+    arr->ndims = MAX(1, MIN(ndim, 3));
+    arr->shape[0] = arr->shape[1] = arr->shape[2] = 1;
+    for (uint32_t i = 0; i < ndim; i++)
+        arr->shape[MIN(i, 2)] *= (uint32_t)shape[ndim - 1 - i];
+    if (ndim == 0)
+        arr->shape[0] = arr->item_count;
+
+    log_debug(
+        "mapped NPY file %s with %d items of %s", filename, arr->item_count,
+        pretty_size(arr->item_size));
+    return arr;
+}
+
+
+
+/**
+ * Load columns of a CSV or TSV file into a new array.
+ *
+ * @param filename path of the CSV file
+ * @param delimiter the field delimiter, or 0 to detect it from the first row
+ * @param skip_rows number of header rows to skip
+ * @param columns the indices of the columns, one per component of the data type
+ * @param dtype the data type of the array
+ * @returns the array, or NULL if the file could not be opened
+ */
+DvzArray* dvz_array_csv(
+    const char* filename, char delimiter, uint32_t skip_rows, const uint32_t* columns,
+    DvzDataType dtype)
+{
+    ANN(filename);
+    ANN(columns);
+
+    // NOTE: the enum values of the vector types follow the scalar type.
+    uint32_t n = _get_components(dtype);
+    if (n == 0)
+    {
+        log_error("unsupported data type %d for CSV loading", dtype);
+        return NULL;
+    }
+    DvzDataType scalar = (DvzDataType)(dtype - (n - 1));
+    DvzSize item_size = _get_dtype_size(dtype);
+
+    DvzSize size = 0;
+    char* bytes = (char*)dvz_file_map(filename, &size);
+    if (bytes == NULL)
+        return NULL;
+    const char* start = bytes;
+    const char* end = bytes + size;
+
+    // Skip the UTF-8 byte order mark and the header rows.
+    if (size >= 3 && memcmp(start, "\xEF\xBB\xBF", 3) == 0)
+        start += 3;
+    for (uint32_t i = 0; i < skip_rows && start < end; i++)
+    {
+        const char* eol = (const char*)memchr(start, '\n', (size_t)(end - start));
+        start = eol != NULL ? eol + 1 : end;
+    }
+
+    // Detect the delimiter from the first row.
+    if (delimiter == 0)
+    {
+        const char* eol = (const char*)memchr(start, '\n', (size_t)(end - start));
+        eol = eol != NULL ? eol : end;
+        uint32_t commas = 0, tabs = 0, semicolons = 0;
+        for (const char* c = start; c < eol; c++)
+        {
+            commas += *c == ',' ? 1 : 0;
+            tabs += *c == '\t' ? 1 : 0;
+            semicolons += *c == ';' ? 1 : 0;
+        }
+        delimiter = tabs > commas && tabs >= semicolons ? '\t'
+                    : semicolons > commas                ? ';'
+                                                         : ',';
+    }
+
+    // Split the file into chunks starting at the beginning of a line.
+    DvzSize data_size = (DvzSize)(end - start);
+    uint32_t chunk_count = (uint32_t)MAX(1, (data_size + CSV_CHUNK_SIZE - 1) / CSV_CHUNK_SIZE);
+    const char** bounds = (const char**)calloc(chunk_count + 1, sizeof(char*));
+    uint64_t* offsets = (uint64_t*)calloc(chunk_count + 1, sizeof(uint64_t));
+    bounds[0] = start;
+    bounds[chunk_count] = end;
+    for (uint32_t i = 1; i < chunk_count; i++)
+    {
+        const char* b = MAX(start + (DvzSize)i * CSV_CHUNK_SIZE - 1, bounds[i - 1]);
+        const char* eol = (const char*)memchr(b, '\n', (size_t)(end - b));
+        bounds[i] = eol != NULL ? eol + 1 : end;
+    }
+
+    // Count the rows in parallel.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t i = 0; i < (int64_t)chunk_count; i++)
+        offsets[i + 1] = _csv_count(bounds[i], bounds[i + 1]);
+    for (uint32_t i = 0; i < chunk_count; i++)
+        offsets[i + 1] += offsets[i];
+
+    uint64_t row_count = offsets[chunk_count];
+    DvzArray* arr = NULL;
+    if (row_count > UINT32_MAX)
+    {
+        log_error("too many rows in the CSV file %s", filename);
+    }
+    else
+    {
+        arr = _create_array((uint32_t)row_count, dtype, item_size);
+
+        // Parse the rows in parallel, each chunk knows where its rows go.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int64_t i = 0; i < (int64_t)chunk_count; i++)
+        {
+            _csv_parse(
+                bounds[i], bounds[i + 1], delimiter, n, columns, scalar, item_size,
+                (uint8_t*)arr->data + offsets[i] * item_size);
+        }
+
+        log_debug(
+            "loaded %" PRIu64 " rows of %s from CSV file %s", row_count, pretty_size(item_size),
+            filename);
+    }
+
+    FREE(bounds);
+    FREE(offsets);
+    dvz_file_unmap(bytes, size);
+    return arr;
+}
+
+
+
+/**
+ * Create a read-only view of a column of a record batch of an Arrow IPC file.
+ *
+ * @param arrow the Arrow file opened with dvz_arrow_open()
+ * @param batch the record batch index
+ * @param field the column index
+ * @param[out] mask if not NULL, receives the validity mask, or NULL if the column has no nulls
+ * @returns the array, or NULL if the column is not supported
+ */
+DvzArray* dvz_array_arrow(DvzArrowFile* arrow, uint32_t batch, uint32_t field, DvzArray** mask)
+{
+    ANN(arrow);
+    if (mask != NULL)
+        *mask = NULL;
+
+    DvzArrowColumn column = {0};
+    if (dvz_arrow_column(arrow, batch, field, &column) != 0)
+        return NULL;
+    if (column.length > UINT32_MAX)
+    {
+        log_error("too many rows in the Arrow column %s", arrow->fields[field].name);
+        return NULL;
+    }
+    uint32_t count = (uint32_t)column.length;
+    DvzArrowField* f = &arrow->fields[field];
+
+    DvzArray* arr = NULL;
+    if (f->kind == 'b')
+    {
+        // NOTE: booleans are bit-packed, they cannot be used without a copy.
+        arr = _unpack_bits(count, (const uint8_t*)column.data);
+    }
+    else
+    {
+        // Vector data type: the enum values of the vector types follow the scalar type.
+        DvzDataType dtype = _scalar_dtype(f->kind, f->item_size);
+        if (dtype != DVZ_DTYPE_CUSTOM && f->components >= 2 && f->components <= 4)
+            dtype = (DvzDataType)(dtype + f->components - 1);
+
+        if (dtype != DVZ_DTYPE_CUSTOM && _get_components(dtype) == f->components)
+        {
+            arr = dvz_array_wrap(count, dtype, (void*)column.data);
+        }
+        else
+        {
+            arr = _create_array(0, DVZ_DTYPE_CUSTOM, f->item_size * f->components);
+            arr->item_count = count;
+            arr->buffer_size = column.data_size;
+            arr->data = (void*)column.data;
+        }
+
+        // The mapping belongs to the Arrow file, the array does not release it.
+        arr->mapping = arrow->mapping;
+        arr->mapping_size = 0;
+    }
+
+    if (mask != NULL && column.validity != NULL)
+        *mask = _unpack_bits(count, column.validity);
+
+    return arr;
+}
+
+
+
 /**
  * Resize an existing array.
  *
@@ -364,6 +894,9 @@ void dvz_array_resize(DvzArray* array, uint32_t item_count)
     if (item_count == old_item_count)
         return;
 
+    if (_is_mapped(array))
+        return;
+
     // If the array was not allocated, allocate it with the specified size.
     if (array->data == NULL)
     {
@@ -414,6 +947,8 @@ void dvz_array_resize(DvzArray* array, uint32_t item_count)
 void dvz_array_clear(DvzArray* array)
 {
     ANN(array);
+    if (_is_mapped(array))
+        return;
     memset(array->data, 0, array->buffer_size);
 }
 
@@ -443,6 +978,9 @@ void dvz_array_reshape(DvzArray* array, uint32_t width, uint32_t height, uint32_
     if (width == array->shape[0] && height == array->shape[1] && depth == array->shape[2])
         return;
 
+    if (_is_mapped(array))
+        return;
+
     // Resize the underlying buffer.
     dvz_array_resize(array, item_count);
 
@@ -470,6 +1008,8 @@ void dvz_array_insert(DvzArray* array, uint32_t offset, uint32_t size, void* ins
     ANN(array);
     ASSERT(size > 0);
     ANN(insert);
+    if (_is_mapped(array))
+        return;
 
     // Size of the chunk to move to make place for the inserted buffer.
     DvzSize chunk1_size = (array->item_count - offset) * array->item_size;
@@ -515,6 +1055,8 @@ void dvz_array_copy_region(
     ASSERT(dst_offset + item_count <= dst_arr->item_count);
     ASSERT(src_arr->dtype == dst_arr->dtype);
     ASSERT(src_arr->item_size == dst_arr->item_size);
+    if (_is_mapped(dst_arr))
+        return;
 
     void* src = (void*)((int64_t)src_arr->data + ((int64_t)(src_offset * src_arr->item_size)));
     void* dst = (void*)((int64_t)dst_arr->data + ((int64_t)(dst_offset * dst_arr->item_size)));
@@ -561,6 +1103,8 @@ void dvz_array_data(
         log_debug("skipping dvz_array_data() with NULL data");
         return;
     }
+    if (_is_mapped(array))
+        return;
     ASSERT(item_count > 0);
 
     // Resize if necessary.
@@ -614,6 +1158,8 @@ void dvz_array_data(
 void dvz_array_scale(DvzArray* arr, float scaling)
 {
     ANN(arr);
+    if (_is_mapped(arr))
+        return;
     // TODO: support other dtypes.
     if (arr->dtype == DVZ_DTYPE_FLOAT)
     {
@@ -658,6 +1204,8 @@ void dvz_array_column(
     ANN(data);
     ASSERT(item_count > 0);
     ASSERT(first_item + item_count <= array->item_count);
+    if (_is_mapped(array))
+        return;
 
     DvzSize src_offset = 0;
     DvzSize src_stride = col_size;
@@ -720,6 +1268,30 @@ void dvz_array_column(
 
 
 
+void* dvz_array_buffer(DvzArray* array)
+{
+    ANN(array);
+    return array->data;
+}
+
+
+
+uint32_t dvz_array_count(DvzArray* array)
+{
+    ANN(array);
+    return array->item_count;
+}
+
+
+
+DvzDataType dvz_array_dtype(DvzArray* array)
+{
+    ANN(array);
+    return array->dtype;
+}
+
+
+
 void dvz_array_print(DvzArray* array)
 {
     ANN(array);
@@ -750,6 +1322,12 @@ void dvz_array_destroy(DvzArray* array)
     if (!dvz_obj_is_created(&array->obj))
         return;
     dvz_obj_destroyed(&array->obj);
+    if (array->mapping != NULL)
+    {
+        if (array->mapping_size > 0)
+            dvz_file_unmap(array->mapping, array->mapping_size);
+        array->data = NULL;
+    }
     FREE(array->data);
     FREE(array);
 }
@@ -20,6 +20,7 @@
 #include "datoviz_types.h"
 #include "scene/axis.h"
 #include "scene/labels.h"
+#include "scene/mvp.h"
 #include "scene/scene.h"
 #include "scene/ticks.h"
 #include "scene/transform.h"
@@ -123,6 +124,66 @@ static void axis_vertical_pos(DvzAxis* axis, float y0, float y1, vec3 p0, vec3 p
     glm_vec3_copy((vec3){1, 0, 0}, vector);
 }
 
+// Scale of the panel MVP along one axis (0 for x, 1 for y).
+static DvzScaleType axis_scale(DvzAxes* axes, uint32_t dim, double* param)
+{
+    ANN(axes);
+    ANN(axes->panel);
+    ANN(param);
+    ASSERT(dim < 2);
+
+    *param = 0;
+    if (axes->panel->transform == NULL)
+        return DVZ_SCALE_LINEAR;
+
+    DvzMVP* mvp = dvz_transform_mvp(axes->panel->transform);
+    *param = mvp->scale_param[dim];
+    return (DvzScaleType)mvp->scale_type[dim];
+}
+
+// On a nonlinear axis, the vertex shader applies the scale to the tick positions, which are then
+// the tick values in data coordinates. The visible data range is obtained by inverting the MVP
+// matrices and the scale along the axis.
+static void scaled_range(DvzMVP* mvp, uint32_t dim, dvec2 range_data, vec2 range_ndc)
+{
+    ANN(mvp);
+    ASSERT(dim < 2);
+
+    // Clip coordinates of two points of the scaled space, with the scales disabled.
+    DvzMVP lin = *mvp;
+    for (uint32_t i = 0; i < 3; i++)
+        lin.scale_type[i] = DVZ_SCALE_LINEAR;
+    vec4 q0 = {0, 0, 0, 1};
+    vec4 q1 = {0, 0, 0, 1};
+    q1[dim] = 1;
+    dvz_mvp_apply(&lin, q0, q0);
+    dvz_mvp_apply(&lin, q1, q1);
+    double c0 = q0[dim] / q0[3];
+    double c1 = q1[dim] / q1[3];
+    ASSERT(c1 != c0);
+
+    // Scaled coordinates of the edges of the view, back to data coordinates.
+    DvzScaleType type = (DvzScaleType)mvp->scale_type[dim];
+    double param = mvp->scale_param[dim];
+    double a = mvp->scale_a[dim];
+    double b = mvp->scale_b[dim];
+    ASSERT(a != 0);
+
+    double w = 0;
+    dvec2 d = {0};
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        w = ((2.0 * i - 1) - c0) / (c1 - c0);
+        d[i] = dvz_scale_inverse(type, param, (w - b) / a);
+    }
+    range_data[0] = MIN(d[0], d[1]);
+    range_data[1] = MAX(d[0], d[1]);
+
+    // The tick positions are the data values.
+    range_ndc[0] = (float)range_data[0];
+    range_ndc[1] = (float)range_data[1];
+}
+
 // NOTE: the caller must FREE the output.
 static char* concatenate_strings(
     uint32_t glyph_count, uint32_t tick_count, char* string_labels, uint32_t* index)
@@ -163,6 +224,11 @@ compute_ticks(DvzAxes* axes, DvzTicksFlags which, double dmin, double dmax, floa
     ANN(labels);
     ANN(axis);
 
+    // On a nonlinear axis, the ticks are computed in the scaled space of the panel MVP.
+    double param = 0;
+    DvzScaleType scale = axis_scale(axes, horizontal ? 0 : 1, &param);
+    dvz_ticks_scale(ticks, scale, param);
+
     // Specify the axis positions.
     vec3 p0, p1, vector;
     if (horizontal)
@@ -197,8 +263,23 @@ compute_ticks(DvzAxes* axes, DvzTicksFlags which, double dmin, double dmax, floa
     double offset = 0.0;
 
     // Generate the tick labels.
-    uint32_t glyph_count = dvz_labels_generate(
-        labels, DVZ_TICKS_FORMAT_DECIMAL, precision, exponent, offset, lmin, lmax, lstep);
+    uint32_t glyph_count = 0;
+    if (scale == DVZ_SCALE_LINEAR)
+    {
+        glyph_count = dvz_labels_generate(
+            labels, DVZ_TICKS_FORMAT_DECIMAL, precision, exponent, offset, lmin, lmax, lstep);
+    }
+    else
+    {
+        // On a nonlinear axis, the labels show the tick values in data coordinates, which are
+        // also the tick positions.
+        double tick_values[MAX_LABELS] = {0};
+        tick_count = dvz_ticks_values(ticks, MAX_LABELS, tick_values);
+        if (scale == DVZ_SCALE_LOG10 && lstep == round(lstep))
+            precision = 0; // integer decades
+        glyph_count = dvz_labels_from_values(
+            labels, DVZ_TICKS_FORMAT_SCIENTIFIC, precision, tick_count, tick_values);
+    }
 
     // Obtain the arrays generated by the labels.
     char* string_labels = dvz_labels_string(labels);
@@ -289,9 +370,18 @@ DvzAxes* dvz_axes(DvzPanel* panel, int flags)
     axis_horizontal_params(axes->xaxis);
     axis_vertical_params(axes->yaxis);
 
-    // Initial.
-    compute_ticks(axes, DVZ_TICKS_FLAGS_HORIZONTAL, -1, 1, -1, 1);
-    compute_ticks(axes, DVZ_TICKS_FLAGS_VERTICAL, -1, 1, -1, 1);
+    // Initial, on the visible data range on the nonlinear axes of the panel.
+    DvzMVP* mvp = panel->transform != NULL ? dvz_transform_mvp(panel->transform) : NULL;
+    for (uint32_t dim = 0; dim < 2; dim++)
+    {
+        dvec2 range = {-1, 1};
+        vec2 range_ndc = {-1, 1};
+        if (mvp != NULL && mvp->scale_type[dim] != DVZ_SCALE_LINEAR)
+            scaled_range(mvp, dim, range, range_ndc);
+        compute_ticks(
+            axes, dim == 0 ? DVZ_TICKS_FLAGS_HORIZONTAL : DVZ_TICKS_FLAGS_VERTICAL, //
+            range[0], range[1], range_ndc[0], range_ndc[1]);
+    }
 
     // TODO: margins.
     dvz_panel_margins(panel, 20, 20, 120, 120);
@@ -327,7 +417,10 @@ void dvz_axes_xget(DvzAxes* axes, dvec2 range_data, vec2 range_ndc)
     ANN(axes->panel);
 
     DvzMVP* mvp = dvz_transform_mvp(axes->panel->transform);
-    dvz_axis_mvp(axes->xaxis, mvp, range_data, range_ndc);
+    if (mvp->scale_type[0] != DVZ_SCALE_LINEAR)
+        scaled_range(mvp, 0, range_data, range_ndc);
+    else
+        dvz_axis_mvp(axes->xaxis, mvp, range_data, range_ndc);
 }
 
 
@@ -338,7 +431,10 @@ void dvz_axes_yget(DvzAxes* axes, dvec2 range_data, vec2 range_ndc)
     ANN(axes->panel);
 
     DvzMVP* mvp = dvz_transform_mvp(axes->panel->transform);
-    dvz_axis_mvp(axes->yaxis, mvp, range_data, range_ndc);
+    if (mvp->scale_type[1] != DVZ_SCALE_LINEAR)
+        scaled_range(mvp, 1, range_data, range_ndc);
+    else
+        dvz_axis_mvp(axes->yaxis, mvp, range_data, range_ndc);
 }
 
 
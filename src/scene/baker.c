@@ -21,10 +21,129 @@
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Number of positions normalized per block in dvz_baker_normalize().
+#define NORMALIZE_BLOCK 1024
+
+#define SNORM16_MAX 32767.0f
+
+
+
 /*************************************************************************************************/
 /*  Internal functions                                                                           */
 /*************************************************************************************************/
 
+static inline int16_t _snorm16(float value)
+{
+    value = CLIP(value, -1.0f, 1.0f);
+    return (int16_t)lrintf(value * SNORM16_MAX);
+}
+
+
+
+// IEEE 754 half-precision conversion, rounding to nearest even.
+static inline uint16_t _half(float value)
+{
+    uint32_t x = 0;
+    memcpy(&x, &value, sizeof(x));
+
+    uint16_t sign = (uint16_t)((x >> 16) & 0x8000);
+    uint32_t exponent = (x >> 23) & 0xFF;
+    uint32_t mantissa = x & 0x7FFFFF;
+
+    // Infinity and NaN.
+    if (exponent == 0xFF)
+        return (uint16_t)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+
+    int32_t e = (int32_t)exponent - 127 + 15;
+    uint32_t h = 0, rem = 0, mid = 0;
+    if (e >= 0x1F)
+    {
+        // Overflow.
+        return (uint16_t)(sign | 0x7C00);
+    }
+    else if (e <= 0)
+    {
+        // Subnormal or zero.
+        if (e < -10)
+            return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - e);
+        h = mantissa >> shift;
+        rem = mantissa & ((1u << shift) - 1);
+        mid = 1u << (shift - 1);
+    }
+    else
+    {
+        h = ((uint32_t)e << 10) | (mantissa >> 13);
+        rem = mantissa & 0x1FFF;
+        mid = 0x1000;
+    }
+
+    // NOTE: the carry may propagate to the exponent, which is the correct rounding.
+    if (rem > mid || (rem == mid && (h & 1)))
+        h++;
+    return (uint16_t)(sign | h);
+}
+
+
+
+static inline void _write_position(uint8_t* dst, vec3 pos, bool is_snorm)
+{
+    if (is_snorm)
+    {
+        int16_t q[4] = {_snorm16(pos[0]), _snorm16(pos[1]), _snorm16(pos[2]), 0};
+        memcpy(dst, q, sizeof(q));
+    }
+    else
+    {
+        memcpy(dst, pos, sizeof(vec3));
+    }
+}
+
+
+
+
+static DvzDual* _attr_dual(DvzBaker* baker, uint32_t attr_idx, uint32_t required_count)
+{
+    ANN(baker);
+    if (baker->attr_count == 0)
+    {
+        log_error("unitialized baker (attribute #%d)", attr_idx);
+        return NULL;
+    }
+    ASSERT(attr_idx < baker->attr_count);
+
+    DvzBakerAttr* attr = &baker->vertex_attrs[attr_idx];
+    uint32_t binding_idx = attr->binding_idx;
+    ASSERT(binding_idx < baker->binding_count);
+
+    DvzBakerVertex* vertex = &baker->vertex_bindings[binding_idx];
+    ASSERT(vertex->stride > 0);
+
+    DvzDual* dual = &vertex->dual;
+    if (dual->array == NULL)
+    {
+        log_error("dual's array is null, please call dvz_baker_create()");
+        return NULL;
+    }
+
+    if (required_count > dual->array->item_count)
+    {
+        log_error(
+            "baker vertex array is too small (%d) to hold the vertices (%d)",
+            dual->array->item_count, required_count);
+        return NULL;
+    }
+
+    return dual;
+}
+
+
+
 static void _check_sizes(DvzBaker* baker)
 {
     DvzSize sizes[DVZ_MAX_VERTEX_BINDINGS] = {0};
@@ -75,7 +194,7 @@ static void _create_vertex_binding(DvzBaker* baker, uint32_t binding_idx, uint32
 
 
 
-static void _create_index(DvzBaker* baker, uint32_t index_count)
+static void _create_index(DvzBaker* baker, uint32_t index_count, uint32_t vertex_count)
 {
     ANN(baker);
     ASSERT(index_count > 0);
@@ -83,19 +202,59 @@ static void _create_index(DvzBaker* baker, uint32_t index_count)
     log_trace("create index buffer with %d vertices, create dat and array", index_count);
     if (baker->index_shared)
     {
+        // The shared index buffer keeps its 32-bit indices.
         log_trace("skipping creation of dat for shared index buffer");
         return;
     }
+
+    // Small meshes use 16-bit indices, halving the index buffer size.
+    baker->index_size = vertex_count < DVZ_BAKER_INDEX16_MAX_VERTICES && !baker->index32
+                            ? sizeof(uint16_t)
+                            : sizeof(DvzIndex);
     int dual_flags = ((baker->flags & DVZ_BAKER_FLAGS_INDEX_MAPPABLE) == 0)
                          ? DVZ_DAT_FLAGS_PERSISTENT_STAGING
                          : DVZ_DAT_FLAGS_MAPPABLE;
-    baker->index = dvz_dual_index(baker->batch, index_count, dual_flags);
+    baker->index = dvz_dual_index(baker->batch, index_count, baker->index_size, dual_flags);
     // NOTE; mark the dual as needing to be destroyed by the library
     baker->index.need_destroy = true;
 }
 
 
 
+// Switch a 16-bit index buffer to 32-bit indices, when the number of vertices becomes too large.
+static void _widen_index(DvzBaker* baker)
+{
+    ANN(baker);
+    DvzDual* dual = &baker->index;
+    ANN(dual->array);
+    ASSERT(baker->index_size == sizeof(uint16_t));
+
+    log_debug("switching the index buffer to 32-bit indices");
+    uint32_t count = dual->array->item_count;
+    DvzArray* array = dvz_array_struct(count, sizeof(DvzIndex));
+    uint16_t* src = (uint16_t*)dual->array->data;
+    DvzIndex* dst = (DvzIndex*)array->data;
+    for (uint32_t i = 0; i < count; i++)
+        dst[i] = src[i];
+
+    dvz_array_destroy(dual->array);
+    dual->array = array;
+    baker->index_size = sizeof(DvzIndex);
+}
+
+
+
+static inline DvzIndex _index_at(DvzBaker* baker, uint32_t i)
+{
+    ANN(baker);
+    void* item = dvz_array_item(baker->index.array, i);
+    if (baker->index_size == sizeof(uint16_t))
+        return *(uint16_t*)item;
+    return *(DvzIndex*)item;
+}
+
+
+
 static void _create_indirect(DvzBaker* baker, bool indexed)
 {
     ANN(baker);
@@ -121,6 +280,7 @@ DvzBaker* dvz_baker(DvzBatch* batch, int flags)
     // 00xx: which attributes should be in a different buf (8 max)
     // xx00: which attributes should be constants
     baker->flags = flags;
+    baker->index_size = sizeof(DvzIndex);
 
     return baker;
 }
@@ -153,7 +313,7 @@ void dvz_baker_create(DvzBaker* baker, uint32_t index_count, uint32_t vertex_cou
     // Create the index buffer.
     if (index_count > 0)
     {
-        _create_index(baker, index_count);
+        _create_index(baker, index_count, vertex_count);
     }
 
     // Create the indirect buffer.
@@ -335,11 +495,22 @@ void dvz_baker_resize(DvzBaker* baker, uint32_t vertex_count, uint32_t index_cou
 
     // Resizing the index buffer.
 
+    // Too many vertices for 16-bit indices.
+    bool widen = baker->index.array != NULL && !baker->index_shared &&
+                 baker->index_size == sizeof(uint16_t) &&
+                 vertex_count >= DVZ_BAKER_INDEX16_MAX_VERTICES;
+    if (widen)
+        _widen_index(baker);
+
     // Resize the underlying dual array.
     dvz_array_resize(baker->index.array, index_count);
 
     // Emit the dual's dat resize commands.
     dvz_dual_resize(&baker->index, index_count);
+
+    // The existing indices need to be uploaded again with the new index size.
+    if (widen)
+        dvz_dual_dirty(&baker->index, 0, index_count);
 }
 
 
@@ -349,51 +520,162 @@ void dvz_baker_repeat(
     void* data)
 {
     ANN(baker);
-    if (baker->attr_count == 0)
-    {
-        log_error("unitialized baker (attribute #%d)", attr_idx);
-        return;
-    }
-    ASSERT(attr_idx < baker->attr_count);
     ASSERT(count > 0);
     ANN(data);
 
+    DvzDual* dual = _attr_dual(baker, attr_idx, first + count * repeats);
+    if (dual == NULL)
+        return;
+
     DvzBakerAttr* attr = &baker->vertex_attrs[attr_idx];
-    uint32_t binding_idx = attr->binding_idx;
-    ASSERT(binding_idx < baker->binding_count);
+    DvzSize offset = attr->offset;
+    DvzSize item_size = attr->item_size;
+    ASSERT(item_size > 0);
 
-    DvzBakerVertex* vertex = &baker->vertex_bindings[binding_idx];
+    // log_info("%d %d %d %d %d", offset, item_size, first, count, repeats);
+    dvz_dual_column(dual, offset, item_size, first, count, repeats, data);
+}
 
-    DvzDual* dual = &vertex->dual;
+
+
+void dvz_baker_normalize(
+    DvzBaker* baker, uint32_t attr_idx, uint32_t first, uint32_t count, uint32_t repeats,
+    DvzBox source, DvzBox target, dvec3* pos)
+{
+    ANN(baker);
+    ASSERT(count > 0);
+    ASSERT(repeats > 0);
+    ANN(pos);
+
+    DvzDual* dual = _attr_dual(baker, attr_idx, first + count * repeats);
     if (dual == NULL)
+        return;
+
+    DvzBakerAttr* attr = &baker->vertex_attrs[attr_idx];
+    bool is_snorm = attr->item_size == 4 * sizeof(int16_t);
+    if (attr->item_size != sizeof(vec3) && !is_snorm)
     {
-        log_error("dual is null, please call dvz_baker_create()");
+        log_error(
+            "attribute #%d has size %d, expected a vec3 or a snorm16x4 attribute", attr_idx,
+            attr->item_size);
         return;
     }
-    ANN(dual);
-    if (dual->array == NULL)
+
+    DvzArray* array = dual->array;
+    ANN(array);
+    ANN(array->data);
+
+    // Same mapping as dvz_box_normalize(), so that both paths give identical results.
+    double scale_x =
+        source.xmax != source.xmin ? (target.xmax - target.xmin) / (source.xmax - source.xmin) : 1;
+    double scale_y =
+        source.ymax != source.ymin ? (target.ymax - target.ymin) / (source.ymax - source.ymin) : 1;
+    double scale_z =
+        source.zmax != source.zmin ? (target.zmax - target.zmin) / (source.zmax - source.zmin) : 1;
+
+    // Write the normalized positions directly in the vertex array column, without any
+    // intermediate single-precision buffer.
+    DvzSize stride = array->item_size;
+    uint8_t* dst = (uint8_t*)array->data + first * stride + attr->offset;
+    uint32_t block_count = (count + NORMALIZE_BLOCK - 1) / NORMALIZE_BLOCK;
+
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t b = 0; b < block_count; b++)
     {
-        log_error("dual's array is null");
+        uint32_t start = b * NORMALIZE_BLOCK;
+        uint32_t end = MIN(start + NORMALIZE_BLOCK, count);
+        vec3 tmp[NORMALIZE_BLOCK];
+
+        // Vectorizable pass over contiguous memory.
+        for (uint32_t i = start; i < end; i++)
+        {
+            tmp[i - start][0] = (float)((pos[i][0] - source.xmin) * scale_x + target.xmin);
+            tmp[i - start][1] = (float)((pos[i][1] - source.ymin) * scale_y + target.ymin);
+            tmp[i - start][2] = (float)((pos[i][2] - source.zmin) * scale_z + target.zmin);
+        }
+
+        // Strided scatter into the interleaved vertex buffer.
+        for (uint32_t i = start; i < end; i++)
+        {
+            for (uint32_t r = 0; r < repeats; r++)
+            {
+                _write_position(dst + (i * repeats + r) * stride, tmp[i - start], is_snorm);
+            }
+        }
+    }
+
+    dvz_dual_dirty(dual, first, repeats * count);
+}
+
+
+
+void dvz_baker_quantize(
+    DvzBaker* baker, uint32_t attr_idx, uint32_t first, uint32_t count, uint32_t repeats,
+    DvzFormat format, float scale, float* values)
+{
+    ANN(baker);
+    ASSERT(count > 0);
+    ASSERT(repeats > 0);
+    ANN(values);
+
+    DvzDual* dual = _attr_dual(baker, attr_idx, first + count * repeats);
+    if (dual == NULL)
+        return;
+
+    // Number of input floats per item, and quantized size.
+    uint32_t components = 0;
+    DvzSize size = 0;
+    switch (format)
+    {
+    case DVZ_FORMAT_R16G16B16A16_SNORM:
+        components = 3; // the fourth component is set to 0
+        size = 4 * sizeof(int16_t);
+        break;
+    case DVZ_FORMAT_R16_SNORM:
+    case DVZ_FORMAT_R16_SFLOAT:
+        components = 1;
+        size = sizeof(int16_t);
+        break;
+    default:
+        log_error("unsupported quantized format %d", format);
         return;
     }
 
-    if (first + count * repeats > dual->array->item_count)
+    DvzBakerAttr* attr = &baker->vertex_attrs[attr_idx];
+    if (attr->item_size != size)
     {
         log_error(
-            "baker vertex array is too small (%d) to hold the vertices (%d)",
-            dual->array->item_count, first + count * repeats);
+            "attribute #%d has size %d, expected %d for format %d", attr_idx, attr->item_size,
+            size, format);
         return;
     }
 
-    DvzSize offset = attr->offset;
-    DvzSize item_size = attr->item_size;
-    ASSERT(item_size > 0);
+    DvzArray* array = dual->array;
+    ANN(array);
+    ANN(array->data);
 
-    DvzSize col_size = vertex->stride;
-    ASSERT(col_size > 0);
+    DvzSize stride = array->item_size;
+    uint8_t* dst = (uint8_t*)array->data + first * stride + attr->offset;
+    bool is_half = format == DVZ_FORMAT_R16_SFLOAT;
 
-    // log_info("%d %d %d %d %d", offset, item_size, first, count, repeats);
-    dvz_dual_column(dual, offset, item_size, first, count, repeats, data);
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t q[4] = {0};
+        for (uint32_t c = 0; c < components; c++)
+        {
+            float v = values[i * components + c] * scale;
+            q[c] = is_half ? _half(v) : (uint16_t)_snorm16(v);
+        }
+        for (uint32_t r = 0; r < repeats; r++)
+            memcpy(dst + (i * repeats + r) * stride, q, size);
+    }
+
+    dvz_dual_dirty(dual, first, repeats * count);
 }
 
 
@@ -427,7 +709,41 @@ void dvz_baker_index(DvzBaker* baker, uint32_t first, uint32_t count, DvzIndex*
         return;
     }
 
-    dvz_dual_data(dual, first, count, (void*)data);
+    // Indices out of the 16-bit range switch the index buffer to 32-bit indices. The dat is
+    // resized, so all the indices need to be uploaded again.
+    if (baker->index_size == sizeof(uint16_t))
+    {
+        DvzIndex max_index = 0;
+#if HAS_OPENMP
+#pragma omp parallel for reduction(max : max_index)
+#endif
+        for (uint32_t i = 0; i < count; i++)
+            max_index = MAX(max_index, data[i]);
+
+        if (max_index > UINT16_MAX)
+        {
+            _widen_index(baker);
+            dvz_dual_resize(dual, dual->array->item_count);
+            dvz_dual_dirty(dual, 0, dual->array->item_count);
+        }
+    }
+
+    if (baker->index_size == sizeof(DvzIndex))
+    {
+        dvz_dual_data(dual, first, count, (void*)data);
+        return;
+    }
+
+    // Conversion to 16-bit indices.
+    ASSERT(baker->index_size == sizeof(uint16_t));
+    uint16_t* indices = (uint16_t*)dvz_array_item(dual->array, first);
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t i = 0; i < count; i++)
+        indices[i] = (uint16_t)data[i];
+
+    dvz_dual_dirty(dual, first, count);
 }
 
 
@@ -482,9 +798,6 @@ void dvz_baker_unindex(DvzBaker* baker)
     ANN(index);
     ANN(index->array);
 
-    // Index array.
-    DvzIndex* indices = (DvzIndex*)index->array->data;
-    ANN(indices);
 
     // Number of indices.
     uint32_t index_count = index->array->item_count;
@@ -517,7 +830,7 @@ void dvz_baker_unindex(DvzBaker* baker)
         DvzIndex vertex_idx = 0;
         for (uint32_t i = 0; i < index_count; i++)
         {
-            vertex_idx = indices[i];
+            vertex_idx = _index_at(baker, i);
             ASSERT(vertex_idx < vertex_count);
             memcpy(
                 (void*)((uint64_t)vertices + vertex_size * i),               //
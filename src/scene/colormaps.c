@@ -37,6 +37,15 @@
 static unsigned char* DVZ_COLORMAP_ARRAY;
 #pragma GCC visibility pop
 
+// Number of values processed at once by a thread in the bulk colormapping functions.
+#define LUT_BLOCK 1024
+
+// Indices of the special colors in the extended lookup table.
+#define LUT_UNDER 256
+#define LUT_OVER  257
+#define LUT_NAN   258
+#define LUT_SIZE  259
+
 
 
 /*************************************************************************************************/
@@ -103,6 +112,93 @@ static inline void _colormap_idx(DvzColormap cmap, uint8_t value, cvec2 out)
 
 
 
+// Concatenate the colors and the special colors of a lookup table.
+static inline void _lut_table(DvzColormapLut* lut, DvzColor* table)
+{
+    ANN(lut);
+    ANN(table);
+    memcpy(table, lut->colors, 256 * sizeof(DvzColor));
+    memcpy(table[LUT_UNDER], lut->under, sizeof(DvzColor));
+    memcpy(table[LUT_OVER], lut->over, sizeof(DvzColor));
+    memcpy(table[LUT_NAN], lut->nan, sizeof(DvzColor));
+}
+
+
+
+/*
+ * Branch-free computation of the lookup table index of a value rescaled to
+ * x = (v-vmin)/(vmax-vmin). The same computation as _scale_uint8() for values within [0, 1],
+ * special indices otherwise. The clamping before the integer conversion protects against NaN
+ * and infinite values.
+ */
+#define LUT_INDEX(x, out)                                                                         \
+    {                                                                                             \
+        float _y = (float)(x)*256.0f;                                                             \
+        _y = _y >= 0 ? _y : 0;                                                                    \
+        _y = _y < 255 ? _y : 255;                                                                 \
+        uint16_t _k = (uint16_t)_y;                                                               \
+        _k = (x) < 0 ? LUT_UNDER : _k;                                                            \
+        _k = (x) > 1 ? LUT_OVER : _k;                                                             \
+        _k = (x) != (x) ? LUT_NAN : _k;                                                           \
+        (out) = _k;                                                                               \
+    }
+
+
+
+// NOTE: the index loops below are kept separate from the gather loop so that the compiler can
+// vectorize them.
+static inline void
+_lut_index_float(uint32_t n, const float* values, float vmin, float d, uint16_t* idx)
+{
+    for (uint32_t i = 0; i < n; i++)
+        LUT_INDEX((values[i] - vmin) / d, idx[i]);
+}
+
+
+
+static inline void
+_lut_index_double(uint32_t n, const double* values, double vmin, double d, uint16_t* idx)
+{
+    for (uint32_t i = 0; i < n; i++)
+        LUT_INDEX((values[i] - vmin) / d, idx[i]);
+}
+
+
+
+static inline void
+_lut_index_int(uint32_t n, const int32_t* values, int32_t vmin, double d, uint16_t* idx)
+{
+    for (uint32_t i = 0; i < n; i++)
+        LUT_INDEX(((double)values[i] - vmin) / d, idx[i]);
+}
+
+
+
+static inline void
+_lut_gather(const DvzColor* table, uint32_t n, const uint16_t* idx, DvzColor* out)
+{
+    for (uint32_t i = 0; i < n; i++)
+        memcpy(out[i], table[idx[i]], sizeof(DvzColor));
+}
+
+
+
+// With an empty range, all values get the first color, as with dvz_colormap_scale().
+static inline bool
+_check_range(DvzColormapLut* lut, double vmin, double vmax, uint32_t count, DvzColor* out)
+{
+    if (vmin == vmax)
+    {
+        log_warn("error in colormap_lut(): vmin=vmax");
+        for (uint32_t i = 0; i < count; i++)
+            memcpy(out[i], lut->colors[0], sizeof(DvzColor));
+        return false;
+    }
+    return true;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -157,9 +253,133 @@ void dvz_colormap_array(
 {
     ANN(values);
     ANN(out);
-    for (uint32_t i = 0; i < count; i++)
+
+    DvzColormapLut lut = {0};
+    dvz_colormap_lut(cmap, &lut);
+    dvz_colormap_lut_float(&lut, count, values, vmin, vmax, out);
+}
+
+
+
+/*************************************************************************************************/
+/*  Lookup tables                                                                                */
+/*************************************************************************************************/
+
+void dvz_colormap_lut(DvzColormap cmap, DvzColormapLut* lut)
+{
+    ANN(lut);
+    for (uint32_t i = 0; i < 256; i++)
+        dvz_colormap(cmap, (uint8_t)i, lut->colors[i]);
+
+    // By default, values are clipped and NaN values get the first color.
+    memcpy(lut->under, lut->colors[0], sizeof(DvzColor));
+    memcpy(lut->over, lut->colors[255], sizeof(DvzColor));
+    memcpy(lut->nan, lut->colors[0], sizeof(DvzColor));
+}
+
+
+
+void dvz_colormap_lut_nan(DvzColormapLut* lut, DvzColor color)
+{
+    ANN(lut);
+    memcpy(lut->nan, color, sizeof(DvzColor));
+}
+
+
+
+void dvz_colormap_lut_clip(DvzColormapLut* lut, DvzColor under, DvzColor over)
+{
+    ANN(lut);
+    memcpy(lut->under, under, sizeof(DvzColor));
+    memcpy(lut->over, over, sizeof(DvzColor));
+}
+
+
+
+void dvz_colormap_lut_float(
+    DvzColormapLut* lut, uint32_t count, float* values, float vmin, float vmax, DvzColor* out)
+{
+    ANN(lut);
+    ANN(values);
+    ANN(out);
+    if (!_check_range(lut, vmin, vmax, count, out))
+        return;
+
+    DvzColor table[LUT_SIZE] = {0};
+    _lut_table(lut, table);
+    float d = vmax - vmin;
+
+    uint32_t block_count = (count + LUT_BLOCK - 1) / LUT_BLOCK;
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t b = 0; b < block_count; b++)
+    {
+        uint16_t idx[LUT_BLOCK];
+        uint32_t first = b * LUT_BLOCK;
+        uint32_t n = MIN(LUT_BLOCK, count - first);
+        _lut_index_float(n, &values[first], vmin, d, idx);
+        _lut_gather(table, n, idx, &out[first]);
+    }
+}
+
+
+
+void dvz_colormap_lut_double(
+    DvzColormapLut* lut, uint32_t count, double* values, double vmin, double vmax,
+    DvzColor* out)
+{
+    ANN(lut);
+    ANN(values);
+    ANN(out);
+    if (!_check_range(lut, vmin, vmax, count, out))
+        return;
+
+    DvzColor table[LUT_SIZE] = {0};
+    _lut_table(lut, table);
+    double d = vmax - vmin;
+
+    uint32_t block_count = (count + LUT_BLOCK - 1) / LUT_BLOCK;
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t b = 0; b < block_count; b++)
+    {
+        uint16_t idx[LUT_BLOCK];
+        uint32_t first = b * LUT_BLOCK;
+        uint32_t n = MIN(LUT_BLOCK, count - first);
+        _lut_index_double(n, &values[first], vmin, d, idx);
+        _lut_gather(table, n, idx, &out[first]);
+    }
+}
+
+
+
+void dvz_colormap_lut_int(
+    DvzColormapLut* lut, uint32_t count, int32_t* values, int32_t vmin, int32_t vmax,
+    DvzColor* out)
+{
+    ANN(lut);
+    ANN(values);
+    ANN(out);
+    if (!_check_range(lut, vmin, vmax, count, out))
+        return;
+
+    DvzColor table[LUT_SIZE] = {0};
+    _lut_table(lut, table);
+    double d = (double)vmax - vmin;
+
+    uint32_t block_count = (count + LUT_BLOCK - 1) / LUT_BLOCK;
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t b = 0; b < block_count; b++)
     {
-        dvz_colormap_scale(cmap, values[i], vmin, vmax, out[i]);
+        uint16_t idx[LUT_BLOCK];
+        uint32_t first = b * LUT_BLOCK;
+        uint32_t n = MIN(LUT_BLOCK, count - first);
+        _lut_index_int(n, &values[first], vmin, d, idx);
+        _lut_gather(table, n, idx, &out[first]);
     }
 }
 
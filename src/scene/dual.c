@@ -186,12 +186,12 @@ DvzDual dvz_dual_vertex(DvzBatch* batch, uint32_t vertex_count, DvzSize vertex_s
 
 
 
-DvzDual dvz_dual_index(DvzBatch* batch, uint32_t index_count, int flags)
+DvzDual dvz_dual_index(DvzBatch* batch, uint32_t index_count, DvzSize index_size, int flags)
 {
     ANN(batch);
     ASSERT(index_count > 0);
+    ASSERT(index_size == sizeof(uint16_t) || index_size == sizeof(DvzIndex));
 
-    DvzSize index_size = sizeof(DvzIndex);
     DvzRequest req = dvz_create_dat(batch, DVZ_BUFFER_TYPE_INDEX, index_count * index_size, flags);
     dvz_batch_desc(batch, "index");
     DvzId dat_id = req.id;
@@ -240,3 +240,21 @@ DvzDual dvz_dual_dat(DvzBatch* batch, DvzSize vertex_size, int flags)
     // dual.need_destroy = true;
     return dual;
 }
+
+
+
+DvzDual dvz_dual_storage(DvzBatch* batch, uint32_t count, DvzSize item_size, int flags)
+{
+    ANN(batch);
+    ASSERT(count > 0);
+    ASSERT(item_size > 0);
+
+    DvzRequest req = dvz_create_dat(batch, DVZ_BUFFER_TYPE_STORAGE, count * item_size, flags);
+    dvz_batch_desc(batch, "storage");
+    DvzId dat_id = req.id;
+    DvzArray* array = dvz_array_struct(count, item_size);
+
+    DvzDual dual = dvz_dual(batch, array, dat_id);
+    // dual.need_destroy = true;
+    return dual;
+}
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Number formatting                                                                            */
+/*************************************************************************************************/
+
+// The fast path scales the value by an exact power of ten and rounds it to an integer mantissa,
+// using the FMA residual to recover the exact rounding direction (Grisu-style). This covers
+// all tick label values. The rare values outside of that range go through snprintf().
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/format.h"
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define POW10_MAX 22
+#define FAST_MAX  9007199254740992.0 // 2^53, integers below are exact in double precision
+
+// All powers of ten up to 1e22 are exactly representable in double precision.
+static const double POW10[POW10_MAX + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static const uint64_t POW10U[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+};
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static inline uint32_t _write(char* out, const char* s)
+{
+    uint32_t n = (uint32_t)strnlen(s, DVZ_FORMAT_MAX_LENGTH - 1);
+    memcpy(out, s, n);
+    out[n] = 0;
+    return n;
+}
+
+
+
+// Copy a string produced by snprintf(), making it independent of LC_NUMERIC.
+static inline uint32_t _write_numeric(char* out, char* s)
+{
+    for (uint32_t i = 0; s[i] != 0; i++)
+        if (s[i] == ',')
+            s[i] = '.';
+    return _write(out, s);
+}
+
+
+
+static inline uint32_t _format_special(double value, char* out)
+{
+    if (isnan(value))
+        return _write(out, "nan");
+    return _write(out, value < 0 ? "-inf" : "inf");
+}
+
+
+
+// Write the decimal digits of n, left-padded with zeros to at least `min_digits` digits.
+static inline uint32_t _write_digits(uint64_t n, uint32_t min_digits, char* out)
+{
+    char tmp[24] = {0};
+    uint32_t k = 0;
+    do
+    {
+        tmp[k++] = (char)('0' + (n % 10));
+        n /= 10;
+    } while (n > 0);
+    while (k < min_digits)
+        tmp[k++] = '0';
+    for (uint32_t i = 0; i < k; i++)
+        out[i] = tmp[k - 1 - i];
+    return k;
+}
+
+
+
+static inline uint32_t _write_exponent(int32_t exponent, char* out)
+{
+    uint32_t k = 0;
+    out[k++] = 'e';
+    out[k++] = exponent < 0 ? '-' : '+';
+    k += _write_digits((uint64_t)abs(exponent), 2, &out[k]);
+    return k;
+}
+
+
+
+// Fallback for the values outside of the fast path range. Return 0 if the output does not fit.
+static inline uint32_t _format_printf(double value, char conversion, int precision, char* out)
+{
+    char fmt[8] = "%.*e";
+    fmt[3] = conversion;
+    char tmp[512] = {0};
+    snprintf(tmp, sizeof(tmp), fmt, precision, value);
+    if (strnlen(tmp, sizeof(tmp)) >= DVZ_FORMAT_MAX_LENGTH)
+        return 0;
+    return _write_numeric(out, tmp);
+}
+
+
+
+// Fallback for the shortest representation outside of the fast path range.
+static inline uint32_t _format_printf_shortest(double value, char* out)
+{
+    char tmp[64] = {0};
+    for (int precision = 1; precision <= 17; precision++)
+    {
+        snprintf(tmp, sizeof(tmp), "%.*g", precision, value);
+        if (strtod(tmp, NULL) == value)
+            break;
+    }
+    return _write_numeric(out, tmp);
+}
+
+
+
+// Round value * 10^k to the nearest integer, ties to even, for a non-negative value.
+// Return false if the result cannot be computed exactly with double precision arithmetic.
+static inline bool _round_scaled(double value, int32_t k, uint64_t* out)
+{
+    ASSERT(value >= 0);
+    if (k < -POW10_MAX || k > POW10_MAX)
+        return false;
+
+    // The scaled value s, and the residual r such that the exact result is s + r * eps, eps > 0.
+    double s = 0, r = 0;
+    if (k >= 0)
+    {
+        s = value * POW10[k];
+        r = fma(value, POW10[k], -s);
+    }
+    else
+    {
+        s = value / POW10[-k];
+        r = fma(-s, POW10[-k], value);
+    }
+    if (!(s < FAST_MAX))
+        return false;
+
+    double f = floor(s);
+    double d = s - f; // exact as s < 2^53
+    uint64_t n = (uint64_t)f;
+    if (d > .5 || (d == .5 && (r > 0 || (r == 0 && (n & 1)))))
+        n++;
+
+    *out = n;
+    return true;
+}
+
+
+
+// Compute the mantissa n with precision+1 significant digits and the decimal exponent e such that
+// value ~= n * 10^(e - precision).
+static inline bool
+_decompose(double value, uint32_t precision, uint64_t* out_mantissa, int32_t* out_exponent)
+{
+    ASSERT(value > 0);
+    ASSERT(precision <= DVZ_FORMAT_MAX_PRECISION);
+
+    int32_t p = (int32_t)precision;
+    int32_t e = (int32_t)floor(log10(value));
+    uint64_t n = 0;
+
+    if (!_round_scaled(value, p - e, &n))
+        return false;
+
+    // log10() may be off by one, and rounding may carry over to the next power of ten.
+    if (n >= POW10U[p + 1])
+    {
+        e++;
+        if (!_round_scaled(value, p - e, &n))
+            return false;
+    }
+    else if (n < POW10U[p])
+    {
+        e--;
+        if (!_round_scaled(value, p - e, &n))
+            return false;
+    }
+    ASSERT(POW10U[p] <= n && n < POW10U[p + 1]);
+
+    *out_mantissa = n;
+    *out_exponent = e;
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+uint32_t dvz_format_fixed(double value, uint32_t precision, char* out)
+{
+    ANN(out);
+    if (!isfinite(value))
+        return _format_special(value, out);
+    precision = MIN(precision, DVZ_FORMAT_MAX_PRECISION);
+
+    uint64_t n = 0;
+    uint32_t k = 0;
+    if (!_round_scaled(fabs(value), (int32_t)precision, &n))
+    {
+        k = _format_printf(value, 'f', (int)precision, out);
+        return k > 0 ? k : dvz_format_scientific(value, precision, out);
+    }
+
+    if (signbit(value))
+        out[k++] = '-';
+
+    // Digits, with at least one digit before the decimal point.
+    char digits[24] = {0};
+    uint32_t count = _write_digits(n, precision + 1, digits);
+    uint32_t int_count = count - precision;
+
+    memcpy(&out[k], digits, int_count);
+    k += int_count;
+    if (precision > 0)
+    {
+        out[k++] = '.';
+        memcpy(&out[k], &digits[int_count], precision);
+        k += precision;
+    }
+    out[k] = 0;
+    ASSERT(k < DVZ_FORMAT_MAX_LENGTH);
+    return k;
+}
+
+
+
+uint32_t dvz_format_scientific(double value, uint32_t precision, char* out)
+{
+    ANN(out);
+    if (!isfinite(value))
+        return _format_special(value, out);
+    precision = MIN(precision, DVZ_FORMAT_MAX_PRECISION);
+
+    double a = fabs(value);
+    uint64_t n = 0;
+    int32_t e = 0;
+    if (a > 0 && !_decompose(a, precision, &n, &e))
+        return _format_printf(value, 'e', (int)precision, out);
+
+    uint32_t k = 0;
+    if (signbit(value))
+        out[k++] = '-';
+
+    char digits[24] = {0};
+    _write_digits(n, precision + 1, digits);
+
+    out[k++] = digits[0];
+    if (precision > 0)
+    {
+        out[k++] = '.';
+        memcpy(&out[k], &digits[1], precision);
+        k += precision;
+    }
+    k += _write_exponent(e, &out[k]);
+    out[k] = 0;
+    ASSERT(k < DVZ_FORMAT_MAX_LENGTH);
+    return k;
+}
+
+
+
+uint32_t dvz_format_shortest(double value, char* out)
+{
+    ANN(out);
+    if (!isfinite(value))
+        return _format_special(value, out);
+
+    uint32_t k = 0;
+    if (signbit(value))
+        out[k++] = '-';
+
+    double a = fabs(value);
+    if (a == 0)
+    {
+        out[k++] = '0';
+        out[k] = 0;
+        return k;
+    }
+
+    // Find the smallest number of significant digits that round-trips. A decimal n * 10^k with
+    // n < 2^53 and |k| <= 22 is parsed with a single correctly rounded operation, so that the
+    // check below is exact.
+    uint64_t n = 0;
+    int32_t e = 0;
+    bool found = false;
+    for (uint32_t p = 0; p <= DVZ_FORMAT_MAX_PRECISION; p++)
+    {
+        if (!_decompose(a, p, &n, &e))
+            break;
+        int32_t shift = e - (int32_t)p;
+        if (shift < -POW10_MAX || shift > POW10_MAX)
+            break;
+        double back = shift >= 0 ? (double)n * POW10[shift] : (double)n / POW10[-shift];
+        if (back == a)
+        {
+            found = true;
+            break;
+        }
+    }
+    if (!found)
+        return _format_printf_shortest(value, out);
+
+    // Remove the trailing zeros.
+    while (n >= 10 && n % 10 == 0)
+        n /= 10;
+    char digits[24] = {0};
+    uint32_t count = _write_digits(n, 1, digits);
+
+    // Same layout rule as "%g", with at least 6 significant digits before switching to the
+    // scientific notation.
+    if (e < -4 || e >= (int32_t)MAX(6, count))
+    {
+        out[k++] = digits[0];
+        if (count > 1)
+        {
+            out[k++] = '.';
+            memcpy(&out[k], &digits[1], count - 1);
+            k += count - 1;
+        }
+        k += _write_exponent(e, &out[k]);
+    }
+    else if (e < 0)
+    {
+        out[k++] = '0';
+        out[k++] = '.';
+        for (int32_t i = 0; i < -e - 1; i++)
+            out[k++] = '0';
+        memcpy(&out[k], digits, count);
+        k += count;
+    }
+    else
+    {
+        uint32_t int_count = (uint32_t)e + 1;
+        for (uint32_t i = 0; i < int_count; i++)
+            out[k++] = i < count ? digits[i] : '0';
+        if (count > int_count)
+        {
+            out[k++] = '.';
+            memcpy(&out[k], &digits[int_count], count - int_count);
+            k += count - int_count;
+        }
+    }
+    out[k] = 0;
+    ASSERT(k < DVZ_FORMAT_MAX_LENGTH);
+    return k;
+}
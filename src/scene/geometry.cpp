@@ -48,3 +48,95 @@ DvzIndex* dvz_earcut(uint32_t point_count, const dvec2* polygon, uint32_t* out_i
     *out_index_count = indices.size();
     return out;
 }
+
+
+
+// NOTE: the caller must FREE the output.
+DvzIndex* dvz_earcut_polygons(
+    uint32_t polygon_count, const uint32_t* polygon_offsets, const uint32_t* ring_offsets,
+    const dvec2* points, uint32_t* out_index_count, uint32_t* out_index_offsets)
+{
+    ASSERT(polygon_count > 0);
+    ANN(polygon_offsets);
+    ANN(ring_offsets);
+    ANN(points);
+    ANN(out_index_count);
+
+    // Upper bound on the number of indices of each polygon: after bridging the holes, a polygon
+    // with n points and h holes has n + 2h points, and n + 2h - 2 triangles.
+    std::vector<uint32_t> bounds(polygon_count + 1, 0);
+    for (uint32_t p = 0; p < polygon_count; p++)
+    {
+        uint32_t ring_count = polygon_offsets[p + 1] - polygon_offsets[p];
+        uint32_t n = ring_offsets[polygon_offsets[p + 1]] - ring_offsets[polygon_offsets[p]];
+        uint32_t m = ring_count > 0 ? n + 2 * (ring_count - 1) : 0;
+        bounds[p + 1] = bounds[p] + (m > 2 ? 3 * (m - 2) : 0);
+    }
+    uint32_t total = bounds[polygon_count];
+    log_debug(
+        "running earcut polygon triangulation on %d polygons and %d points", polygon_count,
+        ring_offsets[polygon_offsets[polygon_count]]);
+
+    DvzIndex* out = (DvzIndex*)malloc(MAX(total, 1) * sizeof(DvzIndex));
+    ANN(out);
+    std::vector<uint32_t> counts(polygon_count, 0);
+
+    // Each polygon is triangulated independently, directly in its range of the output buffer.
+#if HAS_OPENMP
+#pragma omp parallel
+#endif
+    {
+        // The triangulator and the rings are reused across the polygons of each thread.
+        mapbox::detail::Earcut<uint32_t> earcut;
+        std::vector<std::vector<std::array<double, 2>>> rings;
+
+#if HAS_OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+        for (int64_t i = 0; i < (int64_t)polygon_count; i++)
+        {
+            uint32_t p = (uint32_t)i;
+            uint32_t first_ring = polygon_offsets[p];
+            uint32_t ring_count = polygon_offsets[p + 1] - first_ring;
+            if (bounds[p + 1] == bounds[p])
+                continue;
+
+            rings.resize(ring_count);
+            for (uint32_t r = 0; r < ring_count; r++)
+            {
+                rings[r].clear();
+                for (uint32_t k = ring_offsets[first_ring + r];
+                     k < ring_offsets[first_ring + r + 1]; k++)
+                    rings[r].push_back({{points[k][0], points[k][1]}});
+            }
+            earcut(rings);
+
+            // The earcut indices are relative to the first point of the polygon.
+            uint32_t base = ring_offsets[first_ring];
+            uint32_t count = (uint32_t)earcut.indices.size();
+            ASSERT(count <= bounds[p + 1] - bounds[p]);
+            count = MIN(count, bounds[p + 1] - bounds[p]);
+            DvzIndex* dst = &out[bounds[p]];
+            for (uint32_t k = 0; k < count; k++)
+                dst[k] = base + earcut.indices[k];
+            counts[p] = count;
+        }
+    }
+
+    // Remove the gaps left by the polygons with fewer triangles than the upper bound.
+    uint32_t index_count = 0;
+    for (uint32_t p = 0; p < polygon_count; p++)
+    {
+        if (out_index_offsets != NULL)
+            out_index_offsets[p] = index_count;
+        if (index_count != bounds[p])
+            memmove(&out[index_count], &out[bounds[p]], counts[p] * sizeof(DvzIndex));
+        index_count += counts[p];
+    }
+    if (out_index_offsets != NULL)
+        out_index_offsets[polygon_count] = index_count;
+    log_debug("earcut found %d indices", index_count);
+
+    *out_index_count = index_count;
+    return out;
+}
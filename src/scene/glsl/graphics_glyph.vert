@@ -51,7 +51,7 @@ void main()
     mat4 ortho_inv = inverse(ortho);
 
     // NOTE: manual transform.
-    vec4 tr = transform_mvp(pos);
+    vec4 tr = transform_data(pos);
     tr = transform_fixed(tr, pos);
     // NOTE: custom rotation, this need to be improved
     tr = ortho * rot * tra * rot_inv * ortho_inv * tr;
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+#version 450
+#include "common.glsl"
+#include "params_mesh.glsl"
+#include "lighting_mesh.glsl"
+
+layout(constant_id = 0) const int MESH_LIGHTING = 0; // 1 to enable
+layout(constant_id = 1) const int MESH_FLAT = 0;     // 1 to enable
+
+// Varying variables.
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec4 in_color;
+
+layout(location = 0) out vec4 out_color;
+
+
+
+void main()
+{
+    CLIP;
+
+    out_color = in_color;
+    if (MESH_LIGHTING > 0)
+    {
+        vec3 normal = MESH_FLAT > 0 ? face_normal(in_pos) : normalize(in_normal);
+        out_color.rgb = mesh_lighting(in_pos, normal, in_color.rgb);
+    }
+}
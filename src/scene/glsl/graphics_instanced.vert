@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+#version 450
+#include "common.glsl"
+#include "params_mesh.glsl"
+
+// Attributes of the shared shape.
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec4 color;
+
+// Per-instance transform and color, indexed by gl_InstanceIndex.
+struct Instance
+{
+    vec4 pos;      // x, y, z, ***
+    vec4 rotation; // quaternion x, y, z, w
+    vec4 scale;    // x, y, z, ***
+    vec4 color;    // r, g, b, a
+};
+
+layout(std430, binding = (USER_BINDING + 1)) readonly buffer Instances { Instance data[]; }
+instances;
+
+// Varying variables.
+layout(location = 0) out vec3 out_pos;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec4 out_color;
+
+
+
+vec3 rotate(vec4 q, vec3 v) { return v + 2 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+
+
+
+void main()
+{
+    Instance instance = instances.data[gl_InstanceIndex];
+
+    // Scale, rotate, and translate the shape.
+    vec3 pos_ = instance.pos.xyz + rotate(instance.rotation, instance.scale.xyz * pos);
+    gl_Position = transform(pos_);
+
+    // The normals follow the inverse transpose of the instance transform.
+    vec3 normal_ = rotate(instance.rotation, normal / instance.scale.xyz);
+
+    out_pos = pos_;
+    out_normal = ((transpose(inverse(mvp.model)) * vec4(normal_, 1.0))).xyz;
+    out_color = color * instance.color;
+}
@@ -23,7 +23,7 @@ void main()
 
     out_color = color;
     out_size = size;
-    out_angle = angle;
+    out_angle = decode_angle(angle);
 
-    gl_PointSize = size * (abs(cos(angle)) + abs(sin(angle)));
+    gl_PointSize = size * (abs(cos(out_angle)) + abs(sin(out_angle)));
 }
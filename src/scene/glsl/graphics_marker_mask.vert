@@ -0,0 +1,34 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+#version 450
+#include "common.glsl"
+#define MASK_BINDING (USER_BINDING + 2)
+#include "mask.glsl"
+#include "constants.glsl"
+
+layout(location = 0) in vec3 pos;
+layout(location = 1) in float size;
+layout(location = 2) in float angle;
+layout(location = 3) in vec4 color;
+
+layout(location = 0) out vec4 out_color;
+layout(location = 1) out float out_size;
+layout(location = 2) out float out_angle;
+
+void main()
+{
+    vec4 color_ = color;
+    float size_ = size;
+    gl_Position = transform(pos);
+    mask_apply(uint(gl_VertexIndex), gl_Position, color_, size_);
+
+    out_color = color_;
+    out_size = size_;
+    out_angle = decode_angle(angle);
+
+    gl_PointSize = size_ * (abs(cos(out_angle)) + abs(sin(out_angle)));
+}
@@ -8,11 +8,13 @@
 #include "common.glsl"
 #include "constants.glsl"
 #include "params_mesh.glsl"
+#include "lighting_mesh.glsl"
 
 layout(constant_id = 0) const int MESH_TEXTURED = 0; // 1 to enable
 layout(constant_id = 1) const int MESH_LIGHTING = 0; // 1 to enable
 layout(constant_id = 2) const int MESH_CONTOUR = 0;  // 1 to enable
 layout(constant_id = 3) const int MESH_ISOLINE = 0;  // 1 to enable
+layout(constant_id = 4) const int MESH_FLAT = 0;     // 1 to enable
 
 const float eps = .00001;
 const float antialias_ = 2 * antialias;
@@ -141,20 +143,15 @@ void main()
     // if (in_clip < -eps)
     //     discard;
 
-    vec3 normal, light_dir, light_color, ambient, diffuse, view_dir, reflect_dir, specular, color;
-    vec4 lpar;
-    vec3 lpos;
-    float diff, spec, view_facing;
+    vec3 normal, color;
 
     // Stroke parameters.
     float linewidth = params.stroke.a;
     vec3 stroke = params.stroke.rgb;
-    vec3 pos_tr;
 
-    normal = normalize(in_normal);
+    // Flat shading: face normal instead of the interpolated vertex normals.
+    normal = MESH_FLAT > 0 ? face_normal(in_pos) : normalize(in_normal);
     out_color = vec4(0, 0, 0, 1);
-    diffuse = vec3(0);
-    specular = vec3(0);
 
     // Texture.
     if (MESH_TEXTURED > 0)
@@ -171,40 +168,7 @@ void main()
     // Lighting.
     if (MESH_LIGHTING > 0)
     {
-        pos_tr = ((mvp.model * vec4(in_pos, 1.0))).xyz;
-        view_dir = normalize(-mvp.view[3].xyz - pos_tr);
-
-        for (int i = 0; i < 4; i++)
-        {
-            // Light position and params.
-            lpar = params.light_params[i];
-            if (length(lpar) == 0)
-                continue;
-
-            // Light direction.
-            // light_dir = normalize(lpos - pos_tr);
-            // TODO OPTIM: normalize on the CPU instead, in dvz_mesh_light_dir()
-            light_dir = normalize(params.light_dir[i].xyz);
-
-            // Color.
-            light_color = params.light_color[i].xyz;
-            ambient = light_color;
-
-            // Diffuse component.
-            view_facing = max(dot(normal, view_dir), 0.0);
-            diff = max(dot(normal, -light_dir), 0.0);
-            // HACK: normals on both faces
-            // diff = max(diff, max(dot(light_dir, -normal), 0.0));
-            diffuse = diff * view_facing * light_color;
-
-            // Specular component.
-            reflect_dir = reflect(light_dir, normal);
-            spec = pow(max(dot(view_dir, reflect_dir), 0.0), lpar.w);
-            specular = spec * view_facing * light_color;
-
-            // Total color.
-            out_color.xyz += (lpar.x * ambient + lpar.y * diffuse + lpar.z * specular) * color;
-        }
+        out_color.xyz = mesh_lighting(in_pos, normal, color);
 
         // by convention, alpha channel is in 4th component of this attribute
         out_color.a = in_uvcolor.a;
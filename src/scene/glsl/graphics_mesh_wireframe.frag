@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Wireframe variant of the mesh fragment shader. The mesh stays indexed: the three vertices of
+// the current triangle are fetched from the vertex and index buffers, bound as storage buffers,
+// using gl_PrimitiveID. The edge distances and the face normal are computed from them.
+// NOTE: gl_PrimitiveID in a fragment shader requires the geometryShader device feature.
+
+#version 450
+#include "common.glsl"
+#include "constants.glsl"
+#include "params_mesh.glsl"
+#include "lighting_mesh.glsl"
+
+layout(constant_id = 0) const int MESH_TEXTURED = 0; // 1 to enable
+layout(constant_id = 1) const int MESH_LIGHTING = 0; // 1 to enable
+layout(constant_id = 4) const int MESH_FLAT = 0;     // 1 to enable
+
+// Varying variables.
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec4 in_uvcolor;
+
+layout(location = 0) out vec4 out_color;
+
+layout(binding = (USER_BINDING + 1)) uniform sampler2D tex;
+
+// Vertex buffer, the position is the first vec3 of each vertex.
+layout(std430, binding = (USER_BINDING + 2)) readonly buffer Vertices { float data[]; }
+vertices;
+
+// Index buffer, the wireframe mode always uses 32-bit indices.
+layout(std430, binding = (USER_BINDING + 3)) readonly buffer Indices { uint data[]; }
+indices;
+
+// Edge flags, one byte per face: bit c is set if the edge opposite to corner c is drawn.
+layout(std430, binding = (USER_BINDING + 4)) readonly buffer Edges { uint data[]; }
+edges;
+
+
+
+uint fetch_index(uint i)
+{
+    return params.index_size == 0 ? i : indices.data[i];
+}
+
+
+
+vec3 fetch_pos(uint vertex)
+{
+    uint k = vertex * params.vertex_stride;
+    return vec3(vertices.data[k], vertices.data[k + 1], vertices.data[k + 2]);
+}
+
+
+
+// Framebuffer coordinates of a position.
+vec2 to_pixels(vec3 pos)
+{
+    vec4 tr = transform(pos);
+    vec2 ndc = tr.xy / tr.w;
+    VkViewport vp = viewport.viewport;
+    return vec2(vp.x, vp.y) + .5 * (ndc + 1) * vec2(vp.w, vp.h);
+}
+
+
+
+// Distance between a point and a segment, in pixels.
+float segment_distance(vec2 p, vec2 a, vec2 b)
+{
+    vec2 ab = b - a;
+    float t = clamp(dot(p - a, ab) / max(dot(ab, ab), 1e-12), 0, 1);
+    return length(p - a - t * ab);
+}
+
+
+
+void main()
+{
+    CLIP;
+
+    // Current face and its vertices.
+    uint face = uint(gl_PrimitiveID) + params.face_offset;
+    vec3 p0 = fetch_pos(fetch_index(3 * face + 0));
+    vec3 p1 = fetch_pos(fetch_index(3 * face + 1));
+    vec3 p2 = fetch_pos(fetch_index(3 * face + 2));
+    uint flags = (edges.data[face >> 2] >> (8 * (face & 3))) & 0x7;
+
+    // Stroke parameters.
+    float linewidth = params.stroke.a;
+    vec3 stroke = params.stroke.rgb;
+
+    // Color or texture.
+    vec3 color = MESH_TEXTURED > 0 ? texture(tex, in_uvcolor.xy).xyz : in_uvcolor.xyz;
+    out_color = vec4(color, in_uvcolor.a);
+
+    // Lighting, with the face normal in flat mode.
+    if (MESH_LIGHTING > 0)
+    {
+        vec3 normal = normalize(in_normal);
+        if (MESH_FLAT > 0)
+        {
+            vec3 a = (mvp.model * vec4(relative_pos(p0), 1.0)).xyz;
+            vec3 b = (mvp.model * vec4(relative_pos(p1), 1.0)).xyz;
+            vec3 c = (mvp.model * vec4(relative_pos(p2), 1.0)).xyz;
+            normal = normalize(cross(b - a, c - a));
+            if (dot(normal, -mvp.view[3].xyz - a) < 0)
+                normal = -normal;
+        }
+        out_color.rgb = mesh_lighting(in_pos, normal, color);
+    }
+
+    // Edges: distance to the closest drawn edge, in pixels.
+    if (flags != 0)
+    {
+        vec2 q0 = to_pixels(p0);
+        vec2 q1 = to_pixels(p1);
+        vec2 q2 = to_pixels(p2);
+        vec2 frag = gl_FragCoord.xy;
+
+        float d = 1e9;
+        if ((flags & 1) != 0)
+            d = min(d, segment_distance(frag, q1, q2));
+        if ((flags & 2) != 0)
+            d = min(d, segment_distance(frag, q2, q0));
+        if ((flags & 4) != 0)
+            d = min(d, segment_distance(frag, q0, q1));
+
+        float e = smoothstep(.5 * linewidth, .5 * linewidth + antialias, d);
+        out_color.rgb = mix(stroke, out_color.rgb, e);
+    }
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Wireframe variant of the mesh vertex shader. The edge distances are computed in the fragment
+// shader, the contour attributes are not used.
+
+#version 450
+#include "common.glsl"
+#include "params_mesh.glsl"
+
+// Attributes.
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec4 uvcolor; // color or texture, contains either rgba, or uv*a
+
+// Varying variables.
+layout(location = 0) out vec3 out_pos;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec4 out_uvcolor;
+
+
+void main()
+{
+    gl_Position = transform(pos);
+
+    out_pos = pos.xyz;
+    out_normal = ((transpose(inverse(mvp.model)) * vec4(normal, 1.0))).xyz;
+    out_uvcolor = uvcolor;
+}
@@ -30,7 +30,7 @@ void main()
     // Transform.
     mat4 ortho = get_ortho_matrix();
     mat4 ortho_inv = inverse(ortho);
-    vec4 tr = transform_mvp(pos);
+    vec4 tr = transform_data(pos);
     tr = transform_fixed(tr, pos);
     tr = ortho * tra * ortho_inv * tr;
     tr = transform_margins(tr);
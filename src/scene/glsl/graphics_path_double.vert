@@ -0,0 +1,30 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+// Copyright (c) 2009-2016 Nicolas P. Rougier. All rights reserved.
+// Distributed under the (new) BSD License.
+// Modifications by Cyrille Rossant for Datoviz, 2021
+
+#version 450
+#include "common.glsl"
+#include "path.glsl"
+
+layout(location = 0) in vec3 p0_ndc;
+layout(location = 1) in vec3 p1_ndc;
+layout(location = 2) in vec3 p2_ndc;
+layout(location = 3) in vec3 p3_ndc;
+layout(location = 4) in vec4 color;
+layout(location = 5) in vec3 p0_lo; // low parts of the double-single positions
+layout(location = 6) in vec3 p1_lo;
+layout(location = 7) in vec3 p2_lo;
+layout(location = 8) in vec3 p3_lo;
+
+void main()
+{
+    path_vertex(
+        transform_double(p0_ndc, p0_lo), transform_double(p1_ndc, p1_lo),
+        transform_double(p2_ndc, p2_lo), transform_double(p3_ndc, p3_lo), color);
+}
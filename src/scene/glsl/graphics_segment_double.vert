@@ -0,0 +1,27 @@
+/*
+* Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+* Licensed under the MIT license. See LICENSE file in the project root for details.
+* SPDX-License-Identifier: MIT
+*/
+
+#version 450
+#include "common.glsl"
+#include "constants.glsl"
+#include "segment.glsl"
+
+layout(location = 0) in vec3 P0;
+layout(location = 1) in vec3 P1;
+layout(location = 2) in vec4 shift;
+layout(location = 3) in vec4 color;
+layout(location = 4) in float linewidth;
+layout(location = 5) in int cap0;
+layout(location = 6) in int cap1;
+layout(location = 7) in vec3 P0_lo; // low parts of the double-single positions
+layout(location = 8) in vec3 P1_lo;
+
+void main(void)
+{
+    vec4 P0_ = transform(P0, P0_lo, shift.xy);
+    vec4 P1_ = transform(P1, P1_lo, shift.zw);
+    segment_vertex(P0_, P1_, color, linewidth, cap0, cap1);
+}
@@ -62,7 +62,7 @@ void main()
     out_color = vec4(final_color, alpha);
 
     // Depth.
-    vec4 vm = mvp.view * mvp.model * vec4(in_pos, 1);
+    vec4 vm = mvp.view * mvp.model * vec4(relative_pos(in_pos), 1);
     float d = length(vm.xyz);
 
     // Viewport size.
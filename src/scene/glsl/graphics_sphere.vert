@@ -30,7 +30,7 @@ void main()
     out_color = color;
 
     // Calculate the eye-space position
-    vec4 world_pos = mvp.model * vec4(pos, 1.0);
+    vec4 world_pos = mvp.model * vec4(relative_pos(pos), 1.0);
     vec4 eye_pos = mvp.view * world_pos;
     out_eye_pos = eye_pos;
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+#version 450
+#include "colormaps.glsl"
+#include "common.glsl"
+#include "params_surface.glsl"
+
+layout(constant_id = 0) const int SURFACE_LIGHTING = 0; // 1 to enable
+
+// Varying variables.
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in float in_scalar;
+
+layout(location = 0) out vec4 out_color;
+
+
+void main()
+{
+    CLIP;
+
+    // Colormap.
+    float v0 = params.range.x;
+    float v1 = params.range.y;
+    float value = clamp((in_scalar - v0) / (v1 - v0), 0, 1);
+    vec3 color = colormap(params.grid.z, value).rgb;
+
+    // Lighting.
+    if (SURFACE_LIGHTING > 0)
+    {
+        vec4 lpar = params.light_params;
+        vec3 normal = normalize(in_normal);
+        vec3 light_dir = params.light_dir.xyz;
+
+        vec3 pos_tr = (mvp.model * vec4(relative_pos(in_pos), 1.0)).xyz;
+        vec3 view_dir = normalize(-mvp.view[3].xyz - pos_tr);
+
+        // Two-sided lighting: the surface may be seen from below.
+        if (dot(normal, view_dir) < 0)
+            normal = -normal;
+
+        float diff = max(dot(normal, -light_dir), 0.0);
+        vec3 reflect_dir = reflect(light_dir, normal);
+        float spec = pow(max(dot(view_dir, reflect_dir), 0.0), lpar.w);
+        color = (lpar.x + lpar.y * diff + lpar.z * spec) * color;
+    }
+
+    out_color = vec4(color, 1);
+}
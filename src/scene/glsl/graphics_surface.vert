@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+#version 450
+#include "common.glsl"
+#include "params_surface.glsl"
+
+// NOTE: no vertex attributes, the grid topology is derived from gl_VertexIndex.
+
+// Corners of the 2 triangles of a grid cell, (row, col) offsets, same order as
+// dvz_shape_surface().
+const ivec2 CORNERS[6] = ivec2[](
+    ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1), ivec2(0, 1), ivec2(1, 0));
+
+// Varying variables.
+layout(location = 0) out vec3 out_pos;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out float out_scalar;
+
+
+float height(ivec2 ij)
+{
+    ij = clamp(ij, ivec2(0), params.grid.xy - 1);
+    return texelFetch(tex_heights, ij.yx, 0).r;
+}
+
+
+void main()
+{
+    int row_count = params.grid.x;
+    int col_count = params.grid.y;
+
+    // Grid cell and corner.
+    int cell = gl_VertexIndex / 6;
+    ivec2 ij = ivec2(cell / (col_count - 1), cell % (col_count - 1)) + CORNERS[gl_VertexIndex % 6];
+
+    // Position.
+    vec3 u = params.u.xyz;
+    vec3 v = params.v.xyz;
+    vec3 n = normalize(cross(u, v));
+    float h = height(ij);
+    vec3 pos = params.origin.xyz + ij.x * u + ij.y * v + h * n;
+
+    // Normal with central differences (one-sided on the borders).
+    ivec2 i0 = ivec2(max(ij.x - 1, 0), ij.y);
+    ivec2 i1 = ivec2(min(ij.x + 1, row_count - 1), ij.y);
+    ivec2 j0 = ivec2(ij.x, max(ij.y - 1, 0));
+    ivec2 j1 = ivec2(ij.x, min(ij.y + 1, col_count - 1));
+    float dhi = (height(i1) - height(i0)) / float(max(i1.x - i0.x, 1));
+    float dhj = (height(j1) - height(j0)) / float(max(j1.y - j0.y, 1));
+    vec3 normal = normalize(cross(u + dhi * n, v + dhj * n));
+
+    gl_Position = transform(pos);
+
+    out_pos = pos;
+    out_normal = (transpose(inverse(mvp.model)) * vec4(normal, 0.0)).xyz;
+    out_scalar = texelFetch(tex_scalar, ij.yx, 0).r;
+}
@@ -65,7 +65,9 @@ void main()
     vec4 u_ = mi * vec4(normalize(in_ray), 1);
     vec3 u = u_.xyz / u_.w;
     vec4 o_ = mi * vec4(-mvp.view[3].xyz, 1);
-    vec3 o = o_.xyz / o_.w;
+    // NOTE: the world coordinates are relative to the MVP offset, the ray origin is brought back
+    // to the volume coordinates.
+    vec3 o = o_.xyz / o_.w + mvp.offset_hi.xyz + mvp.offset_lo.xyz;
 
     vec3 b0 = -params.box_size.xyz / 2;
     vec3 b1 = +params.box_size.xyz / 2;
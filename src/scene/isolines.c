@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Isolines                                                                                     */
+/*************************************************************************************************/
+
+// Marching squares on a 2D grid of values, for several levels at once.
+//
+// 1. The grid is split in bands of rows, and every (level, band) pair is processed in parallel.
+//    Each cell crossed by the level emits one or two oriented segments between two grid edges:
+//    the segment goes from the edge where the cell boundary (c0, c1, c2, c3) goes from high to
+//    low to the edge where it goes from low to high. With this orientation, a segment ending on
+//    an edge is continued by the segment starting on that same edge in the neighbor cell.
+// 2. For every level, in parallel, the segments are stitched into polylines. The segments are
+//    sorted by cell, so that the successor of a segment is found with a binary search in the
+//    neighbor cell. Open polylines start on the grid border, the remaining ones are closed.
+// 3. The crossing points are interpolated linearly along the grid edges.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "_cglm.h"
+#include "_log.h"
+#include "_macros.h"
+#include "datoviz.h"
+#include "datoviz_types.h"
+
+#if HAS_OPENMP
+#include <omp.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Number of grid rows per parallel task.
+#define BAND_SIZE 64
+
+#define NO_SEGMENT UINT32_MAX
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct Segment Segment;
+typedef struct SegmentArray SegmentArray;
+typedef struct Polylines Polylines;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct Segment
+{
+    uint32_t cell;  // row-major cell index
+    uint32_t start; // edge index
+    uint32_t end;   // edge index
+};
+
+
+
+struct SegmentArray
+{
+    Segment* items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+
+
+struct Polylines
+{
+    uint32_t* edges; // edge index of each point
+    uint32_t point_count;
+    uint32_t point_capacity;
+
+    uint32_t* lengths;
+    uint32_t path_count;
+    uint32_t path_capacity;
+};
+
+
+
+/*************************************************************************************************/
+/*  Grid edges                                                                                   */
+/*************************************************************************************************/
+
+// Edge indices: the horizontal edges (i, j)-(i, j + 1) come first, then the vertical edges
+// (i, j)-(i + 1, j).
+
+static inline uint32_t _hedge(uint32_t col_count, uint32_t i, uint32_t j)
+{
+    return i * (col_count - 1) + j;
+}
+
+
+
+static inline uint32_t _vedge(uint32_t row_count, uint32_t col_count, uint32_t i, uint32_t j)
+{
+    return row_count * (col_count - 1) + i * col_count + j;
+}
+
+
+
+// The cell on the other side of an edge, or NO_SEGMENT on the grid border.
+static inline uint32_t
+_neighbor_cell(uint32_t row_count, uint32_t col_count, uint32_t edge, uint32_t cell)
+{
+    uint32_t cell_cols = col_count - 1;
+    uint32_t hcount = row_count * (col_count - 1);
+    uint32_t i = 0, j = 0, a = 0, b = 0;
+    if (edge < hcount)
+    {
+        // Shared by the cells (i - 1, j) and (i, j).
+        i = edge / (col_count - 1);
+        j = edge % (col_count - 1);
+        a = i > 0 ? (i - 1) * cell_cols + j : NO_SEGMENT;
+        b = i < row_count - 1 ? i * cell_cols + j : NO_SEGMENT;
+    }
+    else
+    {
+        // Shared by the cells (i, j - 1) and (i, j).
+        i = (edge - hcount) / col_count;
+        j = (edge - hcount) % col_count;
+        a = j > 0 ? i * cell_cols + j - 1 : NO_SEGMENT;
+        b = j < col_count - 1 ? i * cell_cols + j : NO_SEGMENT;
+    }
+    return a == cell ? b : a;
+}
+
+
+
+static inline void _edge_point(
+    uint32_t row_count, uint32_t col_count, const float* values, float level, uint32_t edge,
+    vec3 o, vec3 u, vec3 v, vec3 out)
+{
+    uint32_t hcount = row_count * (col_count - 1);
+    uint32_t i = 0, j = 0;
+    float x = 0, y = 0, va = 0, vb = 0;
+    if (edge < hcount)
+    {
+        i = edge / (col_count - 1);
+        j = edge % (col_count - 1);
+        va = values[i * col_count + j];
+        vb = values[i * col_count + j + 1];
+        x = (float)i;
+        y = (float)j + (level - va) / (vb - va);
+    }
+    else
+    {
+        i = (edge - hcount) / col_count;
+        j = (edge - hcount) % col_count;
+        va = values[i * col_count + j];
+        vb = values[(i + 1) * col_count + j];
+        x = (float)i + (level - va) / (vb - va);
+        y = (float)j;
+    }
+    for (uint32_t k = 0; k < 3; k++)
+        out[k] = o[k] + x * u[k] + y * v[k];
+}
+
+
+
+/*************************************************************************************************/
+/*  Marching squares                                                                             */
+/*************************************************************************************************/
+
+static inline void _push_segment(SegmentArray* arr, uint32_t cell, uint32_t start, uint32_t end)
+{
+    if (arr->count == arr->capacity)
+    {
+        arr->capacity = MAX(1024, 2 * arr->capacity);
+        REALLOC(arr->items, arr->capacity * sizeof(Segment));
+    }
+    arr->items[arr->count++] = (Segment){cell, start, end};
+}
+
+
+
+static void _march_band(
+    uint32_t row_count, uint32_t col_count, const float* values, float level, //
+    uint32_t row_start, uint32_t row_end, SegmentArray* out)
+{
+    float c[4] = {0};
+    uint32_t e[4] = {0};
+    bool high[4] = {0};
+    uint32_t cell_cols = col_count - 1;
+
+    for (uint32_t i = row_start; i < row_end; i++)
+    {
+        const float* r0 = &values[i * col_count];
+        const float* r1 = &values[(i + 1) * col_count];
+        for (uint32_t j = 0; j < cell_cols; j++)
+        {
+            // Cell corners, along the cell boundary.
+            c[0] = r0[j];
+            c[1] = r0[j + 1];
+            c[2] = r1[j + 1];
+            c[3] = r1[j];
+            if (isnan(c[0]) || isnan(c[1]) || isnan(c[2]) || isnan(c[3]))
+                continue;
+
+            uint32_t mask = 0;
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                high[k] = c[k] >= level;
+                mask |= (uint32_t)high[k] << k;
+            }
+            if (mask == 0 || mask == 0xF)
+                continue;
+
+            // Edge k goes from corner k to corner k + 1.
+            e[0] = _hedge(col_count, i, j);
+            e[1] = _vedge(row_count, col_count, i, j + 1);
+            e[2] = _hedge(col_count, i + 1, j);
+            e[3] = _vedge(row_count, col_count, i, j);
+            uint32_t cell = i * cell_cols + j;
+
+            // Saddle: two segments, the center value decides which corners are connected.
+            if (mask == 0x5 || mask == 0xA)
+            {
+                bool center = .25f * (c[0] + c[1] + c[2] + c[3]) >= level;
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    if (!high[k] || high[(k + 1) % 4])
+                        continue;
+                    // High to low crossing on edge k: cut off the low corner k + 1 if the center
+                    // is high, or the high corner k otherwise.
+                    _push_segment(out, cell, e[k], center ? e[(k + 1) % 4] : e[(k + 3) % 4]);
+                }
+                continue;
+            }
+
+            // One segment, from the high to low crossing to the low to high crossing.
+            uint32_t start = 0, end = 0;
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                if (high[k] && !high[(k + 1) % 4])
+                    start = e[k];
+                else if (!high[k] && high[(k + 1) % 4])
+                    end = e[k];
+            }
+            _push_segment(out, cell, start, end);
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Stitching                                                                                    */
+/*************************************************************************************************/
+
+// Find the segment of a cell starting on a given edge, the segments are sorted by cell.
+static inline uint32_t _find_segment(uint32_t count, const Segment* segs, uint32_t cell, uint32_t edge)
+{
+    uint32_t lo = 0, hi = count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (segs[mid].cell < cell)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (uint32_t s = lo; s < count && segs[s].cell == cell; s++)
+        if (segs[s].start == edge)
+            return s;
+    return NO_SEGMENT;
+}
+
+
+
+static inline void _push_point(Polylines* pl, uint32_t edge)
+{
+    if (pl->point_count == pl->point_capacity)
+    {
+        pl->point_capacity = MAX(1024, 2 * pl->point_capacity);
+        REALLOC(pl->edges, pl->point_capacity * sizeof(uint32_t));
+    }
+    pl->edges[pl->point_count++] = edge;
+}
+
+
+
+static inline void _push_path(Polylines* pl, uint32_t length)
+{
+    if (pl->path_count == pl->path_capacity)
+    {
+        pl->path_capacity = MAX(64, 2 * pl->path_capacity);
+        REALLOC(pl->lengths, pl->path_capacity * sizeof(uint32_t));
+    }
+    pl->lengths[pl->path_count++] = length;
+}
+
+
+
+static void _stitch(
+    uint32_t row_count, uint32_t col_count, uint32_t count, const Segment* segs, Polylines* out)
+{
+    if (count == 0)
+        return;
+
+    uint32_t* next = (uint32_t*)malloc(count * sizeof(uint32_t));
+    uint8_t* has_prev = (uint8_t*)calloc(count, sizeof(uint8_t));
+    uint8_t* visited = (uint8_t*)calloc(count, sizeof(uint8_t));
+
+    for (uint32_t s = 0; s < count; s++)
+    {
+        uint32_t cell = _neighbor_cell(row_count, col_count, segs[s].end, segs[s].cell);
+        next[s] = cell != NO_SEGMENT ? _find_segment(count, segs, cell, segs[s].end) : NO_SEGMENT;
+        if (next[s] != NO_SEGMENT)
+            has_prev[next[s]] = 1;
+    }
+
+    // Open polylines, from the grid border (or a NaN cell) to the grid border.
+    uint32_t length = 0;
+    for (uint32_t s = 0; s < count; s++)
+    {
+        if (has_prev[s])
+            continue;
+        _push_point(out, segs[s].start);
+        length = 1;
+        for (uint32_t t = s; t != NO_SEGMENT; t = next[t])
+        {
+            visited[t] = 1;
+            _push_point(out, segs[t].end);
+            length++;
+        }
+        _push_path(out, length);
+    }
+
+    // Closed polylines, the first point is repeated at the end.
+    for (uint32_t s = 0; s < count; s++)
+    {
+        if (visited[s])
+            continue;
+        length = 0;
+        uint32_t t = s;
+        do
+        {
+            visited[t] = 1;
+            _push_point(out, segs[t].start);
+            length++;
+            t = next[t];
+        } while (t != NO_SEGMENT && t != s);
+        _push_point(out, segs[s].start);
+        length++;
+        _push_path(out, length);
+    }
+
+    FREE(next);
+    FREE(has_prev);
+    FREE(visited);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzIsolines dvz_isolines(
+    uint32_t row_count, uint32_t col_count, const float* values, //
+    uint32_t level_count, const float* levels, vec3 o, vec3 u, vec3 v)
+{
+    ANN(values);
+    ANN(levels);
+
+    DvzIsolines isolines = {0};
+    if (row_count < 2 || col_count < 2 || level_count == 0)
+        return isolines;
+    ASSERT((uint64_t)2 * row_count * col_count < NO_SEGMENT);
+
+    // Marching squares, in parallel on (level, band) pairs.
+    uint32_t band_count = (row_count - 1 + BAND_SIZE - 1) / BAND_SIZE;
+    uint32_t task_count = level_count * band_count;
+    SegmentArray* bands = (SegmentArray*)calloc(task_count, sizeof(SegmentArray));
+
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t t = 0; t < (int64_t)task_count; t++)
+    {
+        uint32_t level = (uint32_t)t / band_count;
+        uint32_t band = (uint32_t)t % band_count;
+        uint32_t row_start = band * BAND_SIZE;
+        uint32_t row_end = MIN(row_start + BAND_SIZE, row_count - 1);
+        _march_band(
+            row_count, col_count, values, levels[level], row_start, row_end, &bands[(uint32_t)t]);
+    }
+
+    // Stitch the segments of each level, in parallel on the levels. The bands are concatenated
+    // in order, so that the segments are sorted by cell.
+    Polylines* polylines = (Polylines*)calloc(level_count, sizeof(Polylines));
+
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t l = 0; l < (int64_t)level_count; l++)
+    {
+        uint32_t count = 0;
+        for (uint32_t b = 0; b < band_count; b++)
+            count += bands[(uint32_t)l * band_count + b].count;
+        if (count == 0)
+            continue;
+
+        Segment* segs = (Segment*)malloc(count * sizeof(Segment));
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < band_count; b++)
+        {
+            SegmentArray* arr = &bands[(uint32_t)l * band_count + b];
+            if (arr->count > 0)
+                memcpy(&segs[offset], arr->items, arr->count * sizeof(Segment));
+            offset += arr->count;
+            FREE(arr->items);
+        }
+        _stitch(row_count, col_count, count, segs, &polylines[l]);
+        FREE(segs);
+    }
+    FREE(bands);
+
+    // Output arrays.
+    uint32_t* point_offsets = (uint32_t*)calloc(level_count + 1, sizeof(uint32_t));
+    uint32_t* path_offsets = (uint32_t*)calloc(level_count + 1, sizeof(uint32_t));
+    for (uint32_t l = 0; l < level_count; l++)
+    {
+        point_offsets[l + 1] = point_offsets[l] + polylines[l].point_count;
+        path_offsets[l + 1] = path_offsets[l] + polylines[l].path_count;
+    }
+    isolines.point_count = point_offsets[level_count];
+    isolines.path_count = path_offsets[level_count];
+    log_debug(
+        "found %d isolines with %d points on %d levels", isolines.path_count,
+        isolines.point_count, level_count);
+
+    if (isolines.point_count > 0)
+    {
+        isolines.pos = (vec3*)calloc(isolines.point_count, sizeof(vec3));
+        isolines.path_lengths = (uint32_t*)calloc(isolines.path_count, sizeof(uint32_t));
+        isolines.path_levels = (uint32_t*)calloc(isolines.path_count, sizeof(uint32_t));
+    }
+
+    // Interpolate the points.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t l = 0; l < (int64_t)level_count; l++)
+    {
+        Polylines* pl = &polylines[l];
+        uint32_t p0 = point_offsets[l];
+        for (uint32_t k = 0; k < pl->point_count; k++)
+            _edge_point(
+                row_count, col_count, values, levels[l], pl->edges[k], o, u, v,
+                isolines.pos[p0 + k]);
+        for (uint32_t k = 0; k < pl->path_count; k++)
+        {
+            isolines.path_lengths[path_offsets[l] + k] = pl->lengths[k];
+            isolines.path_levels[path_offsets[l] + k] = (uint32_t)l;
+        }
+        FREE(pl->edges);
+        FREE(pl->lengths);
+    }
+
+    FREE(polylines);
+    FREE(point_offsets);
+    FREE(path_offsets);
+    return isolines;
+}
+
+
+
+void dvz_isolines_destroy(DvzIsolines* isolines)
+{
+    ANN(isolines);
+    FREE(isolines->pos);
+    FREE(isolines->path_lengths);
+    FREE(isolines->path_levels);
+    isolines->point_count = 0;
+    isolines->path_count = 0;
+}
@@ -0,0 +1,840 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Isosurface                                                                                   */
+/*************************************************************************************************/
+
+// Marching cubes on a 3D grid of values, split in bricks of BRICK_SIZE^3 cells processed in
+// parallel.
+//
+// 1. Each brick owns the grid edges starting at its nodes. It creates one vertex per owned edge
+//    crossed by the level, with a normal interpolated from the value gradients, and registers it
+//    in a small per-brick hash map keyed by the local edge index.
+// 2. The vertices of all bricks are numbered with a prefix sum, and each brick triangulates its
+//    cells, looking up the vertex of each edge in the hash map of the brick owning it, so that the
+//    vertices are shared across bricks and the mesh is watertight.
+//
+// Bricks whose value range does not contain the level are skipped in both passes. The ranges can
+// be computed once with dvz_isosurface_ranges() and reused when the level changes.
+//
+// The triangle table below was generated by resolving the ambiguous cube faces with a fixed rule
+// (the high corners are separated), which only depends on the face values and is thus consistent
+// between neighbor cubes. The polygons are triangulated without diagonals lying on a cube face,
+// so that the mesh is a closed manifold away from the grid border. The triangles are oriented
+// counterclockwise when seen from the low values.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "_cglm.h"
+#include "_log.h"
+#include "_macros.h"
+#include "datoviz.h"
+#include "datoviz_math.h"
+#include "datoviz_types.h"
+
+#if HAS_OPENMP
+#include <omp.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Number of cells along each side of a brick.
+#define BRICK_SIZE 16
+
+// Number of nodes along each side of a brick, including the nodes of the last brick on the far
+// grid border.
+#define BRICK_NODES (BRICK_SIZE + 1)
+
+#define NO_VERTEX UINT32_MAX
+
+
+
+/*************************************************************************************************/
+/*  Tables                                                                                       */
+/*************************************************************************************************/
+
+// Cube corners: bit k of the case index is set if the value at corner k is >= level.
+//     c0 (0,0,0), c1 (1,0,0), c2 (1,1,0), c3 (0,1,0), c4 (0,0,1), c5 (1,0,1), c6 (1,1,1), c7 (0,1,1)
+static const uint8_t CORNERS[8][3] = {
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1},
+};
+
+// Cube edges, as the offset of their first node and their axis.
+static const uint8_t EDGES[12][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 0}, {0, 0, 0, 1}, // z = 0
+    {0, 0, 1, 0}, {1, 0, 1, 1}, {0, 1, 1, 0}, {0, 0, 1, 1}, // z = 1
+    {0, 0, 0, 2}, {1, 0, 0, 2}, {1, 1, 0, 2}, {0, 1, 0, 2}, // along z
+};
+
+// Up to 5 triangles per case, as triplets of cube edges, terminated by -1.
+static const int8_t TRIANGLES[256][16] = {
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 2, 0, 9, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 9, 10, 2, 8, 9, 2, 3, 8, -1, -1, -1, -1, -1, -1, -1},
+    {2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 11, 8, 1, 2, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 11, 3, 1, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 10, 11, 0, 1, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 3, 0, 10, 11, 0, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+    {8, 10, 11, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 9, 1, 7, 4, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 3, 7, 1, 10, 2, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 2, 0, 9, 10, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {2, 9, 10, 2, 4, 9, 2, 7, 4, 2, 3, 7, -1, -1, -1, -1},
+    {2, 11, 3, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 11, 7, 0, 2, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 11, 3, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 9, 1, 7, 4, 1, 11, 7, 1, 2, 11, -1, -1, -1, -1},
+    {1, 11, 3, 1, 10, 11, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 11, 7, 0, 10, 11, 0, 1, 10, -1, -1, -1, -1},
+    {0, 11, 3, 0, 10, 11, 0, 9, 10, 4, 8, 7, -1, -1, -1, -1},
+    {4, 11, 7, 4, 10, 11, 4, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+    {4, 5, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 1, 0, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 5, 1, 8, 4, 1, 3, 8, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 10, 2, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 2, 0, 5, 10, 0, 4, 5, -1, -1, -1, -1, -1, -1, -1},
+    {2, 5, 10, 2, 4, 5, 2, 8, 4, 2, 3, 8, -1, -1, -1, -1},
+    {2, 11, 3, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 2, 11, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 1, 0, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 5, 1, 8, 4, 1, 11, 8, 1, 2, 11, -1, -1, -1, -1},
+    {1, 11, 3, 1, 10, 11, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 10, 11, 0, 1, 10, 4, 5, 9, -1, -1, -1, -1},
+    {0, 11, 3, 0, 10, 11, 0, 5, 10, 0, 4, 5, -1, -1, -1, -1},
+    {4, 11, 8, 4, 10, 11, 4, 5, 10, -1, -1, -1, -1, -1, -1, -1},
+    {5, 8, 7, 5, 9, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 9, 0, 7, 5, 0, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 1, 0, 7, 5, 0, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {1, 7, 5, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, 5, 8, 7, 5, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 9, 0, 7, 5, 0, 3, 7, 1, 10, 2, -1, -1, -1, -1},
+    {0, 10, 2, 0, 5, 10, 0, 7, 5, 0, 8, 7, -1, -1, -1, -1},
+    {2, 5, 10, 2, 7, 5, 2, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+    {2, 11, 3, 5, 8, 7, 5, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 9, 0, 7, 5, 0, 11, 7, 0, 2, 11, -1, -1, -1, -1},
+    {0, 5, 1, 0, 7, 5, 0, 8, 7, 2, 11, 3, -1, -1, -1, -1},
+    {1, 7, 5, 1, 11, 7, 1, 2, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 11, 3, 1, 10, 11, 5, 8, 7, 5, 9, 8, -1, -1, -1, -1},
+    {0, 5, 9, 0, 7, 5, 0, 11, 7, 0, 10, 11, 0, 1, 10, -1},
+    {0, 11, 3, 0, 10, 11, 0, 5, 10, 0, 7, 5, 0, 8, 7, -1},
+    {5, 11, 7, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {1, 6, 2, 1, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 6, 2, 1, 5, 6, -1, -1, -1, -1, -1, -1, -1},
+    {0, 6, 2, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+    {2, 5, 6, 2, 9, 5, 2, 8, 9, 2, 3, 8, -1, -1, -1, -1},
+    {2, 11, 3, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 2, 11, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 11, 3, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 11, 8, 1, 2, 11, 5, 6, 10, -1, -1, -1, -1},
+    {1, 11, 3, 1, 6, 11, 1, 5, 6, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 6, 11, 0, 5, 6, 0, 1, 5, -1, -1, -1, -1},
+    {0, 11, 3, 0, 6, 11, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1},
+    {5, 8, 9, 5, 11, 8, 5, 6, 11, -1, -1, -1, -1, -1, -1, -1},
+    {4, 8, 7, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 3, 7, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 4, 8, 7, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 9, 1, 7, 4, 1, 3, 7, 5, 6, 10, -1, -1, -1, -1},
+    {1, 6, 2, 1, 5, 6, 4, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 3, 7, 1, 6, 2, 1, 5, 6, -1, -1, -1, -1},
+    {0, 6, 2, 0, 5, 6, 0, 9, 5, 4, 8, 7, -1, -1, -1, -1},
+    {2, 5, 6, 2, 9, 5, 2, 4, 9, 2, 7, 4, 2, 3, 7, -1},
+    {2, 11, 3, 4, 8, 7, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 4, 0, 11, 7, 0, 2, 11, 5, 6, 10, -1, -1, -1, -1},
+    {0, 9, 1, 2, 11, 3, 4, 8, 7, 5, 6, 10, -1, -1, -1, -1},
+    {1, 4, 9, 1, 7, 4, 1, 11, 7, 1, 2, 11, 5, 6, 10, -1},
+    {1, 11, 3, 1, 6, 11, 1, 5, 6, 4, 8, 7, -1, -1, -1, -1},
+    {0, 7, 4, 0, 11, 7, 0, 6, 11, 0, 5, 6, 0, 1, 5, -1},
+    {0, 11, 3, 0, 6, 11, 0, 5, 6, 0, 9, 5, 4, 8, 7, -1},
+    {4, 11, 7, 4, 9, 11, 11, 5, 6, 11, 9, 5, -1, -1, -1, -1},
+    {4, 10, 9, 4, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 4, 10, 9, 4, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 1, 0, 6, 10, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+    {1, 6, 10, 1, 4, 6, 1, 8, 4, 1, 3, 8, -1, -1, -1, -1},
+    {1, 6, 2, 1, 4, 6, 1, 9, 4, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 6, 2, 1, 4, 6, 1, 9, 4, -1, -1, -1, -1},
+    {0, 6, 2, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 4, 6, 2, 8, 4, 2, 3, 8, -1, -1, -1, -1, -1, -1, -1},
+    {2, 11, 3, 4, 10, 9, 4, 6, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 8, 0, 2, 11, 4, 10, 9, 4, 6, 10, -1, -1, -1, -1},
+    {0, 10, 1, 0, 6, 10, 0, 4, 6, 2, 11, 3, -1, -1, -1, -1},
+    {1, 6, 10, 1, 4, 6, 1, 8, 4, 1, 11, 8, 1, 2, 11, -1},
+    {1, 11, 3, 1, 6, 11, 1, 4, 6, 1, 9, 4, -1, -1, -1, -1},
+    {0, 11, 8, 0, 6, 11, 0, 1, 6, 6, 9, 4, 6, 1, 9, -1},
+    {0, 11, 3, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+    {4, 11, 8, 4, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {6, 8, 7, 6, 9, 8, 6, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 9, 0, 6, 10, 0, 7, 6, 0, 3, 7, -1, -1, -1, -1},
+    {0, 10, 1, 0, 6, 10, 0, 7, 6, 0, 8, 7, -1, -1, -1, -1},
+    {1, 6, 10, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+    {1, 6, 2, 1, 7, 6, 1, 8, 7, 1, 9, 8, -1, -1, -1, -1},
+    {0, 6, 9, 9, 2, 1, 9, 6, 2, 0, 7, 6, 0, 3, 7, -1},
+    {0, 6, 2, 0, 7, 6, 0, 8, 7, -1, -1, -1, -1, -1, -1, -1},
+    {2, 7, 6, 2, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 11, 3, 6, 8, 7, 6, 9, 8, 6, 10, 9, -1, -1, -1, -1},
+    {0, 10, 9, 0, 6, 10, 0, 7, 6, 0, 11, 7, 0, 2, 11, -1},
+    {0, 10, 1, 0, 6, 10, 0, 7, 6, 0, 8, 7, 2, 11, 3, -1},
+    {1, 6, 10, 1, 7, 6, 1, 11, 7, 1, 2, 11, -1, -1, -1, -1},
+    {1, 11, 3, 1, 6, 11, 1, 7, 6, 1, 8, 7, 1, 9, 8, -1},
+    {0, 1, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 3, 0, 6, 11, 0, 7, 6, 0, 8, 7, -1, -1, -1, -1},
+    {6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {6, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 3, 8, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 10, 2, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 2, 0, 9, 10, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {2, 9, 10, 2, 8, 9, 2, 3, 8, 6, 7, 11, -1, -1, -1, -1},
+    {2, 7, 3, 2, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 6, 7, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 7, 3, 2, 6, 7, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 7, 8, 1, 6, 7, 1, 2, 6, -1, -1, -1, -1},
+    {1, 7, 3, 1, 6, 7, 1, 10, 6, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 6, 7, 0, 10, 6, 0, 1, 10, -1, -1, -1, -1},
+    {0, 7, 3, 0, 6, 7, 0, 10, 6, 0, 9, 10, -1, -1, -1, -1},
+    {6, 9, 10, 6, 8, 9, 6, 7, 8, -1, -1, -1, -1, -1, -1, -1},
+    {4, 11, 6, 4, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 6, 4, 0, 11, 6, 0, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 4, 11, 6, 4, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 9, 1, 6, 4, 1, 11, 6, 1, 3, 11, -1, -1, -1, -1},
+    {1, 10, 2, 4, 11, 6, 4, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 6, 4, 0, 11, 6, 0, 3, 11, 1, 10, 2, -1, -1, -1, -1},
+    {0, 10, 2, 0, 9, 10, 4, 11, 6, 4, 8, 11, -1, -1, -1, -1},
+    {2, 9, 10, 2, 4, 9, 2, 3, 4, 4, 11, 6, 4, 3, 11, -1},
+    {2, 8, 3, 2, 4, 8, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1},
+    {0, 6, 4, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 8, 3, 2, 4, 8, 2, 6, 4, -1, -1, -1, -1},
+    {1, 4, 9, 1, 6, 4, 1, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 3, 1, 4, 8, 1, 6, 4, 1, 10, 6, -1, -1, -1, -1},
+    {0, 6, 4, 0, 10, 6, 0, 1, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 6, 3, 3, 4, 8, 3, 6, 4, 0, 10, 6, 0, 9, 10, -1},
+    {4, 10, 6, 4, 9, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {4, 5, 9, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 4, 5, 9, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 1, 0, 4, 5, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 4, 5, 1, 8, 4, 1, 3, 8, 6, 7, 11, -1, -1, -1, -1},
+    {1, 10, 2, 4, 5, 9, 6, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 10, 2, 4, 5, 9, 6, 7, 11, -1, -1, -1, -1},
+    {0, 10, 2, 0, 5, 10, 0, 4, 5, 6, 7, 11, -1, -1, -1, -1},
+    {2, 5, 10, 2, 4, 5, 2, 8, 4, 2, 3, 8, 6, 7, 11, -1},
+    {2, 7, 3, 2, 6, 7, 4, 5, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 6, 7, 0, 2, 6, 4, 5, 9, -1, -1, -1, -1},
+    {0, 5, 1, 0, 4, 5, 2, 7, 3, 2, 6, 7, -1, -1, -1, -1},
+    {1, 4, 5, 1, 8, 4, 1, 7, 8, 1, 6, 7, 1, 2, 6, -1},
+    {1, 7, 3, 1, 6, 7, 1, 10, 6, 4, 5, 9, -1, -1, -1, -1},
+    {0, 7, 8, 0, 6, 7, 0, 10, 6, 0, 1, 10, 4, 5, 9, -1},
+    {0, 7, 3, 0, 6, 7, 0, 10, 6, 0, 5, 10, 0, 4, 5, -1},
+    {4, 10, 8, 8, 6, 7, 8, 10, 6, 4, 5, 10, -1, -1, -1, -1},
+    {5, 11, 6, 5, 8, 11, 5, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 9, 0, 6, 5, 0, 11, 6, 0, 3, 11, -1, -1, -1, -1},
+    {0, 5, 1, 0, 6, 5, 0, 11, 6, 0, 8, 11, -1, -1, -1, -1},
+    {1, 6, 5, 1, 11, 6, 1, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 10, 2, 5, 11, 6, 5, 8, 11, 5, 9, 8, -1, -1, -1, -1},
+    {0, 5, 9, 0, 6, 5, 0, 11, 6, 0, 3, 11, 1, 10, 2, -1},
+    {0, 10, 2, 0, 5, 10, 0, 6, 5, 0, 11, 6, 0, 8, 11, -1},
+    {2, 5, 10, 2, 3, 5, 5, 11, 6, 5, 3, 11, -1, -1, -1, -1},
+    {2, 8, 3, 2, 9, 8, 2, 5, 9, 2, 6, 5, -1, -1, -1, -1},
+    {0, 5, 9, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 1, 0, 6, 5, 0, 8, 6, 6, 3, 2, 6, 8, 3, -1},
+    {1, 6, 5, 1, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 3, 1, 6, 8, 8, 5, 9, 8, 6, 5, 1, 10, 6, -1},
+    {0, 5, 9, 0, 6, 5, 0, 10, 6, 0, 1, 10, -1, -1, -1, -1},
+    {0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {5, 11, 10, 5, 7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 5, 11, 10, 5, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 5, 11, 10, 5, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 9, 1, 3, 8, 5, 11, 10, 5, 7, 11, -1, -1, -1, -1},
+    {1, 11, 2, 1, 7, 11, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 1, 11, 2, 1, 7, 11, 1, 5, 7, -1, -1, -1, -1},
+    {0, 11, 2, 0, 7, 11, 0, 5, 7, 0, 9, 5, -1, -1, -1, -1},
+    {2, 7, 11, 2, 5, 7, 2, 9, 5, 2, 8, 9, 2, 3, 8, -1},
+    {2, 7, 3, 2, 5, 7, 2, 10, 5, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 5, 7, 0, 10, 5, 0, 2, 10, -1, -1, -1, -1},
+    {0, 9, 1, 2, 7, 3, 2, 5, 7, 2, 10, 5, -1, -1, -1, -1},
+    {1, 8, 9, 1, 7, 8, 1, 2, 7, 7, 10, 5, 7, 2, 10, -1},
+    {1, 7, 3, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 5, 7, 0, 1, 5, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 3, 0, 5, 7, 0, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+    {5, 8, 9, 5, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {4, 10, 5, 4, 11, 10, 4, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 4, 0, 10, 5, 0, 11, 10, 0, 3, 11, -1, -1, -1, -1},
+    {0, 9, 1, 4, 10, 5, 4, 11, 10, 4, 8, 11, -1, -1, -1, -1},
+    {1, 4, 9, 1, 11, 4, 4, 10, 5, 4, 11, 10, 1, 3, 11, -1},
+    {1, 11, 2, 1, 8, 11, 1, 4, 8, 1, 5, 4, -1, -1, -1, -1},
+    {0, 5, 4, 0, 11, 5, 5, 2, 1, 5, 11, 2, 0, 3, 11, -1},
+    {0, 11, 2, 0, 5, 11, 11, 4, 8, 11, 5, 4, 0, 9, 5, -1},
+    {2, 3, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 8, 3, 2, 4, 8, 2, 5, 4, 2, 10, 5, -1, -1, -1, -1},
+    {0, 5, 4, 0, 10, 5, 0, 2, 10, -1, -1, -1, -1, -1, -1, -1},
+    {0, 9, 1, 2, 8, 3, 2, 4, 8, 2, 5, 4, 2, 10, 5, -1},
+    {1, 4, 9, 1, 2, 4, 4, 10, 5, 4, 2, 10, -1, -1, -1, -1},
+    {1, 8, 3, 1, 4, 8, 1, 5, 4, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 4, 0, 1, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 5, 3, 3, 4, 8, 3, 5, 4, 0, 9, 5, -1, -1, -1, -1},
+    {4, 9, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {4, 10, 9, 4, 11, 10, 4, 7, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 3, 8, 4, 10, 9, 4, 11, 10, 4, 7, 11, -1, -1, -1, -1},
+    {0, 10, 1, 0, 11, 10, 0, 7, 11, 0, 4, 7, -1, -1, -1, -1},
+    {1, 11, 10, 1, 7, 11, 1, 4, 7, 1, 8, 4, 1, 3, 8, -1},
+    {1, 11, 2, 1, 7, 11, 1, 4, 7, 1, 9, 4, -1, -1, -1, -1},
+    {0, 3, 8, 1, 11, 2, 1, 7, 11, 1, 4, 7, 1, 9, 4, -1},
+    {0, 11, 2, 0, 7, 11, 0, 4, 7, -1, -1, -1, -1, -1, -1, -1},
+    {2, 7, 11, 2, 4, 7, 2, 8, 4, 2, 3, 8, -1, -1, -1, -1},
+    {2, 7, 3, 2, 4, 7, 2, 9, 4, 2, 10, 9, -1, -1, -1, -1},
+    {0, 7, 8, 0, 10, 7, 7, 9, 4, 7, 10, 9, 0, 2, 10, -1},
+    {0, 10, 1, 0, 7, 10, 10, 3, 2, 10, 7, 3, 0, 4, 7, -1},
+    {1, 2, 10, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 7, 3, 1, 4, 7, 1, 9, 4, -1, -1, -1, -1, -1, -1, -1},
+    {0, 7, 8, 0, 1, 7, 7, 9, 4, 7, 1, 9, -1, -1, -1, -1},
+    {0, 7, 3, 0, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {8, 10, 9, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 9, 0, 11, 10, 0, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 1, 0, 11, 10, 0, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+    {1, 11, 10, 1, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 11, 2, 1, 8, 11, 1, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+    {0, 11, 9, 9, 2, 1, 9, 11, 2, 0, 3, 11, -1, -1, -1, -1},
+    {0, 11, 2, 0, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {2, 8, 3, 2, 9, 8, 2, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 9, 0, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 10, 1, 0, 8, 10, 10, 3, 2, 10, 8, 3, -1, -1, -1, -1},
+    {1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {1, 8, 3, 1, 9, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
+};
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct Volume Volume;
+typedef struct Brick Brick;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct Volume
+{
+    uint32_t shape[3]; // width, height, depth
+    uint32_t bricks[3];
+    const float* values;
+    float level;
+};
+
+
+
+struct Brick
+{
+    bool active;
+
+    // Vertices.
+    uint32_t vertex_count;
+    uint32_t vertex_capacity;
+    uint32_t* keys; // local edge index of each vertex
+    vec3* pos;
+    vec3* normal;
+    uint32_t vertex_offset;
+
+    // Hash map from the local edge index to the vertex index, with open addressing.
+    uint32_t map_size; // power of two
+    uint32_t* map_keys;
+    uint32_t* map_values;
+
+    // Triangles.
+    uint32_t index_count;
+    uint32_t index_capacity;
+    DvzIndex* index;
+};
+
+
+
+/*************************************************************************************************/
+/*  Volume utils                                                                                 */
+/*************************************************************************************************/
+
+static inline float _value(Volume* vol, uint32_t x, uint32_t y, uint32_t z)
+{
+    return vol->values[((uint64_t)z * vol->shape[1] + y) * vol->shape[0] + x];
+}
+
+
+
+static inline uint32_t _brick_count(uint32_t n)
+{
+    return n > 1 ? (n - 1 + BRICK_SIZE - 1) / BRICK_SIZE : 0;
+}
+
+
+
+// Range of nodes [n0, n1] covered by brick b along one axis, including the far border nodes.
+static inline void _brick_nodes(uint32_t n, uint32_t b, uint32_t* n0, uint32_t* n1)
+{
+    *n0 = b * BRICK_SIZE;
+    *n1 = MIN(*n0 + BRICK_SIZE, n - 1);
+}
+
+
+
+// Brick owning a node along one axis, the last brick also owns the nodes on the far border.
+static inline uint32_t _node_brick(uint32_t bricks, uint32_t x)
+{
+    return MIN(x / BRICK_SIZE, bricks - 1);
+}
+
+
+
+static void _gradient(Volume* vol, uint32_t x, uint32_t y, uint32_t z, vec3 out)
+{
+    uint32_t p[3] = {x, y, z};
+    uint32_t a[3] = {0}, b[3] = {0};
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        memcpy(a, p, sizeof(a));
+        memcpy(b, p, sizeof(b));
+        a[k] = p[k] > 0 ? p[k] - 1 : p[k];
+        b[k] = p[k] < vol->shape[k] - 1 ? p[k] + 1 : p[k];
+        out[k] = (_value(vol, b[0], b[1], b[2]) - _value(vol, a[0], a[1], a[2])) /
+                 (float)MAX(1, b[k] - a[k]);
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Hash map                                                                                     */
+/*************************************************************************************************/
+
+static inline uint32_t _hash(uint32_t key, uint32_t size)
+{
+    return (key * 2654435761u) & (size - 1);
+}
+
+
+
+static void _map_build(Brick* brick)
+{
+    ANN(brick);
+    uint32_t size = 16;
+    while (size < 2 * brick->vertex_count)
+        size *= 2;
+    brick->map_size = size;
+    brick->map_keys = (uint32_t*)malloc(size * sizeof(uint32_t));
+    brick->map_values = (uint32_t*)malloc(size * sizeof(uint32_t));
+    memset(brick->map_keys, 0xFF, size * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < brick->vertex_count; i++)
+    {
+        uint32_t h = _hash(brick->keys[i], size);
+        while (brick->map_keys[h] != NO_VERTEX)
+            h = (h + 1) & (size - 1);
+        brick->map_keys[h] = brick->keys[i];
+        brick->map_values[h] = i;
+    }
+}
+
+
+
+static inline uint32_t _map_get(Brick* brick, uint32_t key)
+{
+    ANN(brick);
+    if (brick->map_size == 0)
+        return NO_VERTEX;
+    uint32_t h = _hash(key, brick->map_size);
+    while (brick->map_keys[h] != NO_VERTEX)
+    {
+        if (brick->map_keys[h] == key)
+            return brick->map_values[h];
+        h = (h + 1) & (brick->map_size - 1);
+    }
+    return NO_VERTEX;
+}
+
+
+
+/*************************************************************************************************/
+/*  Marching cubes                                                                               */
+/*************************************************************************************************/
+
+// Create the vertices on the edges owned by a brick.
+static void _brick_vertices(Volume* vol, Brick* brick, const uint32_t b[3])
+{
+    uint32_t n0[3] = {0}, n1[3] = {0}, end[3] = {0};
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        _brick_nodes(vol->shape[k], b[k], &n0[k], &n1[k]);
+        // The nodes on the brick far border belong to the next brick, if any.
+        end[k] = b[k] < vol->bricks[k] - 1 ? n1[k] - 1 : n1[k];
+    }
+
+    float level = vol->level;
+    float va = 0, vb = 0, t = 0;
+    uint32_t q[3] = {0};
+    vec3 ga = {0}, gb = {0}, g = {0};
+
+    for (uint32_t z = n0[2]; z <= end[2]; z++)
+    {
+        for (uint32_t y = n0[1]; y <= end[1]; y++)
+        {
+            for (uint32_t x = n0[0]; x <= end[0]; x++)
+            {
+                va = _value(vol, x, y, z);
+                if (isnan(va))
+                    continue;
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    q[0] = x;
+                    q[1] = y;
+                    q[2] = z;
+                    q[axis]++;
+                    if (q[axis] >= vol->shape[axis])
+                        continue;
+                    vb = _value(vol, q[0], q[1], q[2]);
+                    if (isnan(vb) || ((va >= level) == (vb >= level)))
+                        continue;
+
+                    if (brick->vertex_count == brick->vertex_capacity)
+                    {
+                        brick->vertex_capacity = MAX(256, 2 * brick->vertex_capacity);
+                        REALLOC(brick->keys, brick->vertex_capacity * sizeof(uint32_t));
+                        REALLOC(brick->pos, brick->vertex_capacity * sizeof(vec3));
+                        REALLOC(brick->normal, brick->vertex_capacity * sizeof(vec3));
+                    }
+                    uint32_t i = brick->vertex_count++;
+                    brick->keys[i] =
+                        (((z - n0[2]) * BRICK_NODES + (y - n0[1])) * BRICK_NODES + (x - n0[0])) *
+                            3 +
+                        axis;
+
+                    // Position in grid coordinates, interpolated along the edge.
+                    t = (level - va) / (vb - va);
+                    brick->pos[i][0] = (float)x;
+                    brick->pos[i][1] = (float)y;
+                    brick->pos[i][2] = (float)z;
+                    brick->pos[i][axis] += t;
+
+                    // Gradient in grid coordinates, interpolated along the edge.
+                    _gradient(vol, x, y, z, ga);
+                    _gradient(vol, q[0], q[1], q[2], gb);
+                    glm_vec3_lerp(ga, gb, t, g);
+                    memcpy(brick->normal[i], g, sizeof(vec3));
+                }
+            }
+        }
+    }
+}
+
+
+
+// Triangulate the cells of a brick.
+static void _brick_triangles(Volume* vol, Brick* bricks, const uint32_t b[3])
+{
+    Brick* brick = &bricks[(b[2] * vol->bricks[1] + b[1]) * vol->bricks[0] + b[0]];
+    uint32_t c0[3] = {0}, c1[3] = {0};
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        _brick_nodes(vol->shape[k], b[k], &c0[k], &c1[k]);
+    }
+
+    float level = vol->level;
+    float c[8] = {0};
+    uint32_t node[3] = {0}, ob[3] = {0}, on0 = 0, on1 = 0;
+    bool nan = false;
+
+    for (uint32_t z = c0[2]; z < c1[2]; z++)
+    {
+        for (uint32_t y = c0[1]; y < c1[1]; y++)
+        {
+            for (uint32_t x = c0[0]; x < c1[0]; x++)
+            {
+                uint32_t mask = 0;
+                nan = false;
+                for (uint32_t k = 0; k < 8; k++)
+                {
+                    c[k] = _value(
+                        vol, x + CORNERS[k][0], y + CORNERS[k][1], z + CORNERS[k][2]);
+                    nan |= isnan(c[k]);
+                    mask |= (uint32_t)(c[k] >= level) << k;
+                }
+                if (nan || mask == 0 || mask == 0xFF)
+                    continue;
+
+                const int8_t* tri = TRIANGLES[mask];
+                for (uint32_t i = 0; i < 16 && tri[i] >= 0; i++)
+                {
+                    const uint8_t* e = EDGES[tri[i]];
+
+                    // Find the brick owning the edge, and the vertex in its hash map.
+                    node[0] = x + e[0];
+                    node[1] = y + e[1];
+                    node[2] = z + e[2];
+                    for (uint32_t k = 0; k < 3; k++)
+                        ob[k] = _node_brick(vol->bricks[k], node[k]);
+                    Brick* owner = &bricks[(ob[2] * vol->bricks[1] + ob[1]) * vol->bricks[0] + ob[0]];
+                    uint32_t key = 0;
+                    for (int32_t k = 2; k >= 0; k--)
+                    {
+                        _brick_nodes(vol->shape[k], ob[k], &on0, &on1);
+                        key = key * BRICK_NODES + (node[k] - on0);
+                    }
+                    key = 3 * key + e[3];
+                    uint32_t v = _map_get(owner, key);
+                    ASSERT(v != NO_VERTEX);
+
+                    if (brick->index_count == brick->index_capacity)
+                    {
+                        brick->index_capacity = MAX(1024, 2 * brick->index_capacity);
+                        REALLOC(brick->index, brick->index_capacity * sizeof(DvzIndex));
+                    }
+                    brick->index[brick->index_count++] = owner->vertex_offset + v;
+                }
+            }
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+uint32_t dvz_isosurface_bricks(uint32_t width, uint32_t height, uint32_t depth)
+{
+    return _brick_count(width) * _brick_count(height) * _brick_count(depth);
+}
+
+
+
+void dvz_isosurface_ranges(
+    uint32_t width, uint32_t height, uint32_t depth, const float* volume, vec2* ranges)
+{
+    ANN(volume);
+    ANN(ranges);
+
+    Volume vol = {.shape = {width, height, depth}, .values = volume};
+    uint32_t bx = _brick_count(width), by = _brick_count(height);
+    uint32_t brick_count = dvz_isosurface_bricks(width, height, depth);
+
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t i = 0; i < (int64_t)brick_count; i++)
+    {
+        uint32_t b[3] = {(uint32_t)i % bx, ((uint32_t)i / bx) % by, (uint32_t)i / (bx * by)};
+        uint32_t n0[3] = {0}, n1[3] = {0};
+        for (uint32_t k = 0; k < 3; k++)
+            _brick_nodes(vol.shape[k], b[k], &n0[k], &n1[k]);
+
+        // NaN values are ignored, a brick with only NaN values has an empty range.
+        float vmin = INFINITY, vmax = -INFINITY, value = 0;
+        for (uint32_t z = n0[2]; z <= n1[2]; z++)
+        {
+            for (uint32_t y = n0[1]; y <= n1[1]; y++)
+            {
+                for (uint32_t x = n0[0]; x <= n1[0]; x++)
+                {
+                    value = _value(&vol, x, y, z);
+                    vmin = fminf(vmin, value);
+                    vmax = fmaxf(vmax, value);
+                }
+            }
+        }
+        ranges[i][0] = vmin;
+        ranges[i][1] = vmax;
+    }
+}
+
+
+
+DvzShape dvz_shape_isosurface(
+    uint32_t width, uint32_t height, uint32_t depth, const float* volume, float level,
+    vec2* ranges, vec3 o, vec3 u, vec3 v, vec3 w, DvzColor color)
+{
+    ANN(volume);
+
+    DvzShape shape = {0};
+    shape.type = DVZ_SHAPE_OTHER;
+
+    uint32_t brick_count = dvz_isosurface_bricks(width, height, depth);
+    if (brick_count == 0)
+    {
+        log_error("the volume needs at least 2 values along each dimension");
+        return shape;
+    }
+    ASSERT((uint64_t)BRICK_NODES * BRICK_NODES * BRICK_NODES * 3 < NO_VERTEX);
+
+    Volume vol = {
+        .shape = {width, height, depth},
+        .bricks = {_brick_count(width), _brick_count(height), _brick_count(depth)},
+        .values = volume,
+        .level = level,
+    };
+
+    // Value ranges of the bricks, to skip the bricks that do not contain the level.
+    vec2* brick_ranges = ranges;
+    if (brick_ranges == NULL)
+    {
+        brick_ranges = (vec2*)calloc(brick_count, sizeof(vec2));
+        dvz_isosurface_ranges(width, height, depth, volume, brick_ranges);
+    }
+
+    Brick* bricks = (Brick*)calloc(brick_count, sizeof(Brick));
+    uint32_t active_count = 0;
+    for (uint32_t i = 0; i < brick_count; i++)
+    {
+        bricks[i].active = brick_ranges[i][0] < level && level <= brick_ranges[i][1];
+        active_count += bricks[i].active ? 1 : 0;
+    }
+
+    // Vertices on the edges owned by each brick, and hash maps.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t i = 0; i < (int64_t)brick_count; i++)
+    {
+        if (!bricks[i].active)
+            continue;
+        uint32_t b[3] = {
+            (uint32_t)i % vol.bricks[0], ((uint32_t)i / vol.bricks[0]) % vol.bricks[1],
+            (uint32_t)i / (vol.bricks[0] * vol.bricks[1])};
+        _brick_vertices(&vol, &bricks[i], b);
+        _map_build(&bricks[i]);
+    }
+
+    // Global vertex numbering.
+    uint32_t vertex_count = 0;
+    for (uint32_t i = 0; i < brick_count; i++)
+    {
+        bricks[i].vertex_offset = vertex_count;
+        vertex_count += bricks[i].vertex_count;
+    }
+
+    // Triangles, the hash maps are only read at this point.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t i = 0; i < (int64_t)brick_count; i++)
+    {
+        if (!bricks[i].active)
+            continue;
+        uint32_t b[3] = {
+            (uint32_t)i % vol.bricks[0], ((uint32_t)i / vol.bricks[0]) % vol.bricks[1],
+            (uint32_t)i / (vol.bricks[0] * vol.bricks[1])};
+        _brick_triangles(&vol, bricks, b);
+    }
+
+    uint32_t* index_offsets = (uint32_t*)calloc(brick_count + 1, sizeof(uint32_t));
+    for (uint32_t i = 0; i < brick_count; i++)
+        index_offsets[i + 1] = index_offsets[i] + bricks[i].index_count;
+    uint32_t index_count = index_offsets[brick_count];
+
+    log_debug(
+        "isosurface with %d vertices and %d triangles, %d/%d bricks", vertex_count,
+        index_count / 3, active_count, brick_count);
+
+    if (index_count > 0)
+    {
+        shape.vertex_count = vertex_count;
+        shape.index_count = index_count;
+        shape.pos = (vec3*)calloc(vertex_count, sizeof(vec3));
+        shape.normal = (vec3*)calloc(vertex_count, sizeof(vec3));
+        shape.color = (DvzColor*)calloc(vertex_count, sizeof(DvzColor));
+        shape.index = (DvzIndex*)calloc(index_count, sizeof(DvzIndex));
+    }
+
+    // The gradients are transformed with the inverse transpose of the (u, v, w) matrix.
+    mat3 m = {0}, m_it = {0};
+    glm_vec3_copy(u, m[0]);
+    glm_vec3_copy(v, m[1]);
+    glm_vec3_copy(w, m[2]);
+    glm_mat3_inv(m, m_it);
+    glm_mat3_transpose(m_it);
+
+    // Final positions, normals, colors and indices.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int64_t i = 0; i < (int64_t)brick_count; i++)
+    {
+        Brick* brick = &bricks[i];
+        if (index_count > 0)
+        {
+            vec3 g = {0};
+            for (uint32_t j = 0; j < brick->vertex_count; j++)
+            {
+                uint32_t k = brick->vertex_offset + j;
+                float* p = brick->pos[j];
+                for (uint32_t l = 0; l < 3; l++)
+                    shape.pos[k][l] = o[l] + p[0] * u[l] + p[1] * v[l] + p[2] * w[l];
+
+                // The normals point towards the low values.
+                glm_mat3_mulv(m_it, brick->normal[j], g);
+                glm_vec3_negate(g);
+                glm_vec3_normalize(g);
+                glm_vec3_copy(g, shape.normal[k]);
+
+                memcpy(shape.color[k], color, sizeof(DvzColor));
+            }
+            if (brick->index_count > 0)
+                memcpy(
+                    &shape.index[index_offsets[i]], brick->index,
+                    brick->index_count * sizeof(DvzIndex));
+        }
+
+        FREE(brick->keys);
+        FREE(brick->pos);
+        FREE(brick->normal);
+        FREE(brick->map_keys);
+        FREE(brick->map_values);
+        FREE(brick->index);
+    }
+
+    FREE(bricks);
+    FREE(index_offsets);
+    if (ranges == NULL)
+        FREE(brick_ranges);
+
+    return shape;
+}
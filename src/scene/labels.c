@@ -16,6 +16,7 @@
 #include "scene/labels.h"
 #include "_macros.h"
 #include "labels_utils.h"
+#include "scene/format.h"
 #include "scene/ticks.h"
 
 
@@ -32,8 +33,8 @@ dvz_label_format(DvzTicksFormat format, uint32_t precision, int32_t exponent, do
         .precision = precision,
         .exponent = exponent,
         .offset = offset,
+        .scientific = _is_format_scientific(format),
     };
-    _get_tick_format(format, precision, f.tick_format);
     return f;
 }
 
@@ -107,13 +108,18 @@ uint32_t dvz_labels_generate(
         // Exponent.
 
         if (exponent != 0)
-            _tick_label(pow(10, exponent), "x%g", labels->exponent);
+        {
+            char exp[DVZ_FORMAT_MAX_LENGTH] = {0};
+            dvz_format_shortest(pow(10, exponent), exp);
+            labels->exponent[0] = 'x';
+            strncpy(&labels->exponent[1], exp, DVZ_LABELS_MAX_EXPONENT_LENGTH - 2);
+        }
         else
             labels->exponent[0] = 0;
 
         // Offset.
         if (offset != 0)
-            _tick_label(offset, fmt.tick_format, labels->offset);
+            _tick_label(offset, fmt.scientific, precision, labels->offset);
         else
             labels->offset[0] = 0;
     }
@@ -123,6 +129,39 @@ uint32_t dvz_labels_generate(
 
 
 
+uint32_t dvz_labels_from_values(
+    DvzLabels* labels, DvzTicksFormat format, uint32_t precision, //
+    uint32_t count, double* values)
+{
+    ANN(labels);
+    ANN(values);
+    ASSERT(count <= MAX_LABELS);
+
+    DvzLabelFormat fmt = dvz_label_format(format, precision, 0, 0);
+    labels->count = count; // tick count.
+
+    uint32_t k = 0, n = 0;
+    uint32_t glyph_count = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        n = format_label(&fmt, values[i], &labels->labels[k]);
+
+        labels->length[i] = n;
+        labels->index[i] = k;
+        labels->values[i] = values[i];
+
+        glyph_count += n;
+        k += (n + 1); // NOTE: 0-terminated strings
+    }
+
+    labels->exponent[0] = 0;
+    labels->offset[0] = 0;
+
+    return glyph_count;
+}
+
+
+
 // the output must not be freed
 char* dvz_labels_string(DvzLabels* labels)
 {
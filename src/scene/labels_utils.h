@@ -17,6 +17,7 @@
 /*************************************************************************************************/
 
 #include "_macros.h"
+#include "scene/format.h"
 #include "scene/labels.h"
 
 
@@ -33,42 +34,44 @@
 /*  Util functions                                                                               */
 /*************************************************************************************************/
 
-static inline void _get_tick_format(DvzTicksFormat format, uint32_t precision, char* fmt)
+static inline bool _is_format_scientific(DvzTicksFormat format)
 {
-    uint32_t offset = 4;
-    strcpy(fmt, "%s%.XF"); // [2] = precision, [3] = f or e
-    snprintf(&fmt[offset], 4, "%u", precision);
     switch (format)
     {
     case DVZ_TICKS_FORMAT_DECIMAL:
     case DVZ_TICKS_FORMAT_DECIMAL_FACTORED:
     case DVZ_TICKS_FORMAT_SCIENTIFIC_FACTORED:
-        fmt[offset + 1] = 'f';
-        break;
+        return false;
     case DVZ_TICKS_FORMAT_SCIENTIFIC:
-        fmt[offset + 1] = 'e';
-        break;
+        return true;
     default:
         log_error("unknown tick format %d", format);
-        break;
+        return false;
     }
+    return false;
 }
 
 
 
-static inline void _tick_label(double x, char* tick_format, char* out)
+static inline uint32_t _tick_label(double x, bool scientific, uint32_t precision, char* out)
 {
     if (x == 0)
     {
-        snprintf(out, 2, "0");
-        return;
+        out[0] = '0';
+        out[1] = 0;
+        return 1;
     }
-    char sign[2] = {0};
-    sign[0] = x < 0 ? '-' : '+';
-    MUTE_NONLITERAL_ON
-    snprintf(out, MAX_GLYPHS_PER_LABEL, tick_format, sign, fabs(x));
-    MUTE_NONLITERAL_OFF
-    ASSERT(strnlen(out, 2 * MAX_GLYPHS_PER_LABEL) < MAX_GLYPHS_PER_LABEL);
+    // NOTE: the formatter may write up to DVZ_FORMAT_MAX_LENGTH bytes, the label is truncated so
+    // that the sign and the trailing 0 fit in MAX_GLYPHS_PER_LABEL bytes.
+    char tmp[DVZ_FORMAT_MAX_LENGTH] = {0};
+    uint32_t n = scientific ? dvz_format_scientific(fabs(x), precision, tmp)
+                            : dvz_format_fixed(fabs(x), precision, tmp);
+    n = MIN(n, MAX_GLYPHS_PER_LABEL - 2);
+    out[0] = x < 0 ? '-' : '+';
+    memcpy(&out[1], tmp, n);
+    out[n + 1] = 0;
+    ASSERT(n + 1 < MAX_GLYPHS_PER_LABEL);
+    return n + 1;
 }
 
 
@@ -228,12 +231,7 @@ static inline uint32_t format_label(DvzLabelFormat* fmt, double value, char* out
         value /= exp;
     }
 
-    _tick_label(value, fmt->tick_format, out);
-
-    uint32_t n = strnlen(out, MAX_GLYPHS_PER_LABEL * 2);
-    ASSERT(n < MAX_GLYPHS_PER_LABEL);
-
-    return n;
+    return _tick_label(value, fmt->scientific, fmt->precision, out);
 }
 
 
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Binary mesh files                                                                            */
+/*************************************************************************************************/
+
+// A .dvzmesh file starts with a fixed-size header, followed by one section per non-NULL array of
+// the shape, each aligned to DVZ_MESHFILE_ALIGNMENT bytes. All values are stored in the native
+// (little-endian) byte order, so that loading a shape is a plain copy of each section.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/meshfile.h"
+#include "_macros.h"
+#include "datoviz.h"
+#include "fileio.h"
+
+#include <sys/stat.h>
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define MESHFILE_MAGIC "DVZMESH"
+
+typedef enum
+{
+    SECTION_POS,
+    SECTION_NORMAL,
+    SECTION_COLOR,
+    SECTION_TEXCOORDS,
+    SECTION_ISOLINE,
+    SECTION_D_LEFT,
+    SECTION_D_RIGHT,
+    SECTION_CONTOUR,
+    SECTION_INDEX,
+    SECTION_COUNT,
+} MeshFileSection;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct
+{
+    DvzSize field_offset; // offset of the array pointer in DvzShape
+    DvzSize item_size;
+    bool per_index; // index_count items instead of vertex_count
+} SectionSpec;
+
+
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t type;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint64_t source_size;
+    uint64_t source_mtime;
+
+    uint32_t lod_count;
+    uint32_t lod_first[DVZ_SHAPE_MAX_LODS];
+    uint32_t lod_index_count[DVZ_SHAPE_MAX_LODS];
+    float lod_error[DVZ_SHAPE_MAX_LODS];
+
+    uint64_t offsets[SECTION_COUNT]; // 0 if the array is NULL
+} MeshFileHeader;
+
+
+
+static const SectionSpec SECTIONS[SECTION_COUNT] = {
+    {offsetof(DvzShape, pos), sizeof(vec3), false},
+    {offsetof(DvzShape, normal), sizeof(vec3), false},
+    {offsetof(DvzShape, color), sizeof(DvzColor), false},
+    {offsetof(DvzShape, texcoords), sizeof(vec4), false},
+    {offsetof(DvzShape, isoline), sizeof(float), false},
+    {offsetof(DvzShape, d_left), sizeof(vec3), false},
+    {offsetof(DvzShape, d_right), sizeof(vec3), false},
+    {offsetof(DvzShape, contour), sizeof(cvec4), false},
+    {offsetof(DvzShape, index), sizeof(DvzIndex), true},
+};
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static inline void** _section_field(DvzShape* shape, MeshFileSection section)
+{
+    return (void**)((uint8_t*)shape + SECTIONS[section].field_offset);
+}
+
+
+
+static inline DvzSize
+_section_size(MeshFileSection section, uint32_t vertex_count, uint32_t index_count)
+{
+    SectionSpec spec = SECTIONS[section];
+    return spec.item_size * (spec.per_index ? index_count : vertex_count);
+}
+
+
+
+static inline uint64_t _align(uint64_t offset)
+{
+    return (offset + DVZ_MESHFILE_ALIGNMENT - 1) & ~(uint64_t)(DVZ_MESHFILE_ALIGNMENT - 1);
+}
+
+
+
+static bool _check_header(const MeshFileHeader* header, DvzSize file_size)
+{
+    if (memcmp(header->magic, MESHFILE_MAGIC, sizeof(MESHFILE_MAGIC)) != 0)
+    {
+        log_error("invalid .dvzmesh file");
+        return false;
+    }
+    if (header->version != DVZ_MESHFILE_VERSION)
+    {
+        log_warn("unsupported .dvzmesh file version %d", header->version);
+        return false;
+    }
+    if (header->type > DVZ_SHAPE_OTHER)
+    {
+        log_error("invalid shape type %d in .dvzmesh file", header->type);
+        return false;
+    }
+
+    // Levels of detail, within the index buffer.
+    if (header->lod_count > DVZ_SHAPE_MAX_LODS)
+    {
+        log_error("invalid number of levels of detail in .dvzmesh file");
+        return false;
+    }
+    for (uint32_t k = 0; k < header->lod_count; k++)
+    {
+        if ((uint64_t)header->lod_first[k] + header->lod_index_count[k] > header->index_count)
+        {
+            log_error("invalid level of detail #%d in .dvzmesh file", k);
+            return false;
+        }
+    }
+
+    // Sections, within the file.
+    for (uint32_t s = 0; s < SECTION_COUNT; s++)
+    {
+        uint64_t offset = header->offsets[s];
+        DvzSize size = _section_size((MeshFileSection)s, header->vertex_count, header->index_count);
+        if (offset != 0 && (offset % DVZ_MESHFILE_ALIGNMENT != 0 || offset > file_size ||
+                            size > file_size - offset))
+        {
+            log_error("truncated .dvzmesh file");
+            return false;
+        }
+    }
+
+    // The positions and the indices are required as soon as there are vertices and indices.
+    if ((header->vertex_count > 0 && header->offsets[SECTION_POS] == 0) ||
+        (header->index_count > 0 && header->offsets[SECTION_INDEX] == 0))
+    {
+        log_error("missing positions or indices in .dvzmesh file");
+        return false;
+    }
+    return true;
+}
+
+
+
+// All the indices must refer to existing vertices.
+static bool _check_index(const DvzIndex* index, uint32_t index_count, uint32_t vertex_count)
+{
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        if (index[i] >= vertex_count)
+        {
+            log_error("index %d out of bounds in .dvzmesh file", index[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+int dvz_meshfile_write(
+    DvzShape* shape, const char* file_path, uint64_t source_size, uint64_t source_mtime)
+{
+    ANN(shape);
+    ANN(file_path);
+
+    MeshFileHeader header = {0};
+    memcpy(header.magic, MESHFILE_MAGIC, sizeof(MESHFILE_MAGIC));
+    header.version = DVZ_MESHFILE_VERSION;
+    header.type = (uint32_t)shape->type;
+    header.vertex_count = shape->vertex_count;
+    header.index_count = shape->index_count;
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    header.lod_count = shape->lod_count;
+    memcpy(header.lod_first, shape->lod_first, sizeof(header.lod_first));
+    memcpy(header.lod_index_count, shape->lod_index_count, sizeof(header.lod_index_count));
+    memcpy(header.lod_error, shape->lod_error, sizeof(header.lod_error));
+
+    // Section offsets.
+    uint64_t offset = _align(sizeof(MeshFileHeader));
+    for (uint32_t s = 0; s < SECTION_COUNT; s++)
+    {
+        DvzSize size =
+            _section_size((MeshFileSection)s, shape->vertex_count, shape->index_count);
+        if (*_section_field(shape, (MeshFileSection)s) == NULL || size == 0)
+            continue;
+        header.offsets[s] = offset;
+        offset = _align(offset + size);
+    }
+
+    FILE* f = fopen(file_path, "wb");
+    if (f == NULL)
+    {
+        log_debug("unable to write %s", file_path);
+        return 1;
+    }
+
+    const uint8_t zeros[DVZ_MESHFILE_ALIGNMENT] = {0};
+    uint64_t written = fwrite(&header, sizeof(header), 1, f) == 1 ? sizeof(header) : 0;
+    bool ok = written > 0;
+    for (uint32_t s = 0; s < SECTION_COUNT && ok; s++)
+    {
+        if (header.offsets[s] == 0)
+            continue;
+        ok &= fwrite(zeros, 1, header.offsets[s] - written, f) == header.offsets[s] - written;
+        DvzSize size =
+            _section_size((MeshFileSection)s, shape->vertex_count, shape->index_count);
+        ok &= fwrite(*_section_field(shape, (MeshFileSection)s), 1, size, f) == size;
+        written = header.offsets[s] + size;
+    }
+    ok &= fclose(f) == 0;
+
+    if (!ok)
+    {
+        log_debug("error while writing %s", file_path);
+        remove(file_path);
+        return 1;
+    }
+    log_debug("wrote %s (%s)", file_path, pretty_size(written));
+    return 0;
+}
+
+
+
+bool dvz_meshfile_read(
+    const char* file_path, uint64_t source_size, uint64_t source_mtime, DvzShape* shape)
+{
+    ANN(file_path);
+    ANN(shape);
+
+    DvzSize file_size = 0;
+    uint8_t* data = (uint8_t*)dvz_file_map(file_path, &file_size);
+    if (data == NULL)
+        return false;
+
+    MeshFileHeader header = {0};
+    bool ok = file_size >= sizeof(header);
+    if (ok)
+    {
+        memcpy(&header, data, sizeof(header));
+        ok = _check_header(&header, file_size);
+    }
+    if (ok && (source_size != 0 || source_mtime != 0) &&
+        (header.source_size != source_size || header.source_mtime != source_mtime))
+    {
+        log_debug("stale mesh cache %s", file_path);
+        ok = false;
+    }
+    if (ok && header.offsets[SECTION_INDEX] != 0)
+    {
+        // NOTE: the offset is aligned, so that the indices can be read from the mapping.
+        ok = _check_index(
+            (const DvzIndex*)&data[header.offsets[SECTION_INDEX]], header.index_count,
+            header.vertex_count);
+    }
+    if (!ok)
+    {
+        dvz_file_unmap(data, file_size);
+        return false;
+    }
+
+    DvzShape out = {0};
+    out.type = (DvzShapeType)header.type;
+    out.vertex_count = header.vertex_count;
+    out.index_count = header.index_count;
+    out.lod_count = header.lod_count;
+    memcpy(out.lod_first, header.lod_first, sizeof(out.lod_first));
+    memcpy(out.lod_index_count, header.lod_index_count, sizeof(out.lod_index_count));
+    memcpy(out.lod_error, header.lod_error, sizeof(out.lod_error));
+
+    // NOTE: the arrays are copied out of the mapping, as the shape owns them and the shape
+    // functions may free or reallocate them.
+    for (uint32_t s = 0; s < SECTION_COUNT; s++)
+    {
+        if (header.offsets[s] == 0)
+            continue;
+        DvzSize size = _section_size((MeshFileSection)s, out.vertex_count, out.index_count);
+        void* array = malloc(size);
+        ANN(array);
+        memcpy(array, &data[header.offsets[s]], size);
+        *_section_field(&out, (MeshFileSection)s) = array;
+    }
+    dvz_file_unmap(data, file_size);
+
+    *shape = out;
+    return true;
+}
+
+
+
+bool dvz_meshfile_stamp(const char* file_path, uint64_t* size, uint64_t* mtime)
+{
+    ANN(file_path);
+    ANN(size);
+    ANN(mtime);
+
+    struct stat st = {0};
+    if (stat(file_path, &st) != 0)
+        return false;
+    *size = (uint64_t)st.st_size;
+#if OS_MACOS
+    *mtime = (uint64_t)st.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)st.st_mtimespec.tv_nsec;
+#elif OS_WINDOWS
+    *mtime = (uint64_t)st.st_mtime * 1000000000ull;
+#else
+    *mtime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Shape functions                                                                              */
+/*************************************************************************************************/
+
+int dvz_shape_save(DvzShape* shape, const char* file_path)
+{
+    ANN(shape);
+    ANN(file_path);
+    int res = dvz_meshfile_write(shape, file_path, 0, 0);
+    if (res != 0)
+        log_error("unable to save the mesh file %s", file_path);
+    return res;
+}
+
+
+
+DvzShape dvz_shape_load(const char* file_path)
+{
+    ANN(file_path);
+    DvzShape shape = {0};
+    if (!dvz_meshfile_read(file_path, 0, 0, &shape))
+        log_error("unable to load the mesh file %s", file_path);
+    return shape;
+}
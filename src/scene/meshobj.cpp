@@ -11,6 +11,7 @@
 #include "_log.h"
 #include "_macros.h"
 #include "datoviz.h"
+#include "scene/meshfile.h"
 
 // #define MUTE_MISSING_PROTOTYPES _Pragma("GCC diagnostic ignored \"-Wmissing-prototypes\"")
 
@@ -25,6 +26,21 @@ MUTE_OFF
 /*  Constants                                                                                    */
 /*************************************************************************************************/
 
+// Set this environment variable to 1 to enable the .dvzmesh side cache of the OBJ files.
+#define MESH_CACHE_ENV "DVZ_MESH_CACHE"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+// The cache of an OBJ file is stored next to it, with the .dvzmesh extension appended.
+static std::string _cache_path(const char* file_path)
+{
+    return std::string(file_path) + DVZ_MESHFILE_EXTENSION;
+}
+
 
 
 /*************************************************************************************************/
@@ -84,6 +100,19 @@ DvzShape dvz_shape_obj(const char* file_path)
     DvzShape shape = {};
     shape.type = DVZ_SHAPE_OBJ;
 
+    // Side cache, valid as long as the OBJ file's size and modification time (in nanoseconds)
+    // are unchanged. Enabled by default (getenvint() returns -1 when the variable is unset),
+    // DVZ_MESH_CACHE=0 disables it.
+    bool use_cache = getenvint(MESH_CACHE_ENV) != 0;
+    uint64_t source_size = 0, source_mtime = 0;
+    std::string cache_path = _cache_path(file_path);
+    if (use_cache && dvz_meshfile_stamp(file_path, &source_size, &source_mtime) &&
+        dvz_meshfile_read(cache_path.c_str(), source_size, source_mtime, &shape))
+    {
+        log_debug("loaded %s from the cache %s", file_path, cache_path.c_str());
+        return shape;
+    }
+
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -218,5 +247,9 @@ DvzShape dvz_shape_obj(const char* file_path)
 
     dvz_shape_normalize(&shape);
 
+    // NOTE: the cache is optional, it may not be writable next to the OBJ file.
+    if (use_cache && source_size > 0)
+        dvz_meshfile_write(&shape, cache_path.c_str(), source_size, source_mtime);
+
     return shape;
 }
@@ -0,0 +1,1040 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Mesh optimization                                                                            */
+/*************************************************************************************************/
+
+// Three passes, applied in this order by dvz_shape_optimize():
+// - vertex cache: triangle reordering with Tom Forsyth's linear-speed algorithm,
+// - overdraw: clusters of triangles sorted so that the outward-facing ones come first,
+// - vertex fetch: vertices renumbered in the order of first use.
+//
+// The simplification collapses edges onto one of their vertices (quadric error metric), so that
+// all levels of detail share the same vertex buffer. Each pass sorts all candidate collapses and
+// applies the cheapest independent ones; the results do not depend on the number of threads.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/meshopt.h"
+#include "_macros.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define VCACHE_DECAY_POWER    1.5f
+#define VCACHE_LAST_TRI_SCORE 0.75f
+#define VCACHE_VALENCE_SCALE  2.0f
+#define VCACHE_VALENCE_POWER  0.5f
+#define VCACHE_VALENCE_MAX    64 // valences with a tabulated score
+
+// Cache size used to find the cluster boundaries in the overdraw pass.
+#define OVERDRAW_CACHE_SIZE 16
+
+// Minimum number of triangles in a soft cluster.
+#define OVERDRAW_MIN_CLUSTER 8
+
+// Weight of the quadrics that keep the mesh borders in place.
+#define SIMPLIFY_BORDER_WEIGHT 10.0
+
+// Maximum number of edge collapse passes.
+#define SIMPLIFY_MAX_PASSES 100
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct
+{
+    float key;
+    uint32_t idx;
+} ClusterKey;
+
+
+
+// Symmetric matrix A, vector b, constant c, weight w: error(p) = (p'Ap + 2b.p + c) / w.
+typedef struct
+{
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c, w;
+} Quadric;
+
+
+
+typedef struct
+{
+    float cost;
+    uint32_t v; // removed vertex
+    uint32_t t; // target vertex
+} Collapse;
+
+
+
+typedef enum
+{
+    VERTEX_MANIFOLD,
+    VERTEX_BORDER,
+} VertexKind;
+
+
+
+/*************************************************************************************************/
+/*  Vertex cache utils                                                                           */
+/*************************************************************************************************/
+
+typedef struct
+{
+    float cache[DVZ_MESHOPT_VCACHE_SIZE];
+    float valence[VCACHE_VALENCE_MAX];
+} ScoreTable;
+
+
+
+// Indices that do not form a full triangle, at the end of the buffer, are copied through.
+static void _copy_tail(uint32_t index_count, const DvzIndex* index, DvzIndex* out)
+{
+    uint32_t first = 3 * (index_count / 3);
+    if (out != index && first < index_count)
+        memcpy(&out[first], &index[first], (index_count - first) * sizeof(DvzIndex));
+}
+
+
+
+static void _score_table(ScoreTable* table)
+{
+    ANN(table);
+    for (uint32_t i = 0; i < DVZ_MESHOPT_VCACHE_SIZE; i++)
+    {
+        if (i < 3)
+        {
+            table->cache[i] = VCACHE_LAST_TRI_SCORE;
+        }
+        else
+        {
+            float s = 1.0f - (float)(i - 3) / (DVZ_MESHOPT_VCACHE_SIZE - 3);
+            table->cache[i] = powf(s, VCACHE_DECAY_POWER);
+        }
+    }
+    table->valence[0] = 0;
+    for (uint32_t i = 1; i < VCACHE_VALENCE_MAX; i++)
+        table->valence[i] = VCACHE_VALENCE_SCALE * powf((float)i, -VCACHE_VALENCE_POWER);
+}
+
+
+
+static inline float _vertex_score(ScoreTable* table, int32_t cache_pos, uint32_t remaining)
+{
+    // Vertices without any remaining triangle do not matter anymore.
+    if (remaining == 0)
+        return -1.0f;
+
+    float score = cache_pos >= 0 ? table->cache[cache_pos] : 0;
+    score += remaining < VCACHE_VALENCE_MAX
+                 ? table->valence[remaining]
+                 : VCACHE_VALENCE_SCALE * powf((float)remaining, -VCACHE_VALENCE_POWER);
+    return score;
+}
+
+
+
+/*************************************************************************************************/
+/*  Overdraw utils                                                                               */
+/*************************************************************************************************/
+
+// FIFO cache simulation with timestamps: a vertex is in the cache if it has been loaded less than
+// cache_size misses ago. Return the number of misses for the triangle.
+static inline uint32_t
+_fifo_misses(const DvzIndex* tri, uint32_t* timestamps, uint32_t* time, uint32_t cache_size)
+{
+    uint32_t misses = 0;
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        DvzIndex v = tri[c];
+        if (*time - timestamps[v] > cache_size)
+        {
+            timestamps[v] = (*time)++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+
+
+// Split the mesh at the triangles that miss all of their vertices, where the vertex cache
+// optimizer had to restart. Return the number of cluster starts written to `clusters`.
+static uint32_t _hard_clusters(
+    const DvzIndex* index, uint32_t face_count, uint32_t* timestamps, uint32_t* time,
+    uint32_t* clusters)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < face_count; i++)
+    {
+        if (_fifo_misses(&index[3 * i], timestamps, time, OVERDRAW_CACHE_SIZE) == 3 || i == 0)
+            clusters[count++] = i;
+    }
+    return count;
+}
+
+
+
+// Further split a hard cluster as soon as the running ACMR reaches `threshold` times the cluster
+// ACMR. Return the number of cluster starts written to `clusters`.
+static uint32_t _soft_clusters(
+    const DvzIndex* index, uint32_t first, uint32_t last, float threshold, uint32_t* timestamps,
+    uint32_t* time, uint32_t* clusters)
+{
+    // ACMR of the whole cluster, starting with an empty cache.
+    *time += OVERDRAW_CACHE_SIZE + 1;
+    uint32_t misses = 0;
+    for (uint32_t i = first; i < last; i++)
+        misses += _fifo_misses(&index[3 * i], timestamps, time, OVERDRAW_CACHE_SIZE);
+    float target = threshold * (float)misses / (float)(last - first);
+
+    uint32_t count = 0;
+    uint32_t start = first;
+    clusters[count++] = first;
+    *time += OVERDRAW_CACHE_SIZE + 1;
+    misses = 0;
+    for (uint32_t i = first; i < last; i++)
+    {
+        misses += _fifo_misses(&index[3 * i], timestamps, time, OVERDRAW_CACHE_SIZE);
+        uint32_t n = i + 1 - start;
+        if (i + 1 < last && n >= OVERDRAW_MIN_CLUSTER && (float)misses <= target * (float)n)
+        {
+            start = i + 1;
+            clusters[count++] = start;
+            *time += OVERDRAW_CACHE_SIZE + 1;
+            misses = 0;
+        }
+    }
+    return count;
+}
+
+
+
+static int _compare_keys(const void* a, const void* b)
+{
+    const ClusterKey* ka = (const ClusterKey*)a;
+    const ClusterKey* kb = (const ClusterKey*)b;
+    if (ka->key != kb->key)
+        return ka->key > kb->key ? -1 : +1;
+    return ka->idx < kb->idx ? -1 : (ka->idx > kb->idx ? +1 : 0);
+}
+
+
+
+/*************************************************************************************************/
+/*  Simplification utils                                                                         */
+/*************************************************************************************************/
+
+static inline void _quadric_plane(Quadric* q, const double* n, double d, double w)
+{
+    q->a00 += w * n[0] * n[0];
+    q->a01 += w * n[0] * n[1];
+    q->a02 += w * n[0] * n[2];
+    q->a11 += w * n[1] * n[1];
+    q->a12 += w * n[1] * n[2];
+    q->a22 += w * n[2] * n[2];
+    q->b0 += w * d * n[0];
+    q->b1 += w * d * n[1];
+    q->b2 += w * d * n[2];
+    q->c += w * d * d;
+    q->w += w;
+}
+
+
+
+static inline void _quadric_add(Quadric* q, const Quadric* r)
+{
+    q->a00 += r->a00;
+    q->a01 += r->a01;
+    q->a02 += r->a02;
+    q->a11 += r->a11;
+    q->a12 += r->a12;
+    q->a22 += r->a22;
+    q->b0 += r->b0;
+    q->b1 += r->b1;
+    q->b2 += r->b2;
+    q->c += r->c;
+    q->w += r->w;
+}
+
+
+
+// Weighted squared distance between a point and the planes of a quadric.
+static inline double _quadric_eval(const Quadric* q, const float* p)
+{
+    double x = p[0], y = p[1], z = p[2];
+    double e = q->a00 * x * x + q->a11 * y * y + q->a22 * z * z +
+               2 * (q->a01 * x * y + q->a02 * x * z + q->a12 * y * z) +
+               2 * (q->b0 * x + q->b1 * y + q->b2 * z) + q->c;
+    return fabs(e);
+}
+
+
+
+// Unnormalized triangle normal, its norm is twice the triangle area.
+static inline void _triangle_normal(const float* p0, const float* p1, const float* p2, double* n)
+{
+    double u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    double v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    n[0] = u[1] * v[2] - u[2] * v[1];
+    n[1] = u[2] * v[0] - u[0] * v[2];
+    n[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+
+
+static int _compare_u64(const void* a, const void* b)
+{
+    uint64_t ka = *(const uint64_t*)a;
+    uint64_t kb = *(const uint64_t*)b;
+    return ka < kb ? -1 : (ka > kb ? +1 : 0);
+}
+
+
+
+static int _compare_collapses(const void* a, const void* b)
+{
+    const Collapse* ca = (const Collapse*)a;
+    const Collapse* cb = (const Collapse*)b;
+    if (ca->cost != cb->cost)
+        return ca->cost < cb->cost ? -1 : +1;
+    if (ca->v != cb->v)
+        return ca->v < cb->v ? -1 : +1;
+    return ca->t < cb->t ? -1 : (ca->t > cb->t ? +1 : 0);
+}
+
+
+
+static inline uint64_t _edge_key(DvzIndex a, DvzIndex b) { return ((uint64_t)a << 32) | b; }
+
+
+
+static inline bool _has_edge(const uint64_t* keys, uint32_t count, DvzIndex a, DvzIndex b)
+{
+    uint64_t key = _edge_key(a, b);
+    return bsearch(&key, keys, count, sizeof(uint64_t), _compare_u64) != NULL;
+}
+
+
+
+// Sorted directed edges of the triangles.
+static uint64_t* _edge_keys(const DvzIndex* index, uint32_t face_count)
+{
+    uint64_t* keys = (uint64_t*)malloc(3 * face_count * sizeof(uint64_t));
+    ANN(keys);
+    for (uint32_t f = 0; f < face_count; f++)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+            keys[3 * f + c] = _edge_key(index[3 * f + c], index[3 * f + (c + 1) % 3]);
+    }
+    qsort(keys, 3 * face_count, sizeof(uint64_t), _compare_u64);
+    return keys;
+}
+
+
+
+// Sum the plane quadrics of the triangles around each vertex, and the border quadrics of the
+// border edges, which are the edges without any opposite edge.
+static void _vertex_quadrics(
+    const DvzIndex* index, uint32_t face_count, uint32_t vertex_count, vec3* pos,
+    const uint64_t* keys, const uint32_t* offsets, const uint32_t* faces, Quadric* quadrics,
+    uint8_t* kinds)
+{
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        Quadric q = {0};
+        uint8_t kind = VERTEX_MANIFOLD;
+        for (uint32_t j = offsets[v]; j < offsets[v + 1]; j++)
+        {
+            const DvzIndex* tri = &index[3 * faces[j]];
+            double n[3] = {0};
+            _triangle_normal(pos[tri[0]], pos[tri[1]], pos[tri[2]], n);
+            double area2 = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (area2 <= 0)
+                continue;
+            for (uint32_t d = 0; d < 3; d++)
+                n[d] /= area2;
+            double dist = -(n[0] * pos[tri[0]][0] + n[1] * pos[tri[0]][1] + n[2] * pos[tri[0]][2]);
+            _quadric_plane(&q, n, dist, .5 * area2);
+
+            // Border edges starting or ending at v.
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                DvzIndex a = tri[c], b = tri[(c + 1) % 3];
+                if ((a != v && b != v) || _has_edge(keys, 3 * face_count, b, a))
+                    continue;
+                kind = VERTEX_BORDER;
+
+                // Plane containing the edge, orthogonal to the triangle.
+                double e[3] = {
+                    pos[b][0] - pos[a][0], pos[b][1] - pos[a][1], pos[b][2] - pos[a][2]};
+                double m[3] = {
+                    e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2],
+                    e[0] * n[1] - e[1] * n[0]};
+                double mn = sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+                if (mn <= 0)
+                    continue;
+                for (uint32_t d = 0; d < 3; d++)
+                    m[d] /= mn;
+                double md = -(m[0] * pos[a][0] + m[1] * pos[a][1] + m[2] * pos[a][2]);
+                double len2 = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+                _quadric_plane(&q, m, md, SIMPLIFY_BORDER_WEIGHT * len2);
+            }
+        }
+        quadrics[v] = q;
+        kinds[v] = kind;
+    }
+}
+
+
+
+static inline float
+_collapse_cost(const Quadric* quadrics, vec3* pos, uint32_t v, uint32_t t)
+{
+    Quadric q = quadrics[v];
+    _quadric_add(&q, &quadrics[t]);
+    return (float)(q.w > 0 ? _quadric_eval(&q, pos[t]) / q.w : 0);
+}
+
+
+
+// Check that replacing v by t does not flip any of the remaining triangles around v.
+// Return false if the collapse is invalid, otherwise the number of removed triangles.
+static bool _collapse_valid(
+    const DvzIndex* index, vec3* pos, const uint32_t* offsets, const uint32_t* faces, uint32_t v,
+    uint32_t t, uint32_t* removed)
+{
+    *removed = 0;
+    for (uint32_t j = offsets[v]; j < offsets[v + 1]; j++)
+    {
+        const DvzIndex* tri = &index[3 * faces[j]];
+        if (tri[0] == t || tri[1] == t || tri[2] == t)
+        {
+            (*removed)++;
+            continue;
+        }
+
+        const float* p[3] = {pos[tri[0]], pos[tri[1]], pos[tri[2]]};
+        double n0[3] = {0}, n1[3] = {0};
+        _triangle_normal(p[0], p[1], p[2], n0);
+        for (uint32_t c = 0; c < 3; c++)
+            if (tri[c] == v)
+                p[c] = pos[t];
+        _triangle_normal(p[0], p[1], p[2], n1);
+        if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0)
+            return false;
+    }
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+void dvz_meshopt_vcache(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, DvzIndex* out)
+{
+    ANN(index);
+    ANN(out);
+
+    _copy_tail(index_count, index, out);
+    uint32_t face_count = index_count / 3;
+    if (face_count == 0 || vertex_count == 0)
+    {
+        if (out != index)
+            memcpy(out, index, 3 * face_count * sizeof(DvzIndex));
+        return;
+    }
+
+    // Support in-place optimization.
+    DvzIndex* src = (DvzIndex*)index;
+    if (out == index)
+    {
+        src = (DvzIndex*)malloc(3 * face_count * sizeof(DvzIndex));
+        ANN(src);
+        memcpy(src, index, 3 * face_count * sizeof(DvzIndex));
+    }
+
+    // Number of remaining triangles for each vertex.
+    uint32_t* valence = (uint32_t*)calloc(vertex_count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < 3 * face_count; i++)
+    {
+        ASSERT(src[i] < vertex_count);
+        valence[src[i]]++;
+    }
+
+    // Vertex-triangle adjacency, the first valence[v] items of each vertex are the remaining
+    // triangles.
+    uint32_t* offsets = (uint32_t*)calloc(vertex_count + 1, sizeof(uint32_t));
+    for (uint32_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] = offsets[v] + valence[v];
+    uint32_t* fill = (uint32_t*)calloc(vertex_count, sizeof(uint32_t));
+    uint32_t* adjacency = (uint32_t*)malloc(3 * face_count * sizeof(uint32_t));
+    for (uint32_t t = 0; t < face_count; t++)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            DvzIndex v = src[3 * t + c];
+            adjacency[offsets[v] + fill[v]++] = t;
+        }
+    }
+    FREE(fill);
+
+    // Initial scores.
+    ScoreTable table = {0};
+    _score_table(&table);
+
+    float* vertex_scores = (float*)malloc(vertex_count * sizeof(float));
+    int32_t* cache_pos = (int32_t*)malloc(vertex_count * sizeof(int32_t));
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        cache_pos[v] = -1;
+        vertex_scores[v] = _vertex_score(&table, -1, valence[v]);
+    }
+
+    float* tri_scores = (float*)malloc(face_count * sizeof(float));
+    bool* emitted = (bool*)calloc(face_count, sizeof(bool));
+    uint32_t best = 0;
+    for (uint32_t t = 0; t < face_count; t++)
+    {
+        tri_scores[t] = vertex_scores[src[3 * t + 0]] + vertex_scores[src[3 * t + 1]] +
+                        vertex_scores[src[3 * t + 2]];
+        if (tri_scores[t] > tri_scores[best])
+            best = t;
+    }
+
+    uint32_t cache[DVZ_MESHOPT_VCACHE_SIZE + 3] = {0};
+    uint32_t new_cache[DVZ_MESHOPT_VCACHE_SIZE + 3] = {0};
+    uint32_t cache_count = 0;
+    uint32_t cursor = 0;
+
+    for (uint32_t k = 0; k < face_count; k++)
+    {
+        // Dead end: take the next triangle in the input order.
+        if (best == UINT32_MAX)
+        {
+            while (emitted[cursor])
+                cursor++;
+            ASSERT(cursor < face_count);
+            best = cursor;
+        }
+
+        uint32_t t = best;
+        const DvzIndex* tri = &src[3 * t];
+        ASSERT(!emitted[t]);
+        emitted[t] = true;
+        memcpy(&out[3 * k], tri, 3 * sizeof(DvzIndex));
+
+        // Remove the triangle from the remaining triangles of its vertices.
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            DvzIndex v = tri[c];
+            uint32_t* adj = &adjacency[offsets[v]];
+            for (uint32_t j = 0; j < valence[v]; j++)
+            {
+                if (adj[j] == t)
+                {
+                    adj[j] = adj[valence[v] - 1];
+                    break;
+                }
+            }
+            ASSERT(valence[v] > 0);
+            valence[v]--;
+        }
+
+        // Move the triangle vertices to the front of the LRU cache.
+        uint32_t new_count = 0;
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            bool dup = false;
+            for (uint32_t j = 0; j < new_count; j++)
+                dup |= new_cache[j] == tri[c];
+            if (!dup)
+                new_cache[new_count++] = tri[c];
+        }
+        for (uint32_t j = 0; j < cache_count; j++)
+        {
+            uint32_t v = cache[j];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                new_cache[new_count++] = v;
+        }
+
+        // Update the scores of the vertices in the cache, including the evicted ones.
+        for (uint32_t j = 0; j < new_count; j++)
+        {
+            uint32_t v = new_cache[j];
+            cache_pos[v] = j < DVZ_MESHOPT_VCACHE_SIZE ? (int32_t)j : -1;
+            vertex_scores[v] = _vertex_score(&table, cache_pos[v], valence[v]);
+        }
+
+        // Update the scores of their remaining triangles, and find the best one.
+        best = UINT32_MAX;
+        float best_score = -1;
+        for (uint32_t j = 0; j < new_count; j++)
+        {
+            uint32_t v = new_cache[j];
+            uint32_t* adj = &adjacency[offsets[v]];
+            for (uint32_t a = 0; a < valence[v]; a++)
+            {
+                uint32_t u = adj[a];
+                const DvzIndex* other = &src[3 * u];
+                float score = vertex_scores[other[0]] + vertex_scores[other[1]] +
+                              vertex_scores[other[2]];
+                tri_scores[u] = score;
+                if (score > best_score)
+                {
+                    best_score = score;
+                    best = u;
+                }
+            }
+        }
+
+        cache_count = MIN(new_count, DVZ_MESHOPT_VCACHE_SIZE);
+        memcpy(cache, new_cache, cache_count * sizeof(uint32_t));
+    }
+
+    FREE(valence);
+    FREE(offsets);
+    FREE(adjacency);
+    FREE(vertex_scores);
+    FREE(cache_pos);
+    FREE(tri_scores);
+    FREE(emitted);
+    if (src != index)
+        FREE(src);
+}
+
+
+
+void dvz_meshopt_overdraw(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, vec3* pos,
+    float threshold, DvzIndex* out)
+{
+    ANN(index);
+    ANN(pos);
+    ANN(out);
+    ASSERT(out != index);
+
+    _copy_tail(index_count, index, out);
+    uint32_t face_count = index_count / 3;
+    if (face_count == 0 || vertex_count == 0)
+    {
+        memcpy(out, index, 3 * face_count * sizeof(DvzIndex));
+        return;
+    }
+
+    // Cluster boundaries.
+    uint32_t* timestamps = (uint32_t*)calloc(vertex_count, sizeof(uint32_t));
+    uint32_t time = OVERDRAW_CACHE_SIZE + 1;
+    uint32_t* hard = (uint32_t*)malloc(face_count * sizeof(uint32_t));
+    uint32_t hard_count = _hard_clusters(index, face_count, timestamps, &time, hard);
+
+    uint32_t* clusters = (uint32_t*)malloc((face_count + 1) * sizeof(uint32_t));
+    uint32_t cluster_count = 0;
+    for (uint32_t i = 0; i < hard_count; i++)
+    {
+        uint32_t last = i + 1 < hard_count ? hard[i + 1] : face_count;
+        cluster_count += _soft_clusters(
+            index, hard[i], last, threshold, timestamps, &time, &clusters[cluster_count]);
+    }
+    clusters[cluster_count] = face_count;
+    FREE(hard);
+    FREE(timestamps);
+
+    // Mesh centroid, weighted by the triangle areas.
+    ClusterKey* keys = (ClusterKey*)calloc(cluster_count, sizeof(ClusterKey));
+    float* centroids = (float*)calloc(4 * cluster_count, sizeof(float)); // x, y, z, area
+    float* normals = (float*)calloc(3 * cluster_count, sizeof(float));
+    double mesh_center[3] = {0};
+    double mesh_area = 0;
+
+    for (uint32_t k = 0; k < cluster_count; k++)
+    {
+        for (uint32_t t = clusters[k]; t < clusters[k + 1]; t++)
+        {
+            float* p0 = pos[index[3 * t + 0]];
+            float* p1 = pos[index[3 * t + 1]];
+            float* p2 = pos[index[3 * t + 2]];
+
+            float u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {
+                u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+            float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (uint32_t d = 0; d < 3; d++)
+            {
+                float c = (p0[d] + p1[d] + p2[d]) / 3.0f;
+                centroids[4 * k + d] += c * area;
+                normals[3 * k + d] += n[d];
+                mesh_center[d] += (double)(c * area);
+            }
+            centroids[4 * k + 3] += area;
+            mesh_area += (double)area;
+        }
+    }
+    for (uint32_t d = 0; d < 3; d++)
+        mesh_center[d] = mesh_area > 0 ? mesh_center[d] / mesh_area : 0;
+
+    // Sort the clusters by decreasing dot product between their normal and their direction from
+    // the mesh center: the outer surfaces, which occlude the rest, are drawn first.
+    for (uint32_t k = 0; k < cluster_count; k++)
+    {
+        float area = centroids[4 * k + 3];
+        float* n = &normals[3 * k];
+        float norm = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float dot = 0;
+        if (area > 0 && norm > 0)
+        {
+            for (uint32_t d = 0; d < 3; d++)
+                dot += (centroids[4 * k + d] / area - (float)mesh_center[d]) * n[d] / norm;
+        }
+        keys[k].key = dot;
+        keys[k].idx = k;
+    }
+    qsort(keys, cluster_count, sizeof(ClusterKey), _compare_keys);
+
+    // Write the clusters in their new order.
+    uint32_t offset = 0;
+    for (uint32_t k = 0; k < cluster_count; k++)
+    {
+        uint32_t c = keys[k].idx;
+        uint32_t count = clusters[c + 1] - clusters[c];
+        memcpy(&out[3 * offset], &index[3 * clusters[c]], 3 * count * sizeof(DvzIndex));
+        offset += count;
+    }
+    ASSERT(offset == face_count);
+
+    log_debug("mesh overdraw optimization with %d clusters", cluster_count);
+
+    FREE(clusters);
+    FREE(keys);
+    FREE(centroids);
+    FREE(normals);
+}
+
+
+
+uint32_t
+dvz_meshopt_fetch(uint32_t index_count, DvzIndex* index, uint32_t vertex_count, uint32_t* remap)
+{
+    ANN(index);
+    ANN(remap);
+
+    memset(remap, 0xFF, vertex_count * sizeof(uint32_t));
+
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        DvzIndex v = index[i];
+        ASSERT(v < vertex_count);
+        if (remap[v] == UINT32_MAX)
+            remap[v] = next++;
+        index[i] = remap[v];
+    }
+    uint32_t referenced = next;
+
+    // Unreferenced vertices are kept at the end.
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        if (remap[v] == UINT32_MAX)
+            remap[v] = next++;
+    }
+    ASSERT(next == vertex_count);
+
+    return referenced;
+}
+
+
+
+float dvz_meshopt_acmr(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, uint32_t cache_size)
+{
+    ANN(index);
+    ASSERT(cache_size > 0);
+
+    uint32_t face_count = index_count / 3;
+    if (face_count == 0)
+        return 0;
+
+    uint32_t* timestamps = (uint32_t*)calloc(vertex_count, sizeof(uint32_t));
+    uint32_t time = cache_size + 1;
+    uint32_t misses = 0;
+    for (uint32_t t = 0; t < face_count; t++)
+        misses += _fifo_misses(&index[3 * t], timestamps, &time, cache_size);
+    FREE(timestamps);
+
+    return (float)misses / (float)face_count;
+}
+
+
+
+void dvz_meshopt_adjacency(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, uint32_t* offsets,
+    uint32_t* faces)
+{
+    ANN(index);
+    ANN(offsets);
+    ANN(faces);
+
+    uint32_t face_count = index_count / 3;
+    memset(offsets, 0, (vertex_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < 3 * face_count; i++)
+        offsets[index[i] + 1]++;
+    for (uint32_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] += offsets[v];
+
+    // NOTE: the triangles around each vertex are sorted by increasing index.
+    uint32_t* fill = (uint32_t*)calloc(vertex_count, sizeof(uint32_t));
+    ANN(fill);
+    for (uint32_t f = 0; f < face_count; f++)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            DvzIndex v = index[3 * f + c];
+            faces[offsets[v] + fill[v]++] = f;
+        }
+    }
+    FREE(fill);
+}
+
+
+
+uint32_t dvz_meshopt_simplify(
+    uint32_t index_count, const DvzIndex* index, uint32_t vertex_count, vec3* pos,
+    uint32_t target_index_count, float* out_error, DvzIndex* out)
+{
+    ANN(index);
+    ANN(pos);
+    ANN(out);
+
+    uint32_t face_count = index_count / 3;
+    uint32_t target_faces = target_index_count / 3;
+    if (out != index)
+        memcpy(out, index, 3 * face_count * sizeof(DvzIndex));
+    if (out_error != NULL)
+        *out_error = 0;
+    if (face_count <= target_faces || vertex_count == 0)
+        return 3 * face_count;
+
+    // Vertex quadrics and kinds, from the original mesh.
+    uint32_t* offsets = (uint32_t*)calloc(vertex_count + 1, sizeof(uint32_t));
+    uint32_t* faces = (uint32_t*)malloc(3 * face_count * sizeof(uint32_t));
+    Quadric* quadrics = (Quadric*)calloc(vertex_count, sizeof(Quadric));
+    uint8_t* kinds = (uint8_t*)calloc(vertex_count, sizeof(uint8_t));
+    uint8_t* locked = (uint8_t*)calloc(vertex_count, sizeof(uint8_t));
+    uint32_t* remap = (uint32_t*)malloc(vertex_count * sizeof(uint32_t));
+
+    uint64_t* keys = _edge_keys(out, face_count);
+    dvz_meshopt_adjacency(3 * face_count, out, vertex_count, offsets, faces);
+    _vertex_quadrics(out, face_count, vertex_count, pos, keys, offsets, faces, quadrics, kinds);
+
+    float max_error = 0;
+    for (uint32_t pass = 0; pass < SIMPLIFY_MAX_PASSES && face_count > target_faces; pass++)
+    {
+        if (pass > 0)
+        {
+            FREE(keys);
+            keys = _edge_keys(out, face_count);
+            dvz_meshopt_adjacency(3 * face_count, out, vertex_count, offsets, faces);
+        }
+        uint32_t key_count = 3 * face_count;
+
+        // Candidate collapses, one per undirected edge, in the cheapest valid direction.
+        Collapse* collapses = (Collapse*)malloc(key_count * sizeof(Collapse));
+        uint32_t collapse_count = 0;
+        for (uint32_t i = 0; i < key_count; i++)
+        {
+            if (i > 0 && keys[i] == keys[i - 1])
+                continue;
+            DvzIndex a = (DvzIndex)(keys[i] >> 32), b = (DvzIndex)(keys[i] & 0xFFFFFFFF);
+            if (a > b && _has_edge(keys, key_count, b, a))
+                continue; // interior edge, already seen as (b, a)
+            collapses[collapse_count++] = (Collapse){0, a, b};
+        }
+
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+        for (uint32_t i = 0; i < collapse_count; i++)
+        {
+            uint32_t a = collapses[i].v, b = collapses[i].t;
+            bool border = !_has_edge(keys, key_count, a, b) || !_has_edge(keys, key_count, b, a);
+
+            // Border vertices can only move along a border edge, to another border vertex.
+            bool ab = kinds[a] == VERTEX_MANIFOLD || (border && kinds[b] == VERTEX_BORDER);
+            bool ba = kinds[b] == VERTEX_MANIFOLD || (border && kinds[a] == VERTEX_BORDER);
+            float cab = ab ? _collapse_cost(quadrics, pos, a, b) : INFINITY;
+            float cba = ba ? _collapse_cost(quadrics, pos, b, a) : INFINITY;
+            if (cba < cab)
+                collapses[i] = (Collapse){cba, b, a};
+            else
+                collapses[i] = (Collapse){cab, a, b};
+        }
+        qsort(collapses, collapse_count, sizeof(Collapse), _compare_collapses);
+
+        // Apply the cheapest collapses whose neighborhoods do not overlap.
+        memset(locked, 0, vertex_count * sizeof(uint8_t));
+        for (uint32_t v = 0; v < vertex_count; v++)
+            remap[v] = v;
+        uint32_t removed = 0;
+        uint32_t applied = 0;
+        for (uint32_t i = 0; i < collapse_count && face_count - removed > target_faces; i++)
+        {
+            Collapse c = collapses[i];
+            if (!isfinite(c.cost))
+                break;
+            if (locked[c.v] || locked[c.t])
+                continue;
+
+            uint32_t r = 0;
+            if (!_collapse_valid(out, pos, offsets, faces, c.v, c.t, &r))
+                continue;
+
+            remap[c.v] = c.t;
+            _quadric_add(&quadrics[c.t], &quadrics[c.v]);
+            max_error = MAX(max_error, c.cost);
+            removed += r;
+            applied++;
+
+            // Lock the one-ring of the removed vertex, whose triangles have changed.
+            for (uint32_t j = offsets[c.v]; j < offsets[c.v + 1]; j++)
+            {
+                const DvzIndex* tri = &out[3 * faces[j]];
+                locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+            }
+        }
+        FREE(collapses);
+
+        // Remap the indices and remove the degenerate triangles.
+        uint32_t k = 0;
+        for (uint32_t f = 0; f < face_count; f++)
+        {
+            DvzIndex i0 = remap[out[3 * f + 0]];
+            DvzIndex i1 = remap[out[3 * f + 1]];
+            DvzIndex i2 = remap[out[3 * f + 2]];
+            if (i0 == i1 || i1 == i2 || i0 == i2)
+                continue;
+            out[3 * k + 0] = i0;
+            out[3 * k + 1] = i1;
+            out[3 * k + 2] = i2;
+            k++;
+        }
+        log_trace("simplification pass #%d: %d collapses, %d -> %d faces", pass, applied,
+            face_count, k);
+        face_count = k;
+
+        if (applied == 0)
+            break;
+    }
+
+    FREE(offsets);
+    FREE(faces);
+    FREE(quadrics);
+    FREE(kinds);
+    FREE(locked);
+    FREE(remap);
+    FREE(keys);
+
+    if (out_error != NULL)
+        *out_error = sqrtf(max_error);
+    return 3 * face_count;
+}
+
+
+
+void dvz_meshopt_sphere(uint32_t vertex_count, vec3* pos, vec4 sphere)
+{
+    ANN(pos);
+    memset(sphere, 0, sizeof(vec4));
+    if (vertex_count == 0)
+        return;
+
+    vec3 vmin = {+INFINITY, +INFINITY, +INFINITY};
+    vec3 vmax = {-INFINITY, -INFINITY, -INFINITY};
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        for (uint32_t d = 0; d < 3; d++)
+        {
+            vmin[d] = MIN(vmin[d], pos[v][d]);
+            vmax[d] = MAX(vmax[d], pos[v][d]);
+        }
+    }
+
+    float r2 = 0;
+    for (uint32_t d = 0; d < 3; d++)
+        sphere[d] = .5f * (vmin[d] + vmax[d]);
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        float dx = pos[v][0] - sphere[0], dy = pos[v][1] - sphere[1], dz = pos[v][2] - sphere[2];
+        r2 = MAX(r2, dx * dx + dy * dy + dz * dz);
+    }
+    sphere[3] = sqrtf(r2);
+}
+
+
+
+void dvz_meshopt_borders(uint32_t index_count, const DvzIndex* index, uint8_t* out)
+{
+    ANN(index);
+    ANN(out);
+    ASSERT(index_count % 3 == 0);
+    uint32_t face_count = index_count / 3;
+    if (face_count == 0)
+        return;
+
+    // Sorted undirected edges: an edge is on the border if it belongs to a single triangle.
+    uint64_t* keys = (uint64_t*)malloc(index_count * sizeof(uint64_t));
+    ANN(keys);
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        DvzIndex a = index[i], b = index[i - i % 3 + (i + 1) % 3];
+        keys[i] = _edge_key(MIN(a, b), MAX(a, b));
+    }
+    qsort(keys, index_count, sizeof(uint64_t), _compare_u64);
+
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t f = 0; f < face_count; f++)
+    {
+        uint8_t bits = 0;
+        for (uint32_t c = 0; c < 3; c++)
+        {
+            // Edge opposite to the corner c.
+            DvzIndex a = index[3 * f + (c + 1) % 3], b = index[3 * f + (c + 2) % 3];
+            uint64_t key = _edge_key(MIN(a, b), MAX(a, b));
+            uint64_t* k =
+                (uint64_t*)bsearch(&key, keys, index_count, sizeof(uint64_t), _compare_u64);
+            ANN(k);
+            uint64_t* last = &keys[index_count - 1];
+            bool shared = (k > keys && k[-1] == key) || (k < last && k[1] == key);
+            if (!shared)
+                bits |= (uint8_t)(1 << c);
+        }
+        out[f] = bits;
+    }
+
+    FREE(keys);
+}
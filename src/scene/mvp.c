@@ -15,10 +15,48 @@
 
 #include "scene/mvp.h"
 #include "_cglm.h"
+#include "_log.h"
+#include "_macros.h"
 #include "datoviz_protocol.h"
 
 
 
+/*************************************************************************************************/
+/*  Scale functions                                                                              */
+/*************************************************************************************************/
+
+double dvz_scale_apply(DvzScaleType type, double param, double x)
+{
+    switch (type)
+    {
+    case DVZ_SCALE_LOG10:
+        return x > 0 ? log10(x) : NAN;
+    case DVZ_SCALE_SYMLOG:
+        ASSERT(param > 0);
+        return fabs(x) <= param ? x / param : copysign(1 + log10(fabs(x) / param), x);
+    default:
+        return x;
+    }
+}
+
+
+
+double dvz_scale_inverse(DvzScaleType type, double param, double y)
+{
+    switch (type)
+    {
+    case DVZ_SCALE_LOG10:
+        return pow(10, y);
+    case DVZ_SCALE_SYMLOG:
+        ASSERT(param > 0);
+        return fabs(y) <= 1 ? y * param : copysign(param * pow(10, fabs(y) - 1), y);
+    default:
+        return y;
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  MVP functions                                                                                */
 /*************************************************************************************************/
@@ -45,11 +83,78 @@ DvzMVP dvz_mvp_default(void)
 
 
 
+void dvz_mvp_offset(DvzMVP* mvp, dvec3 offset)
+{
+    ANN(mvp);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        mvp->offset_hi[i] = (float)offset[i];
+        mvp->offset_lo[i] = (float)(offset[i] - (double)mvp->offset_hi[i]);
+    }
+    mvp->offset_hi[3] = 0;
+    mvp->offset_lo[3] = 0;
+}
+
+
+
+void dvz_mvp_scale(
+    DvzMVP* mvp, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range)
+{
+    ANN(mvp);
+    ASSERT(dim < 3);
+
+    mvp->scale_type[dim] = (int)type;
+    mvp->scale_param[dim] = 0;
+    mvp->scale_a[dim] = 1;
+    mvp->scale_b[dim] = 0;
+    if (type == DVZ_SCALE_LINEAR)
+        return;
+
+    if (type == DVZ_SCALE_LOG10 && (domain[0] <= 0 || domain[1] <= 0))
+    {
+        log_error(
+            "the domain of a log10 scale must be positive, got [%g, %g]", domain[0], domain[1]);
+        mvp->scale_type[dim] = DVZ_SCALE_LINEAR;
+        return;
+    }
+    if (type == DVZ_SCALE_SYMLOG && param <= 0)
+    {
+        log_error("the linear threshold of a symlog scale must be positive, got %g", param);
+        mvp->scale_type[dim] = DVZ_SCALE_LINEAR;
+        return;
+    }
+
+    double f0 = dvz_scale_apply(type, param, domain[0]);
+    double f1 = dvz_scale_apply(type, param, domain[1]);
+    double a = f1 != f0 ? (range[1] - range[0]) / (f1 - f0) : 1;
+
+    mvp->scale_param[dim] = (float)param;
+    mvp->scale_a[dim] = (float)a;
+    mvp->scale_b[dim] = (float)(range[0] - a * f0);
+}
+
+
+
 void dvz_mvp_apply(DvzMVP* mvp, vec4 point, vec4 out)
 {
     ANN(mvp);
 
-    glm_mat4_mulv(mvp->model, point, out);
+    // The positions are relative to the offset, after the axis scales.
+    vec4 rel = {0};
+    float x = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        x = point[i];
+        if (mvp->scale_type[i] != DVZ_SCALE_LINEAR)
+            x = mvp->scale_a[i] *
+                    (float)dvz_scale_apply(
+                        (DvzScaleType)mvp->scale_type[i], mvp->scale_param[i], x) +
+                mvp->scale_b[i];
+        rel[i] = (x - mvp->offset_hi[i] * point[3]) - mvp->offset_lo[i] * point[3];
+    }
+    rel[3] = point[3];
+
+    glm_mat4_mulv(mvp->model, rel, out);
     glm_mat4_mulv(mvp->view, out, out);
     glm_mat4_mulv(mvp->proj, out, out);
 }
@@ -154,7 +154,8 @@ void dvz_ortho_flags(DvzOrtho* ortho, int flags)
 void dvz_ortho_pan(DvzOrtho* ortho, vec2 pan)
 {
     ANN(ortho);
-    _vec2_copy(pan, ortho->pan);
+    ortho->pan[0] = pan[0];
+    ortho->pan[1] = pan[1];
 }
 
 
@@ -175,11 +176,11 @@ void dvz_ortho_pan_shift(DvzOrtho* ortho, vec2 shift_px, vec2 center_px)
     vec2 shift = {0};
     _normalize_shift(ortho, shift_px, shift);
 
-    float z = ortho->zoom;
+    double z = ortho->zoom;
     ASSERT(z > 0);
 
-    float x0 = ortho->pan_center[0];
-    float y0 = ortho->pan_center[1];
+    double x0 = ortho->pan_center[0];
+    double y0 = ortho->pan_center[1];
 
     ortho->pan[0] = x0 + shift[0] / z;
     ortho->pan[1] = y0 + shift[1] / z;
@@ -200,8 +201,8 @@ void dvz_ortho_zoom_shift(DvzOrtho* ortho, vec2 shift_px, vec2 center_px)
     vec2 center = {0};
     _normalize_pos(ortho, center_px, center);
 
-    float zx0 = ortho->zoom_center[0];
-    float zy0 = ortho->zoom_center[1];
+    double zx0 = ortho->zoom_center[0];
+    double zy0 = ortho->zoom_center[1];
 
     // HACK: coefficient depends onthe viewport size.
     float w = ortho->viewport_size[0];
@@ -211,15 +212,15 @@ void dvz_ortho_zoom_shift(DvzOrtho* ortho, vec2 shift_px, vec2 center_px)
     float s = shift[0] + shift[1];
     ortho->zoom = zx0 * exp(DVZ_ORTHO_ZOOM_DRAG_COEF * a * s);
 
-    float z = ortho->zoom;
+    double z = ortho->zoom;
     ASSERT(z > 0);
 
     // Update pan.
-    float px = center[0] * (1.0f / zx0 - 1.0f / z) * z;
-    float py = center[1] * (1.0f / zy0 - 1.0f / z) * z;
+    double px = center[0] * (1.0 / zx0 - 1.0 / z) * z;
+    double py = center[1] * (1.0 / zy0 - 1.0 / z) * z;
 
-    float x0 = ortho->pan_center[0];
-    float y0 = ortho->pan_center[1];
+    double x0 = ortho->pan_center[0];
+    double y0 = ortho->pan_center[1];
 
     ortho->pan[0] = x0 - px / z;
     ortho->pan[1] = y0 - py / z;
@@ -272,16 +273,15 @@ void dvz_ortho_mvp(DvzOrtho* ortho, DvzMVP* mvp)
     // WARNING: this does not affect the model matrix, so ensure it is properly initialized to the
     // identity (not all zeros).
 
-    // View matrix (depends on the pan).
-    {
-        float x = -ortho->pan[0];
-        float y = -ortho->pan[1];
-        glm_lookat((vec3){x, y, 2}, (vec3){x, y, 0}, (vec3){0, 1, 0}, mvp->view);
-    }
+    // The pan goes into the MVP offset rather than in the view matrix, as with the panzoom.
+    dvz_mvp_offset(mvp, (dvec3){-ortho->pan[0], -ortho->pan[1], 0});
+
+    // View matrix.
+    glm_lookat((vec3){0, 0, 2}, (vec3){0, 0, 0}, (vec3){0, 1, 0}, mvp->view);
 
     // Proj matrix (depends on the zoom).
     {
-        float z = ortho->zoom;
+        float z = (float)ortho->zoom;
         float w = ortho->viewport_size[0];
         float h = ortho->viewport_size[1];
         float aspect = w / h;
@@ -184,7 +184,8 @@ void dvz_panzoom_zlim(DvzPanzoom* pz, vec2 zlim)
 void dvz_panzoom_pan(DvzPanzoom* pz, vec2 pan)
 {
     ANN(pz);
-    _vec2_copy(pan, pz->pan);
+    pz->pan[0] = pan[0];
+    pz->pan[1] = pan[1];
 }
 
 
@@ -192,7 +193,8 @@ void dvz_panzoom_pan(DvzPanzoom* pz, vec2 pan)
 void dvz_panzoom_zoom(DvzPanzoom* pz, vec2 zoom)
 {
     ANN(pz);
-    _vec2_copy(zoom, pz->zoom);
+    pz->zoom[0] = zoom[0];
+    pz->zoom[1] = zoom[1];
 }
 
 
@@ -205,13 +207,13 @@ void dvz_panzoom_pan_shift(DvzPanzoom* pz, vec2 shift_px, vec2 center_px)
     vec2 shift = {0};
     _normalize_shift(pz, shift_px, shift);
 
-    float zx = pz->zoom[0];
-    float zy = pz->zoom[1];
+    double zx = pz->zoom[0];
+    double zy = pz->zoom[1];
     ASSERT(zx > 0);
     ASSERT(zy > 0);
 
-    float x0 = pz->pan_center[0];
-    float y0 = pz->pan_center[1];
+    double x0 = pz->pan_center[0];
+    double y0 = pz->pan_center[1];
 
     if (!(pz->flags & DVZ_PANZOOM_FLAGS_FIXED_X))
         pz->pan[0] = x0 + shift[0] / zx;
@@ -234,8 +236,8 @@ void dvz_panzoom_zoom_shift(DvzPanzoom* pz, vec2 shift_px, vec2 center_px)
     vec2 center = {0};
     _normalize_pos(pz, center_px, center);
 
-    float zx0 = pz->zoom_center[0];
-    float zy0 = pz->zoom_center[1];
+    double zx0 = pz->zoom_center[0];
+    double zy0 = pz->zoom_center[1];
 
     // HACK: coefficient depends onthe viewport size.
     float w = pz->viewport_size[0];
@@ -245,17 +247,17 @@ void dvz_panzoom_zoom_shift(DvzPanzoom* pz, vec2 shift_px, vec2 center_px)
     pz->zoom[0] = zx0 * exp(DVZ_PANZOOM_ZOOM_DRAG_COEF * a * shift[0]);
     pz->zoom[1] = zy0 * exp(DVZ_PANZOOM_ZOOM_DRAG_COEF * a * shift[1]);
 
-    float zx = pz->zoom[0];
-    float zy = pz->zoom[1];
+    double zx = pz->zoom[0];
+    double zy = pz->zoom[1];
     ASSERT(zx > 0);
     ASSERT(zy > 0);
 
     // Update pan.
-    float px = center[0] * (1.0f / zx0 - 1.0f / zx) * zx;
-    float py = center[1] * (1.0f / zy0 - 1.0f / zy) * zy;
+    double px = center[0] * (1.0 / zx0 - 1.0 / zx) * zx;
+    double py = center[1] * (1.0 / zy0 - 1.0 / zy) * zy;
 
-    float x0 = pz->pan_center[0];
-    float y0 = pz->pan_center[1];
+    double x0 = pz->pan_center[0];
+    double y0 = pz->pan_center[1];
 
     if (!(pz->flags & DVZ_PANZOOM_FLAGS_FIXED_X))
         pz->pan[0] = x0 - px / zx;
@@ -307,10 +309,10 @@ DvzBox dvz_panzoom_extent(DvzPanzoom* pz)
 {
     ANN(pz);
 
-    float xmin = -pz->pan[0] - 1.0f / pz->zoom[0];
-    float xmax = -pz->pan[0] + 1.0f / pz->zoom[0];
-    float ymin = -pz->pan[1] - 1.0f / pz->zoom[1];
-    float ymax = -pz->pan[1] + 1.0f / pz->zoom[1];
+    double xmin = -pz->pan[0] - 1.0 / pz->zoom[0];
+    double xmax = -pz->pan[0] + 1.0 / pz->zoom[0];
+    double ymin = -pz->pan[1] - 1.0 / pz->zoom[1];
+    double ymax = -pz->pan[1] + 1.0 / pz->zoom[1];
 
     return dvz_box(xmin, xmax, ymin, ymax, pz->zlim[0], pz->zlim[1]);
 }
@@ -321,14 +323,14 @@ void dvz_panzoom_set(DvzPanzoom* pz, DvzBox extent)
 {
     ANN(pz);
 
-    float width = extent.xmax - extent.xmin;
-    float height = extent.ymax - extent.ymin;
+    double width = extent.xmax - extent.xmin;
+    double height = extent.ymax - extent.ymin;
 
-    pz->zoom[0] = 2.0f / width;
-    pz->zoom[1] = 2.0f / height;
+    pz->zoom[0] = 2.0 / width;
+    pz->zoom[1] = 2.0 / height;
 
-    pz->pan[0] = -(extent.xmin + extent.xmax) / 2.0f;
-    pz->pan[1] = -(extent.ymin + extent.ymax) / 2.0f;
+    pz->pan[0] = -(extent.xmin + extent.xmax) / 2.0;
+    pz->pan[1] = -(extent.ymin + extent.ymax) / 2.0;
 
     // pz->zlim[0] = extent.zmin;
     // pz->zlim[1] = extent.zmax;
@@ -343,17 +345,17 @@ void dvz_panzoom_mvp(DvzPanzoom* pz, DvzMVP* mvp)
     // WARNING: this does not affect the model matrix, so ensure it is properly initialized to the
     // identity (not all zeros).
 
-    // View matrix (depends on the pan).
-    {
-        float x = -pz->pan[0];
-        float y = -pz->pan[1];
-        glm_lookat((vec3){x, y, 2}, (vec3){x, y, 0}, (vec3){0, 1, 0}, mvp->view);
-    }
+    // The pan goes into the MVP offset rather than in the view matrix. The shaders subtract it
+    // from the positions before the scaling, which preserves the precision at high zoom levels.
+    dvz_mvp_offset(mvp, (dvec3){-pz->pan[0], -pz->pan[1], 0});
+
+    // View matrix.
+    glm_lookat((vec3){0, 0, 2}, (vec3){0, 0, 0}, (vec3){0, 1, 0}, mvp->view);
 
     // Proj matrix (depends on the zoom).
     {
-        float zx = pz->zoom[0];
-        float zy = pz->zoom[1];
+        float zx = (float)pz->zoom[0];
+        float zy = (float)pz->zoom[1];
         glm_ortho(-1.0f / zx, +1.0f / zx, -1.0f / zy, 1.0f / zy, -10.0f, 10.0f, mvp->proj);
     }
 }
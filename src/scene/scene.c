@@ -425,6 +425,20 @@ void dvz_panel_mvpmat(DvzPanel* panel, mat4 model, mat4 view, mat4 proj)
 
 
 
+void dvz_panel_scale(
+    DvzPanel* panel, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range)
+{
+    ANN(panel);
+    if (panel->transform == NULL)
+    {
+        log_error("could not set the panel scale as the panel has no transform yet");
+        return;
+    }
+    dvz_transform_scale(panel->transform, dim, type, param, domain, range);
+}
+
+
+
 void dvz_panel_resize(DvzPanel* panel, float x, float y, float width, float height)
 {
     ANN(panel);
@@ -886,6 +900,29 @@ void dvz_panel_update(DvzPanel* panel)
 /*  Run                                                                                          */
 /*************************************************************************************************/
 
+// Select the level of detail of the visuals, return whether the commands must be recorded again.
+static bool _viewset_lod(DvzViewset* viewset)
+{
+    ANN(viewset);
+    bool changed = false;
+    uint64_t view_count = dvz_list_count(viewset->views);
+    for (uint64_t view_idx = 0; view_idx < view_count; view_idx++)
+    {
+        DvzView* view = (DvzView*)dvz_list_get(viewset->views, view_idx).p;
+        ANN(view);
+        uint64_t visual_count = dvz_list_count(view->visuals);
+        for (uint64_t visual_idx = 0; visual_idx < visual_count; visual_idx++)
+        {
+            DvzVisual* visual = (DvzVisual*)dvz_list_get(view->visuals, visual_idx).p;
+            ANN(visual);
+            changed |= dvz_visual_lod_update(visual);
+        }
+    }
+    return changed;
+}
+
+
+
 static void _scene_build(DvzScene* scene)
 {
     ANN(scene);
@@ -906,6 +943,10 @@ static void _scene_build(DvzScene* scene)
         ANN(fig->viewset);
         ANN(fig->viewset->views);
 
+        // A change in the level of detail of a visual requires recording the commands again.
+        if (_viewset_lod(fig->viewset))
+            dvz_atomic_set(fig->viewset->status, (int)DVZ_BUILD_DIRTY);
+
         // Build status.
         status = (DvzBuildStatus)dvz_atomic_get(fig->viewset->status);
         // if viewset state == dirty, build viewset, and set the viewset state to clear
@@ -20,6 +20,7 @@
 
 #include "datoviz.h"
 #include "datoviz_types.h"
+#include "scene/meshopt.h"
 
 
 
@@ -40,6 +41,23 @@
     x[3 * i + (idx)][2] = shape->x[y][2];                                                         \
     x[3 * i + (idx)][3] = shape->x[y][3];
 
+// Permute per-vertex values in place: the value of vertex v moves to remap[v].
+static void _remap_vertices(void** values, DvzSize item_size, uint32_t count, uint32_t* remap)
+{
+    ANN(values);
+    ANN(remap);
+    if (*values == NULL)
+        return;
+
+    uint8_t* src = (uint8_t*)*values;
+    uint8_t* dst = (uint8_t*)malloc(count * item_size);
+    ANN(dst);
+    for (uint32_t v = 0; v < count; v++)
+        memcpy(&dst[remap[v] * item_size], &src[v * item_size], item_size);
+    FREE(*values);
+    *values = dst;
+}
+
 static inline void direction_vector(vec3 a, vec3 b, vec2 u)
 {
     u[0] = b[0] - a[0];
@@ -66,12 +84,9 @@ void dvz_compute_normals(
     ANN(index);
     ANN(normal);
 
-    DvzIndex i0, i1, i2;
-    vec3 u, v, n;
-    vec3 v0, v1, v2;
-    vec3 n0, n1, n2;
-
     uint32_t face_count = index_count / 3;
+    vec3* face_normal = (vec3*)malloc(face_count * sizeof(vec3));
+    ANN(face_normal);
 
 #if HAS_OPENMP
 #pragma omp parallel for
@@ -79,36 +94,42 @@ void dvz_compute_normals(
     // Go through all triangle faces.
     for (uint32_t i = 0; i < face_count; i++)
     {
-        i0 = index[3 * i + 0];
-        i1 = index[3 * i + 1];
-        i2 = index[3 * i + 2];
-
-        glm_vec3_copy(pos[i0], v0);
-        glm_vec3_copy(pos[i1], v1);
-        glm_vec3_copy(pos[i2], v2);
+        DvzIndex i0 = index[3 * i + 0];
+        DvzIndex i1 = index[3 * i + 1];
+        DvzIndex i2 = index[3 * i + 2];
 
         // u = v1-v0
         // v = v2-v0
         // n = u^v      normalized vector orthogonal to the current face
-        glm_vec3_sub(v1, v0, u);
-        glm_vec3_sub(v2, v0, v);
-        glm_vec3_crossn(u, v, n);
-
-        // Add the face normal to the current vertex normal.
-        glm_vec3_add(normal[i0], n, normal[i0]);
-        glm_vec3_add(normal[i1], n, normal[i1]);
-        glm_vec3_add(normal[i2], n, normal[i2]);
+        vec3 u, v;
+        glm_vec3_sub(pos[i1], pos[i0], u);
+        glm_vec3_sub(pos[i2], pos[i0], v);
+        glm_vec3_crossn(u, v, face_normal[i]);
     }
 
+    // Each vertex gathers the normals of its faces in increasing order, so that the result does
+    // not depend on the number of threads.
+    uint32_t* offsets = (uint32_t*)malloc((vertex_count + 1) * sizeof(uint32_t));
+    uint32_t* faces = (uint32_t*)malloc(3 * face_count * sizeof(uint32_t));
+    ANN(offsets);
+    ANN(faces);
+    dvz_meshopt_adjacency(3 * face_count, index, vertex_count, offsets, faces);
+
 #if HAS_OPENMP
 #pragma omp parallel for
 #endif
-    // Normalize all normals since every vertex might contain the sum of many normals.
     for (uint32_t i = 0; i < vertex_count; i++)
     {
+        for (uint32_t j = offsets[i]; j < offsets[i + 1]; j++)
+            glm_vec3_add(normal[i], face_normal[faces[j]], normal[i]);
+
+        // Normalize all normals since every vertex might contain the sum of many normals.
         glm_vec3_normalize(normal[i]);
-        // glm_vec3_print(normal[i], stdout);
     }
+
+    FREE(face_normal);
+    FREE(offsets);
+    FREE(faces);
 }
 
 
@@ -264,6 +285,13 @@ void dvz_shape_unindex(DvzShape* shape, int flags)
         return;
     }
 
+    if (shape->lod_count > 0)
+    {
+        log_warn("unindexing the shape discards its levels of detail except the finest one");
+        shape->index_count = shape->lod_index_count[0];
+        shape->lod_count = 0;
+    }
+
     int32_t vertex_count = (int32_t)shape->vertex_count;
     ASSERT(vertex_count > 0);
 
@@ -537,6 +565,153 @@ void dvz_shape_unindex(DvzShape* shape, int flags)
 
 
 
+void dvz_shape_optimize(DvzShape* shape)
+{
+    ANN(shape);
+
+    uint32_t vertex_count = shape->vertex_count;
+    uint32_t index_count = shape->index_count;
+    if (index_count == 0 || shape->index == NULL)
+    {
+        log_warn("the shape is non-indexed, skipping optimization");
+        return;
+    }
+    ANN(shape->pos);
+
+    log_debug("optimizing shape with %d vertices and %d indices", vertex_count, index_count);
+
+    // Vertex cache and overdraw, separately in each level of detail.
+    uint32_t range_count = MAX(1, shape->lod_count);
+    DvzIndex* index = (DvzIndex*)malloc(index_count * sizeof(DvzIndex));
+    ANN(index);
+    for (uint32_t k = 0; k < range_count; k++)
+    {
+        uint32_t first = shape->lod_count > 0 ? shape->lod_first[k] : 0;
+        uint32_t count = shape->lod_count > 0 ? shape->lod_index_count[k] : index_count;
+        dvz_meshopt_vcache(count, &shape->index[first], vertex_count, index);
+        dvz_meshopt_overdraw(
+            count, index, vertex_count, shape->pos, DVZ_MESHOPT_OVERDRAW_THRESHOLD,
+            &shape->index[first]);
+    }
+    FREE(index);
+
+    // Vertex fetch.
+    uint32_t* remap = (uint32_t*)malloc(vertex_count * sizeof(uint32_t));
+    ANN(remap);
+    dvz_meshopt_fetch(index_count, shape->index, vertex_count, remap);
+
+    _remap_vertices((void**)&shape->pos, sizeof(vec3), vertex_count, remap);
+    _remap_vertices((void**)&shape->normal, sizeof(vec3), vertex_count, remap);
+    _remap_vertices((void**)&shape->color, sizeof(DvzColor), vertex_count, remap);
+    _remap_vertices((void**)&shape->texcoords, sizeof(vec4), vertex_count, remap);
+    _remap_vertices((void**)&shape->isoline, sizeof(float), vertex_count, remap);
+    _remap_vertices((void**)&shape->d_left, sizeof(vec3), vertex_count, remap);
+    _remap_vertices((void**)&shape->d_right, sizeof(vec3), vertex_count, remap);
+    _remap_vertices((void**)&shape->contour, sizeof(cvec4), vertex_count, remap);
+    FREE(remap);
+}
+
+
+
+float dvz_shape_simplify(DvzShape* shape, float ratio)
+{
+    ANN(shape);
+
+    uint32_t index_count = shape->index_count;
+    if (index_count == 0 || shape->index == NULL)
+    {
+        log_error("only indexed shapes can be simplified");
+        return 0;
+    }
+    if (shape->lod_count > 0)
+    {
+        log_error("the shape already has levels of detail, cannot simplify it");
+        return 0;
+    }
+    ANN(shape->pos);
+
+    ratio = CLIP(ratio, 0, 1);
+    uint32_t target = 3 * (uint32_t)roundf(ratio * (index_count / 3));
+    float error = 0;
+    shape->index_count = dvz_meshopt_simplify(
+        index_count, shape->index, shape->vertex_count, shape->pos, target, &error,
+        shape->index);
+
+    vec4 sphere = {0};
+    dvz_meshopt_sphere(shape->vertex_count, shape->pos, sphere);
+    error = sphere[3] > 0 ? error / sphere[3] : 0;
+    log_debug(
+        "simplified shape from %d to %d indices, relative error %.6f", index_count,
+        shape->index_count, error);
+    return error;
+}
+
+
+
+void dvz_shape_lod(DvzShape* shape, uint32_t lod_count, float* ratios)
+{
+    ANN(shape);
+    ANN(ratios);
+    ASSERT(lod_count > 0);
+
+    if (shape->index_count == 0 || shape->index == NULL)
+    {
+        log_error("only indexed shapes can have levels of detail");
+        return;
+    }
+    ANN(shape->pos);
+    if (lod_count > DVZ_SHAPE_MAX_LODS)
+    {
+        log_warn("too many levels of detail, keeping the first %d", DVZ_SHAPE_MAX_LODS);
+        lod_count = DVZ_SHAPE_MAX_LODS;
+    }
+
+    // Start again from the finest level if the levels are recomputed.
+    uint32_t base_count = shape->lod_count > 0 ? shape->lod_index_count[0] : shape->index_count;
+    uint32_t vertex_count = shape->vertex_count;
+
+    vec4 sphere = {0};
+    dvz_meshopt_sphere(vertex_count, shape->pos, sphere);
+
+    // Each level is simplified from the previous one, all levels end up concatenated in the
+    // index buffer.
+    DvzIndex* index = (DvzIndex*)malloc(lod_count * base_count * sizeof(DvzIndex));
+    ANN(index);
+    uint32_t first = 0;
+    uint32_t count = base_count;
+    const DvzIndex* prev = shape->index;
+    float error = 0;
+    for (uint32_t k = 0; k < lod_count; k++)
+    {
+        float ratio = CLIP(ratios[k], 0, 1);
+        uint32_t target = 3 * (uint32_t)roundf(ratio * (base_count / 3));
+        float level_error = 0;
+        count = dvz_meshopt_simplify(
+            count, prev, vertex_count, shape->pos, target, &level_error, &index[first]);
+
+        // The errors of successive simplifications add up.
+        error += sphere[3] > 0 ? level_error / sphere[3] : 0;
+
+        shape->lod_first[k] = first;
+        shape->lod_index_count[k] = count;
+        shape->lod_error[k] = error;
+        log_debug(
+            "level of detail #%d: %d indices (ratio %.3f), relative error %.6f", k, count,
+            (double)count / base_count, error);
+
+        prev = &index[first];
+        first += count;
+    }
+
+    FREE(shape->index);
+    shape->index = (DvzIndex*)realloc(index, first * sizeof(DvzIndex));
+    ANN(shape->index);
+    shape->index_count = first;
+    shape->lod_count = lod_count;
+}
+
+
+
 void dvz_shape_destroy(DvzShape* shape)
 {
     ANN(shape);
@@ -560,18 +735,20 @@ void dvz_shape_destroy(DvzShape* shape)
 
 static inline void transform_pos(mat4 transform, vec3 pos)
 {
-    glm_mat4_mulv3(transform, pos, 1, pos);
+    float x = pos[0], y = pos[1], z = pos[2];
+    for (uint32_t k = 0; k < 3; k++)
+        pos[k] = transform[0][k] * x + transform[1][k] * y + transform[2][k] * z + transform[3][k];
 }
 
 
 
-static inline void transform_normal(mat4 transform, vec3 normal)
+// NOTE: the normal matrix is the inverse transpose of the transformation matrix, it is computed
+// once per transformation.
+static inline void transform_normal(mat4 normal_matrix, vec3 normal)
 {
-    mat4 tr;
-    glm_mat4_copy(transform, tr);
-    glm_mat4_inv(tr, tr);
-    glm_mat4_transpose(tr);
-    glm_mat4_mulv3(tr, normal, 1, normal);
+    float x = normal[0], y = normal[1], z = normal[2];
+    for (uint32_t k = 0; k < 3; k++)
+        normal[k] = normal_matrix[0][k] * x + normal_matrix[1][k] * y + normal_matrix[2][k] * z;
 }
 
 
@@ -651,12 +828,23 @@ void dvz_shape_end(DvzShape* shape)
     if (shape->count == 0)
         return;
 
+    uint32_t first = shape->first;
+    uint32_t last = first + shape->count;
+    ASSERT(last <= shape->vertex_count);
+
+    mat4 normal_matrix;
+    glm_mat4_inv(shape->transform, normal_matrix);
+    glm_mat4_transpose(normal_matrix);
+
     // Apply the transformation to the vertex positions and normals.
-    for (uint32_t i = shape->first; i < shape->count; i++)
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t i = first; i < last; i++)
     {
-        ASSERT(i < shape->vertex_count);
         transform_pos(shape->transform, shape->pos[i]);
-        transform_normal(shape->transform, shape->normal[i]);
+        if (shape->normal != NULL)
+            transform_normal(normal_matrix, shape->normal[i]);
     }
 
     // Reset the transformation matrix.
@@ -812,6 +1000,61 @@ DvzShape dvz_shape_polygon(uint32_t count, const dvec2* points, DvzColor color)
 
 
 
+DvzShape dvz_shape_polygons(
+    uint32_t polygon_count, const uint32_t* polygon_offsets, const uint32_t* ring_offsets,
+    const dvec2* points, DvzColor* colors)
+{
+    ASSERT(polygon_count > 0);
+    ANN(polygon_offsets);
+    ANN(ring_offsets);
+    ANN(points);
+    ANN(colors);
+
+    DvzShape shape = {0};
+    shape.type = DVZ_SHAPE_POLYGON;
+
+    // Triangulate all polygons in parallel, the output index buffer is used as is.
+    uint32_t index_count = 0;
+    DvzIndex* indices = dvz_earcut_polygons(
+        polygon_count, polygon_offsets, ring_offsets, points, &index_count, NULL);
+    if (index_count == 0)
+    {
+        log_error("Polygon triangulation failed");
+        FREE(indices);
+        return shape;
+    }
+
+    uint32_t first = ring_offsets[polygon_offsets[0]];
+    uint32_t vertex_count = ring_offsets[polygon_offsets[polygon_count]];
+    ASSERT(first == 0);
+
+    shape.vertex_count = vertex_count;
+    shape.index_count = index_count;
+    shape.index = indices;
+    shape.pos = (vec3*)calloc(vertex_count, sizeof(vec3));
+    shape.color = (DvzColor*)calloc(vertex_count, sizeof(DvzColor));
+
+    // Positions and colors, polygon by polygon.
+#if HAS_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int64_t p = 0; p < (int64_t)polygon_count; p++)
+    {
+        uint32_t i0 = ring_offsets[polygon_offsets[p]];
+        uint32_t i1 = ring_offsets[polygon_offsets[p + 1]];
+        for (uint32_t i = i0; i < i1; i++)
+        {
+            shape.pos[i][0] = (float)points[i][0];
+            shape.pos[i][1] = (float)points[i][1];
+            memcpy(shape.color[i], colors[p], sizeof(DvzColor));
+        }
+    }
+
+    return shape;
+}
+
+
+
 /*************************************************************************************************/
 /*  3D shapes                                                                                    */
 /*************************************************************************************************/
@@ -841,19 +1084,19 @@ DvzShape dvz_shape_surface(
     shape.index = (DvzIndex*)calloc(index_count, sizeof(DvzIndex));
     shape.color = (DvzColor*)calloc(vertex_count, sizeof(DvzColor));
 
-    uint32_t point_idx = 0;
-    uint32_t index = 0;
-
     vec3 normal = {0};
     glm_vec3_crossn(u, v, normal);
-    float height = 0;
 
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
     for (uint32_t i = 0; i < row_count; i++)
     {
+        uint32_t point_idx = col_count * i;
+        uint32_t index = 6 * (col_count - 1) * i;
+        float height = 0;
         for (uint32_t j = 0; j < col_count; j++)
         {
-            ASSERT(point_idx == col_count * i + j);
-
             // Position.
             shape.pos[point_idx][0] = o[0] + i * u[0] + j * v[0];
             shape.pos[point_idx][1] = o[1] + i * u[1] + j * v[1];
@@ -15,6 +15,7 @@
 
 #include "scene/ticks.h"
 #include "_macros.h"
+#include "scene/mvp.h"
 
 #include "_debug.h"
 
@@ -476,6 +477,28 @@ static void wilk_ext(DvzTicks* ticks, int32_t m)
 
 
 
+// On a nonlinear axis spanning several decades, put the ticks on integer decades in the scaled
+// space, with an integer step so that there are at most m ticks.
+static bool decade_ticks(DvzTicks* ticks, int32_t m)
+{
+    ANN(ticks);
+    ASSERT(m > 0);
+
+    double fmin = ticks->dmin;
+    double fmax = ticks->dmax;
+    if (!isfinite(fmin) || !isfinite(fmax) || fmax - fmin < 2)
+        return false;
+
+    double lstep = MAX(1, ceil((fmax - fmin) / m));
+    ticks->lstep = lstep;
+    ticks->lmin = ceil(fmin / lstep) * lstep;
+    ticks->lmax = floor(fmax / lstep) * lstep;
+    ticks->format = DVZ_TICKS_FORMAT_SCIENTIFIC;
+    return true;
+}
+
+
+
 /*************************************************************************************************/
 /*  Ticks functions                                                                              */
 /*************************************************************************************************/
@@ -484,11 +507,23 @@ DvzTicks* dvz_ticks(int flags)
 {
     DvzTicks* ticks = (DvzTicks*)calloc(1, sizeof(DvzTicks));
     ticks->flags = flags;
+    if ((flags & DVZ_TICKS_FLAGS_LOG) != 0)
+        ticks->scale = DVZ_SCALE_LOG10;
     return ticks;
 }
 
 
 
+void dvz_ticks_scale(DvzTicks* ticks, DvzScaleType type, double param)
+{
+    ANN(ticks);
+    ASSERT(type != DVZ_SCALE_SYMLOG || param > 0);
+    ticks->scale = type;
+    ticks->scale_param = param;
+}
+
+
+
 // range_size is in the same unit as glyph size, it's the size between dmin
 // and dmax (below)
 void dvz_ticks_size(DvzTicks* ticks, double range_size, double glyph_size)
@@ -503,8 +538,16 @@ void dvz_ticks_size(DvzTicks* ticks, double range_size, double glyph_size)
 bool dvz_ticks_compute(DvzTicks* ticks, double dmin, double dmax, uint32_t requested_count)
 {
     ANN(ticks);
-    ticks->dmin = dmin;
-    ticks->dmax = dmax;
+
+    // On nonlinear axes, the ticks are computed in the scaled space.
+    if (ticks->scale == DVZ_SCALE_LOG10)
+    {
+        // Clamp the nonpositive bounds to a fixed number of decades below the maximum.
+        dmax = dmax > 0 ? dmax : 1;
+        dmin = dmin > 0 ? dmin : dmax * 1e-6;
+    }
+    ticks->dmin = dvz_scale_apply(ticks->scale, ticks->scale_param, dmin);
+    ticks->dmax = dvz_scale_apply(ticks->scale, ticks->scale_param, dmax);
 
     // Keep track of the initial parameters.
     double lmin = ticks->lmin;
@@ -514,7 +557,8 @@ bool dvz_ticks_compute(DvzTicks* ticks, double dmin, double dmax, uint32_t reque
 
     // Run the algorithm.
     int32_t m = (int32_t)requested_count;
-    wilk_ext(ticks, m);
+    if (ticks->scale == DVZ_SCALE_LINEAR || !decade_ticks(ticks, m))
+        wilk_ext(ticks, m);
 
     // Determine whether the parameters are different.
     bool has_changed =
@@ -550,6 +594,20 @@ uint32_t dvz_ticks_range(DvzTicks* ticks, double* lmin, double* lmax, double* ls
 
 
 
+uint32_t dvz_ticks_values(DvzTicks* ticks, uint32_t count, double* values)
+{
+    ANN(ticks);
+    ANN(values);
+
+    count = MIN(count, tick_count(ticks->lmin, ticks->lmax, ticks->lstep));
+    for (uint32_t i = 0; i < count; i++)
+        values[i] = dvz_scale_inverse(
+            ticks->scale, ticks->scale_param, ticks->lmin + i * ticks->lstep);
+    return count;
+}
+
+
+
 DvzTicksFormat dvz_ticks_format(DvzTicks* ticks)
 {
     // decimal or scientific notation
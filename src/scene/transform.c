@@ -78,6 +78,16 @@ void dvz_transform_update(DvzTransform* tr)
 
 
 
+void dvz_transform_scale(
+    DvzTransform* tr, uint32_t dim, DvzScaleType type, double param, dvec2 domain, vec2 range)
+{
+    ANN(tr);
+    dvz_mvp_scale(dvz_transform_mvp(tr), dim, type, param, domain, range);
+    dvz_transform_update(tr);
+}
+
+
+
 void dvz_transform_next(DvzTransform* tr, DvzTransform* next)
 {
     ANN(tr);
@@ -263,6 +263,9 @@ void dvz_view_add(
     visual->instance_count = instance_count;
     visual->view = view;
 
+    // NOTE: the transform is also used on the CPU to select the level of detail.
+    visual->lod_transform = transform;
+
     dvz_list_append(view->visuals, (DvzListItem){.p = visual});
 
     // // MVP.
@@ -15,6 +15,7 @@
 /*************************************************************************************************/
 
 #include "scene/visual.h"
+#include "_cglm.h"
 #include "_map.h"
 #include "datoviz.h"
 #include "datoviz_protocol.h"
@@ -24,6 +25,8 @@
 #include "scene/dual.h"
 #include "scene/graphics.h"
 #include "scene/params.h"
+#include "scene/transform.h"
+#include "scene/viewset.h"
 
 
 
@@ -31,6 +34,187 @@
 /*  Macros                                                                                       */
 /*************************************************************************************************/
 
+// Size of the mask header (selected color and style parameters), in 4-byte words.
+#define MASK_HEADER_WORDS 8
+
+#define MASK_DEFAULT_COLOR     {1, .6, 0, 1}
+#define MASK_DEFAULT_HIGHLIGHT 1.5
+#define MASK_DEFAULT_DIMMED    .1
+
+// Box of quantized positions before the positions are set.
+#define QUANTIZE_EMPTY_BOX {+INFINITY, -INFINITY, +INFINITY, -INFINITY, +INFINITY, -INFINITY}
+
+// Maximum simplification error of the selected level of detail, in pixels.
+#define LOD_PIXEL_ERROR 1.0f
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static void _set_visual_dirty(DvzVisual* visual)
+{
+    ANN(visual);
+    dvz_atomic_set(visual->status, (int32_t)DVZ_BUILD_DIRTY);
+}
+
+
+
+static uint32_t _attr_repeats(DvzVisual* visual, uint32_t attr_idx)
+{
+    ANN(visual);
+    ASSERT(attr_idx < DVZ_MAX_VERTEX_ATTRS);
+
+    // Extract the N in 0xN00 part, that is the number of repeats.
+    int flags = visual->attrs[attr_idx].flags;
+    uint32_t reps = 1;
+    if ((flags & DVZ_ATTR_FLAGS_REPEAT) != 0)
+    {
+        reps = (uint32_t)((flags & 0x0F00) >> 8);
+        ASSERT(reps >= 1);
+    }
+    return reps;
+}
+
+
+
+// Bind the index buffer again if the baker switched from 16-bit to 32-bit indices.
+static void _rebind_index(DvzVisual* visual, DvzSize old_index_size)
+{
+    ANN(visual);
+    DvzBaker* baker = visual->baker;
+    ANN(baker);
+
+    if (baker->index_size == old_index_size)
+        return;
+    dvz_bind_index_size(
+        visual->batch, visual->graphics_id, baker->index.dat, 0, baker->index_size);
+    _set_visual_dirty(visual);
+}
+
+
+
+// Number of words holding the states of the given number of items, one byte per item.
+static inline uint32_t _mask_words(uint32_t item_count) { return (item_count + 3) / 4; }
+
+
+
+// Only the point and marker graphics have vertex shader variants reading the mask or decoding
+// quantized positions.
+static bool _has_shader_variants(const char* name)
+{
+    ANN(name);
+    return strcmp(name, "graphics_point") == 0 || strcmp(name, "graphics_marker") == 0;
+}
+
+
+
+// Box of the quantized positions, and the matching decoding uniform.
+static void _quantize_box(DvzVisual* visual, DvzBox box)
+{
+    ANN(visual);
+    ASSERT(visual->quantize_slot > 0);
+
+    visual->quantize_box = box;
+    vec4 scale = {
+        (float)(.5 * (box.xmax - box.xmin)), (float)(.5 * (box.ymax - box.ymin)),
+        (float)(.5 * (box.zmax - box.zmin)), 0};
+    vec4 offset = {
+        (float)(.5 * (box.xmax + box.xmin)), (float)(.5 * (box.ymax + box.ymin)),
+        (float)(.5 * (box.zmax + box.zmin)), 0};
+    dvz_visual_param(visual, visual->quantize_slot, 0, scale);
+    dvz_visual_param(visual, visual->quantize_slot, 1, offset);
+}
+
+
+
+// Quantize positions relative to the box of all the positions of the visual. A partial update
+// can only grow the box, in which case all positions are requantized from their retained source
+// values, so that the quantization error does not accumulate across updates.
+static void _quantize_positions(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, dvec3* pos)
+{
+    ANN(visual);
+    ANN(pos);
+    ASSERT(count > 0);
+
+    if (visual->quantize_slot == 0)
+    {
+        log_error("the visual should be created with `DVZ_VISUAL_FLAGS_QUANTIZED`");
+        return;
+    }
+
+    DvzBox box = QUANTIZE_EMPTY_BOX;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        box.xmin = MIN(box.xmin, pos[i][0]);
+        box.xmax = MAX(box.xmax, pos[i][0]);
+        box.ymin = MIN(box.ymin, pos[i][1]);
+        box.ymax = MAX(box.ymax, pos[i][1]);
+        box.zmin = MIN(box.zmin, pos[i][2]);
+        box.zmax = MAX(box.zmax, pos[i][2]);
+    }
+
+    // Retain the source positions.
+    uint32_t source_count = MAX(visual->item_count, first + count);
+    if (visual->quantize_source == NULL)
+        visual->quantize_source = dvz_array_struct(source_count, sizeof(dvec3));
+    else if (visual->quantize_source->item_count < source_count)
+        dvz_array_resize(visual->quantize_source, source_count);
+    dvz_array_data(visual->quantize_source, first, count, count, pos);
+
+    DvzBox old = visual->quantize_box;
+    bool is_empty = old.xmin > old.xmax;
+    bool is_full = first == 0 && count >= visual->item_count;
+    bool has_grown = false;
+    if (!is_empty && !is_full)
+    {
+        box = dvz_box_merge(2, (DvzBox[]){old, box}, DVZ_BOX_MERGE_DEFAULT);
+        has_grown = memcmp(&box, &old, sizeof(DvzBox)) != 0;
+    }
+    _quantize_box(visual, box);
+
+    uint32_t reps = _attr_repeats(visual, attr_idx);
+    if (has_grown)
+    {
+        first = 0;
+        count = visual->quantize_source->item_count;
+        pos = (dvec3*)visual->quantize_source->data;
+    }
+    dvz_baker_normalize(visual->baker, attr_idx, first, count, reps, box, DVZ_BOX_NDC, pos);
+}
+
+
+
+static void _mask_style(DvzVisual* visual, vec4 color, float highlight_scale, float dimmed_alpha)
+{
+    ANN(visual);
+    ANN(visual->mask.array);
+
+    // Same layout as the mask.glsl header.
+    float header[MASK_HEADER_WORDS] = {
+        color[0], color[1], color[2], color[3], highlight_scale, dimmed_alpha, 0, 0};
+    dvz_dual_data(&visual->mask, 0, MASK_HEADER_WORDS, header);
+}
+
+
+
+static void _mask_create(DvzVisual* visual, uint32_t item_count)
+{
+    ANN(visual);
+    ASSERT(item_count > 0);
+
+    uint32_t words = MASK_HEADER_WORDS + _mask_words(item_count);
+    visual->mask = dvz_dual_storage(visual->batch, words, sizeof(uint32_t), 0);
+    visual->mask.need_destroy = true;
+
+    // All items are in the default state initially.
+    _mask_style(
+        visual, (vec4)MASK_DEFAULT_COLOR, MASK_DEFAULT_HIGHLIGHT, MASK_DEFAULT_DIMMED);
+    dvz_dual_dirty(&visual->mask, 0, words);
+}
+
 
 
 /*************************************************************************************************/
@@ -104,6 +288,18 @@ void dvz_visual_update(DvzVisual* visual)
             dvz_params_update(visual->params[i]);
     }
 
+    // Update the mask.
+    if (visual->mask.array != NULL)
+        dvz_dual_update(&visual->mask);
+
+    // Update the edge flags.
+    if (visual->edges.array != NULL)
+        dvz_dual_update(&visual->edges);
+
+    // Update the instances.
+    if (visual->instances.array != NULL)
+        dvz_dual_update(&visual->instances);
+
     // Clear the visual status.
     dvz_atomic_set(visual->status, (int32_t)DVZ_BUILD_CLEAR);
 }
@@ -127,6 +323,22 @@ void dvz_visual_destroy(DvzVisual* visual)
         }
     }
 
+    // Destroy the mask.
+    if (visual->mask.array != NULL)
+        dvz_dual_destroy(&visual->mask);
+
+    // Destroy the source of the quantized positions.
+    if (visual->quantize_source != NULL)
+        dvz_array_destroy(visual->quantize_source);
+
+    // Destroy the edge flags.
+    if (visual->edges.array != NULL)
+        dvz_dual_destroy(&visual->edges);
+
+    // Destroy the instances.
+    if (visual->instances.array != NULL)
+        dvz_dual_destroy(&visual->instances);
+
     dvz_atomic_destroy(visual->status);
     FREE(visual);
 }
@@ -271,8 +483,25 @@ void dvz_visual_shader(DvzVisual* visual, const char* name)
     unsigned long size = 0;
     char rname[64] = {0};
 
-    // Vertex shader.
-    snprintf(rname, 60, "%s_%s", name, "vert");
+    // Vertex shader, with its double precision, quantized and mask variants if requested.
+    bool is_double = (visual->flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0;
+    bool is_quantized = (visual->flags & DVZ_VISUAL_FLAGS_QUANTIZED) != 0;
+    bool is_mask = (visual->flags & DVZ_VISUAL_FLAGS_MASK) != 0;
+    if (is_quantized && !_has_shader_variants(name))
+    {
+        log_warn("%s does not support `DVZ_VISUAL_FLAGS_QUANTIZED`, ignoring it", name);
+        visual->flags &= ~DVZ_VISUAL_FLAGS_QUANTIZED;
+        is_quantized = false;
+    }
+    if (is_mask && !_has_shader_variants(name))
+    {
+        log_warn("%s does not support `DVZ_VISUAL_FLAGS_MASK`, ignoring the mask", name);
+        visual->flags &= ~DVZ_VISUAL_FLAGS_MASK;
+        is_mask = false;
+    }
+    snprintf(
+        rname, 60, "%s_%s%s%svert", name, is_double ? "double_" : "",
+        is_quantized ? "quantized_" : "", is_mask ? "mask_" : "");
     unsigned char* buffer = dvz_resource_shader(rname, &size);
     dvz_visual_spirv(visual, DVZ_SHADER_VERTEX, size, buffer);
 
@@ -301,12 +530,32 @@ void dvz_visual_resize(
     }
 
     // Mark the new item count.
+    uint32_t old_item_count = visual->item_count;
     visual->item_count = item_count;
     visual->vertex_count = vertex_count;
     visual->index_count = index_count;
 
     // Resize the baker, resize the underlying arrays, emit the dat resize commands.
-    dvz_baker_resize(visual->baker, vertex_count, index_count);
+    DvzBaker* baker = visual->baker;
+    DvzSize index_size = baker->index_size;
+    dvz_baker_resize(baker, vertex_count, index_count);
+
+    _rebind_index(visual, index_size);
+
+    // Resize the mask, and upload it entirely as the dat contents may not be preserved.
+    if (visual->mask.array != NULL)
+    {
+        uint32_t words = MASK_HEADER_WORDS + _mask_words(item_count);
+        dvz_array_resize(visual->mask.array, words);
+
+        // The new items are in the default state.
+        uint8_t* states = (uint8_t*)dvz_array_item(visual->mask.array, MASK_HEADER_WORDS);
+        if (item_count > old_item_count)
+            memset(&states[old_item_count], 0, 4 * _mask_words(item_count) - old_item_count);
+        dvz_dual_resize(&visual->mask, words);
+        dvz_dual_dirty(&visual->mask, 0, words);
+        _set_visual_dirty(visual);
+    }
 }
 
 
@@ -383,6 +632,49 @@ void dvz_visual_slot(DvzVisual* visual, uint32_t slot_idx, DvzSlotType type)
 
 
 
+void dvz_visual_mask_slot(DvzVisual* visual, uint32_t slot_idx)
+{
+    ANN(visual);
+    ASSERT(0 < slot_idx && slot_idx < DVZ_MAX_BINDINGS);
+
+    if ((visual->flags & DVZ_VISUAL_FLAGS_MASK) == 0)
+    {
+        log_error("the visual should be created with `DVZ_VISUAL_FLAGS_MASK` to use a mask");
+        return;
+    }
+
+    dvz_set_slot(
+        visual->batch, visual->graphics_id, slot_idx, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    visual->mask_slot = slot_idx;
+}
+
+
+
+void dvz_visual_quantize_slot(DvzVisual* visual, uint32_t slot_idx)
+{
+    ANN(visual);
+    ASSERT(0 < slot_idx && slot_idx < DVZ_MAX_BINDINGS);
+
+    if ((visual->flags & DVZ_VISUAL_FLAGS_QUANTIZED) == 0)
+    {
+        log_error("the visual should be created with `DVZ_VISUAL_FLAGS_QUANTIZED`");
+        return;
+    }
+
+    dvz_visual_slot(visual, slot_idx, DVZ_SLOT_DAT);
+    DvzParams* params = dvz_visual_params(visual, slot_idx, sizeof(DvzQuantizeParams));
+    dvz_params_attr(params, 0, FIELD(DvzQuantizeParams, scale));
+    dvz_params_attr(params, 1, FIELD(DvzQuantizeParams, offset));
+    visual->quantize_slot = slot_idx;
+
+    // Until positions are set, the snorm16 range corresponds to the NDC cube, and the box is
+    // marked as empty.
+    _quantize_box(visual, DVZ_BOX_NDC);
+    visual->quantize_box = (DvzBox)QUANTIZE_EMPTY_BOX;
+}
+
+
+
 DvzParams* dvz_visual_params(DvzVisual* visual, uint32_t slot_idx, DvzSize size)
 {
     ANN(visual);
@@ -589,7 +881,14 @@ void dvz_visual_alloc(
     // Bind the index buffer.
     if (indexed)
     {
-        dvz_bind_index(batch, graphics_id, baker->index.dat, 0);
+        dvz_bind_index_size(batch, graphics_id, baker->index.dat, 0, baker->index_size);
+    }
+
+    // Create and bind the mask buffer.
+    if (visual->mask_slot > 0)
+    {
+        _mask_create(visual, item_count);
+        dvz_bind_dat(batch, graphics_id, visual->mask_slot, visual->mask.dat, 0);
     }
 
     // We now need to send the vertex/descriptor binding requests to the GPU.
@@ -695,12 +994,6 @@ void dvz_visual_viewport(DvzVisual* visual, DvzViewport* viewport)
 /*  Visual data                                                                                  */
 /*************************************************************************************************/
 
-static void _set_visual_dirty(DvzVisual* visual)
-{
-    ANN(visual);
-    dvz_atomic_set(visual->status, (int32_t)DVZ_BUILD_DIRTY);
-}
-
 void dvz_visual_data(
     DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, void* data)
 {
@@ -742,6 +1035,108 @@ void dvz_visual_data(
 
 
 
+void dvz_visual_data_double(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t attr_lo, uint32_t first, uint32_t count,
+    dvec3* data)
+{
+    ANN(visual);
+    ANN(data);
+    ASSERT(count > 0);
+
+    // Quantized positions are directly normalized into the box of the positions.
+    if (visual->attrs[attr_idx].format == DVZ_FORMAT_R16G16B16A16_SNORM)
+    {
+        _quantize_positions(visual, attr_idx, first, count, data);
+        _set_visual_dirty(visual);
+        return;
+    }
+
+    // Split the double precision values into high and low single precision parts.
+    bool is_double = (visual->flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0;
+    vec3* hi = (vec3*)calloc(count, sizeof(vec3));
+    vec3* lo = is_double ? (vec3*)calloc(count, sizeof(vec3)) : NULL;
+
+#if HAS_OPENMP
+#pragma omp parallel for
+#endif
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            hi[i][j] = (float)data[i][j];
+            if (lo != NULL)
+                lo[i][j] = (float)(data[i][j] - (double)hi[i][j]);
+        }
+    }
+
+    // Without double precision, only the high part is used.
+    dvz_visual_data(visual, attr_idx, first, count, (void*)hi);
+    if (lo != NULL)
+        dvz_visual_data(visual, attr_lo, first, count, (void*)lo);
+
+    FREE(hi);
+    FREE(lo);
+}
+
+
+
+void dvz_visual_data_box(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, DvzBox source,
+    DvzBox target, dvec3* pos)
+{
+    ANN(visual);
+    ASSERT(attr_idx < DVZ_MAX_VERTEX_ATTRS);
+
+    DvzBaker* baker = visual->baker;
+    ANN(baker);
+
+    uint32_t reps = _attr_repeats(visual, attr_idx);
+    log_debug(
+        "visual normalized data for attr #%d (%d->%d, repeat x%d)", attr_idx, first, count, reps);
+    dvz_baker_normalize(baker, attr_idx, first, count, reps, source, target, pos);
+
+    _set_visual_dirty(visual);
+}
+
+
+
+void dvz_visual_quantize(
+    DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, float scale,
+    float* data)
+{
+    ANN(visual);
+    ANN(data);
+    ASSERT(attr_idx < DVZ_MAX_VERTEX_ATTRS);
+
+    DvzBaker* baker = visual->baker;
+    ANN(baker);
+
+    uint32_t reps = _attr_repeats(visual, attr_idx);
+    DvzFormat format = visual->attrs[attr_idx].format;
+    log_debug(
+        "visual quantized data for attr #%d (%d->%d, format %d)", attr_idx, first, count, format);
+
+    // Positions are quantized relative to their box, which is passed to the vertex shader.
+    if (format == DVZ_FORMAT_R16G16B16A16_SNORM)
+    {
+        dvec3* pos = (dvec3*)malloc(count * sizeof(dvec3));
+        ANN(pos);
+        for (uint32_t i = 0; i < count; i++)
+            for (uint32_t j = 0; j < 3; j++)
+                pos[i][j] = (double)(data[3 * i + j] * scale);
+        _quantize_positions(visual, attr_idx, first, count, pos);
+        FREE(pos);
+    }
+    else
+    {
+        dvz_baker_quantize(baker, attr_idx, first, count, reps, format, scale, data);
+    }
+
+    _set_visual_dirty(visual);
+}
+
+
+
 void dvz_visual_quads(
     DvzVisual* visual, uint32_t attr_idx, uint32_t first, uint32_t count, vec4* tl_br)
 {
@@ -769,13 +1164,56 @@ void dvz_visual_index(DvzVisual* visual, uint32_t first, uint32_t count, DvzInde
     ANN(baker);
 
     log_debug("visual data for index (%d->%d)", first, count);
+    DvzSize index_size = baker->index_size;
     dvz_baker_index(baker, first, count, data);
+    _rebind_index(visual, index_size);
 
     _set_visual_dirty(visual);
 }
 
 
 
+void dvz_visual_mask(DvzVisual* visual, uint32_t first, uint32_t count, uint8_t* bits)
+{
+    ANN(visual);
+    ANN(bits);
+    if (count == 0)
+        return;
+    if (visual->mask.array == NULL)
+    {
+        log_error("the visual has no mask, it should be created with `DVZ_VISUAL_FLAGS_MASK`");
+        return;
+    }
+    ASSERT(first + count <= visual->item_count);
+
+    // The item states are bytes after the header, the upload is done by whole words.
+    uint8_t* states = (uint8_t*)dvz_array_item(visual->mask.array, MASK_HEADER_WORDS);
+    memcpy(&states[first], bits, count);
+
+    uint32_t word_first = first / 4;
+    uint32_t word_last = _mask_words(first + count);
+    dvz_dual_dirty(&visual->mask, MASK_HEADER_WORDS + word_first, word_last - word_first);
+
+    _set_visual_dirty(visual);
+}
+
+
+
+void dvz_visual_mask_style(
+    DvzVisual* visual, vec4 selected_color, float highlight_scale, float dimmed_alpha)
+{
+    ANN(visual);
+    if (visual->mask.array == NULL)
+    {
+        log_error("the visual has no mask, it should be created with `DVZ_VISUAL_FLAGS_MASK`");
+        return;
+    }
+    _mask_style(visual, selected_color, highlight_scale, dimmed_alpha);
+    _set_visual_dirty(visual);
+}
+
+
+
 void dvz_visual_param(DvzVisual* visual, uint32_t slot_idx, uint32_t attr_idx, void* item)
 {
     ANN(visual);
@@ -791,6 +1229,119 @@ void dvz_visual_param(DvzVisual* visual, uint32_t slot_idx, uint32_t attr_idx, v
 
 
 
+/*************************************************************************************************/
+/*  Visual levels of detail                                                                      */
+/*************************************************************************************************/
+
+void dvz_visual_lod(
+    DvzVisual* visual, uint32_t lod_count, uint32_t* first, uint32_t* index_count, float* error,
+    vec4 sphere)
+{
+    ANN(visual);
+    ASSERT(lod_count <= DVZ_SHAPE_MAX_LODS);
+    if (lod_count > 0)
+    {
+        ANN(first);
+        ANN(index_count);
+        ANN(error);
+        if ((visual->flags & DVZ_VISUAL_FLAGS_INDEXED) == 0)
+        {
+            log_error("levels of detail require an indexed visual, discarding them");
+            lod_count = 0;
+        }
+    }
+
+    visual->lod_count = lod_count;
+    visual->lod_level = 0;
+    for (uint32_t k = 0; k < lod_count; k++)
+    {
+        visual->lod_first[k] = first[k];
+        visual->lod_index_count[k] = index_count[k];
+        visual->lod_error[k] = error[k];
+    }
+    glm_vec4_copy(sphere, visual->lod_sphere);
+
+    if (visual->lod_callback != NULL)
+        visual->lod_callback(visual, 0);
+}
+
+
+
+uint32_t dvz_visual_lod_select(DvzVisual* visual, DvzMVP* mvp, vec2 size)
+{
+    ANN(visual);
+    ANN(mvp);
+    if (visual->lod_count <= 1)
+        return 0;
+
+    // Bounding sphere in clip space, the radius is scaled by the largest axis scaling of the
+    // model-view matrix.
+    mat4 mv = {0};
+    glm_mat4_mul(mvp->view, mvp->model, mv);
+    // NOTE: the positions are relative to the MVP offset, as in the shaders.
+    vec4 center = {0, 0, 0, 1};
+    for (uint32_t j = 0; j < 3; j++)
+        center[j] = (visual->lod_sphere[j] - mvp->offset_hi[j]) - mvp->offset_lo[j];
+    vec4 eye = {0};
+    glm_mat4_mulv(mv, center, eye);
+    float scale = 0;
+    for (uint32_t j = 0; j < 3; j++)
+        scale = MAX(scale, glm_vec3_norm(mv[j]));
+    float w = mvp->proj[0][3] * eye[0] + mvp->proj[1][3] * eye[1] + mvp->proj[2][3] * eye[2] +
+              mvp->proj[3][3] * eye[3];
+
+    // Behind the camera: the coarsest level.
+    uint32_t coarsest = visual->lod_count - 1;
+    if (w <= 0)
+        return coarsest;
+
+    // Projected radius in pixels, the same expression holds for perspective (w is the depth)
+    // and orthographic (w = 1) projections.
+    float radius_px = visual->lod_sphere[3] * scale * fabsf(mvp->proj[1][1]) / w * .5f * size[1];
+
+    // The errors increase with the level.
+    uint32_t level = 0;
+    for (uint32_t k = 1; k < visual->lod_count; k++)
+    {
+        if (visual->lod_error[k] * radius_px > LOD_PIXEL_ERROR)
+            break;
+        level = k;
+    }
+    return level;
+}
+
+
+
+bool dvz_visual_lod_update(DvzVisual* visual)
+{
+    ANN(visual);
+    if (visual->lod_count <= 1 || visual->view == NULL || visual->lod_transform == NULL)
+        return false;
+
+    DvzMVP* mvp = dvz_transform_mvp(visual->lod_transform);
+    uint32_t level = dvz_visual_lod_select(visual, mvp, visual->view->shape);
+    if (level == visual->lod_level)
+        return false;
+
+    log_debug("switching visual to level of detail #%d", level);
+    visual->lod_level = level;
+    if (visual->lod_callback != NULL)
+        visual->lod_callback(visual, level);
+    return true;
+}
+
+
+
+void dvz_visual_lod_callback(DvzVisual* visual, DvzVisualLodCallback callback)
+{
+    ANN(visual);
+    ANN(callback);
+
+    visual->lod_callback = callback;
+}
+
+
+
 /*************************************************************************************************/
 /*  Visual drawing internal functions                                                            */
 /*************************************************************************************************/
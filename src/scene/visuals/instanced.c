@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Instanced mesh                                                                               */
+/*************************************************************************************************/
+
+// The instanced mesh visual uploads a single shape in the vertex and index buffers, and draws it
+// once per instance with a single instanced draw call. The per-instance position, rotation,
+// scale and color are stored in a storage buffer indexed by gl_InstanceIndex in the vertex
+// shader. By convention in this visual, 1 item = 1 instance.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/visuals/instanced.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "datoviz_types.h"
+#include "scene/array.h"
+#include "scene/graphics.h"
+#include "scene/scene.h"
+#include "scene/viewset.h"
+#include "scene/visual.h"
+#include "scene/visuals/mesh.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SLOT_PARAMS    2
+#define SLOT_INSTANCES 3
+
+#define DEFAULT_LIGHT_DIR                                                                         \
+    (vec3) { 0.25, -0.25, -1 }
+
+#if DVZ_COLOR_CVEC4
+#define DEFAULT_LIGHT_COLOR                                                                       \
+    (cvec4) { 255, 255, 255, 255 }
+#else
+#define DEFAULT_LIGHT_COLOR                                                                       \
+    (vec3) { 1, 1, 1, 1 }
+#endif
+
+#define DEFAULT_LIGHT_PARAMS                                                                      \
+    (vec4) { .3, .7, .4, 16 }
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static void _visual_callback(
+    DvzVisual* visual, DvzId canvas, //
+    uint32_t first, uint32_t count,  //
+    uint32_t first_instance, uint32_t instance_count)
+{
+    ANN(visual);
+
+    // NOTE: 1 item = 1 instance, the whole shape is drawn for each instance.
+    bool indexed = ((visual->flags & DVZ_VISUAL_FLAGS_INDEXED) != 0);
+    uint32_t n = indexed ? visual->index_count : visual->vertex_count;
+    dvz_visual_instance(visual, canvas, 0, 0, n, first, count);
+}
+
+
+
+// Default instances: no translation, no rotation, unit scale, white.
+static void _instanced_defaults(DvzVisual* visual, uint32_t first, uint32_t count)
+{
+    ANN(visual);
+    ANN(visual->instances.array);
+
+    DvzInstancedItem item = {
+        .pos = {0, 0, 0, 0},
+        .rotation = {0, 0, 0, 1},
+        .scale = {1, 1, 1, 0},
+        .color = {1, 1, 1, 1},
+    };
+    for (uint32_t i = first; i < first + count; i++)
+        memcpy(dvz_array_item(visual->instances.array, i), &item, sizeof(item));
+}
+
+
+
+// Create the instance storage buffer, or resize it if it already exists.
+static void _instanced_storage(DvzVisual* visual, uint32_t instance_count)
+{
+    ANN(visual);
+    ASSERT(instance_count > 0);
+
+    DvzDual* instances = &visual->instances;
+    uint32_t old_count = 0;
+    if (instances->array == NULL)
+    {
+        *instances = dvz_dual_storage(visual->batch, instance_count, sizeof(DvzInstancedItem), 0);
+        instances->need_destroy = true;
+        dvz_visual_dat(visual, SLOT_INSTANCES, instances->dat);
+    }
+    else
+    {
+        old_count = instances->array->item_count;
+        dvz_array_resize(instances->array, instance_count);
+        dvz_dual_resize(instances, instance_count);
+    }
+
+    // The new instances get the default values, and the whole buffer is uploaded as the dat
+    // contents may not be preserved.
+    if (instance_count > old_count)
+        _instanced_defaults(visual, old_count, instance_count - old_count);
+    dvz_dual_dirty(instances, 0, instance_count);
+}
+
+
+
+static void _instanced_column(
+    DvzVisual* visual, DvzSize offset, DvzSize col_size, uint32_t first, uint32_t count,
+    void* values)
+{
+    ANN(visual);
+    ANN(values);
+    if (visual->instances.array == NULL)
+    {
+        log_error("the instanced visual needs to be allocated with dvz_instanced_alloc() first");
+        return;
+    }
+    ASSERT(first + count <= visual->instances.array->item_count);
+    dvz_dual_column(&visual->instances, offset, col_size, first, count, 1, values);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzVisual* dvz_instanced(DvzBatch* batch, int flags)
+{
+    ANN(batch);
+
+    // NOTE: the shape is usually indexed.
+    DvzVisual* visual = dvz_visual(batch, DVZ_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, flags);
+    ANN(visual);
+
+    // Parse flags.
+    int lighting = (flags & DVZ_MESH_FLAGS_LIGHTING);
+    int flat = (flags & DVZ_MESH_FLAGS_FLAT);
+
+    // Visual shaders.
+    dvz_visual_shader(visual, "graphics_instanced");
+
+    // Enable depth test.
+    dvz_visual_depth(visual, DVZ_DEPTH_TEST_ENABLE);
+    dvz_visual_front(visual, DVZ_FRONT_FACE_COUNTER_CLOCKWISE);
+    dvz_visual_cull(visual, DVZ_CULL_MODE_NONE);
+
+    // Specialization constants.
+    dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 0, sizeof(int), &lighting);
+    dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 1, sizeof(int), &flat);
+
+    // Vertex attributes.
+    dvz_visual_attr(visual, 0, FIELD(DvzInstancedVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+    dvz_visual_attr(visual, 1, FIELD(DvzInstancedVertex, normal), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+    dvz_visual_attr(visual, 2, FIELD(DvzInstancedVertex, color), DVZ_FORMAT_COLOR, 0);
+
+    // Vertex stride.
+    dvz_visual_stride(visual, 0, sizeof(DvzInstancedVertex));
+
+    // Slots.
+    dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
+    dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
+    dvz_visual_slot(visual, SLOT_PARAMS, DVZ_SLOT_DAT);
+    dvz_set_slot(batch, visual->graphics_id, SLOT_INSTANCES, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+    // Params: same as the mesh visual, so that the dvz_mesh_light_*() functions can be used.
+    DvzParams* params = dvz_visual_params(visual, SLOT_PARAMS, sizeof(DvzMeshParams));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_LIGHT_DIR, FIELD(DvzMeshParams, light_dir));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_LIGHT_COLOR, FIELD(DvzMeshParams, light_color));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_LIGHT_PARAMS, FIELD(DvzMeshParams, light_params));
+
+    if (lighting > 0)
+    {
+        dvz_mesh_light_color(visual, 0, DEFAULT_LIGHT_COLOR);
+        dvz_mesh_light_dir(visual, 0, DEFAULT_LIGHT_DIR);
+        dvz_mesh_light_params(visual, 0, DEFAULT_LIGHT_PARAMS);
+    }
+
+    // Visual draw callback.
+    dvz_visual_callback(visual, _visual_callback);
+
+    return visual;
+}
+
+
+
+void dvz_instanced_alloc(DvzVisual* visual, DvzShape* shape, uint32_t instance_count)
+{
+    ANN(visual);
+    ANN(shape);
+    ANN(shape->pos);
+    ASSERT(instance_count > 0);
+
+    // Only the finest level of detail is drawn.
+    uint32_t vertex_count = shape->vertex_count;
+    uint32_t index_first = shape->lod_count > 0 ? shape->lod_first[0] : 0;
+    uint32_t index_count = shape->lod_count > 0 ? shape->lod_index_count[0] : shape->index_count;
+    ASSERT(vertex_count > 0);
+
+    bool indexed = (visual->flags & DVZ_VISUAL_FLAGS_INDEXED) != 0;
+    if (indexed != (index_count > 0))
+    {
+        log_error(
+            "the instanced visual should be created with `DVZ_VISUAL_FLAGS_INDEXED` if and only "
+            "if the shape has indices");
+        return;
+    }
+
+    // NOTE: 1 item = 1 instance.
+    dvz_visual_alloc(visual, instance_count, vertex_count, index_count);
+
+    // Upload the shape, again after a resize as the dat contents may not be preserved.
+    dvz_visual_data(visual, 0, 0, vertex_count, shape->pos);
+    if (shape->normal != NULL)
+        dvz_visual_data(visual, 1, 0, vertex_count, shape->normal);
+    if (shape->color != NULL)
+    {
+        dvz_visual_data(visual, 2, 0, vertex_count, shape->color);
+    }
+    else
+    {
+        // Without vertex colors, the instance colors are used as they are.
+        DvzColor* white = (DvzColor*)calloc(vertex_count, sizeof(DvzColor));
+        ANN(white);
+        for (uint32_t i = 0; i < vertex_count; i++)
+            memcpy(white[i], DVZ_WHITE, sizeof(DvzColor));
+        dvz_visual_data(visual, 2, 0, vertex_count, white);
+        FREE(white);
+    }
+    if (index_count > 0)
+        dvz_visual_index(visual, 0, index_count, &shape->index[index_first]);
+
+    _instanced_storage(visual, instance_count);
+}
+
+
+
+void dvz_instanced_position(
+    DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
+{
+    _instanced_column(
+        visual, offsetof(DvzInstancedItem, pos), sizeof(vec3), first, count, (void*)values);
+}
+
+
+
+void dvz_instanced_rotation(
+    DvzVisual* visual, uint32_t first, uint32_t count, vec4* values, int flags)
+{
+    _instanced_column(
+        visual, offsetof(DvzInstancedItem, rotation), sizeof(vec4), first, count, (void*)values);
+}
+
+
+
+void dvz_instanced_scale(DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
+{
+    _instanced_column(
+        visual, offsetof(DvzInstancedItem, scale), sizeof(vec3), first, count, (void*)values);
+}
+
+
+
+void dvz_instanced_color(
+    DvzVisual* visual, uint32_t first, uint32_t count, DvzColor* values, int flags)
+{
+    ANN(visual);
+    ANN(values);
+    if (visual->instances.array == NULL)
+    {
+        log_error("the instanced visual needs to be allocated with dvz_instanced_alloc() first");
+        return;
+    }
+    ASSERT(first + count <= visual->instances.array->item_count);
+
+    // The colors are stored as floats in the storage buffer.
+    DvzInstancedItem* items = (DvzInstancedItem*)visual->instances.array->data;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t k = 0; k < 4; k++)
+        {
+#if DVZ_COLOR_CVEC4
+            items[first + i].color[k] = values[i][k] / 255.0f;
+#else
+            items[first + i].color[k] = values[i][k];
+#endif
+        }
+    }
+    dvz_dual_dirty(&visual->instances, first, count);
+}
@@ -36,6 +36,39 @@
 /*  Internal functions */
 /*************************************************************************************************/
 
+static inline bool _is_quantized(DvzVisual* visual)
+{
+    ANN(visual);
+    return (visual->flags & DVZ_VISUAL_FLAGS_QUANTIZED) != 0;
+}
+
+
+
+// Quantized angles are stored as angle / pi in snorm16, so they must be wrapped in [-pi, +pi].
+static void _marker_angle_quantized(DvzVisual* visual, uint32_t first, uint32_t count, float* values)
+{
+    ANN(visual);
+    ANN(values);
+
+    bool in_range = true;
+    for (uint32_t i = 0; i < count && in_range; i++)
+        in_range = fabsf(values[i]) <= M_PI;
+
+    float* wrapped = values;
+    if (!in_range)
+    {
+        wrapped = (float*)malloc(count * sizeof(float));
+        ANN(wrapped);
+        for (uint32_t i = 0; i < count; i++)
+            wrapped[i] = remainderf(values[i], (float)(2 * M_PI));
+    }
+
+    dvz_visual_quantize(visual, 2, first, count, (float)(1.0 / M_PI), wrapped);
+
+    if (wrapped != values)
+        FREE(wrapped);
+}
+
 
 
 /*************************************************************************************************/
@@ -46,6 +79,14 @@ DvzVisual* dvz_marker(DvzBatch* batch, int flags)
 {
     ANN(batch);
 
+    // Quantized positions are already compact, double precision does not apply.
+    if ((flags & DVZ_VISUAL_FLAGS_QUANTIZED) != 0 &&
+        (flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        log_warn("double precision is not supported with quantized marker positions");
+        flags &= ~DVZ_VISUAL_FLAGS_DOUBLE_PRECISION;
+    }
+
     DvzVisual* visual = dvz_visual(batch, DVZ_PRIMITIVE_TOPOLOGY_POINT_LIST, flags);
     ANN(visual);
 
@@ -53,13 +94,38 @@ DvzVisual* dvz_marker(DvzBatch* batch, int flags)
     dvz_visual_shader(visual, "graphics_marker");
 
     // Vertex attributes.
-    dvz_visual_attr(visual, 0, FIELD(DvzMarkerVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
-    dvz_visual_attr(visual, 1, FIELD(DvzMarkerVertex, size), DVZ_FORMAT_R32_SFLOAT, 0);
-    dvz_visual_attr(visual, 2, FIELD(DvzMarkerVertex, angle), DVZ_FORMAT_R32_SFLOAT, 0);
-    dvz_visual_attr(visual, 3, FIELD(DvzMarkerVertex, color), DVZ_FORMAT_COLOR, 0);
-
-    // Vertex stride.
-    dvz_visual_stride(visual, 0, sizeof(DvzMarkerVertex));
+    if (_is_quantized(visual))
+    {
+        dvz_visual_attr(
+            visual, 0, FIELD(DvzMarkerVertexQuantized, pos), DVZ_FORMAT_R16G16B16A16_SNORM, 0);
+        dvz_visual_attr(
+            visual, 1, FIELD(DvzMarkerVertexQuantized, size), DVZ_FORMAT_R16_SFLOAT, 0);
+        dvz_visual_attr(
+            visual, 2, FIELD(DvzMarkerVertexQuantized, angle), DVZ_FORMAT_R16_SNORM, 0);
+        dvz_visual_attr(visual, 3, FIELD(DvzMarkerVertexQuantized, color), DVZ_FORMAT_COLOR, 0);
+        dvz_visual_stride(visual, 0, sizeof(DvzMarkerVertexQuantized));
+
+        // The vertex shader decodes the angle from [-1, +1] to [-pi, +pi].
+        dvz_visual_specialization(
+            visual, DVZ_SHADER_VERTEX, DVZ_SPECIALIZATION_QUANTIZE, sizeof(int32_t),
+            (int32_t[]){DVZ_QUANTIZE_ANGLE});
+    }
+    else
+    {
+        dvz_visual_attr(visual, 0, FIELD(DvzMarkerVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+        dvz_visual_attr(visual, 1, FIELD(DvzMarkerVertex, size), DVZ_FORMAT_R32_SFLOAT, 0);
+        dvz_visual_attr(visual, 2, FIELD(DvzMarkerVertex, angle), DVZ_FORMAT_R32_SFLOAT, 0);
+        dvz_visual_attr(visual, 3, FIELD(DvzMarkerVertex, color), DVZ_FORMAT_COLOR, 0);
+        dvz_visual_stride(visual, 0, sizeof(DvzMarkerVertex));
+    }
+
+    // Low parts of the double-single positions, in a separate vertex binding.
+    if ((flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        dvz_visual_attr(
+            visual, 4, 0, sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, DVZ_ATTR_FLAGS_DYNAMIC);
+        dvz_visual_stride(visual, 1, sizeof(vec3));
+    }
 
     // Uniforms.
     dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
@@ -67,6 +133,14 @@ DvzVisual* dvz_marker(DvzBatch* batch, int flags)
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 3, DVZ_SLOT_TEX);
 
+    // Decoding of the quantized positions.
+    if (_is_quantized(visual))
+        dvz_visual_quantize_slot(visual, 4);
+
+    // Per-item mask.
+    if ((flags & DVZ_VISUAL_FLAGS_MASK) != 0)
+        dvz_visual_mask_slot(visual, _is_quantized(visual) ? 5 : 4);
+
     // Params.
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzMarkerParams));
     dvz_params_attr(params, 0, FIELD(DvzMarkerParams, edge_color));
@@ -135,7 +209,19 @@ void dvz_marker_position(
     DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
 {
     ANN(visual);
-    dvz_visual_data(visual, 0, first, count, (void*)values);
+    if (_is_quantized(visual))
+        dvz_visual_quantize(visual, 0, first, count, 1, (float*)values);
+    else
+        dvz_visual_data(visual, 0, first, count, (void*)values);
+}
+
+
+
+void dvz_marker_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* values, int flags)
+{
+    ANN(visual);
+    dvz_visual_data_double(visual, 0, 4, first, count, values);
 }
 
 
@@ -143,7 +229,10 @@ void dvz_marker_position(
 void dvz_marker_size(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
     ANN(visual);
-    dvz_visual_data(visual, 1, first, count, (void*)values);
+    if (_is_quantized(visual))
+        dvz_visual_quantize(visual, 1, first, count, 1, values);
+    else
+        dvz_visual_data(visual, 1, first, count, (void*)values);
 }
 
 
@@ -151,7 +240,10 @@ void dvz_marker_size(DvzVisual* visual, uint32_t first, uint32_t count, float* v
 void dvz_marker_angle(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
     ANN(visual);
-    dvz_visual_data(visual, 2, first, count, (void*)values);
+    if (_is_quantized(visual))
+        _marker_angle_quantized(visual, first, count, values);
+    else
+        dvz_visual_data(visual, 2, first, count, (void*)values);
 }
 
 
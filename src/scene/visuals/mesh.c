@@ -21,8 +21,10 @@
 #include "datoviz_protocol.h"
 #include "datoviz_types.h"
 #include "fileio.h"
+#include "scene/array.h"
 #include "scene/baker.h"
 #include "scene/graphics.h"
+#include "scene/meshopt.h"
 #include "scene/scene.h"
 #include "scene/viewset.h"
 #include "scene/visual.h"
@@ -49,12 +51,32 @@
 #define DEFAULT_LIGHT_PARAMS                                                                      \
     (vec4) { .3, .7, .4, 16 }
 
+// Storage buffers of the wireframe mode.
+#define SLOT_VERTICES 4
+#define SLOT_INDICES  5
+#define SLOT_EDGES    6
+
+// All edges of a face are drawn in wireframe mode by default.
+#define EDGES_ALL 0x07
+
 
 
 /*************************************************************************************************/
 /*  Internal functions                                                                           */
 /*************************************************************************************************/
 
+static void* _get_param(DvzVisual* visual, uint32_t slot_idx, uint32_t attr_idx)
+{
+    ANN(visual);
+
+    DvzParams* params = visual->params[slot_idx];
+    ANN(params);
+
+    return dvz_params_get(params, attr_idx);
+}
+
+
+
 static void _visual_callback(
     DvzVisual* visual, DvzId canvas, //
     uint32_t first, uint32_t count,  //
@@ -71,19 +93,82 @@ static void _visual_callback(
         count *= 3;
     }
 
+    // With levels of detail, draw the range of the index buffer of the current level.
+    if (indexed && visual->lod_count > 0)
+    {
+        ASSERT(visual->lod_level < visual->lod_count);
+        first = visual->lod_first[visual->lod_level];
+        count = visual->lod_index_count[visual->lod_level];
+    }
+
     dvz_visual_instance(visual, canvas, first, 0, count, first_instance, instance_count);
 }
 
 
 
-static void* _get_param(DvzVisual* visual, uint32_t slot_idx, uint32_t attr_idx)
+// The wireframe fragment shader needs the global face index, but gl_PrimitiveID restarts at 0 at
+// every draw call: the offset of the first face of the level of detail is passed as a parameter.
+static void _lod_callback(DvzVisual* visual, uint32_t level)
 {
     ANN(visual);
 
-    DvzParams* params = visual->params[slot_idx];
-    ANN(params);
+    uint32_t face_offset = visual->lod_count > 0 ? visual->lod_first[level] / 3 : 0;
+    dvz_visual_param(visual, 2, DVZ_MESH_PARAMS_FACE_OFFSET, &face_offset);
+}
 
-    return dvz_params_get(params, attr_idx);
+
+
+// The isoline and contour attributes are not declared in wireframe mode.
+static bool _has_contour_attrs(DvzVisual* visual, const char* name)
+{
+    ANN(visual);
+    if ((visual->flags & DVZ_MESH_FLAGS_WIREFRAME) != 0)
+    {
+        log_warn("%s() is not supported by a mesh with the DVZ_MESH_FLAGS_WIREFRAME flag", name);
+        return false;
+    }
+    return true;
+}
+
+
+
+// Bind the vertex and index buffers as storage buffers for the wireframe fragment shader, and
+// (re)create the per-face edge flags, with all edges drawn.
+static void _wireframe_alloc(DvzVisual* visual, uint32_t face_count)
+{
+    ANN(visual);
+    ASSERT(face_count > 0);
+
+    DvzBaker* baker = visual->baker;
+    ANN(baker);
+
+    DvzId vertices = baker->vertex_bindings[0].dual.dat;
+    DvzId indices = baker->index.dat;
+    ASSERT(vertices != DVZ_ID_NONE);
+
+    // NOTE: non-indexed meshes bind the vertex buffer twice as the shader does not use indices.
+    uint32_t index_size = indices != DVZ_ID_NONE ? (uint32_t)baker->index_size : 0;
+    uint32_t vertex_stride = (uint32_t)(baker->vertex_bindings[0].stride / sizeof(float));
+    dvz_visual_param(visual, 2, DVZ_MESH_PARAMS_INDEX_SIZE, &index_size);
+    dvz_visual_param(visual, 2, DVZ_MESH_PARAMS_VERTEX_STRIDE, &vertex_stride);
+    dvz_visual_dat(visual, SLOT_VERTICES, vertices);
+    dvz_visual_dat(visual, SLOT_INDICES, index_size > 0 ? indices : vertices);
+
+    // One byte per face, padded to 4-byte words.
+    uint32_t count = 4 * ((face_count + 3) / 4);
+    if (visual->edges.array == NULL)
+    {
+        visual->edges = dvz_dual_storage(visual->batch, count, sizeof(uint8_t), 0);
+        visual->edges.need_destroy = true;
+    }
+    else
+    {
+        dvz_array_resize(visual->edges.array, count);
+        dvz_dual_resize(&visual->edges, count);
+    }
+    memset(visual->edges.array->data, EDGES_ALL, count);
+    dvz_dual_dirty(&visual->edges, 0, count);
+    dvz_visual_dat(visual, SLOT_EDGES, visual->edges.dat);
 }
 
 
@@ -104,10 +189,28 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     int lighting = (flags & DVZ_MESH_FLAGS_LIGHTING);
     int contour = (flags & DVZ_MESH_FLAGS_CONTOUR);
     int isoline = (flags & DVZ_MESH_FLAGS_ISOLINE);
+    int flat = (flags & DVZ_MESH_FLAGS_FLAT);
+    int wireframe = (flags & DVZ_MESH_FLAGS_WIREFRAME);
     log_trace("create mesh visual, texture: %d, lighting: %d", textured, lighting);
 
-    // Visual shaders.
-    dvz_visual_shader(visual, "graphics_mesh");
+    // Visual shaders. The wireframe mode has its own shaders: the fragment shader fetches the
+    // vertices of the current triangle from the vertex and index buffers with gl_PrimitiveID.
+    if (wireframe)
+    {
+        unsigned long size = 0;
+        unsigned char* buffer = dvz_resource_shader("graphics_mesh_wireframe_vert", &size);
+        dvz_visual_spirv(visual, DVZ_SHADER_VERTEX, size, buffer);
+        buffer = dvz_resource_shader("graphics_mesh_wireframe_frag", &size);
+        dvz_visual_spirv(visual, DVZ_SHADER_FRAGMENT, size, buffer);
+    }
+    else
+    {
+        dvz_visual_shader(visual, "graphics_mesh");
+    }
+
+    // NOTE: the wireframe fragment shader reads the index buffer as 4-byte words, 32-bit indices
+    // avoid reading past the end of a 16-bit index buffer with an odd number of indices.
+    visual->baker->index32 = wireframe != 0;
 
     // Enable depth test.
     dvz_visual_depth(visual, DVZ_DEPTH_TEST_ENABLE);
@@ -119,9 +222,33 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 1, sizeof(int), &lighting);
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 2, sizeof(int), &contour);
     dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 3, sizeof(int), &isoline);
+    dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 4, sizeof(int), &flat);
 
+    // Wireframe vertex, without the isoline and contour attributes.
+    if (wireframe)
+    {
+        // Vertex attributes.
+        dvz_visual_attr( //
+            visual, 0, FIELD(DvzMeshWireframeColorVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+        dvz_visual_attr( //
+            visual, 1, FIELD(DvzMeshWireframeColorVertex, normal), DVZ_FORMAT_R32G32B32_SFLOAT,
+            0);
+        if (textured)
+            dvz_visual_attr(
+                visual, 2, FIELD(DvzMeshWireframeTexturedVertex, texcoords),
+                DVZ_FORMAT_R32G32B32A32_SFLOAT, 0);
+        else
+            dvz_visual_attr( //
+                visual, 2, FIELD(DvzMeshWireframeColorVertex, color), DVZ_FORMAT_COLOR, 0);
+
+        // Vertex stride.
+        dvz_visual_stride(
+            visual, 0,
+            textured ? sizeof(DvzMeshWireframeTexturedVertex)
+                     : sizeof(DvzMeshWireframeColorVertex));
+    }
     // Textured vertex.
-    if (textured)
+    else if (textured)
     {
         // Vertex attributes.
         dvz_visual_attr( //
@@ -170,6 +297,12 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 2, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 3, DVZ_SLOT_TEX);
+    if (wireframe)
+    {
+        dvz_set_slot(batch, visual->graphics_id, SLOT_VERTICES, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        dvz_set_slot(batch, visual->graphics_id, SLOT_INDICES, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        dvz_set_slot(batch, visual->graphics_id, SLOT_EDGES, DVZ_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    }
 
     // Params.
     DvzParams* params = dvz_visual_params(visual, 2, sizeof(DvzMeshParams));
@@ -178,6 +311,9 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
     dvz_params_attr(params, DVZ_MESH_PARAMS_LIGHT_PARAMS, FIELD(DvzMeshParams, light_params));
     dvz_params_attr(params, DVZ_MESH_PARAMS_STROKE, FIELD(DvzMeshParams, stroke));
     dvz_params_attr(params, DVZ_MESH_PARAMS_ISOLINE_COUNT, FIELD(DvzMeshParams, isoline_count));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_FACE_OFFSET, FIELD(DvzMeshParams, face_offset));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_INDEX_SIZE, FIELD(DvzMeshParams, index_size));
+    dvz_params_attr(params, DVZ_MESH_PARAMS_VERTEX_STRIDE, FIELD(DvzMeshParams, vertex_stride));
 
     // Default texture to avoid Vulkan warning with unbound texture slot.
     dvz_visual_tex(
@@ -196,6 +332,8 @@ DvzVisual* dvz_mesh(DvzBatch* batch, int flags)
 
     // Visual draw callback.
     dvz_visual_callback(visual, _visual_callback);
+    if (wireframe)
+        dvz_visual_lod_callback(visual, _lod_callback);
 
     return visual;
 }
@@ -217,6 +355,9 @@ void dvz_mesh_alloc(DvzVisual* visual, uint32_t vertex_count, uint32_t index_cou
     // NOTE: by convention in this visual, 1 item = 1 triangle.
     // This is why item_count is index_count / 3 below.
     dvz_visual_alloc(visual, index_count / 3, vertex_count, index_count);
+
+    if ((visual->flags & DVZ_MESH_FLAGS_WIREFRAME) != 0)
+        _wireframe_alloc(visual, index_count > 0 ? index_count / 3 : vertex_count / 3);
 }
 
 
@@ -279,6 +420,8 @@ void dvz_mesh_texcoords(DvzVisual* visual, uint32_t first, uint32_t count, vec4*
 void dvz_mesh_isoline(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
     ANN(visual);
+    if (!_has_contour_attrs(visual, "dvz_mesh_isoline"))
+        return;
     dvz_visual_data(visual, 3, first, count, (void*)values);
 }
 
@@ -287,6 +430,8 @@ void dvz_mesh_isoline(DvzVisual* visual, uint32_t first, uint32_t count, float*
 void dvz_mesh_left(DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
 {
     ANN(visual);
+    if (!_has_contour_attrs(visual, "dvz_mesh_left"))
+        return;
     dvz_visual_data(visual, 4, first, count, (void*)values);
 }
 
@@ -295,6 +440,8 @@ void dvz_mesh_left(DvzVisual* visual, uint32_t first, uint32_t count, vec3* valu
 void dvz_mesh_right(DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
 {
     ANN(visual);
+    if (!_has_contour_attrs(visual, "dvz_mesh_right"))
+        return;
     dvz_visual_data(visual, 5, first, count, (void*)values);
 }
 
@@ -303,11 +450,28 @@ void dvz_mesh_right(DvzVisual* visual, uint32_t first, uint32_t count, vec3* val
 void dvz_mesh_contour(DvzVisual* visual, uint32_t first, uint32_t count, cvec4* values, int flags)
 {
     ANN(visual);
+    if (!_has_contour_attrs(visual, "dvz_mesh_contour"))
+        return;
     dvz_visual_data(visual, 6, first, count, (void*)values);
 }
 
 
 
+void dvz_mesh_edges(DvzVisual* visual, uint32_t first, uint32_t count, uint8_t* values)
+{
+    ANN(visual);
+    ANN(values);
+    if (visual->edges.array == NULL)
+    {
+        log_warn("dvz_mesh_edges() requires a mesh with the DVZ_MESH_FLAGS_WIREFRAME flag");
+        return;
+    }
+    ASSERT(first + count <= visual->edges.array->item_count);
+    dvz_dual_data(&visual->edges, first, count, (void*)values);
+}
+
+
+
 void dvz_mesh_texture(
     DvzVisual* visual, DvzId tex, DvzFilter filter, DvzSamplerAddressMode address_mode)
 {
@@ -496,6 +660,10 @@ void dvz_mesh_reshape(DvzVisual* visual, DvzShape* shape)
     uint32_t index_count = shape->index_count;
     ASSERT(vertex_count > 0);
 
+    // NOTE: this modifies the shape in place.
+    if ((visual->flags & DVZ_MESH_FLAGS_OPTIMIZE) != 0 && index_count > 0)
+        dvz_shape_optimize(shape);
+
     dvz_mesh_alloc(visual, vertex_count, index_count);
 
     dvz_mesh_position(visual, 0, vertex_count, shape->pos, 0);
@@ -509,18 +677,43 @@ void dvz_mesh_reshape(DvzVisual* visual, DvzShape* shape)
     if (shape->texcoords && (visual->flags & DVZ_MESH_FLAGS_TEXTURED))
         dvz_mesh_texcoords(visual, 0, vertex_count, shape->texcoords, 0);
 
-    if (shape->isoline)
+    bool wireframe = (visual->flags & DVZ_MESH_FLAGS_WIREFRAME) != 0;
+
+    if (shape->isoline && !wireframe)
         dvz_mesh_isoline(visual, 0, vertex_count, shape->isoline, 0);
 
-    if (shape->d_left)
+    if (shape->d_left && !wireframe)
         dvz_mesh_left(visual, 0, vertex_count, shape->d_left, 0);
 
-    if (shape->d_right)
+    if (shape->d_right && !wireframe)
         dvz_mesh_right(visual, 0, vertex_count, shape->d_right, 0);
 
-    if (shape->contour)
+    if (shape->contour && !wireframe)
         dvz_mesh_contour(visual, 0, vertex_count, shape->contour, 0);
 
     if (shape->index_count > 0)
         dvz_mesh_index(visual, 0, index_count, shape->index, 0);
+
+    // Wireframe contour: only draw the border edges, separately for each level of detail.
+    if (wireframe && (visual->flags & DVZ_MESH_FLAGS_CONTOUR) != 0 && index_count > 0)
+    {
+        uint8_t* borders = (uint8_t*)calloc(index_count / 3, sizeof(uint8_t));
+        ANN(borders);
+        if (shape->lod_count == 0)
+            dvz_meshopt_borders(index_count, shape->index, borders);
+        for (uint32_t i = 0; i < shape->lod_count; i++)
+            dvz_meshopt_borders(
+                shape->lod_index_count[i], &shape->index[shape->lod_first[i]],
+                &borders[shape->lod_first[i] / 3]);
+        dvz_mesh_edges(visual, 0, index_count / 3, borders);
+        FREE(borders);
+    }
+
+    // Levels of detail.
+    vec4 sphere = {0};
+    if (shape->lod_count > 0)
+        dvz_meshopt_sphere(vertex_count, shape->pos, sphere);
+    dvz_visual_lod(
+        visual, shape->lod_count, shape->lod_first, shape->lod_index_count, shape->lod_error,
+        sphere);
 }
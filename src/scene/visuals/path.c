@@ -47,6 +47,81 @@ static void _visual_callback(
 
 
 
+static uint32_t* _path_indices(
+    DvzVisual* visual, uint32_t point_count, uint32_t path_count, uint32_t* path_lengths,
+    uint32_t* out_total_length)
+{
+    ANN(visual);
+    ANN(out_total_length);
+
+    bool closed = (visual->flags & DVZ_PATH_FLAGS_CLOSED) > 0;
+
+    uint32_t path_lengths_1[1] = {point_count};
+    if (path_count <= 1)
+    {
+        path_count = 1;
+        path_lengths = path_lengths_1;
+    }
+
+    // Compute the total number of vertices, which is the sum of all path lengths.
+    uint32_t total_length = 0;
+    int32_t l = 0;
+    for (uint32_t i = 0; i < path_count; i++)
+    {
+        l = (int32_t)path_lengths[i];
+        total_length += (uint32_t)l;
+    }
+
+    // For each path point, the indices of the previous, current, next, and next-next points.
+    uint32_t k = 0;
+    uint32_t src_offset = 0;
+    int32_t i0 = 0, i1 = 0, i2 = 0, i3 = 0;
+    uint32_t* indices = (uint32_t*)calloc(4 * total_length, sizeof(uint32_t));
+    for (uint32_t j = 0; j < path_count; j++)
+    {
+        l = (int32_t)path_lengths[j];
+        for (int32_t i = 0; i < l; i++)
+        {
+            i0 = i - 1;
+            i1 = i + 0;
+            i2 = i + 1;
+            i3 = i + 2;
+
+            if (!closed)
+            {
+                i0 = MAX(i0, 0);
+                i2 = MIN(i2, l - 1);
+                i3 = MIN(i3, l - 1);
+            }
+            else
+            {
+                i0 = i0 < 0 ? i0 + l : i0;
+                i2 = i2 >= l ? i2 - l : i2;
+                i3 = i3 >= l ? i3 - l : i3;
+            }
+
+            ASSERT(0 <= i0 && i0 < l);
+            ASSERT(0 <= i1 && i1 < l);
+            ASSERT(0 <= i2 && i2 < l);
+            ASSERT(0 <= i3 && i3 < l);
+
+            indices[4 * k + 0] = src_offset + (uint32_t)i0;
+            indices[4 * k + 1] = src_offset + (uint32_t)i1;
+            indices[4 * k + 2] = src_offset + (uint32_t)i2;
+            indices[4 * k + 3] = src_offset + (uint32_t)i3;
+
+            k++;
+        }
+        src_offset += (uint32_t)l;
+    }
+    ASSERT(k == total_length);
+
+    *out_total_length = total_length;
+    return indices;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -74,6 +149,16 @@ DvzVisual* dvz_path(DvzBatch* batch, int flags)
     dvz_visual_attr(visual, 3, FIELD(DvzPathVertex, p3), DVZ_FORMAT_R32G32B32_SFLOAT, attr_flag);
     dvz_visual_attr(visual, 4, FIELD(DvzPathVertex, color), DVZ_FORMAT_COLOR, attr_flag);
 
+    // Low parts of the double-single positions, in a separate vertex binding.
+    if ((flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        int lf = attr_flag | DVZ_ATTR_FLAGS_DYNAMIC;
+        for (uint32_t i = 0; i < 4; i++)
+            dvz_visual_attr(
+                visual, 5 + i, i * sizeof(vec3), sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, lf);
+        dvz_visual_stride(visual, 1, 4 * sizeof(vec3));
+    }
+
     // Uniforms.
     dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
@@ -123,81 +208,47 @@ void dvz_path_position(
     ANN(positions);
     ASSERT(point_count > 0);
 
-    bool closed = (visual->flags & DVZ_PATH_FLAGS_CLOSED) > 0;
+    uint32_t total_length = 0;
+    uint32_t* indices = _path_indices(visual, point_count, path_count, path_lengths, &total_length);
 
-    uint32_t path_lengths_1[1] = {point_count};
-    if (path_count <= 1)
+    // NOTE: we did not use REPEAT attr flag for position as we do the repeat manually with a
+    // shift.
+    vec3* p = (vec3*)calloc(total_length, sizeof(vec3));
+    for (uint32_t j = 0; j < 4; j++)
     {
-        path_count = 1;
-        path_lengths = path_lengths_1;
+        for (uint32_t k = 0; k < total_length; k++)
+            _vec3_copy(positions[indices[4 * k + j]], p[k]);
+        dvz_visual_data(visual, j, 0, total_length, (void*)p);
     }
 
-    // Compute the total number of vertices, which is the sum of all path lengths.
-    uint32_t total_length = 0;
-    int32_t l = 0;
-    for (uint32_t i = 0; i < path_count; i++)
-    {
-        l = (int32_t)path_lengths[i];
-        total_length += (uint32_t)l;
-    }
+    FREE(p);
+    FREE(indices);
+}
 
-    uint32_t k = 0;
-    uint32_t src_offset = 0;
-    int32_t i0 = 0, i1 = 0, i2 = 0, i3 = 0;
-    vec3* p0 = (vec3*)calloc(total_length, sizeof(vec3));
-    vec3* p1 = (vec3*)calloc(total_length, sizeof(vec3));
-    vec3* p2 = (vec3*)calloc(total_length, sizeof(vec3));
-    vec3* p3 = (vec3*)calloc(total_length, sizeof(vec3));
-    for (uint32_t j = 0; j < path_count; j++)
-    {
-        l = (int32_t)path_lengths[j];
-        for (int32_t i = 0; i < l; i++)
-        {
-            i0 = i - 1;
-            i1 = i + 0;
-            i2 = i + 1;
-            i3 = i + 2;
 
-            if (!closed)
-            {
-                i0 = MAX(i0, 0);
-                i2 = MIN(i2, l - 1);
-                i3 = MIN(i3, l - 1);
-            }
-            else
-            {
-                i0 = i0 < 0 ? i0 + l : i0;
-                i2 = i2 >= l ? i2 - l : i2;
-                i3 = i3 >= l ? i3 - l : i3;
-            }
 
-            ASSERT(0 <= i0 && i0 < l);
-            ASSERT(0 <= i1 && i1 < l);
-            ASSERT(0 <= i2 && i2 < l);
-            ASSERT(0 <= i3 && i3 < l);
+void dvz_path_position_double(
+    DvzVisual* visual, uint32_t point_count, dvec3* positions, //
+    uint32_t path_count, uint32_t* path_lengths, int flags)
+{
+    ANN(visual);
+    ANN(positions);
+    ASSERT(point_count > 0);
 
-            _vec3_copy(positions[src_offset + (uint32_t)i0], p0[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i1], p1[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i2], p2[k]);
-            _vec3_copy(positions[src_offset + (uint32_t)i3], p3[k]);
+    uint32_t total_length = 0;
+    uint32_t* indices = _path_indices(visual, point_count, path_count, path_lengths, &total_length);
 
-            k++;
-        }
-        src_offset += (uint32_t)l;
+    // The low parts of p0, p1, p2, p3 go to the attributes 5, 6, 7, 8.
+    dvec3* p = (dvec3*)calloc(total_length, sizeof(dvec3));
+    for (uint32_t j = 0; j < 4; j++)
+    {
+        for (uint32_t k = 0; k < total_length; k++)
+            memcpy(p[k], positions[indices[4 * k + j]], sizeof(dvec3));
+        dvz_visual_data_double(visual, j, 5 + j, 0, total_length, p);
     }
-    ASSERT(k == total_length);
 
-    // NOTE: we did not use REPEAT attr flag for position as we do the repeat manually with a
-    // shift.
-    dvz_visual_data(visual, 0, 0, total_length, (void*)p0);
-    dvz_visual_data(visual, 1, 0, total_length, (void*)p1);
-    dvz_visual_data(visual, 2, 0, total_length, (void*)p2);
-    dvz_visual_data(visual, 3, 0, total_length, (void*)p3);
-
-    FREE(p0);
-    FREE(p1);
-    FREE(p2);
-    FREE(p3);
+    FREE(p);
+    FREE(indices);
 }
 
 
@@ -211,6 +262,39 @@ void dvz_path_color(DvzVisual* visual, uint32_t first, uint32_t count, DvzColor*
 
 
 
+void dvz_path_isolines(DvzVisual* visual, DvzIsolines* isolines, DvzColor* level_colors)
+{
+    ANN(visual);
+    ANN(isolines);
+    if (isolines->point_count == 0)
+    {
+        log_warn("no isolines to display");
+        return;
+    }
+
+    uint32_t n = isolines->point_count;
+    dvz_path_alloc(visual, n);
+    dvz_path_position(visual, n, isolines->pos, isolines->path_count, isolines->path_lengths, 0);
+
+    if (level_colors == NULL)
+        return;
+
+    // Each polyline gets the color of its level.
+    DvzColor* colors = (DvzColor*)calloc(n, sizeof(DvzColor));
+    ANN(colors);
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < isolines->path_count; i++)
+    {
+        for (uint32_t j = 0; j < isolines->path_lengths[i]; j++)
+            memcpy(colors[k++], level_colors[isolines->path_levels[i]], sizeof(DvzColor));
+    }
+    ASSERT(k == n);
+    dvz_path_color(visual, 0, n, colors, 0);
+    FREE(colors);
+}
+
+
+
 void dvz_path_linewidth(DvzVisual* visual, float width)
 {
     ANN(visual);
@@ -35,6 +35,12 @@
 /*  Internal functions                                                                           */
 /*************************************************************************************************/
 
+static inline bool _is_quantized(DvzVisual* visual)
+{
+    ANN(visual);
+    return (visual->flags & DVZ_VISUAL_FLAGS_QUANTIZED) != 0;
+}
+
 
 
 /*************************************************************************************************/
@@ -45,6 +51,14 @@ DvzVisual* dvz_point(DvzBatch* batch, int flags)
 {
     ANN(batch);
 
+    // Quantized positions are already compact, double precision does not apply.
+    if ((flags & DVZ_VISUAL_FLAGS_QUANTIZED) != 0 &&
+        (flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        log_warn("double precision is not supported with quantized point positions");
+        flags &= ~DVZ_VISUAL_FLAGS_DOUBLE_PRECISION;
+    }
+
     DvzVisual* visual = dvz_visual(batch, DVZ_PRIMITIVE_TOPOLOGY_POINT_LIST, flags);
     ANN(visual);
 
@@ -52,17 +66,43 @@ DvzVisual* dvz_point(DvzBatch* batch, int flags)
     dvz_visual_shader(visual, "graphics_point");
 
     // Vertex attributes.
-    dvz_visual_attr(visual, 0, FIELD(DvzPointVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
-    dvz_visual_attr(visual, 1, FIELD(DvzPointVertex, color), DVZ_FORMAT_COLOR, 0);
-    dvz_visual_attr(visual, 2, FIELD(DvzPointVertex, size), DVZ_FORMAT_R32_SFLOAT, 0);
-
-    // Vertex stride.
-    dvz_visual_stride(visual, 0, sizeof(DvzPointVertex));
+    if (_is_quantized(visual))
+    {
+        dvz_visual_attr(
+            visual, 0, FIELD(DvzPointVertexQuantized, pos), DVZ_FORMAT_R16G16B16A16_SNORM, 0);
+        dvz_visual_attr(visual, 1, FIELD(DvzPointVertexQuantized, color), DVZ_FORMAT_COLOR, 0);
+        dvz_visual_attr(
+            visual, 2, FIELD(DvzPointVertexQuantized, size), DVZ_FORMAT_R16_SFLOAT, 0);
+        dvz_visual_stride(visual, 0, sizeof(DvzPointVertexQuantized));
+    }
+    else
+    {
+        dvz_visual_attr(visual, 0, FIELD(DvzPointVertex, pos), DVZ_FORMAT_R32G32B32_SFLOAT, 0);
+        dvz_visual_attr(visual, 1, FIELD(DvzPointVertex, color), DVZ_FORMAT_COLOR, 0);
+        dvz_visual_attr(visual, 2, FIELD(DvzPointVertex, size), DVZ_FORMAT_R32_SFLOAT, 0);
+        dvz_visual_stride(visual, 0, sizeof(DvzPointVertex));
+    }
+
+    // Low parts of the double-single positions, in a separate vertex binding.
+    if ((flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        dvz_visual_attr(
+            visual, 3, 0, sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, DVZ_ATTR_FLAGS_DYNAMIC);
+        dvz_visual_stride(visual, 1, sizeof(vec3));
+    }
 
     // Uniforms.
     dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
 
+    // Decoding of the quantized positions.
+    if (_is_quantized(visual))
+        dvz_visual_quantize_slot(visual, 2);
+
+    // Per-item mask.
+    if ((flags & DVZ_VISUAL_FLAGS_MASK) != 0)
+        dvz_visual_mask_slot(visual, _is_quantized(visual) ? 3 : 2);
+
     return visual;
 }
 
@@ -85,7 +125,19 @@ void dvz_point_alloc(DvzVisual* visual, uint32_t item_count)
 void dvz_point_position(DvzVisual* visual, uint32_t first, uint32_t count, vec3* values, int flags)
 {
     ANN(visual);
-    dvz_visual_data(visual, 0, first, count, (void*)values);
+    if (_is_quantized(visual))
+        dvz_visual_quantize(visual, 0, first, count, 1, (float*)values);
+    else
+        dvz_visual_data(visual, 0, first, count, (void*)values);
+}
+
+
+
+void dvz_point_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* values, int flags)
+{
+    ANN(visual);
+    dvz_visual_data_double(visual, 0, 3, first, count, values);
 }
 
 
@@ -102,5 +154,8 @@ void dvz_point_color(
 void dvz_point_size(DvzVisual* visual, uint32_t first, uint32_t count, float* values, int flags)
 {
     ANN(visual);
-    dvz_visual_data(visual, 2, first, count, (void*)values);
+    if (_is_quantized(visual))
+        dvz_visual_quantize(visual, 2, first, count, 1, values);
+    else
+        dvz_visual_data(visual, 2, first, count, (void*)values);
 }
@@ -75,6 +75,15 @@ DvzVisual* dvz_segment(DvzBatch* batch, int flags)
     dvz_visual_attr(visual, 5, FIELD(DvzSegmentVertex, cap0), DVZ_FORMAT_R32_SINT, af);
     dvz_visual_attr(visual, 6, FIELD(DvzSegmentVertex, cap1), DVZ_FORMAT_R32_SINT, af);
 
+    // Low parts of the double-single positions, in a separate vertex binding.
+    if ((flags & DVZ_VISUAL_FLAGS_DOUBLE_PRECISION) != 0)
+    {
+        int lf = af | DVZ_ATTR_FLAGS_DYNAMIC;
+        dvz_visual_attr(visual, 7, 0, sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, lf);
+        dvz_visual_attr(visual, 8, sizeof(vec3), sizeof(vec3), DVZ_FORMAT_R32G32B32_SFLOAT, lf);
+        dvz_visual_stride(visual, 1, 2 * sizeof(vec3));
+    }
+
     // Uniforms.
     dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
     dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
@@ -125,6 +134,17 @@ void dvz_segment_position(
 
 
 
+void dvz_segment_position_double(
+    DvzVisual* visual, uint32_t first, uint32_t count, dvec3* initial, dvec3* terminal,
+    int flags)
+{
+    ANN(visual);
+    dvz_visual_data_double(visual, 0, 7, first, count, initial);
+    dvz_visual_data_double(visual, 1, 8, first, count, terminal);
+}
+
+
+
 void dvz_segment_shift(DvzVisual* visual, uint32_t first, uint32_t count, vec4* values, int flags)
 {
     ANN(visual);
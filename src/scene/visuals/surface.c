@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Surface                                                                                      */
+/*************************************************************************************************/
+
+// The surface visual has no vertex buffer: the vertex shader derives the grid cell and corner
+// from gl_VertexIndex (6 vertices per cell), fetches the heights from a 2D float texture, and
+// computes the normals by finite differences. Updating the heights is a texture upload.
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/visuals/surface.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "datoviz_types.h"
+#include "scene/graphics.h"
+#include "scene/scene.h"
+#include "scene/viewset.h"
+#include "scene/visual.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SLOT_PARAMS  2
+#define SLOT_HEIGHTS 3
+#define SLOT_SCALAR  4
+
+#define ADDRESS_MODE DVZ_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE
+
+#define DEFAULT_LIGHT_DIR                                                                         \
+    (vec3) { 0.25, -0.25, -1 }
+
+#define DEFAULT_LIGHT_PARAMS                                                                      \
+    (vec4) { .3, .7, .4, 16 }
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static void _visual_callback(
+    DvzVisual* visual, DvzId canvas, //
+    uint32_t first, uint32_t count,  //
+    uint32_t first_instance, uint32_t instance_count)
+{
+    ANN(visual);
+    // NOTE: 1 item = 1 grid cell = 2 triangles.
+    dvz_visual_instance(visual, canvas, 6 * first, 0, 6 * count, first_instance, instance_count);
+}
+
+
+
+static void* _get_param(DvzVisual* visual, uint32_t slot_idx, uint32_t attr_idx)
+{
+    ANN(visual);
+
+    DvzParams* params = visual->params[slot_idx];
+    ANN(params);
+
+    return dvz_params_get(params, attr_idx);
+}
+
+
+
+// Create the float texture bound to a slot, or resize it if it already exists.
+static void
+_surface_tex(DvzVisual* visual, uint32_t slot_idx, uint32_t row_count, uint32_t col_count)
+{
+    ANN(visual);
+
+    DvzBatch* batch = visual->batch;
+    ANN(batch);
+
+    uvec3 shape = {col_count, row_count, 1};
+    DvzId tex = visual->texs[slot_idx];
+    if (tex == DVZ_ID_NONE)
+    {
+        // NOTE: the shader uses texelFetch() so the sampler parameters are not used.
+        tex = dvz_create_tex(batch, DVZ_TEX_2D, DVZ_FORMAT_R32_SFLOAT, shape, 0).id;
+        DvzId sampler = dvz_create_sampler(batch, DVZ_FILTER_NEAREST, ADDRESS_MODE).id;
+        dvz_visual_tex(visual, slot_idx, tex, sampler, DVZ_ZERO_OFFSET);
+        visual->texs[slot_idx] = tex;
+    }
+    else
+    {
+        dvz_resize_tex(batch, tex, shape);
+    }
+
+    // Start with a flat surface.
+    DvzSize size = row_count * col_count * sizeof(float);
+    float* zeros = (float*)calloc(row_count * col_count, sizeof(float));
+    dvz_upload_tex(batch, tex, DVZ_ZERO_OFFSET, shape, size, zeros, 0);
+    FREE(zeros);
+}
+
+
+
+static void _surface_upload(
+    DvzVisual* visual, uint32_t slot_idx, uint32_t row, uint32_t col, uint32_t row_count,
+    uint32_t col_count, float* values)
+{
+    ANN(visual);
+    ANN(values);
+
+    DvzId tex = visual->texs[slot_idx];
+    if (tex == DVZ_ID_NONE)
+    {
+        log_error("the surface visual needs to be allocated with dvz_surface_alloc() first");
+        return;
+    }
+
+    ivec4* grid = _get_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID);
+    ANN(grid);
+    if (row + row_count > (uint32_t)grid[0][0] || col + col_count > (uint32_t)grid[0][1])
+    {
+        log_error(
+            "surface region (%d, %d) + (%d, %d) exceeds the grid size (%d, %d)", row, col,
+            row_count, col_count, grid[0][0], grid[0][1]);
+        return;
+    }
+
+    // A single sub-region upload, the grid topology and the normals are computed on the GPU.
+    uvec3 offset = {col, row, 0};
+    uvec3 shape = {col_count, row_count, 1};
+    DvzSize size = row_count * col_count * sizeof(float);
+    dvz_upload_tex(visual->batch, tex, offset, shape, size, values, 0);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzVisual* dvz_surface(DvzBatch* batch, int flags)
+{
+    ANN(batch);
+
+    DvzVisual* visual = dvz_visual(batch, DVZ_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, flags);
+    ANN(visual);
+
+    // Visual shaders.
+    dvz_visual_shader(visual, "graphics_surface");
+
+    // Enable depth test.
+    dvz_visual_depth(visual, DVZ_DEPTH_TEST_ENABLE);
+    dvz_visual_front(visual, DVZ_FRONT_FACE_COUNTER_CLOCKWISE);
+    dvz_visual_cull(visual, DVZ_CULL_MODE_NONE);
+
+    // Specialization constants.
+    int lighting = (flags & DVZ_SURFACE_FLAGS_LIGHTING) != 0;
+    dvz_visual_specialization(visual, DVZ_SHADER_FRAGMENT, 0, sizeof(int), &lighting);
+
+    // NOTE: no vertex attributes, the vertex shader only uses gl_VertexIndex.
+
+    // Slots.
+    dvz_visual_slot(visual, 0, DVZ_SLOT_DAT);
+    dvz_visual_slot(visual, 1, DVZ_SLOT_DAT);
+    dvz_visual_slot(visual, SLOT_PARAMS, DVZ_SLOT_DAT);
+    dvz_visual_slot(visual, SLOT_HEIGHTS, DVZ_SLOT_TEX);
+    dvz_visual_slot(visual, SLOT_SCALAR, DVZ_SLOT_TEX);
+
+    // Params.
+    DvzParams* params = dvz_visual_params(visual, SLOT_PARAMS, sizeof(DvzSurfaceParams));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_ORIGIN, FIELD(DvzSurfaceParams, origin));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_U, FIELD(DvzSurfaceParams, u));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_V, FIELD(DvzSurfaceParams, v));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_LIGHT_DIR, FIELD(DvzSurfaceParams, light_dir));
+    dvz_params_attr(
+        params, DVZ_SURFACE_PARAMS_LIGHT_PARAMS, FIELD(DvzSurfaceParams, light_params));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_RANGE, FIELD(DvzSurfaceParams, range));
+    dvz_params_attr(params, DVZ_SURFACE_PARAMS_GRID, FIELD(DvzSurfaceParams, grid));
+
+    // Default textures to avoid Vulkan warning with unbound texture slots.
+    dvz_visual_tex(
+        visual, SLOT_HEIGHTS, DVZ_SCENE_DEFAULT_TEX_ID, DVZ_SCENE_DEFAULT_SAMPLER_ID,
+        DVZ_ZERO_OFFSET);
+    dvz_visual_tex(
+        visual, SLOT_SCALAR, DVZ_SCENE_DEFAULT_TEX_ID, DVZ_SCENE_DEFAULT_SAMPLER_ID,
+        DVZ_ZERO_OFFSET);
+
+    // Default parameters.
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_ORIGIN, (vec4){-1, 0, -1, 0});
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_U, (vec4){0, 0, 0, 0});
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_V, (vec4){0, 0, 0, 0});
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID, (ivec4){0, 0, 0, 0});
+    dvz_surface_colormap(visual, DVZ_CMAP_VIRIDIS, 0, 1);
+    dvz_surface_light_dir(visual, DEFAULT_LIGHT_DIR);
+    dvz_surface_light_params(visual, DEFAULT_LIGHT_PARAMS);
+
+    // Visual draw callback.
+    dvz_visual_callback(visual, _visual_callback);
+
+    return visual;
+}
+
+
+
+void dvz_surface_alloc(DvzVisual* visual, uint32_t row_count, uint32_t col_count)
+{
+    ANN(visual);
+    ASSERT(row_count >= 2);
+    ASSERT(col_count >= 2);
+    log_debug("allocating the surface visual, %d rows, %d columns", row_count, col_count);
+
+    // NOTE: by convention in this visual, 1 item = 1 grid cell. There is no vertex buffer, the
+    // vertex count is only used to compute the draw call size.
+    uint32_t cell_count = (row_count - 1) * (col_count - 1);
+    dvz_visual_alloc(visual, cell_count, 6 * cell_count, 0);
+
+    // Grid size, used by the vertex shader to map gl_VertexIndex to the grid.
+    ivec4* grid = _get_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID);
+    ANN(grid);
+    ivec4 size = {(int32_t)row_count, (int32_t)col_count, grid[0][2], 0};
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID, size);
+
+    // Height texture, and scalar texture if needed. Otherwise the colormap applies to the
+    // heights, the height texture is bound to both slots.
+    _surface_tex(visual, SLOT_HEIGHTS, row_count, col_count);
+    if ((visual->flags & DVZ_SURFACE_FLAGS_SCALAR) != 0)
+    {
+        _surface_tex(visual, SLOT_SCALAR, row_count, col_count);
+    }
+    else if (visual->texs[SLOT_SCALAR] == DVZ_ID_NONE)
+    {
+        DvzId tex = visual->texs[SLOT_HEIGHTS];
+        DvzId sampler = dvz_create_sampler(visual->batch, DVZ_FILTER_NEAREST, ADDRESS_MODE).id;
+        dvz_visual_tex(visual, SLOT_SCALAR, tex, sampler, DVZ_ZERO_OFFSET);
+        visual->texs[SLOT_SCALAR] = tex;
+    }
+
+    // Default grid spanning [-1, +1] in the xz plane, heights along the y axis.
+    vec4* u = _get_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_U);
+    vec4* v = _get_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_V);
+    if (glm_vec3_norm(u[0]) == 0 && glm_vec3_norm(v[0]) == 0)
+    {
+        dvz_surface_grid(
+            visual, (vec3){-1, 0, -1}, (vec3){0, 0, 2.0f / (row_count - 1)},
+            (vec3){2.0f / (col_count - 1), 0, 0});
+    }
+}
+
+
+
+void dvz_surface_grid(DvzVisual* visual, vec3 o, vec3 u, vec3 v)
+{
+    ANN(visual);
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_ORIGIN, (vec4){o[0], o[1], o[2], 0});
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_U, (vec4){u[0], u[1], u[2], 0});
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_V, (vec4){v[0], v[1], v[2], 0});
+}
+
+
+
+void dvz_surface_heights(
+    DvzVisual* visual, uint32_t row, uint32_t col, uint32_t row_count, uint32_t col_count,
+    float* heights)
+{
+    ANN(visual);
+    _surface_upload(visual, SLOT_HEIGHTS, row, col, row_count, col_count, heights);
+}
+
+
+
+void dvz_surface_scalar(
+    DvzVisual* visual, uint32_t row, uint32_t col, uint32_t row_count, uint32_t col_count,
+    float* values)
+{
+    ANN(visual);
+    if ((visual->flags & DVZ_SURFACE_FLAGS_SCALAR) == 0)
+    {
+        log_error("the surface visual needs to be created with the DVZ_SURFACE_FLAGS_SCALAR flag");
+        return;
+    }
+    _surface_upload(visual, SLOT_SCALAR, row, col, row_count, col_count, values);
+}
+
+
+
+void dvz_surface_colormap(DvzVisual* visual, DvzColormap cmap, float vmin, float vmax)
+{
+    ANN(visual);
+
+    ivec4* grid = _get_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID);
+    ANN(grid);
+    ivec4 value = {grid[0][0], grid[0][1], (int32_t)cmap, 0};
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_GRID, value);
+
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_RANGE, (vec4){vmin, vmax, 0, 0});
+}
+
+
+
+void dvz_surface_light_dir(DvzVisual* visual, vec3 dir)
+{
+    ANN(visual);
+
+    // NOTE: normalized here rather than in the fragment shader.
+    vec4 value = {dir[0], dir[1], dir[2], 0};
+    glm_vec3_normalize(value);
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_LIGHT_DIR, value);
+}
+
+
+
+void dvz_surface_light_params(DvzVisual* visual, vec4 params)
+{
+    ANN(visual);
+    dvz_visual_param(visual, SLOT_PARAMS, DVZ_SURFACE_PARAMS_LIGHT_PARAMS, params);
+}
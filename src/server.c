@@ -19,6 +19,7 @@
 #include "datoviz_protocol.h"
 #include "env_utils.h"
 #include "host.h"
+#include "imwriter.h"
 #include "keyboard.h"
 #include "mouse.h"
 #include "render_utils.h"
@@ -26,6 +27,78 @@
 
 
 
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+static DvzImageWriter* _server_writer(DvzServer* server)
+{
+    ANN(server);
+    if (server->writer == NULL)
+        server->writer = dvz_image_writer(0, 0);
+    return server->writer;
+}
+
+
+
+// Wait until the GPU has finished rendering the frames in flight, without downloading them.
+static void _server_idle(DvzServer* server)
+{
+    ANN(server);
+    for (uint32_t i = 0; i < server->count; i++)
+    {
+        DvzBoardReadback* readback =
+            &server->readbacks[(server->first + i) % server->frames_in_flight];
+        dvz_fences_wait(&readback->fences, 0);
+    }
+}
+
+
+
+// Download the oldest frame in flight, waiting for the GPU if needed, and pass it to the callback.
+static void _server_deliver(DvzServer* server)
+{
+    ANN(server);
+    ASSERT(server->count > 0);
+
+    DvzBoardReadback* readback = &server->readbacks[server->first];
+    ANN(readback->board);
+    DvzId canvas_id = readback->board->obj.id;
+    DvzReadbackEvent ev = {
+        .frame_idx = readback->frame_idx,
+        .width = readback->width,
+        .height = readback->height,
+        .user_data = server->callback_data,
+    };
+
+    DvzSize size = (DvzSize)ev.width * ev.height * 3;
+    if (size > server->rgb_size)
+    {
+        REALLOC(server->rgb, size);
+        server->rgb_size = size;
+    }
+    dvz_board_readback_download(readback, server->rgb);
+    ev.rgb = server->rgb;
+
+    // NOTE: the frame is removed before calling the callback, which may render new frames.
+    server->first = (server->first + 1) % server->frames_in_flight;
+    server->count--;
+
+    if (server->callback != NULL)
+        server->callback(server, canvas_id, ev);
+}
+
+
+
+static void _server_flush(DvzServer* server)
+{
+    ANN(server);
+    while (server->count > 0)
+        _server_deliver(server);
+}
+
+
+
 /*************************************************************************************************/
 /*  Server functions                                                                             */
 /*************************************************************************************************/
@@ -74,6 +147,9 @@ void dvz_server_submit(DvzServer* server, DvzBatch* batch)
     DvzRenderer* rd = server->rd;
     ANN(rd);
 
+    // The requests may modify resources used by the frames being rendered.
+    _server_idle(server);
+
     // Submit the pending requests to the renderer.
     log_debug("server processes %d requests", count);
 
@@ -126,6 +202,7 @@ uint8_t* dvz_server_grab(DvzServer* server, DvzId canvas_id, int flags)
     ASSERT(dvz_obj_is_created(&canvas->obj));
 
     // Trigger an update.
+    _server_idle(server);
     dvz_cmd_submit_sync(&canvas->cmds, DVZ_DEFAULT_QUEUE_RENDER);
 
     // Grab the image.
@@ -138,10 +215,130 @@ uint8_t* dvz_server_grab(DvzServer* server, DvzId canvas_id, int flags)
 
 
 
+void dvz_server_pipeline(
+    DvzServer* server, uint32_t frames_in_flight, DvzServerReadbackCallback callback,
+    void* user_data)
+{
+    ANN(server);
+    frames_in_flight = CLIP(frames_in_flight, 1, DVZ_SERVER_MAX_FRAMES);
+
+    // Deliver the frames rendered with the previous settings.
+    _server_flush(server);
+    server->callback = callback;
+    server->callback_data = user_data;
+    if (frames_in_flight == server->frames_in_flight)
+        return;
+
+    for (uint32_t i = 0; i < server->frames_in_flight; i++)
+        dvz_board_readback_destroy(&server->readbacks[i]);
+    FREE(server->readbacks);
+
+    log_debug("pipelined rendering with %d frames in flight", frames_in_flight);
+    server->readbacks = (DvzBoardReadback*)calloc(frames_in_flight, sizeof(DvzBoardReadback));
+    ANN(server->readbacks);
+    server->frames_in_flight = frames_in_flight;
+    server->first = 0;
+}
+
+
+
+uint64_t dvz_server_render(DvzServer* server, DvzId canvas_id, int flags)
+{
+    ANN(server);
+    if (server->readbacks == NULL)
+    {
+        log_error("pipelined rendering needs to be enabled with dvz_server_pipeline() first");
+        return 0;
+    }
+
+    DvzCanvas* board = dvz_renderer_canvas(server->rd, canvas_id);
+    ANN(board);
+    ASSERT(board->obj.type == DVZ_OBJECT_TYPE_BOARD);
+    ASSERT(dvz_obj_is_created(&board->obj));
+
+    // Back-pressure: deliver the oldest frame if all readbacks are in flight.
+    if (server->count == server->frames_in_flight)
+        _server_deliver(server);
+
+    // NOTE: the frame is submitted without waiting for the previous ones: the board command
+    // buffer may be pending several times, and each readback has its own staging image and fence.
+    uint32_t idx = (server->first + server->count) % server->frames_in_flight;
+    DvzBoardReadback* readback = &server->readbacks[idx];
+    readback->frame_idx = server->frame_idx++;
+    dvz_board_readback_submit(board, readback);
+    server->count++;
+
+    return readback->frame_idx;
+}
+
+
+
+uint32_t dvz_server_poll(DvzServer* server)
+{
+    ANN(server);
+    uint32_t delivered = 0;
+    while (server->count > 0 && dvz_board_readback_ready(&server->readbacks[server->first]))
+    {
+        _server_deliver(server);
+        delivered++;
+    }
+    return delivered;
+}
+
+
+
+void dvz_server_screenshot(DvzServer* server, DvzId canvas_id, const char* filename, int flags)
+{
+    ANN(server);
+    ANN(filename);
+
+    uint8_t* rgb = dvz_server_grab(server, canvas_id, flags);
+    ANN(rgb);
+    DvzCanvas* canvas = dvz_renderer_canvas(server->rd, canvas_id);
+    ANN(canvas);
+
+    // The image is copied, encoded and written in the background, so that the next frame can be
+    // rendered in the meantime.
+    dvz_image_writer_push(_server_writer(server), filename, canvas->width, canvas->height, rgb);
+}
+
+
+
+void dvz_server_png(DvzServer* server, int level, DvzPngFilter filter)
+{
+    ANN(server);
+    dvz_image_writer_png(_server_writer(server), level, filter);
+}
+
+
+
+uint32_t dvz_server_wait(DvzServer* server)
+{
+    ANN(server);
+    _server_flush(server);
+    if (server->writer == NULL)
+        return 0;
+    uint32_t errors = dvz_image_writer_wait(server->writer);
+    if (errors > 0)
+        log_warn("%d screenshot(s) could not be written", errors);
+    return errors;
+}
+
+
+
 void dvz_server_destroy(DvzServer* server)
 {
     ANN(server); //
 
+    // Deliver the remaining frames and write the remaining screenshots.
+    _server_flush(server);
+    for (uint32_t i = 0; i < server->frames_in_flight; i++)
+        dvz_board_readback_destroy(&server->readbacks[i]);
+    FREE(server->readbacks);
+    FREE(server->rgb);
+    if (server->writer != NULL)
+        dvz_image_writer_destroy(server->writer);
+
     dvz_mouse_destroy(server->mouse);
     dvz_keyboard_destroy(server->keyboard);
     dvz_renderer_destroy(server->rd);
@@ -574,6 +574,14 @@ DvzCommands dvz_commands(DvzGpu* gpu, uint32_t queue, uint32_t count)
 
 
 
+void dvz_commands_usage(DvzCommands* cmds, VkCommandBufferUsageFlags usage)
+{
+    ANN(cmds);
+    cmds->usage = usage;
+}
+
+
+
 void dvz_cmd_begin(DvzCommands* cmds, uint32_t idx)
 {
     ANN(cmds);
@@ -583,6 +591,7 @@ void dvz_cmd_begin(DvzCommands* cmds, uint32_t idx)
     // log_trace("begin command buffer");
     VkCommandBufferBeginInfo begin_info = {0};
     begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = cmds->usage;
     VK_CHECK_RESULT(vkBeginCommandBuffer(cmds->cmds[idx], &begin_info));
 }
 
@@ -4059,10 +4068,11 @@ void dvz_cmd_bind_vertex_buffer(
 
 
 void dvz_cmd_bind_index_buffer(
-    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset)
+    DvzCommands* cmds, uint32_t idx, DvzBufferRegions br, VkDeviceSize offset,
+    VkIndexType index_type)
 {
     CMD_START_CLIP(br.count)
-    vkCmdBindIndexBuffer(cb, br.buffer->buffer, br.offsets[iclip] + offset, VK_INDEX_TYPE_UINT32);
+    vkCmdBindIndexBuffer(cb, br.buffer->buffer, br.offsets[iclip] + offset, index_type);
     CMD_END
 }
 
@@ -16,6 +16,7 @@
 
 #include "scene/test_array.h"
 #include "_cglm.h"
+#include "fileio.h"
 #include "scene/array.h"
 #include "test.h"
 #include "testing.h"
@@ -362,3 +363,328 @@ int test_array_3D(TstSuite* suite)
     dvz_array_destroy(arr);
     return 0;
 }
+
+
+
+static void _write_npy(const char* path, const char* dict, DvzSize data_size, const void* data)
+{
+    // Version 1 header, padded so that the data is 64-byte aligned as NumPy does.
+    uint32_t len = (uint32_t)strlen(dict);
+    uint32_t header_len = (uint32_t)(((10 + len + 1 + 63) / 64) * 64 - 10);
+    DvzSize size = 10 + header_len + data_size;
+    uint8_t* bytes = (uint8_t*)calloc(size, 1);
+    memcpy(bytes, "\x93NUMPY\x01\x00", 8);
+    bytes[8] = (uint8_t)(header_len & 0xFF);
+    bytes[9] = (uint8_t)(header_len >> 8);
+    memset(bytes + 10, ' ', header_len);
+    memcpy(bytes + 10, dict, len);
+    bytes[10 + header_len - 1] = '\n';
+    memcpy(bytes + 10 + header_len, data, data_size);
+    dvz_write_bytes(path, "wb", size, bytes);
+    FREE(bytes);
+}
+
+
+
+int test_array_npy(TstSuite* suite)
+{
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test_array.npy", ARTIFACTS_DIR);
+
+    // 5 x 3 float32 array: 5 vec3 items.
+    float values[15] = {0};
+    for (uint32_t i = 0; i < 15; i++)
+        values[i] = i;
+    _write_npy(
+        path, "{'descr': '<f4', 'fortran_order': False, 'shape': (5, 3), }", sizeof(values),
+        values);
+
+    // Scalar data type by default.
+    DvzArray* arr = dvz_array_npy(path, 0);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_FLOAT);
+    AT(arr->item_count == 15);
+    AT(arr->ndims == 2);
+    AT(arr->shape[0] == 3);
+    AT(arr->shape[1] == 5);
+    dvz_array_destroy(arr);
+
+    arr = dvz_array_npy(path, DVZ_ARRAY_FLAGS_VECTOR);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_VEC3);
+    AT(arr->item_size == sizeof(vec3));
+    AT(arr->item_count == 5);
+    AT(arr->ndims == 1);
+    AT(arr->shape[0] == 5);
+
+    // No copy: the data points into the file mapping.
+    AT(arr->mapping != NULL);
+    AT((char*)arr->data == (char*)arr->mapping + 128);
+    AT(((vec3*)dvz_array_item(arr, 4))[0][2] == 14);
+
+    // The mapping is read-only: the functions modifying the array leave it unchanged.
+    vec3 item = {-1, -1, -1};
+    DvzArray* other = dvz_array(5, DVZ_DTYPE_VEC3);
+    dvz_array_data(arr, 0, 1, 1, item);
+    dvz_array_insert(arr, 0, 1, item);
+    dvz_array_copy_region(other, arr, 0, 0, 5);
+    dvz_array_column(arr, 0, sizeof(float), 0, 5, 1, item, 0, 0, DVZ_ARRAY_COPY_NONE, 1);
+    dvz_array_scale(arr, 2);
+    dvz_array_clear(arr);
+    dvz_array_reshape(arr, 2, 2, 2);
+    dvz_array_resize(arr, 10);
+    AT(arr->item_count == 5);
+    AT(arr->shape[0] == 5);
+    for (uint32_t i = 0; i < 15; i++)
+        AT(((float*)arr->data)[i] == i);
+    dvz_array_destroy(other);
+    dvz_array_destroy(arr);
+
+    // 2 x 3 x 4 Fortran-ordered uint8 array: the C-ordered 4 x 3 x 2 transpose, with cvec2 items.
+    uint8_t bytes[24] = {0};
+    _write_npy(
+        path, "{'descr': '|u1', 'fortran_order': True, 'shape': (2, 3, 4), }", sizeof(bytes),
+        bytes);
+    arr = dvz_array_npy(path, DVZ_ARRAY_FLAGS_VECTOR);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_CVEC2);
+    AT(arr->item_count == 12);
+    AT(arr->ndims == 2);
+    AT(arr->shape[0] == 3);
+    AT(arr->shape[1] == 4);
+    dvz_array_destroy(arr);
+
+    // int64 values: custom items.
+    int64_t longs[6] = {0};
+    _write_npy(
+        path, "{'descr': '<i8', 'fortran_order': False, 'shape': (6,), }", sizeof(longs), longs);
+    arr = dvz_array_npy(path, 0);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_CUSTOM);
+    AT(arr->item_size == 8);
+    AT(arr->item_count == 6);
+    dvz_array_destroy(arr);
+
+    return 0;
+}
+
+
+
+int test_array_csv(TstSuite* suite)
+{
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test_array.csv", ARTIFACTS_DIR);
+
+    // Header row, CRLF line endings, an empty line, quoted and missing values.
+    const char* csv = "x,y,z,label,r\r\n"
+                      "1,2.5,-3e2,a,12\r\n"
+                      "\r\n"
+                      "\"4\", 0.125 ,6,b,300\r\n"
+                      "7,,nan,c,-5\r\n"
+                      "1.7976931348623157e308,1e-320,0.1";
+    dvz_write_bytes(path, "wb", strlen(csv), (const uint8_t*)csv);
+
+    uint32_t xyz[3] = {0, 1, 2};
+    DvzArray* arr = dvz_array_csv(path, ',', 1, xyz, DVZ_DTYPE_DVEC3);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_DVEC3);
+    AT(arr->item_count == 4);
+    dvec3* pos = (dvec3*)arr->data;
+    AT(pos[0][0] == 1 && pos[0][1] == 2.5 && pos[0][2] == -300);
+    AT(pos[1][0] == 4 && pos[1][1] == 0.125 && pos[1][2] == 6);
+    AT(pos[2][0] == 7 && isnan(pos[2][1]) && isnan(pos[2][2]));
+    AT(pos[3][0] == 1.7976931348623157e308 && pos[3][1] == 1e-320 && pos[3][2] == 0.1);
+    dvz_array_destroy(arr);
+
+    // Integer values are rounded and clamped, missing values give 0. The array is read with the
+    // public accessors.
+    uint32_t color[4] = {4, 0, 1, 9};
+    arr = dvz_array_csv(path, ',', 1, color, DVZ_DTYPE_CVEC4);
+    AT(arr != NULL);
+    AT(dvz_array_count(arr) == 4);
+    AT(dvz_array_dtype(arr) == DVZ_DTYPE_CVEC4);
+    cvec4* rgba = (cvec4*)dvz_array_buffer(arr);
+    AT(rgba[0][0] == 12 && rgba[0][1] == 1 && rgba[0][2] == 3 && rgba[0][3] == 0);
+    AT(rgba[1][0] == 255 && rgba[1][1] == 4 && rgba[1][2] == 0);
+    AT(rgba[2][0] == 0 && rgba[2][1] == 7);
+    dvz_array_destroy(arr);
+
+    // Large TSV file parsed in several chunks, with the delimiter detected.
+    uint32_t row_count = 200000;
+    char* tsv = (char*)calloc(row_count, 64);
+    DvzSize size = 0;
+    for (uint32_t i = 0; i < row_count; i++)
+        size += (DvzSize)snprintf(tsv + size, 64, "%u\t%.4f\t%d\n", i, i * 0.0625, -(int)i);
+    dvz_write_bytes(path, "wb", size, (const uint8_t*)tsv);
+    FREE(tsv);
+
+    uint32_t cols[2] = {1, 2};
+    arr = dvz_array_csv(path, 0, 0, cols, DVZ_DTYPE_VEC2);
+    AT(arr != NULL);
+    AT(arr->item_count == row_count);
+    vec2* values = (vec2*)arr->data;
+    for (uint32_t i = 0; i < row_count; i++)
+    {
+        AT(values[i][0] == (float)(i * 0.0625));
+        AT(values[i][1] == -(float)i);
+    }
+    dvz_array_destroy(arr);
+
+    uint32_t col = 0;
+    arr = dvz_array_csv(path, '\t', 0, &col, DVZ_DTYPE_UINT);
+    AT(arr != NULL);
+    AT(((uint32_t*)arr->data)[row_count - 1] == row_count - 1);
+    dvz_array_destroy(arr);
+
+    return 0;
+}
+
+
+
+// Arrow IPC file with a single record batch of 3 rows, written by pyarrow:
+// x: float32 with a null value, pos: fixed_size_list<float32>[3], flag: bool.
+static const uint8_t ARROW_FILE[] = {
+    0x41, 0x52, 0x52, 0x4f, 0x57, 0x31, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x08, 0x01, 0x00,
+    0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x06, 0x00, 0x05, 0x00,
+    0x08, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x08,
+    0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x74, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x06, 0x10, 0x00, 0x00, 0x00, 0x1c, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x66,
+    0x6c, 0x61, 0x67, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0xa0, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x10, 0x14, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0x70, 0x6f, 0x73, 0x00, 0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x04, 0x00, 0x06,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0xd4, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x03,
+    0x10, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x69, 0x74, 0x65, 0x6d, 0x00, 0x00, 0x00, 0x00, 0xca, 0xff,
+    0xff, 0xff, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x14, 0x00, 0x08, 0x00, 0x06, 0x00, 0x07,
+    0x00, 0x0c, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x10, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x06, 0x00, 0x08, 0x00, 0x06, 0x00, 0x06, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x08,
+    0x01, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x16, 0x00,
+    0x06, 0x00, 0x05, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x03, 0x04,
+    0x00, 0x18, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x18, 0x00, 0x0c, 0x00, 0x04, 0x00, 0x08, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x8c,
+    0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3f, 0x00,
+    0x00, 0x00, 0x40, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x80, 0x40, 0x00, 0x00, 0xa0, 0x40,
+    0x00, 0x00, 0xc0, 0x40, 0x00, 0x00, 0xe0, 0x40, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00, 0x00,
+    0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00,
+    0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x14, 0x00, 0x06, 0x00, 0x08, 0x00, 0x0c,
+    0x00, 0x10, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x38, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x18, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+    0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x74, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x06, 0x10, 0x00, 0x00, 0x00, 0x1c, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x66,
+    0x6c, 0x61, 0x67, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0xa0, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x10, 0x14, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0x70, 0x6f, 0x73, 0x00, 0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x04, 0x00, 0x06,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0xd4, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x03,
+    0x10, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x69, 0x74, 0x65, 0x6d, 0x00, 0x00, 0x00, 0x00, 0xca, 0xff,
+    0xff, 0xff, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x14, 0x00, 0x08, 0x00, 0x06, 0x00, 0x07,
+    0x00, 0x0c, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03,
+    0x10, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x06, 0x00, 0x08, 0x00, 0x06, 0x00, 0x06, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x30, 0x01, 0x00, 0x00, 0x41, 0x52, 0x52, 0x4f, 0x57,
+    0x31};
+
+
+
+int test_array_arrow(TstSuite* suite)
+{
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test_array.arrow", ARTIFACTS_DIR);
+    dvz_write_bytes(path, "wb", sizeof(ARROW_FILE), ARROW_FILE);
+
+    DvzArrowFile* arrow = dvz_arrow_open(path);
+    AT(arrow != NULL);
+    AT(arrow->field_count == 3);
+    AT(arrow->batch_count == 1);
+    AT(strcmp(arrow->fields[0].name, "x") == 0);
+    AT(strcmp(arrow->fields[1].name, "pos") == 0);
+    AT(arrow->fields[1].kind == 'f');
+    AT(arrow->fields[1].components == 3);
+    AT(arrow->fields[2].kind == 'b');
+
+    // Float column with a null value.
+    DvzArrowColumn column = {0};
+    AT(dvz_arrow_column(arrow, 0, 0, &column) == 0);
+    AT(column.length == 3);
+    AT(column.null_count == 1);
+    AT(column.validity != NULL);
+    AT(dvz_arrow_column(arrow, 1, 0, &column) != 0);
+
+    DvzArray* mask = NULL;
+    DvzArray* arr = dvz_array_arrow(arrow, 0, 0, &mask);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_FLOAT);
+    AT(arr->item_count == 3);
+    AT(((float*)arr->data)[0] == 1.5f);
+    AT(((float*)arr->data)[2] == 3.0f);
+
+    // No copy: the data points into the file mapping.
+    AT((char*)arr->data > (char*)arrow->mapping);
+    AT((char*)arr->data < (char*)arrow->mapping + arrow->size);
+    AT(mask != NULL);
+    AT(mask->dtype == DVZ_DTYPE_CHAR);
+    AT(((uint8_t*)mask->data)[0] == 1);
+    AT(((uint8_t*)mask->data)[1] == 0);
+    AT(((uint8_t*)mask->data)[2] == 1);
+    dvz_array_destroy(arr);
+    dvz_array_destroy(mask);
+
+    // Fixed-size list of 3 floats: vec3 positions.
+    arr = dvz_array_arrow(arrow, 0, 1, &mask);
+    AT(arr != NULL);
+    AT(arr->dtype == DVZ_DTYPE_VEC3);
+    AT(arr->item_count == 3);
+    AT(mask == NULL);
+    vec3* pos = (vec3*)arr->data;
+    AT(pos[1][0] == 3 && pos[1][1] == 4 && pos[1][2] == 5);
+    AT(pos[2][2] == 8);
+
+    // The view is read-only.
+    vec3 item = {-1, -1, -1};
+    dvz_array_data(arr, 0, 1, 1, item);
+    dvz_array_clear(arr);
+    AT(pos[0][0] == 0 && pos[0][2] == 2);
+    dvz_array_destroy(arr);
+
+    // Booleans.
+    arr = dvz_array_arrow(arrow, 0, 2, NULL);
+    AT(arr != NULL);
+    AT(arr->item_count == 3);
+    AT(((uint8_t*)arr->data)[0] == 1);
+    AT(((uint8_t*)arr->data)[1] == 0);
+    AT(((uint8_t*)arr->data)[2] == 1);
+    dvz_array_destroy(arr);
+
+    dvz_arrow_close(arrow);
+
+    // Invalid file.
+    dvz_write_bytes(path, "wb", 64, ARROW_FILE);
+    AT(dvz_arrow_open(path) == NULL);
+
+    return 0;
+}
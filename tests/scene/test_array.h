@@ -45,6 +45,12 @@ int test_array_mvp(TstSuite*);
 
 int test_array_3D(TstSuite*);
 
+int test_array_npy(TstSuite*);
+
+int test_array_csv(TstSuite*);
+
+int test_array_arrow(TstSuite*);
+
 
 
 #endif
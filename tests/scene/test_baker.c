@@ -19,6 +19,7 @@
 #include "scene/array.h"
 #include "scene/baker.h"
 #include "scene/dual.h"
+#include "datoviz.h"
 #include "test.h"
 #include "testing.h"
 
@@ -224,6 +225,138 @@ int test_baker_2(TstSuite* suite)
 
 
 
+int test_baker_normalize(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzBaker* baker = dvz_baker(batch, 0);
+
+    // Interleaved vertex binding: vec3 position, followed by a float.
+    DvzSize stride = sizeof(vec3) + sizeof(float);
+    dvz_baker_vertex(baker, 0, stride);
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+    dvz_baker_attr(baker, 1, 0, sizeof(vec3), sizeof(float));
+
+    // More positions than a single normalization block, each repeated twice.
+    const uint32_t count = 2500;
+    const uint32_t reps = 2;
+    const uint32_t first = 3;
+    dvz_baker_create(baker, 0, first + reps * count);
+
+    dvec3* pos = (dvec3*)calloc(count, sizeof(dvec3));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pos[i][0] = 1e6 + i;
+        pos[i][1] = -2.0 * i;
+        pos[i][2] = 42; // degenerate range along z
+    }
+    DvzBox source = dvz_box(1e6, 1e6 + count - 1, -2.0 * (count - 1), 0, 42, 42);
+    DvzBox target = dvz_box(-1, +1, -1, +1, -1, +1);
+
+    // Reference.
+    vec3* expected = (vec3*)calloc(count, sizeof(vec3));
+    dvz_box_normalize(source, target, count, pos, expected);
+
+    float other = 7;
+    dvz_baker_repeat(baker, 1, 0, 1, first + reps * count, &other);
+    dvz_baker_normalize(baker, 0, first, count, reps, source, target, pos);
+
+    DvzDual* dual = &baker->vertex_bindings[0].dual;
+    AT(dual->dirty_first == 0);
+    AT(dual->dirty_last == first + reps * count);
+
+    // Check the positions, and that the neighboring attribute has not been overwritten.
+    uint8_t* data = (uint8_t*)dual->array->data;
+    vec3 p = {0};
+    float f = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t r = 0; r < reps; r++)
+        {
+            memcpy(p, data + (first + i * reps + r) * stride, sizeof(vec3));
+            memcpy(&f, data + (first + i * reps + r) * stride + sizeof(vec3), sizeof(float));
+            AT(memcmp(p, expected[i], sizeof(vec3)) == 0);
+            AT(f == other);
+        }
+    }
+    AT(*(float*)(data + (first + reps * count - 1) * stride) == +1);
+
+    FREE(pos);
+    FREE(expected);
+    dvz_baker_destroy(baker);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
+int test_baker_quantize(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzBaker* baker = dvz_baker(batch, 0);
+
+    // Quantized vertex: snorm16x4 position, half-precision size, snorm16 angle.
+    DvzSize stride = 12;
+    dvz_baker_vertex(baker, 0, stride);
+    dvz_baker_attr(baker, 0, 0, 0, 8);
+    dvz_baker_attr(baker, 1, 0, 8, 2);
+    dvz_baker_attr(baker, 2, 0, 10, 2);
+
+    const uint32_t count = 4;
+    const uint32_t reps = 2;
+    dvz_baker_create(baker, 0, reps * count);
+
+    vec3 pos[] = {{-1, 0, 1}, {.5, -.5, 2}, {-3, .25, 0}, {1e-5, 0, -1}};
+    float sizes[] = {1, -2, 10.5, 65536};
+    float angles[] = {M_PI, -M_PI / 2, 0, 2 * M_PI};
+
+    dvz_baker_quantize(
+        baker, 0, 0, count, reps, DVZ_FORMAT_R16G16B16A16_SNORM, 1, (float*)pos);
+    dvz_baker_quantize(baker, 1, 0, count, reps, DVZ_FORMAT_R16_SFLOAT, 1, sizes);
+    dvz_baker_quantize(baker, 2, 0, count, reps, DVZ_FORMAT_R16_SNORM, 1 / M_PI, angles);
+
+    DvzDual* dual = &baker->vertex_bindings[0].dual;
+    AT(dual->dirty_first == 0);
+    AT(dual->dirty_last == reps * count);
+
+    int16_t expected_pos[][4] = {
+        {-32767, 0, 32767, 0}, {16384, -16384, 32767, 0}, {-32767, 8192, 0, 0}, {0, 0, -32767, 0}};
+    uint16_t expected_sizes[] = {0x3C00, 0xC000, 0x4940, 0x7C00};
+    int16_t expected_angles[] = {32767, -16384, 0, 32767};
+
+    uint8_t* data = (uint8_t*)dual->array->data;
+    int16_t p[4] = {0};
+    uint16_t h = 0;
+    int16_t a = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t r = 0; r < reps; r++)
+        {
+            uint8_t* vertex = data + (i * reps + r) * stride;
+            memcpy(p, vertex, sizeof(p));
+            memcpy(&h, vertex + 8, sizeof(h));
+            memcpy(&a, vertex + 10, sizeof(a));
+            AT(memcmp(p, expected_pos[i], sizeof(p)) == 0);
+            AT(h == expected_sizes[i]);
+            AT(a == expected_angles[i]);
+        }
+    }
+
+    // Normalization directly into a quantized position attribute.
+    dvec3 dpos[] = {{0, 0, 0}, {10, 20, 30}, {5, 10, 15}, {10, 0, 30}};
+    DvzBox source = dvz_box(0, 10, 0, 20, 0, 30);
+    dvz_baker_normalize(baker, 0, 0, count, reps, source, DVZ_BOX_NDC, dpos);
+    memcpy(p, data + 2 * reps * stride, sizeof(p));
+    AT(p[0] == 0 && p[1] == 0 && p[2] == 0 && p[3] == 0);
+    memcpy(p, data + 3 * reps * stride, sizeof(p));
+    AT(p[0] == 32767 && p[1] == -32767 && p[2] == 32767);
+
+    dvz_baker_destroy(baker);
+    dvz_batch_destroy(batch);
+    return 0;
+}
+
+
+
 // int test_baker_3(TstSuite* suite)
 // {
 //     DvzBatch* batch = dvz_requester();
@@ -256,3 +389,96 @@ int test_baker_2(TstSuite* suite)
 //     dvz_requester_destroy(batch);
 //     return 0;
 // }
+
+
+
+int test_baker_index16(TstSuite* suite)
+{
+    DvzBatch* batch = dvz_batch();
+    DvzBaker* baker = dvz_baker(batch, 0);
+
+    dvz_baker_vertex(baker, 0, sizeof(vec3));
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+
+    // A small mesh uses 16-bit indices.
+    const uint32_t vertex_count = 4;
+    const uint32_t index_count = 6;
+    dvz_baker_create(baker, index_count, vertex_count);
+    AT(baker->index_size == sizeof(uint16_t));
+    AT(baker->index.array->item_size == sizeof(uint16_t));
+
+    DvzIndex indices[] = {0, 1, 2, 0, 2, 3};
+    dvz_baker_index(baker, 0, index_count, indices);
+    uint16_t* indices16 = (uint16_t*)baker->index.array->data;
+    for (uint32_t i = 0; i < index_count; i++)
+        AT(indices16[i] == indices[i]);
+    AT(baker->index.dirty_first == 0);
+    AT(baker->index.dirty_last == index_count);
+
+    // Growing beyond the 16-bit range switches to 32-bit indices, keeping the existing ones.
+    const uint32_t new_vertex_count = DVZ_BAKER_INDEX16_MAX_VERTICES + 1;
+    dvz_baker_resize(baker, new_vertex_count, 2 * index_count);
+    AT(baker->index_size == sizeof(DvzIndex));
+    AT(baker->index.array->item_size == sizeof(DvzIndex));
+    AT(baker->index.dirty_first == 0);
+    AT(baker->index.dirty_last == 2 * index_count);
+
+    DvzIndex more[] = {4, 5, 6, 0, 6, new_vertex_count - 1};
+    dvz_baker_index(baker, index_count, index_count, more);
+    DvzIndex* indices32 = (DvzIndex*)baker->index.array->data;
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        AT(indices32[i] == indices[i]);
+        AT(indices32[index_count + i] == more[i]);
+    }
+    dvz_baker_destroy(baker);
+
+    // An index out of the 16-bit range also switches to 32-bit indices, keeping the existing
+    // ones, and all the indices are uploaded again.
+    baker = dvz_baker(batch, 0);
+    dvz_baker_vertex(baker, 0, sizeof(vec3));
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+    dvz_baker_create(baker, 2 * index_count, vertex_count);
+    AT(baker->index_size == sizeof(uint16_t));
+    dvz_baker_index(baker, 0, index_count, indices);
+    more[5] = UINT16_MAX + 1;
+    dvz_baker_index(baker, index_count, index_count, more);
+    AT(baker->index_size == sizeof(DvzIndex));
+    AT(baker->index.array->item_size == sizeof(DvzIndex));
+    AT(baker->index.dirty_first == 0);
+    AT(baker->index.dirty_last == 2 * index_count);
+    indices32 = (DvzIndex*)baker->index.array->data;
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        AT(indices32[i] == indices[i]);
+        AT(indices32[index_count + i] == more[i]);
+    }
+    dvz_baker_destroy(baker);
+
+    // A shared index buffer keeps 32-bit indices, even for a small mesh.
+    baker = dvz_baker(batch, 0);
+    dvz_baker_vertex(baker, 0, sizeof(vec3));
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+    dvz_baker_share_index(baker);
+    dvz_baker_create(baker, index_count, vertex_count);
+    AT(baker->index_size == sizeof(DvzIndex));
+    AT(baker->index.array == NULL);
+    dvz_baker_destroy(baker);
+
+    // A baker forced to 32-bit indices keeps them, even for a small mesh.
+    baker = dvz_baker(batch, 0);
+    baker->index32 = true;
+    dvz_baker_vertex(baker, 0, sizeof(vec3));
+    dvz_baker_attr(baker, 0, 0, 0, sizeof(vec3));
+    dvz_baker_create(baker, index_count, vertex_count);
+    AT(baker->index_size == sizeof(DvzIndex));
+    AT(baker->index.array->item_size == sizeof(DvzIndex));
+    dvz_baker_index(baker, 0, index_count, indices);
+    indices32 = (DvzIndex*)baker->index.array->data;
+    for (uint32_t i = 0; i < index_count; i++)
+        AT(indices32[i] == indices[i]);
+
+    dvz_baker_destroy(baker);
+    dvz_batch_destroy(batch);
+    return 0;
+}
@@ -29,6 +29,12 @@ int test_baker_1(TstSuite*);
 
 int test_baker_2(TstSuite*);
 
+int test_baker_normalize(TstSuite*);
+
+int test_baker_quantize(TstSuite*);
+
+int test_baker_index16(TstSuite*);
+
 // int test_baker_3(TstSuite*);
 
 
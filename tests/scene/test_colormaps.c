@@ -119,6 +119,82 @@ int test_colormaps_array(TstSuite* suite)
 
 
 
+int test_colormaps_lut(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzColormap cmap = DVZ_CMAP_VIRIDIS;
+    uint32_t n = 10000;
+    float vmin = -1, vmax = +1;
+
+    float* values = (float*)calloc(n, sizeof(float));
+    double* dvalues = (double*)calloc(n, sizeof(double));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        values[i] = vmin + (vmax - vmin) / (n - 1) * i;
+        dvalues[i] = values[i];
+    }
+    DvzColor* colors = (DvzColor*)calloc(n, sizeof(DvzColor));
+    DvzColor expected = {0};
+
+    DvzColormapLut lut = {0};
+    dvz_colormap_lut(cmap, &lut);
+
+    // The LUT path should give the same colors as the per-value path.
+    dvz_colormap_lut_float(&lut, n, values, vmin, vmax, colors);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        dvz_colormap_scale(cmap, values[i], vmin, vmax, expected);
+        AT(memcmp(colors[i], expected, sizeof(DvzColor)) == 0);
+    }
+
+    dvz_colormap_lut_double(&lut, n, dvalues, vmin, vmax, colors);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        dvz_colormap_scale(cmap, values[i], vmin, vmax, expected);
+        AT(memcmp(colors[i], expected, sizeof(DvzColor)) == 0);
+    }
+
+    // Integer values.
+    int32_t ivalues[] = {-10, 0, 10, 20};
+    dvz_colormap_lut_int(&lut, 4, ivalues, 0, 10, colors);
+    AT(memcmp(colors[0], lut.colors[0], sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[1], lut.colors[0], sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[2], lut.colors[255], sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[3], lut.colors[255], sizeof(DvzColor)) == 0);
+
+    // NaN and clipping colors.
+    DvzColor nan = {0, 0, 0, 0};
+    DvzColor under = {DVZ_ALPHA_MAX, 0, 0, DVZ_ALPHA_MAX};
+    DvzColor over = {0, 0, DVZ_ALPHA_MAX, DVZ_ALPHA_MAX};
+    dvz_colormap_lut_nan(&lut, nan);
+    dvz_colormap_lut_clip(&lut, under, over);
+
+    float special[] = {NAN, -2, vmin, vmax, 2, INFINITY, -INFINITY};
+    dvz_colormap_lut_float(&lut, 7, special, vmin, vmax, colors);
+    AT(memcmp(colors[0], nan, sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[1], under, sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[2], lut.colors[0], sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[3], lut.colors[255], sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[4], over, sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[5], over, sizeof(DvzColor)) == 0);
+    AT(memcmp(colors[6], under, sizeof(DvzColor)) == 0);
+
+    // Empty range: all values get the first color, as with dvz_colormap_scale().
+    memset(colors, 0, 3 * sizeof(DvzColor));
+    dvz_colormap_array(cmap, 3, values, 1, 1, colors);
+    dvz_colormap_scale(cmap, values[0], 1, 1, expected);
+    for (uint32_t i = 0; i < 3; i++)
+        AT(memcmp(colors[i], expected, sizeof(DvzColor)) == 0);
+
+    FREE(colors);
+    FREE(values);
+    FREE(dvalues);
+    return 0;
+}
+
+
+
 // int test_colormaps_uv(TstSuite* suite)
 // {
 //     ANN(suite);
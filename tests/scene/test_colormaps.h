@@ -31,6 +31,8 @@ int test_colormaps_scale(TstSuite*);
 
 int test_colormaps_array(TstSuite*);
 
+int test_colormaps_lut(TstSuite*);
+
 
 
 #endif
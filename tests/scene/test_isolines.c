@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing isolines                                                                             */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+
+#include "test_isolines.h"
+#include "datoviz.h"
+#include "datoviz_types.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Isolines test utils                                                                          */
+/*************************************************************************************************/
+
+static inline double _radius(vec3 p) { return hypot(p[0], p[1]); }
+
+
+
+/*************************************************************************************************/
+/*  Isolines tests                                                                               */
+/*************************************************************************************************/
+
+int test_isolines_1(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Squared distance to the center, on [-1, +1]^2.
+    uint32_t n = 201;
+    float* values = (float*)calloc(n * n, sizeof(float));
+    float x = 0, y = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            x = -1 + 2 * i / (float)(n - 1);
+            y = -1 + 2 * j / (float)(n - 1);
+            values[i * n + j] = x * x + y * y;
+        }
+    }
+
+    // A circle inside the grid, no isoline, and a circle crossing the four grid borders.
+    float levels[] = {.25, 4, 1.44};
+    float d = 2.0f / (n - 1);
+    DvzIsolines isolines = dvz_isolines(
+        n, n, values, 3, levels, (vec3){-1, -1, 0}, (vec3){d, 0, 0}, (vec3){0, d, 0});
+    AT(isolines.path_count == 5);
+    AT(isolines.path_levels[0] == 0);
+
+    // The first polyline is closed.
+    uint32_t l = isolines.path_lengths[0];
+    AT(l > 100);
+    AT(memcmp(isolines.pos[0], isolines.pos[l - 1], sizeof(vec3)) == 0);
+    for (uint32_t k = 0; k < l; k++)
+        AT(fabs(_radius(isolines.pos[k]) - .5) < 1e-3);
+
+    // The other polylines are open arcs going from a grid border to another.
+    uint32_t offset = l;
+    float* p0 = NULL;
+    float* p1 = NULL;
+    for (uint32_t i = 1; i < isolines.path_count; i++)
+    {
+        AT(isolines.path_levels[i] == 2);
+        l = isolines.path_lengths[i];
+        p0 = isolines.pos[offset];
+        p1 = isolines.pos[offset + l - 1];
+        AT(fabs(fabs(p0[0]) - 1) < 1e-5 || fabs(fabs(p0[1]) - 1) < 1e-5);
+        AT(fabs(fabs(p1[0]) - 1) < 1e-5 || fabs(fabs(p1[1]) - 1) < 1e-5);
+        for (uint32_t k = 0; k < l; k++)
+            AT(fabs(_radius(isolines.pos[offset + k]) - 1.2) < 1e-3);
+        offset += l;
+    }
+    AT(offset == isolines.point_count);
+
+    dvz_isolines_destroy(&isolines);
+    FREE(values);
+    return 0;
+}
+
+
+
+int test_isolines_saddle(TstSuite* suite)
+{
+    ANN(suite);
+
+    // A checkerboard: every cell is a saddle, and every segment needs to be stitched.
+    uint32_t n = 150;
+    float* values = (float*)calloc(n * n, sizeof(float));
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t j = 0; j < n; j++)
+            values[i * n + j] = (i + j) % 2 == 0 ? 1 : 0;
+
+    // Make sure the bands are stitched together.
+    float level = .5;
+    DvzIsolines isolines = dvz_isolines(
+        n, n, values, 1, &level, (vec3){0, 0, 0}, (vec3){1, 0, 0}, (vec3){0, 1, 0});
+    AT(isolines.path_count > 0);
+
+    // 2 segments per cell, every segment adds one point to its polyline, and each polyline has
+    // one extra point.
+    uint32_t cells = (n - 1) * (n - 1);
+    AT(isolines.point_count == 2 * cells + isolines.path_count);
+
+    // The points are at the middle of the grid edges.
+    float fx = 0, fy = 0;
+    for (uint32_t k = 0; k < isolines.point_count; k++)
+    {
+        fx = isolines.pos[k][0] - floorf(isolines.pos[k][0]);
+        fy = isolines.pos[k][1] - floorf(isolines.pos[k][1]);
+        AT((fx == 0 && fy == .5) || (fx == .5 && fy == 0));
+    }
+
+    dvz_isolines_destroy(&isolines);
+    FREE(values);
+    return 0;
+}
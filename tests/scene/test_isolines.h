@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_ISOLINES
+#define DVZ_HEADER_TEST_ISOLINES
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Isolines tests                                                                               */
+/*************************************************************************************************/
+
+int test_isolines_1(TstSuite*);
+
+int test_isolines_saddle(TstSuite*);
+
+
+
+#endif
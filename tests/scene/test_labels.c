@@ -16,6 +16,8 @@
 
 #include "test_labels.h"
 #include "../../src/scene/labels_utils.h"
+#include "_time_utils.h"
+#include "scene/format.h"
 #include "scene/labels.h"
 #include "test.h"
 #include "testing.h"
@@ -97,3 +99,104 @@ int test_labels_factored(TstSuite* suite)
     dvz_labels_destroy(labels);
     return 0;
 }
+
+
+
+int test_labels_format(TstSuite* suite)
+{
+    ANN(suite);
+    char out[DVZ_FORMAT_MAX_LENGTH] = {0};
+    char expected[64] = {0};
+
+    // Compare with printf() on tick-like values.
+    double values[] = {0, 1, -1, .5, 2.5, -0.125, 1e-5, 123.456, 1e6 + .25, -999.9999, 1e12};
+    for (uint32_t i = 0; i < ARRAY_COUNT(values); i++)
+    {
+        for (uint32_t precision = 0; precision <= PRECISION_MAX; precision++)
+        {
+            dvz_format_fixed(values[i], precision, out);
+            snprintf(expected, sizeof(expected), "%.*f", (int)precision, values[i]);
+            AT(strcmp(out, expected) == 0);
+
+            dvz_format_scientific(values[i], precision, out);
+            snprintf(expected, sizeof(expected), "%.*e", (int)precision, values[i]);
+            AT(strcmp(out, expected) == 0);
+        }
+
+        // The shortest representation must round-trip.
+        dvz_format_shortest(values[i], out);
+        AT(strtod(out, NULL) == values[i]);
+    }
+
+    dvz_format_shortest(1e-5, out);
+    AT(strcmp(out, "1e-05") == 0);
+    dvz_format_shortest(0.1, out);
+    AT(strcmp(out, "0.1") == 0);
+    dvz_format_shortest(1e6, out);
+    AT(strcmp(out, "1e+06") == 0);
+
+    // Labels.
+    DvzLabels* labels = dvz_labels();
+    dvz_labels_generate(labels, DVZ_TICKS_FORMAT_DECIMAL, 2, 0, 0.0, -1.0, 1.0, 0.25);
+    AT(strcmp(&labels->labels[labels->index[0]], "-1.00") == 0);
+    AT(strcmp(&labels->labels[labels->index[4]], "0") == 0);
+    AT(strcmp(&labels->labels[labels->index[5]], "+0.25") == 0);
+
+    dvz_labels_generate(
+        labels, DVZ_TICKS_FORMAT_SCIENTIFIC_FACTORED, 2, -5, 0.0, 0.0, .0001, .00001);
+    AT(strcmp(labels->exponent, "x1e-05") == 0);
+
+    // Long labels are truncated to fit with their sign.
+    dvz_labels_generate(labels, DVZ_TICKS_FORMAT_DECIMAL, 15, 0, 0.0, -2e6, 2e6, 1e6);
+    for (uint32_t i = 0; i < labels->count; i++)
+        AT(strlen(&labels->labels[labels->index[i]]) < MAX_GLYPHS_PER_LABEL);
+    AT(strncmp(&labels->labels[labels->index[0]], "-2000000.000000", 15) == 0);
+
+    // Labels of arbitrary values, for example the decades of a log axis.
+    double decades[] = {1e-2, 1, 1e2};
+    uint32_t glyph_count =
+        dvz_labels_from_values(labels, DVZ_TICKS_FORMAT_SCIENTIFIC, 0, 3, decades);
+    AT(labels->count == 3);
+    AT(strcmp(&labels->labels[labels->index[0]], "+1e-02") == 0);
+    AT(strcmp(&labels->labels[labels->index[2]], "+1e+02") == 0);
+    AT(labels->values[1] == 1);
+    AT(glyph_count == 18);
+    dvz_labels_destroy(labels);
+
+    return 0;
+}
+
+
+
+int test_labels_bench(TstSuite* suite)
+{
+    ANN(suite);
+    char out[DVZ_FORMAT_MAX_LENGTH] = {0};
+    uint32_t precision = 3;
+    uint32_t n = 100000;
+    double x = 0;
+
+    // Reference: snprintf().
+    DvzClock clock = dvz_clock();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        x = -1000 + i * .125;
+        snprintf(out, sizeof(out), "%s%.*f", x < 0 ? "-" : "+", (int)precision, fabs(x));
+    }
+    double elapsed_printf = dvz_clock_get(&clock);
+
+    // Fast formatter.
+    clock = dvz_clock();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        x = -1000 + i * .125;
+        _tick_label(x, false, precision, out);
+    }
+    double elapsed_fast = dvz_clock_get(&clock);
+
+    log_info(
+        "tick label formatting: snprintf %.1f ns, fast %.1f ns per label", //
+        1e9 * elapsed_printf / n, 1e9 * elapsed_fast / n);
+
+    return 0;
+}
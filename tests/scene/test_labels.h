@@ -29,6 +29,10 @@ int test_labels_1(TstSuite*);
 
 int test_labels_factored(TstSuite*);
 
+int test_labels_format(TstSuite*);
+
+int test_labels_bench(TstSuite*);
+
 
 
 #endif
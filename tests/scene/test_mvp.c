@@ -16,7 +16,11 @@
 
 #include "test_mvp.h"
 #include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
 #include "scene/mvp.h"
+#include "scene/ortho.h"
+#include "scene/panzoom.h"
 #include "test.h"
 #include "testing.h"
 #include "testing_utils.h"
@@ -49,3 +53,149 @@ int test_mvp_1(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_mvp_offset(TstSuite* suite)
+{
+    ANN(suite);
+    DvzMVP mvp = dvz_mvp_default();
+
+    // The high and low parts sum up to the double precision offset.
+    dvec3 offset = {1.7e9 + 0.123456789, -123456.789012345, 0.1};
+    dvz_mvp_offset(&mvp, offset);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        AT(mvp.offset_hi[i] == (float)offset[i]);
+        AT(fabs(((double)mvp.offset_hi[i] + (double)mvp.offset_lo[i]) - offset[i]) <=
+           1e-14 * fabs(offset[i]));
+    }
+    AT(mvp.offset_hi[3] == 0);
+    AT(mvp.offset_lo[3] == 0);
+
+    // The offset is subtracted from the points, but not from the vectors.
+    dvz_mvp_offset(&mvp, (dvec3){1, 2, 3});
+    vec4 out = {0};
+    dvz_mvp_apply(&mvp, (vec4){1, 2, 3, 1}, out);
+    AT(glm_vec4_eqv(out, (vec4){0, 0, 0, 1}));
+    dvz_mvp_apply(&mvp, (vec4){1, 2, 3, 0}, out);
+    AT(glm_vec4_eqv(out, (vec4){1, 2, 3, 0}));
+
+    // The panzoom pan goes to the offset, with the same overall transformation as a view matrix
+    // translation.
+    DvzPanzoom* pz = dvz_panzoom(800, 600, 0);
+    dvz_panzoom_pan(pz, (vec2){.5, -.25});
+    dvz_panzoom_zoom(pz, (vec2){4, 2});
+
+    mvp = dvz_mvp_default();
+    dvz_panzoom_mvp(pz, &mvp);
+    AC(mvp.offset_hi[0], -.5, EPS);
+    AC(mvp.offset_hi[1], +.25, EPS);
+
+    DvzMVP expected = dvz_mvp_default();
+    glm_lookat((vec3){-.5, .25, 2}, (vec3){-.5, .25, 0}, (vec3){0, 1, 0}, expected.view);
+    glm_mat4_copy(mvp.proj, expected.proj);
+
+    vec4 p = {-.4, .3, 0, 1};
+    vec4 q = {0};
+    dvz_mvp_apply(&mvp, p, out);
+    dvz_mvp_apply(&expected, p, q);
+    for (uint32_t i = 0; i < 4; i++)
+        AC(out[i], q[i], EPS);
+
+    // At a high zoom level, a pan shift below the float precision reaches the low part of the
+    // offset.
+    dvz_panzoom_set(pz, dvz_box(1, 1 + 1e-6, -1, 1, -1, 1));
+    dvz_panzoom_end(pz);
+    dvz_panzoom_mvp(pz, &mvp);
+    double x0 = (double)mvp.offset_hi[0] + (double)mvp.offset_lo[0];
+    AT(fabs(x0 - (1 + 5e-7)) < 1e-15);
+
+    // One pixel is 2 / 800 / 2e6 = 1.25e-9, below the float ULP around 1 (~1.2e-7).
+    dvz_panzoom_pan_shift(pz, (vec2){1, 0}, (vec2){0});
+    dvz_panzoom_mvp(pz, &mvp);
+    double x1 = (double)mvp.offset_hi[0] + (double)mvp.offset_lo[0];
+    AT(mvp.offset_lo[0] != 0);
+    AT(fabs((x0 - x1) - 1.25e-9) < 1e-14);
+
+    // Same with the ortho controller.
+    DvzOrtho* ortho = dvz_ortho(800, 600, 0);
+    ortho->pan[0] = .5;
+    ortho->pan[1] = -.25;
+    dvz_ortho_zoom(ortho, 4);
+
+    mvp = dvz_mvp_default();
+    dvz_ortho_mvp(ortho, &mvp);
+    AC(mvp.offset_hi[0], -.5, EPS);
+    AC(mvp.offset_hi[1], +.25, EPS);
+
+    expected = dvz_mvp_default();
+    glm_lookat((vec3){-.5, .25, 2}, (vec3){-.5, .25, 0}, (vec3){0, 1, 0}, expected.view);
+    glm_mat4_copy(mvp.proj, expected.proj);
+    dvz_mvp_apply(&mvp, p, out);
+    dvz_mvp_apply(&expected, p, q);
+    for (uint32_t i = 0; i < 4; i++)
+        AC(out[i], q[i], EPS);
+
+    dvz_ortho_destroy(ortho);
+    dvz_panzoom_destroy(pz);
+    return 0;
+}
+
+
+
+int test_mvp_scale(TstSuite* suite)
+{
+    ANN(suite);
+    DvzMVP mvp = dvz_mvp_default();
+    vec4 out = {0};
+
+    // Log10 axis: the decades [1, 1000] are mapped regularly to [-1, +1].
+    dvz_mvp_scale(&mvp, 0, DVZ_SCALE_LOG10, 0, (dvec2){1, 1000}, (vec2){-1, +1});
+    AT(mvp.scale_type[0] == DVZ_SCALE_LOG10);
+    AT(mvp.scale_type[1] == DVZ_SCALE_LINEAR);
+    float expected[] = {-1, -1. / 3, +1. / 3, +1};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        dvz_mvp_apply(&mvp, (vec4){(float)pow(10, i), .5, 0, 1}, out);
+        AC(out[0], expected[i], 1e-5);
+        AC(out[1], .5, EPS); // the linear axis is unchanged
+    }
+
+    // The nonpositive values on a log10 axis are discarded, as in the vertex shader.
+    dvz_mvp_apply(&mvp, (vec4){-1, .5, 0, 1}, out);
+    AT(isnan(out[0]));
+
+    // An invalid domain leaves the axis linear.
+    dvz_mvp_scale(&mvp, 1, DVZ_SCALE_LOG10, 0, (dvec2){-1, 1}, (vec2){-1, +1});
+    AT(mvp.scale_type[1] == DVZ_SCALE_LINEAR);
+
+    // Symlog axis: linear in [-10, 10], logarithmic outside, symmetric.
+    dvz_mvp_scale(&mvp, 1, DVZ_SCALE_SYMLOG, 10, (dvec2){-1000, 1000}, (vec2){-1, +1});
+    dvz_mvp_apply(&mvp, (vec4){1, 0, 0, 1}, out);
+    AC(out[1], 0, EPS);
+    dvz_mvp_apply(&mvp, (vec4){1, 10, 0, 1}, out);
+    AC(out[1], 1. / 3, 1e-5);
+    dvz_mvp_apply(&mvp, (vec4){1, -100, 0, 1}, out);
+    AC(out[1], -2. / 3, 1e-5);
+
+    // The scale functions and their inverses.
+    double x[] = {-1e5, -10, -.5, 0, .25, 7, 1e3};
+    for (uint32_t i = 0; i < sizeof(x) / sizeof(x[0]); i++)
+    {
+        double y = dvz_scale_apply(DVZ_SCALE_SYMLOG, 2, x[i]);
+        AC(dvz_scale_inverse(DVZ_SCALE_SYMLOG, 2, y), x[i], 1e-9 * MAX(1, fabs(x[i])));
+        if (x[i] > 0)
+        {
+            y = dvz_scale_apply(DVZ_SCALE_LOG10, 0, x[i]);
+            AC(dvz_scale_inverse(DVZ_SCALE_LOG10, 0, y), x[i], 1e-9 * MAX(1, fabs(x[i])));
+        }
+    }
+
+    // Back to linear.
+    dvz_mvp_scale(&mvp, 0, DVZ_SCALE_LINEAR, 0, (dvec2){0, 0}, (vec2){0, 0});
+    dvz_mvp_apply(&mvp, (vec4){3, 0, 0, 1}, out);
+    AC(out[0], 3, EPS);
+
+    return 0;
+}
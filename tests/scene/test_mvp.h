@@ -27,6 +27,10 @@
 
 int test_mvp_1(TstSuite*);
 
+int test_mvp_offset(TstSuite*);
+
+int test_mvp_scale(TstSuite*);
+
 
 
 #endif
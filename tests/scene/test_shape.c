@@ -15,7 +15,11 @@
 /*************************************************************************************************/
 
 #include "test_shape.h"
+#include "_cglm.h"
 #include "datoviz.h"
+#include "fileio.h"
+#include "scene/meshfile.h"
+#include "scene/meshopt.h"
 #include "test.h"
 #include "testing.h"
 #include "testing_utils.h"
@@ -103,3 +107,608 @@ int test_shape_obj(TstSuite* suite)
     dvz_shape_destroy(&shape);
     return 0;
 }
+
+
+
+static int _compare_triangles(const void* a, const void* b)
+{
+    const uint32_t* ta = (const uint32_t*)a;
+    const uint32_t* tb = (const uint32_t*)b;
+    for (uint32_t c = 0; c < 3; c++)
+        if (ta[c] != tb[c])
+            return ta[c] < tb[c] ? -1 : +1;
+    return 0;
+}
+
+
+
+// Triangles identified by the grid positions of their vertices, sorted.
+static uint32_t* _grid_triangles(DvzShape* shape, uint32_t n)
+{
+    uint32_t face_count = shape->index_count / 3;
+    uint32_t* triangles = (uint32_t*)calloc(3 * face_count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < shape->index_count; i++)
+    {
+        float* p = shape->pos[shape->index[i]];
+        triangles[i] = (uint32_t)p[0] * n + (uint32_t)p[1];
+    }
+    qsort(triangles, face_count, 3 * sizeof(uint32_t), _compare_triangles);
+    return triangles;
+}
+
+
+
+int test_shape_optimize(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Regular grid with shuffled triangles.
+    const uint32_t n = 50;
+    const uint32_t face_count = 2 * (n - 1) * (n - 1);
+    DvzShape shape = {0};
+    shape.vertex_count = n * n;
+    shape.index_count = 3 * face_count;
+    shape.pos = (vec3*)calloc(shape.vertex_count, sizeof(vec3));
+    shape.color = (DvzColor*)calloc(shape.vertex_count, sizeof(DvzColor));
+    shape.index = (DvzIndex*)calloc(shape.index_count, sizeof(DvzIndex));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            shape.pos[i * n + j][0] = i;
+            shape.pos[i * n + j][1] = j;
+            shape.color[i * n + j][0] = (uint8_t)(i + j);
+        }
+    }
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n - 1; i++)
+    {
+        for (uint32_t j = 0; j < n - 1; j++)
+        {
+            DvzIndex v = i * n + j;
+            DvzIndex quad[6] = {v, v + n, v + 1, v + 1, v + n, v + n + 1};
+            memcpy(&shape.index[k], quad, sizeof(quad));
+            k += 6;
+        }
+    }
+    uint64_t state = 42;
+    for (uint32_t t = face_count - 1; t > 0; t--)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t u = (uint32_t)((state >> 33) % (t + 1));
+        DvzIndex tmp[3] = {0};
+        memcpy(tmp, &shape.index[3 * t], sizeof(tmp));
+        memcpy(&shape.index[3 * t], &shape.index[3 * u], sizeof(tmp));
+        memcpy(&shape.index[3 * u], tmp, sizeof(tmp));
+    }
+
+    uint32_t* before = _grid_triangles(&shape, n);
+    float acmr_before = dvz_meshopt_acmr(shape.index_count, shape.index, shape.vertex_count, 16);
+    log_debug("ACMR before optimization: %.3f", acmr_before);
+    AT(acmr_before > 2);
+
+    dvz_shape_optimize(&shape);
+
+    float acmr_after = dvz_meshopt_acmr(shape.index_count, shape.index, shape.vertex_count, 16);
+    log_debug("ACMR after optimization: %.3f", acmr_after);
+    AT(acmr_after < 1);
+
+    // Same set of triangles, with the per-vertex values following their vertices.
+    uint32_t* after = _grid_triangles(&shape, n);
+    AT(memcmp(before, after, shape.index_count * sizeof(uint32_t)) == 0);
+    for (uint32_t v = 0; v < shape.vertex_count; v++)
+        AT(shape.color[v][0] == (uint8_t)(shape.pos[v][0] + shape.pos[v][1]));
+
+    // Vertices are fetched in order.
+    DvzIndex next = 0;
+    for (uint32_t i = 0; i < shape.index_count; i++)
+    {
+        AT(shape.index[i] <= next);
+        if (shape.index[i] == next)
+            next++;
+    }
+    AT(next == shape.vertex_count);
+
+    // Overdraw: the clusters facing outwards are drawn first. Two parallel quads with +z
+    // normals, the first one at z=-1 faces the mesh center, the second one at z=+1 faces away.
+    vec3 planes[] = {
+        {0, 0, -1}, {1, 0, -1}, {0, 1, -1}, {1, 1, -1}, {0, 0, +1}, {1, 0, +1}, {0, 1, +1},
+        {1, 1, +1}};
+    DvzIndex quads[] = {0, 1, 2, 1, 3, 2, 4, 5, 6, 5, 7, 6};
+    DvzIndex sorted[12] = {0};
+    dvz_meshopt_overdraw(12, quads, 8, planes, DVZ_MESHOPT_OVERDRAW_THRESHOLD, sorted);
+    AT(memcmp(sorted, &quads[6], 6 * sizeof(DvzIndex)) == 0);
+    AT(memcmp(&sorted[6], quads, 6 * sizeof(DvzIndex)) == 0);
+
+    // Indices that do not form a full triangle at the end are copied through.
+    DvzIndex partial[] = {0, 1, 2, 2, 1, 3, 3, 0};
+    DvzIndex out[8] = {0};
+    DvzIndex out2[8] = {0};
+    dvz_meshopt_vcache(8, partial, 4, out);
+    AT(out[6] == 3 && out[7] == 0);
+    dvz_meshopt_overdraw(8, out, 4, shape.pos, DVZ_MESHOPT_OVERDRAW_THRESHOLD, out2);
+    AT(out2[6] == 3 && out2[7] == 0);
+
+    FREE(before);
+    FREE(after);
+    dvz_shape_destroy(&shape);
+    return 0;
+}
+
+
+
+// Regular grid of a wavy surface in [-1, 1]^2.
+static DvzShape _wavy_grid(uint32_t n)
+{
+    DvzShape shape = {0};
+    shape.vertex_count = n * n;
+    shape.index_count = 6 * (n - 1) * (n - 1);
+    shape.pos = (vec3*)calloc(shape.vertex_count, sizeof(vec3));
+    shape.index = (DvzIndex*)calloc(shape.index_count, sizeof(DvzIndex));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            float x = -1 + 2 * i / (float)(n - 1);
+            float y = -1 + 2 * j / (float)(n - 1);
+            shape.pos[i * n + j][0] = x;
+            shape.pos[i * n + j][1] = y;
+            shape.pos[i * n + j][2] = .1f * sinf(3 * x) * cosf(2 * y);
+        }
+    }
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n - 1; i++)
+    {
+        for (uint32_t j = 0; j < n - 1; j++)
+        {
+            DvzIndex v = i * n + j;
+            DvzIndex quad[6] = {v, v + n, v + 1, v + 1, v + n, v + n + 1};
+            memcpy(&shape.index[k], quad, sizeof(quad));
+            k += 6;
+        }
+    }
+    return shape;
+}
+
+
+
+int test_shape_simplify(TstSuite* suite)
+{
+    ANN(suite);
+
+    const uint32_t n = 64;
+    DvzShape shape = _wavy_grid(n);
+    DvzShape other = _wavy_grid(n);
+    uint32_t index_count = shape.index_count;
+
+    float error = dvz_shape_simplify(&shape, .25f);
+    log_debug(
+        "simplified %d to %d indices, relative error %.6f", index_count, shape.index_count, error);
+    AT(shape.index_count <= index_count / 3);
+    AT(shape.index_count >= index_count / 8);
+    AT(0 < error && error < .05f);
+
+    // Valid, non-degenerate triangles.
+    for (uint32_t i = 0; i < shape.index_count; i += 3)
+    {
+        DvzIndex* tri = &shape.index[i];
+        AT(tri[0] < shape.vertex_count && tri[1] < shape.vertex_count);
+        AT(tri[2] < shape.vertex_count);
+        AT(tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2]);
+    }
+
+    // Deterministic.
+    AT(dvz_shape_simplify(&other, .25f) == error);
+    AT(other.index_count == shape.index_count);
+    AT(memcmp(other.index, shape.index, shape.index_count * sizeof(DvzIndex)) == 0);
+    dvz_shape_destroy(&other);
+    dvz_shape_destroy(&shape);
+
+    // Levels of detail.
+    shape = _wavy_grid(n);
+    float ratios[] = {1, .5f, .25f, .1f};
+    dvz_shape_lod(&shape, 4, ratios);
+    AT(shape.lod_count == 4);
+    AT(shape.lod_first[0] == 0);
+    AT(shape.lod_index_count[0] == index_count);
+    AT(shape.lod_error[0] == 0);
+    for (uint32_t k = 1; k < shape.lod_count; k++)
+    {
+        log_debug(
+            "level #%d: %d indices, relative error %.6f", k, shape.lod_index_count[k],
+            shape.lod_error[k]);
+        AT(shape.lod_first[k] == shape.lod_first[k - 1] + shape.lod_index_count[k - 1]);
+        AT(shape.lod_index_count[k] < shape.lod_index_count[k - 1]);
+        AT(shape.lod_error[k] >= shape.lod_error[k - 1]);
+    }
+    AT(shape.index_count == shape.lod_first[3] + shape.lod_index_count[3]);
+    AT(shape.lod_index_count[3] <= index_count / 5);
+
+    dvz_shape_destroy(&shape);
+    return 0;
+}
+
+
+
+int test_shape_save(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzShape shape = _wavy_grid(32);
+    shape.type = DVZ_SHAPE_SURFACE;
+    shape.color = (DvzColor*)calloc(shape.vertex_count, sizeof(DvzColor));
+    for (uint32_t v = 0; v < shape.vertex_count; v++)
+        shape.color[v][0] = (uint8_t)v;
+    float ratios[] = {1, .25f};
+    dvz_shape_lod(&shape, 2, ratios);
+
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/shape.dvzmesh", ARTIFACTS_DIR);
+    AT(dvz_shape_save(&shape, path) == 0);
+
+    DvzShape loaded = dvz_shape_load(path);
+    AT(loaded.type == DVZ_SHAPE_SURFACE);
+    AT(loaded.vertex_count == shape.vertex_count);
+    AT(loaded.index_count == shape.index_count);
+    AT(loaded.normal == NULL);
+    AT(memcmp(loaded.pos, shape.pos, shape.vertex_count * sizeof(vec3)) == 0);
+    AT(memcmp(loaded.color, shape.color, shape.vertex_count * sizeof(DvzColor)) == 0);
+    AT(memcmp(loaded.index, shape.index, shape.index_count * sizeof(DvzIndex)) == 0);
+    AT(loaded.lod_count == 2);
+    AT(loaded.lod_index_count[1] == shape.lod_index_count[1]);
+    AT(loaded.lod_error[1] == shape.lod_error[1]);
+
+    // Invalid file.
+    snprintf(path, sizeof(path), "%s/shape_invalid.dvzmesh", ARTIFACTS_DIR);
+    const char* text = "not a mesh";
+    dvz_write_bytes(path, "wb", strlen(text), (const uint8_t*)text);
+    DvzShape invalid = dvz_shape_load(path);
+    AT(invalid.vertex_count == 0);
+    AT(invalid.pos == NULL);
+
+    // Stale cache.
+    snprintf(path, sizeof(path), "%s/shape_cache.dvzmesh", ARTIFACTS_DIR);
+    AT(dvz_meshfile_write(&shape, path, 1000, 123456789) == 0);
+    AT(!dvz_meshfile_read(path, 1000, 123456790, &invalid));
+    AT(!dvz_meshfile_read(path, 1001, 123456789, &invalid));
+    AT(dvz_meshfile_read(path, 1000, 123456789, &invalid));
+    dvz_shape_destroy(&invalid);
+
+    // Levels of detail and indices inconsistent with the vertex and index counts.
+    snprintf(path, sizeof(path), "%s/shape_corrupt.dvzmesh", ARTIFACTS_DIR);
+    shape.lod_first[1] = shape.index_count;
+    AT(dvz_shape_save(&shape, path) == 0);
+    invalid = dvz_shape_load(path);
+    AT(invalid.vertex_count == 0);
+    shape.lod_first[1] = 0;
+
+    shape.index[shape.index_count - 1] = shape.vertex_count;
+    AT(dvz_shape_save(&shape, path) == 0);
+    invalid = dvz_shape_load(path);
+    AT(invalid.vertex_count == 0);
+    AT(invalid.index == NULL);
+
+    dvz_shape_destroy(&loaded);
+    dvz_shape_destroy(&shape);
+    return 0;
+}
+
+
+
+int test_shape_normals(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzShape shape = _wavy_grid(128);
+    uint32_t vertex_count = shape.vertex_count;
+    shape.normal = (vec3*)calloc(vertex_count, sizeof(vec3));
+    dvz_shape_normals(&shape);
+
+    // Reference: serial accumulation of the face normals.
+    vec3* expected = (vec3*)calloc(vertex_count, sizeof(vec3));
+    for (uint32_t i = 0; i < shape.index_count; i += 3)
+    {
+        DvzIndex* tri = &shape.index[i];
+        vec3 u = {0}, v = {0}, n = {0};
+        glm_vec3_sub(shape.pos[tri[1]], shape.pos[tri[0]], u);
+        glm_vec3_sub(shape.pos[tri[2]], shape.pos[tri[0]], v);
+        glm_vec3_crossn(u, v, n);
+        for (uint32_t c = 0; c < 3; c++)
+            glm_vec3_add(expected[tri[c]], n, expected[tri[c]]);
+    }
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        glm_vec3_normalize(expected[i]);
+        AT(glm_vec3_distance(shape.normal[i], expected[i]) < 1e-5);
+        AT(fabsf(glm_vec3_norm(shape.normal[i]) - 1) < 1e-5);
+    }
+
+#if HAS_OPENMP
+    // Bitwise identical results with a single thread.
+    vec3* single = (vec3*)calloc(vertex_count, sizeof(vec3));
+    int num_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    dvz_compute_normals(vertex_count, shape.index_count, shape.pos, shape.index, single);
+    omp_set_num_threads(num_threads);
+    AT(memcmp(single, shape.normal, vertex_count * sizeof(vec3)) == 0);
+    FREE(single);
+#endif
+
+    // Transform the second half of the vertices only.
+    vec3 first_pos = {0};
+    glm_vec3_copy(shape.pos[0], first_pos);
+    vec3 last_pos = {0}, last_normal = {0};
+    glm_vec3_copy(shape.pos[vertex_count - 1], last_pos);
+    glm_vec3_copy(shape.normal[vertex_count - 1], last_normal);
+
+    dvz_shape_begin(&shape, vertex_count / 2, vertex_count / 2);
+    dvz_shape_scale(&shape, (vec3){2, 2, 4});
+    dvz_shape_translate(&shape, (vec3){1, 0, 0});
+    dvz_shape_end(&shape);
+
+    AT(glm_vec3_eqv(shape.pos[0], first_pos));
+    AT(fabsf(shape.pos[vertex_count - 1][0] - (2 * last_pos[0] + 1)) < 1e-5);
+    AT(fabsf(shape.pos[vertex_count - 1][2] - 4 * last_pos[2]) < 1e-5);
+
+    // The normals follow the inverse transpose of the transformation.
+    AT(fabsf(shape.normal[vertex_count - 1][0] - last_normal[0] / 2) < 1e-5);
+    AT(fabsf(shape.normal[vertex_count - 1][2] - last_normal[2] / 4) < 1e-5);
+
+    FREE(expected);
+    dvz_shape_destroy(&shape);
+    return 0;
+}
+
+
+
+
+int test_shape_borders(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Two triangles sharing the edge (1, 2): the edges opposite to corner 0 are not borders.
+    DvzIndex quad[] = {0, 1, 2, 3, 2, 1};
+    uint8_t flags[2] = {0};
+    dvz_meshopt_borders(6, quad, flags);
+    AT(flags[0] == 0x06);
+    AT(flags[1] == 0x06);
+
+    // Grid: the border edges are on the boundary of the grid.
+    uint32_t n = 64;
+    DvzShape shape = _wavy_grid(n);
+    uint32_t face_count = shape.index_count / 3;
+    uint8_t* borders = (uint8_t*)calloc(face_count, sizeof(uint8_t));
+    dvz_meshopt_borders(shape.index_count, shape.index, borders);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < face_count; i++)
+        for (uint32_t c = 0; c < 3; c++)
+            count += (borders[i] >> c) & 1;
+    AT(count == 4 * (n - 1));
+
+    FREE(borders);
+    dvz_shape_destroy(&shape);
+    return 0;
+}
+
+
+
+static double _triangle_area(const dvec2* points, const DvzIndex* tri)
+{
+    const double* a = points[tri[0]];
+    const double* b = points[tri[1]];
+    const double* c = points[tri[2]];
+    return .5 * fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]));
+}
+
+
+
+int test_shape_polygons(TstSuite* suite)
+{
+    ANN(suite);
+
+    // A 2x2 square with a 1x1 square hole, and a triangle.
+    dvec2 points[] = {
+        {-1, -1}, {+1, -1}, {+1, +1}, {-1, +1},         // outer ring
+        {-.5, -.5}, {-.5, +.5}, {+.5, +.5}, {+.5, -.5}, // hole
+        {2, 0},   {3, 0},   {2, 1},                     // triangle
+    };
+    uint32_t ring_offsets[] = {0, 4, 8, 11};
+    uint32_t polygon_offsets[] = {0, 2, 3};
+    uint32_t index_offsets[3] = {0};
+    uint32_t index_count = 0;
+    DvzIndex* indices = dvz_earcut_polygons(
+        2, polygon_offsets, ring_offsets, (const dvec2*)points, &index_count, index_offsets);
+    AT(index_count == 3 * (8 + 1));
+    AT(index_offsets[0] == 0);
+    AT(index_offsets[1] == 3 * 8);
+    AT(index_offsets[2] == index_count);
+
+    // The triangles cover the polygon areas, and refer to their own points.
+    double area = 0;
+    for (uint32_t i = 0; i < index_offsets[1]; i += 3)
+    {
+        AT(indices[i] < 8 && indices[i + 1] < 8 && indices[i + 2] < 8);
+        area += _triangle_area((const dvec2*)points, &indices[i]);
+    }
+    AT(fabs(area - 3) < 1e-9);
+    for (uint32_t i = index_offsets[1]; i < index_count; i++)
+        AT(indices[i] >= 8);
+    FREE(indices);
+
+    // Many polygons: same triangulation as one polygon at a time.
+    uint32_t polygon_count = 1000;
+    uint32_t* offsets = (uint32_t*)calloc(polygon_count + 1, sizeof(uint32_t));
+    uint32_t* rings = (uint32_t*)calloc(polygon_count + 1, sizeof(uint32_t));
+    for (uint32_t p = 0; p < polygon_count; p++)
+    {
+        offsets[p + 1] = p + 1;
+        rings[p + 1] = rings[p] + 3 + (p % 17);
+    }
+    uint32_t point_count = rings[polygon_count];
+    dvec2* star = (dvec2*)calloc(point_count, sizeof(dvec2));
+    for (uint32_t p = 0; p < polygon_count; p++)
+    {
+        uint32_t n = rings[p + 1] - rings[p];
+        for (uint32_t i = 0; i < n; i++)
+        {
+            double r = (i % 2 == 0) ? 1 : .5;
+            star[rings[p] + i][0] = p + r * cos(M_2PI * i / n);
+            star[rings[p] + i][1] = r * sin(M_2PI * i / n);
+        }
+    }
+    uint32_t* batch_offsets = (uint32_t*)calloc(polygon_count + 1, sizeof(uint32_t));
+    indices = dvz_earcut_polygons(
+        polygon_count, offsets, rings, (const dvec2*)star, &index_count, batch_offsets);
+    for (uint32_t p = 0; p < polygon_count; p++)
+    {
+        uint32_t count = 0;
+        DvzIndex* single = dvz_earcut(rings[p + 1] - rings[p], &star[rings[p]], &count);
+        AT(count == batch_offsets[p + 1] - batch_offsets[p]);
+        for (uint32_t i = 0; i < count; i++)
+            AT(indices[batch_offsets[p] + i] == rings[p] + single[i]);
+        FREE(single);
+    }
+    FREE(indices);
+
+    // Shape.
+    DvzColor* colors = (DvzColor*)calloc(polygon_count, sizeof(DvzColor));
+    DvzShape shape = dvz_shape_polygons(polygon_count, offsets, rings, (const dvec2*)star, colors);
+    AT(shape.vertex_count == point_count);
+    AT(shape.index_count == index_count);
+    dvz_shape_destroy(&shape);
+
+    FREE(colors);
+    FREE(batch_offsets);
+    FREE(star);
+    FREE(rings);
+    FREE(offsets);
+    return 0;
+}
+
+
+
+static int _cmp_uint64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+
+
+// Check that every oriented edge appears once, and its opposite edge once.
+static int _check_watertight(DvzShape* shape)
+{
+    uint32_t ni = shape->index_count;
+    uint64_t* edges = (uint64_t*)calloc(ni, sizeof(uint64_t));
+    for (uint32_t t = 0; t < ni / 3; t++)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+            edges[3 * t + k] = ((uint64_t)shape->index[3 * t + k] << 32) |
+                               shape->index[3 * t + (k + 1) % 3];
+    }
+    qsort(edges, ni, sizeof(uint64_t), _cmp_uint64);
+    int res = 0;
+    for (uint32_t i = 0; i < ni; i++)
+    {
+        uint64_t opposite = (edges[i] << 32) | (edges[i] >> 32);
+        if ((i > 0 && edges[i] == edges[i - 1]) ||
+            bsearch(&opposite, edges, ni, sizeof(uint64_t), _cmp_uint64) == NULL)
+            res = 1;
+    }
+    FREE(edges);
+    return res;
+}
+
+
+
+int test_shape_isosurface(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Density decreasing from the center, the volume spans several bricks along each axis.
+    uint32_t width = 40, height = 37, depth = 35;
+    float* volume = (float*)calloc(width * height * depth, sizeof(float));
+    vec3 o = {-1, -1, -1};
+    vec3 u = {2.0 / (width - 1), 0, 0};
+    vec3 v = {0, 2.0 / (height - 1), 0};
+    vec3 w = {0, 0, 2.0 / (depth - 1)};
+    for (uint32_t z = 0; z < depth; z++)
+    {
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                vec3 p = {o[0] + x * u[0], o[1] + y * v[1], o[2] + z * w[2]};
+                volume[(z * height + y) * width + x] = 1 - glm_vec3_norm(p);
+            }
+        }
+    }
+
+    // Sphere of radius 0.6.
+    DvzShape shape =
+        dvz_shape_isosurface(width, height, depth, volume, .4, NULL, o, u, v, w, DVZ_WHITE);
+    uint32_t nv = shape.vertex_count;
+    uint32_t ni = shape.index_count;
+    AT(nv > 1000);
+    AT(ni % 3 == 0);
+    for (uint32_t i = 0; i < nv; i++)
+    {
+        float r = glm_vec3_norm(shape.pos[i]);
+        AT(fabs(r - .6) < .01);
+        // The normals point outwards, towards the low values.
+        AT(glm_vec3_dot(shape.normal[i], shape.pos[i]) / r > .95);
+    }
+
+    // Watertight mesh with the Euler characteristic of a sphere.
+    AT(_check_watertight(&shape) == 0);
+    AT((int64_t)nv - (int64_t)ni / 2 + (int64_t)ni / 3 == 2);
+
+    // Same isosurface with precomputed brick ranges.
+    uint32_t brick_count = dvz_isosurface_bricks(width, height, depth);
+    AT(brick_count == 27);
+    vec2* ranges = (vec2*)calloc(brick_count, sizeof(vec2));
+    dvz_isosurface_ranges(width, height, depth, volume, ranges);
+    DvzShape shape_ranges =
+        dvz_shape_isosurface(width, height, depth, volume, .4, ranges, o, u, v, w, DVZ_WHITE);
+    AT(shape_ranges.vertex_count == nv);
+    AT(shape_ranges.index_count == ni);
+    AT(memcmp(shape_ranges.index, shape.index, ni * sizeof(DvzIndex)) == 0);
+    dvz_shape_destroy(&shape_ranges);
+
+    // Level out of the value range.
+    DvzShape empty =
+        dvz_shape_isosurface(width, height, depth, volume, 2, ranges, o, u, v, w, DVZ_WHITE);
+    AT(empty.vertex_count == 0);
+    AT(empty.index_count == 0);
+    dvz_shape_destroy(&empty);
+
+    dvz_shape_destroy(&shape);
+    FREE(ranges);
+    FREE(volume);
+
+    // Random values with many ambiguous cases, zero on the border so that the surface is closed.
+    uint32_t n = 40;
+    volume = (float*)calloc(n * n * n, sizeof(float));
+    uint32_t seed = 1;
+    for (uint32_t z = 1; z < n - 1; z++)
+    {
+        for (uint32_t y = 1; y < n - 1; y++)
+        {
+            for (uint32_t x = 1; x < n - 1; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                volume[(z * n + y) * n + x] = (seed >> 8) / (float)(1 << 24);
+            }
+        }
+    }
+    shape = dvz_shape_isosurface(
+        n, n, n, volume, .5, NULL, (vec3){0, 0, 0}, (vec3){1, 0, 0}, (vec3){0, 1, 0},
+        (vec3){0, 0, 1}, DVZ_WHITE);
+    AT(shape.index_count > 0);
+    AT(_check_watertight(&shape) == 0);
+    dvz_shape_destroy(&shape);
+    FREE(volume);
+
+    return 0;
+}
@@ -33,6 +33,20 @@ int test_shape_transform(TstSuite*);
 
 int test_shape_obj(TstSuite*);
 
+int test_shape_optimize(TstSuite*);
+
+int test_shape_simplify(TstSuite*);
+
+int test_shape_save(TstSuite*);
+
+int test_shape_normals(TstSuite*);
+
+int test_shape_borders(TstSuite*);
+
+int test_shape_polygons(TstSuite*);
+
+int test_shape_isosurface(TstSuite*);
+
 
 
 #endif
@@ -47,3 +47,45 @@ int test_ticks_1(TstSuite* suite)
     dvz_ticks_destroy(ticks);
     return 0;
 }
+
+
+
+int test_ticks_scale(TstSuite* suite)
+{
+    ANN(suite);
+    DvzTicks* ticks = dvz_ticks(DVZ_TICKS_FLAGS_LOG);
+    dvz_ticks_size(ticks, 500, 10);
+    double values[MAX_LABELS] = {0};
+    double lmin = 0, lmax = 0, lstep = 0;
+    uint32_t count = 0;
+
+    // Log axis on several decades: one tick per decade.
+    dvz_ticks_compute(ticks, .5, 2e4, 10);
+    count = dvz_ticks_range(ticks, &lmin, &lmax, &lstep);
+    AT(count == 5);
+    AC(lmin, 0, EPS);
+    AC(lstep, 1, EPS);
+    AT(dvz_ticks_values(ticks, MAX_LABELS, values) == count);
+    for (uint32_t i = 0; i < count; i++)
+        AC(values[i], pow(10, i), 1e-9 * pow(10, i));
+
+    // Many decades: integer steps.
+    dvz_ticks_compute(ticks, 1e-10, 1e10, 5);
+    count = dvz_ticks_range(ticks, &lmin, &lmax, &lstep);
+    AT(count <= 6);
+    AC(lstep, round(lstep), EPS);
+    AC(lmin / lstep, round(lmin / lstep), EPS);
+
+    // Symlog axis around zero: 0, +/- threshold, and decades beyond.
+    dvz_ticks_scale(ticks, DVZ_SCALE_SYMLOG, 1);
+    dvz_ticks_compute(ticks, -150, 1500, 10);
+    count = dvz_ticks_range(ticks, &lmin, &lmax, &lstep);
+    AT(dvz_ticks_values(ticks, MAX_LABELS, values) == count);
+    AT(count == 8);
+    double expected[] = {-100, -10, -1, 0, 1, 10, 100, 1000};
+    for (uint32_t i = 0; i < count; i++)
+        AC(values[i], expected[i], 1e-9 * MAX(1, fabs(expected[i])));
+
+    dvz_ticks_destroy(ticks);
+    return 0;
+}
@@ -17,8 +17,11 @@
 #include "scene/test_visual.h"
 #include "datoviz_protocol.h"
 #include "renderer.h"
+#include "scene/array.h"
+#include "scene/baker.h"
 #include "scene/scene_testing_utils.h"
 #include "scene/visual.h"
+#include "scene/visuals/point.h"
 #include "test.h"
 #include "testing.h"
 #include "testing_utils.h"
@@ -94,3 +97,132 @@ int test_visual_1(TstSuite* suite)
     FREE(color);
     return 0;
 }
+
+
+
+int test_visual_lod(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzVisual visual = {0};
+    visual.flags = DVZ_VISUAL_FLAGS_INDEXED;
+
+    uint32_t first[] = {0, 600, 900};
+    uint32_t index_count[] = {600, 300, 90};
+    float error[] = {0, .01f, .05f};
+    vec4 sphere = {0, 0, 0, 1};
+    dvz_visual_lod(&visual, 3, first, index_count, error, sphere);
+    AT(visual.lod_count == 3);
+    AT(visual.lod_level == 0);
+
+    // Orthographic projection: the bounding sphere radius is 300 pixels.
+    vec2 size = {800, 600};
+    DvzMVP mvp = dvz_mvp_default();
+    AT(dvz_visual_lod_select(&visual, &mvp, size) == 0);
+
+    // 30 pixels.
+    mvp.model[0][0] = mvp.model[1][1] = mvp.model[2][2] = .1f;
+    AT(dvz_visual_lod_select(&visual, &mvp, size) == 1);
+
+    // 3 pixels.
+    mvp.model[0][0] = mvp.model[1][1] = mvp.model[2][2] = .01f;
+    AT(dvz_visual_lod_select(&visual, &mvp, size) == 2);
+
+    // Perspective projection, the level increases with the distance to the camera.
+    mvp = dvz_mvp_default();
+    mvp.proj[2][3] = -1;
+    mvp.proj[3][3] = 0;
+    uint32_t level = 0;
+    for (float d = 2; d < 1000; d *= 2)
+    {
+        mvp.view[3][2] = -d;
+        uint32_t new_level = dvz_visual_lod_select(&visual, &mvp, size);
+        AT(new_level >= level);
+        level = new_level;
+    }
+    AT(level == 2);
+
+    // Behind the camera.
+    mvp.view[3][2] = +10;
+    AT(dvz_visual_lod_select(&visual, &mvp, size) == 2);
+
+    return 0;
+}
+
+
+
+
+int test_visual_quantize(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzBatch* batch = dvz_batch();
+    const uint32_t n = 5;
+
+    DvzVisual* visual = dvz_point(batch, DVZ_VISUAL_FLAGS_QUANTIZED);
+    AT(visual->quantize_slot == 2);
+    dvz_point_alloc(visual, n);
+
+    // Positions well outside of the NDC cube, with a flat z axis.
+    vec3 pos[] = {{-100, 10, 5}, {300, 20, 5}, {0, 15, 5}, {150, 12.5, 5}, {-50, 19, 5}};
+    dvz_point_position(visual, 0, n, pos, 0);
+
+    DvzParams* params = visual->params[visual->quantize_slot];
+    float* scale = (float*)dvz_params_get(params, 0);
+    float* offset = (float*)dvz_params_get(params, 1);
+    AC(scale[0], 200, EPS);
+    AC(scale[1], 5, EPS);
+    AC(scale[2], 0, EPS);
+    AC(offset[0], 100, EPS);
+    AC(offset[1], 15, EPS);
+    AC(offset[2], 5, EPS);
+
+    // Decode the positions as in quantize.glsl.
+    DvzArray* array = visual->baker->vertex_bindings[0].dual.array;
+    int16_t q[4] = {0};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        memcpy(q, dvz_array_item(array, i), sizeof(q));
+        for (uint32_t j = 0; j < 3; j++)
+            AC(q[j] / 32767.0f * scale[j] + offset[j], pos[i][j], 1e-4 * 200);
+    }
+
+    // A partial update outside of the box grows it and requantizes the other positions.
+    vec3 far = {1000, -30, 5};
+    dvz_point_position(visual, 2, 1, &far, 0);
+    AC(scale[0], 550, EPS);
+    AC(offset[0], 450, EPS);
+    memcpy(pos[2], far, sizeof(vec3));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        memcpy(q, dvz_array_item(array, i), sizeof(q));
+        for (uint32_t j = 0; j < 3; j++)
+            AC(q[j] / 32767.0f * scale[j] + offset[j], pos[i][j], 1e-4 * 550);
+    }
+
+    // Successive growths requantize from the source positions: the snorm16 values are the same
+    // as with a direct quantization in the final box, without any accumulated error.
+    for (uint32_t k = 1; k <= 20; k++)
+    {
+        vec3 p = {1000 + 37.3f * k, -30 - 1.7f * k, 5};
+        dvz_point_position(visual, 4, 1, &p, 0);
+        memcpy(pos[4], p, sizeof(vec3));
+    }
+    DvzBox box = visual->quantize_box;
+    double bmin[] = {box.xmin, box.ymin, box.zmin};
+    double bmax[] = {box.xmax, box.ymax, box.zmax};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        memcpy(q, dvz_array_item(array, i), sizeof(q));
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            double a = bmax[j] != bmin[j] ? 2 / (bmax[j] - bmin[j]) : 1;
+            float v = (float)((pos[i][j] - bmin[j]) * a - 1);
+            AT(q[j] == (int16_t)lrintf(v * 32767.0f));
+        }
+    }
+
+    dvz_visual_destroy(visual);
+    dvz_batch_destroy(batch);
+    return 0;
+}
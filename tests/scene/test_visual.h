@@ -27,6 +27,10 @@
 
 int test_visual_1(TstSuite*);
 
+int test_visual_lod(TstSuite*);
+
+int test_visual_quantize(TstSuite*);
+
 
 
 #endif
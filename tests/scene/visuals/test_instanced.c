@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing instanced mesh                                                                       */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/visuals/test_instanced.h"
+#include "_cglm.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "renderer.h"
+#include "scene/arcball.h"
+#include "scene/scene_testing_utils.h"
+#include "scene/viewport.h"
+#include "scene/visual.h"
+#include "scene/visuals/instanced.h"
+#include "scene/visuals/visual_test.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Instanced mesh tests                                                                         */
+/*************************************************************************************************/
+
+int test_instanced_1(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("instanced", VISUAL_TEST_ARCBALL, 0);
+
+    // Shape, uploaded once.
+    DvzColor faces[6] = {0};
+    for (uint32_t i = 0; i < 6; i++)
+        memcpy(faces[i], DVZ_WHITE, sizeof(DvzColor));
+    DvzShape shape = dvz_shape_cube(faces);
+
+    // Create the visual.
+    DvzVisual* visual = dvz_instanced(vt.batch, DVZ_MESH_FLAGS_LIGHTING);
+    uint32_t n = 16;
+    uint32_t count = n * n * n;
+    dvz_instanced_alloc(visual, &shape, count);
+
+    // Instances on a 3D grid, with random rotations and colors.
+    vec3* pos = (vec3*)calloc(count, sizeof(vec3));
+    vec4* rot = (vec4*)calloc(count, sizeof(vec4));
+    vec3* scale = (vec3*)calloc(count, sizeof(vec3));
+    DvzColor* color = (DvzColor*)calloc(count, sizeof(DvzColor));
+    float step = 2.0 / (n - 1);
+    uint32_t idx = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            for (uint32_t k = 0; k < n; k++)
+            {
+                pos[idx][0] = -1 + i * step;
+                pos[idx][1] = -1 + j * step;
+                pos[idx][2] = -1 + k * step;
+
+                vec3 axis = {dvz_rand_float(), dvz_rand_float(), dvz_rand_float()};
+                glm_quatv(rot[idx], M_2PI * dvz_rand_float(), axis);
+
+                scale[idx][0] = scale[idx][1] = scale[idx][2] = .25 * step;
+                scale[idx][0] *= 2;
+
+                dvz_colormap_scale(DVZ_CMAP_HSV, idx, 0, count, color[idx]);
+                idx++;
+            }
+        }
+    }
+    dvz_instanced_position(visual, 0, count, pos, 0);
+    dvz_instanced_rotation(visual, 0, count, rot, 0);
+    dvz_instanced_scale(visual, 0, count, scale, 0);
+    dvz_instanced_color(visual, 0, count, color, 0);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    FREE(pos);
+    FREE(rot);
+    FREE(scale);
+    FREE(color);
+    dvz_shape_destroy(&shape);
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_INSTANCED
+#define DVZ_HEADER_TEST_INSTANCED
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Instanced mesh tests                                                                         */
+/*************************************************************************************************/
+
+int test_instanced_1(TstSuite*);
+
+
+
+#endif
@@ -492,6 +492,61 @@ int test_mesh_surface(TstSuite* suite)
 
 
 
+int test_mesh_wireframe(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("mesh_wireframe", VISUAL_TEST_ARCBALL, 0);
+
+    // Grid size.
+    uint32_t row_count = 50;
+    uint32_t col_count = row_count;
+
+    // Grid parameters.
+    vec3 o = {-1, 0, -1};
+    vec3 u = {0, 0, 2.0 / (col_count - 1)};
+    vec3 v = {2.0 / (row_count - 1), 0, 0};
+
+    // Heights and colors.
+    float* heights = (float*)calloc(row_count * col_count, sizeof(float));
+    DvzColor* colors = (DvzColor*)calloc(row_count * col_count, sizeof(DvzColor));
+    uint32_t idx = 0;
+    float h = 0;
+    for (uint32_t i = 0; i < row_count; i++)
+    {
+        for (uint32_t j = 0; j < col_count; j++)
+        {
+            h = .25 * sin(4 * M_2PI * i / row_count) * cos(3 * M_2PI * j / col_count);
+            heights[idx] = h;
+            dvz_colormap_scale(DVZ_CMAP_PLASMA, -h, -.25, +.25, colors[idx]);
+            idx++;
+        }
+    }
+
+    // The shape stays indexed, the edges and face normals are computed in the shader.
+    DvzShape shape = dvz_shape_surface(row_count, col_count, heights, colors, o, u, v, 0);
+    int flags = DVZ_MESH_FLAGS_LIGHTING | DVZ_MESH_FLAGS_FLAT | DVZ_MESH_FLAGS_WIREFRAME;
+    DvzVisual* visual = dvz_mesh_shape(vt.batch, &shape, flags);
+    dvz_mesh_stroke(visual, (DvzColor){TO_ALPHA(50), TO_ALPHA(50), TO_ALPHA(50), TO_ALPHA(255)});
+    dvz_mesh_linewidth(visual, 1);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    dvz_arcball_initial(vt.arcball, (vec3){0.42339, -0.39686, -0.00554});
+    dvz_panel_update(vt.panel);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    FREE(heights);
+    FREE(colors);
+    dvz_shape_destroy(&shape);
+
+    return 0;
+}
+
+
+
 static inline void _gui_callback(DvzApp* app, DvzId canvas_id, DvzGuiEvent ev)
 {
     VisualTest* vt = ev.user_data;
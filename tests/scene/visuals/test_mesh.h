@@ -35,6 +35,8 @@ int test_mesh_contour(TstSuite*);
 
 int test_mesh_surface(TstSuite*);
 
+int test_mesh_wireframe(TstSuite*);
+
 int test_mesh_obj(TstSuite*);
 
 int test_mesh_geo(TstSuite* suite);
@@ -261,3 +261,56 @@ int test_path_closed(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_path_isolines(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("path_isolines", VISUAL_TEST_PANZOOM, 0);
+
+    // Sum of two gaussians, on [-1, +1]^2.
+    uint32_t n = 256;
+    float* values = (float*)calloc(n * n, sizeof(float));
+    float x = 0, y = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            x = -1 + 2 * i / (float)(n - 1);
+            y = -1 + 2 * j / (float)(n - 1);
+            values[i * n + j] = exp(-4 * ((x - .3) * (x - .3) + y * y)) +
+                                exp(-6 * ((x + .4) * (x + .4) + (y - .2) * (y - .2)));
+        }
+    }
+
+    // Isolines.
+    uint32_t level_count = 10;
+    float* levels = (float*)calloc(level_count, sizeof(float));
+    for (uint32_t l = 0; l < level_count; l++)
+        levels[l] = .1 * (l + 1);
+    float d = 2.0 / (n - 1);
+    DvzIsolines isolines = dvz_isolines(
+        n, n, values, level_count, levels, (vec3){-1, -1, 0}, (vec3){d, 0, 0}, (vec3){0, d, 0});
+
+    // Colors.
+    DvzColor* colors = dvz_mock_cmap(level_count, DVZ_CMAP_VIRIDIS, 255);
+
+    // Create the visual.
+    DvzVisual* visual = dvz_path(vt.batch, 0);
+    dvz_path_isolines(visual, &isolines, colors);
+    dvz_path_linewidth(visual, 2.0);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    dvz_isolines_destroy(&isolines);
+    FREE(values);
+    FREE(levels);
+    FREE(colors);
+
+    return 0;
+}
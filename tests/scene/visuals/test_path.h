@@ -31,6 +31,8 @@ int test_path_2(TstSuite*);
 
 int test_path_closed(TstSuite*);
 
+int test_path_isolines(TstSuite*);
+
 
 
 #endif
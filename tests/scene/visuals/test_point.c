@@ -70,3 +70,59 @@ int test_point_1(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_point_mask(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("point_mask", VISUAL_TEST_PANZOOM, 0);
+
+    // Number of items.
+    const uint32_t n = 10000;
+
+    // Create the visual.
+    DvzVisual* visual = dvz_point(vt.batch, DVZ_VISUAL_FLAGS_MASK);
+
+    // Visual allocation.
+    dvz_point_alloc(visual, n);
+
+    // Position.
+    vec3* pos = dvz_mock_pos2D(n, 0.25);
+    dvz_point_position(visual, 0, n, pos, 0);
+
+    // Color.
+    DvzColor* color = dvz_mock_color(n, TO_ALPHA(128));
+    dvz_point_color(visual, 0, n, color, 0);
+
+    // Size.
+    float* size = dvz_mock_full(n, 20);
+    dvz_point_size(visual, 0, n, size, 0);
+
+    // Hide the left half, select the upper right quadrant, and dim the rest.
+    uint8_t* bits = (uint8_t*)calloc(n, sizeof(uint8_t));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (pos[i][0] < 0)
+            bits[i] = DVZ_MASK_FLAGS_HIDDEN;
+        else if (pos[i][1] > 0)
+            bits[i] = DVZ_MASK_FLAGS_SELECTED | DVZ_MASK_FLAGS_HIGHLIGHTED;
+        else
+            bits[i] = DVZ_MASK_FLAGS_DIMMED;
+    }
+    dvz_visual_mask(visual, 0, n, bits);
+    dvz_visual_mask_style(visual, (vec4){1, 1, 0, 1}, 2, .25);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    FREE(pos);
+    FREE(color);
+    FREE(size);
+    FREE(bits);
+
+    return 0;
+}
@@ -27,6 +27,8 @@
 
 int test_point_1(TstSuite*);
 
+int test_point_mask(TstSuite*);
+
 
 
 #endif
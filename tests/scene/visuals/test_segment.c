@@ -20,6 +20,7 @@
 #include "scene/scene_testing_utils.h"
 #include "scene/viewport.h"
 #include "scene/visual.h"
+#include "scene/visuals/point.h"
 #include "scene/visuals/segment.h"
 #include "scene/visuals/visual_test.h"
 #include "test.h"
@@ -94,3 +95,36 @@ int test_segment_1(TstSuite* suite)
 
     return 0;
 }
+
+
+
+int test_segment_mask(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzBatch* batch = dvz_batch();
+    const uint32_t n = 8;
+
+    // The segment shaders do not read the mask, the flag is dropped when creating the visual.
+    DvzVisual* visual = dvz_segment(batch, DVZ_VISUAL_FLAGS_MASK);
+    AT((visual->flags & DVZ_VISUAL_FLAGS_MASK) == 0);
+    AT(visual->mask_slot == 0);
+    dvz_segment_alloc(visual, n);
+    AT(visual->mask.array == NULL);
+
+    // Setting the mask is a no-op.
+    uint8_t bits[8] = {DVZ_MASK_FLAGS_HIDDEN};
+    dvz_visual_mask(visual, 0, n, bits);
+    dvz_visual_mask_style(visual, (vec4){1, 1, 0, 1}, 2, .25);
+    AT(visual->mask.array == NULL);
+
+    // The point visual keeps it.
+    DvzVisual* point = dvz_point(batch, DVZ_VISUAL_FLAGS_MASK);
+    AT((point->flags & DVZ_VISUAL_FLAGS_MASK) != 0);
+    AT(point->mask_slot == 2);
+
+    dvz_visual_destroy(visual);
+    dvz_visual_destroy(point);
+    dvz_batch_destroy(batch);
+    return 0;
+}
@@ -27,6 +27,8 @@
 
 int test_segment_1(TstSuite*);
 
+int test_segment_mask(TstSuite*);
+
 
 
 #endif
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing surface                                                                              */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "scene/visuals/test_surface.h"
+#include "datoviz.h"
+#include "datoviz_protocol.h"
+#include "renderer.h"
+#include "scene/arcball.h"
+#include "scene/scene_testing_utils.h"
+#include "scene/viewport.h"
+#include "scene/visual.h"
+#include "scene/visuals/surface.h"
+#include "scene/visuals/visual_test.h"
+#include "test.h"
+#include "testing.h"
+#include "testing_utils.h"
+
+
+
+/*************************************************************************************************/
+/*  Surface tests                                                                                */
+/*************************************************************************************************/
+
+int test_surface_1(TstSuite* suite)
+{
+    VisualTest vt = visual_test_start("surface", VISUAL_TEST_ARCBALL, 0);
+
+    // Grid size.
+    uint32_t row_count = 150;
+    uint32_t col_count = row_count;
+
+    // Create the visual.
+    DvzVisual* visual = dvz_surface(vt.batch, DVZ_SURFACE_FLAGS_LIGHTING);
+    dvz_surface_alloc(visual, row_count, col_count);
+
+    // Grid parameters, same as in test_mesh_surface.
+    vec3 o = {-1, 0, -1};
+    vec3 u = {0, 0, 2.0 / (col_count - 1)};
+    vec3 v = {2.0 / (row_count - 1), 0, 0};
+    dvz_surface_grid(visual, o, u, v);
+    dvz_surface_colormap(visual, DVZ_CMAP_PLASMA, +.5, -.5);
+
+    // Heights.
+    float* heights = (float*)calloc(row_count * col_count, sizeof(float));
+    uint32_t idx = 0;
+    float a = 4 * M_2PI / row_count, b = 3 * M_2PI / col_count, c = .5, d = 0;
+    for (uint32_t i = 0; i < row_count; i++)
+    {
+        for (uint32_t j = 0; j < col_count; j++)
+        {
+            d = pow((i - row_count / 2.0) / row_count, 2) + //
+                pow((j - col_count / 2.0) / col_count, 2);
+            d = exp(-10.0 * d);
+            heights[idx++] = c * d * sin(a * i) * cos(b * j);
+        }
+    }
+    dvz_surface_heights(visual, 0, 0, row_count, col_count, heights);
+
+    // Partial update: flatten a band of rows, a single texture sub-region upload.
+    uint32_t band = 10;
+    memset(heights, 0, band * col_count * sizeof(float));
+    dvz_surface_heights(visual, row_count / 2, 0, band, col_count, heights);
+
+    // Add the visual to the panel AFTER setting the visual's data.
+    dvz_panel_visual(vt.panel, visual, 0);
+
+    dvz_arcball_initial(vt.arcball, (vec3){0.42339, -0.39686, -0.00554});
+    dvz_panel_update(vt.panel);
+
+    // Run the test.
+    visual_test_end(vt);
+
+    // Cleanup.
+    FREE(heights);
+
+    return 0;
+}
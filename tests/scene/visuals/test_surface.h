@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_TEST_SURFACE
+#define DVZ_HEADER_TEST_SURFACE
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Surface tests                                                                                */
+/*************************************************************************************************/
+
+int test_surface_1(TstSuite*);
+
+
+
+#endif
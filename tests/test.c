@@ -32,6 +32,7 @@
 #include "scene/test_dual.h"
 #include "scene/test_font.h"
 #include "scene/test_graphics.h"
+#include "scene/test_isolines.h"
 #include "scene/test_labels.h"
 #include "scene/test_mvp.h"
 #include "scene/test_ortho.h"
@@ -46,6 +47,7 @@
 #include "scene/visuals/test_basic.h"
 #include "scene/visuals/test_glyph.h"
 #include "scene/visuals/test_image.h"
+#include "scene/visuals/test_instanced.h"
 #include "scene/visuals/test_marker.h"
 #include "scene/visuals/test_mesh.h"
 #include "scene/visuals/test_monoglyph.h"
@@ -55,6 +57,7 @@
 #include "scene/visuals/test_segment.h"
 #include "scene/visuals/test_slice.h"
 #include "scene/visuals/test_sphere.h"
+#include "scene/visuals/test_surface.h"
 #include "scene/visuals/test_volume.h"
 #include "test.h"
 #include "test_alloc.h"
@@ -66,7 +69,9 @@
 #include "test_datalloc.h"
 #include "test_fifo.h"
 #include "test_fileio.h"
+#include "test_framesink.h"
 #include "test_gui.h"
+#include "test_imwriter.h"
 #include "test_input.h"
 #include "test_keyboard.h"
 #include "test_list.h"
@@ -120,6 +125,10 @@ int dvz_run_tests(const char* match)
 
     // Testing file IO.
     TEST(test_png_1)
+    TEST(test_npy_header)
+    TEST(test_gz_stream)
+    TEST(test_imwriter_1)
+    TEST(test_framesink_1)
 
     // Testing FIFO.
     TEST(test_fifo_1)
@@ -277,6 +286,8 @@ int dvz_run_tests(const char* match)
 
     // Test visuals.
     TEST(test_visual_1)
+    TEST(test_visual_lod)
+    TEST(test_visual_quantize)
     TEST(test_viewset_1)
     TEST(test_viewset_mouse)
 
@@ -318,6 +329,9 @@ int dvz_run_tests(const char* match)
     TEST(test_array_cast)
     TEST(test_array_mvp)
     TEST(test_array_3D)
+    TEST(test_array_npy)
+    TEST(test_array_csv)
+    TEST(test_array_arrow)
 
     // Testing dual.
     TEST(test_dual_1)
@@ -329,12 +343,16 @@ int dvz_run_tests(const char* match)
     // Testing baker.
     TEST(test_baker_1)
     TEST(test_baker_2)
+    TEST(test_baker_normalize)
+    TEST(test_baker_quantize)
+    TEST(test_baker_index16)
     // TEST(test_baker_3)
 
     // Testing colormaps.
     TEST(test_colormaps_default)
     TEST(test_colormaps_scale)
     TEST(test_colormaps_array)
+    TEST(test_colormaps_lut)
 
     // Testing scene elements.
     TEST(test_panzoom_1)
@@ -344,11 +362,20 @@ int dvz_run_tests(const char* match)
     TEST(test_camera_1)
     TEST(test_ortho_1)
     TEST(test_mvp_1)
+    TEST(test_mvp_offset)
+    TEST(test_mvp_scale)
     TEST(test_animation_1)
     TEST(test_shape_1)
     TEST(test_shape_surface)
     TEST(test_shape_transform)
     TEST(test_shape_obj)
+    TEST(test_shape_optimize)
+    TEST(test_shape_simplify)
+    TEST(test_shape_save)
+    TEST(test_shape_normals)
+    TEST(test_shape_borders)
+    TEST(test_shape_polygons)
+    TEST(test_shape_isosurface)
 
     // Box, ticks and axes.
     TEST(test_box_1)
@@ -358,8 +385,15 @@ int dvz_run_tests(const char* match)
     TEST(test_box_5)
     TEST(test_box_6)
     // TEST(test_ticks_1)
+    TEST(test_ticks_scale)
     // TEST(test_labels_1)
     // TEST(test_labels_factored)
+    TEST(test_labels_format)
+    // TEST(test_labels_bench) // benchmark, run manually
+
+    // Isolines.
+    TEST(test_isolines_1)
+    TEST(test_isolines_saddle)
 
     // Testing atlas.
     TEST(test_atlas_1)
@@ -380,6 +414,7 @@ int dvz_run_tests(const char* match)
 
     // Testing server.
     TEST(test_server_1)
+    TEST(test_server_pipeline)
 
     // Testing scene.
     TEST(test_scene_1)
@@ -394,21 +429,25 @@ int dvz_run_tests(const char* match)
     TEST(test_monoglyph_1)
     TEST(test_pixel_1)
     TEST(test_point_1)
+    TEST(test_point_mask)
     TEST(test_marker_code)
     TEST(test_marker_bitmap)
     TEST(test_marker_sdf)
     TEST(test_marker_msdf)
     TEST(test_marker_rotation)
     TEST(test_segment_1)
+    TEST(test_segment_mask)
     TEST(test_path_1)
     TEST(test_path_2)
     TEST(test_path_closed)
+    TEST(test_path_isolines)
     TEST(test_glyph_1)
     TEST(test_mesh_1)
     TEST(test_mesh_polygon)
     TEST(test_mesh_stroke)
     TEST(test_mesh_contour)
     TEST(test_mesh_surface)
+    TEST(test_mesh_wireframe)
     TEST(test_mesh_obj)
     TEST(test_mesh_geo)
     TEST(test_volume_1)
@@ -417,6 +456,8 @@ int dvz_run_tests(const char* match)
     TEST(test_image_2)
     TEST(test_slice_1)
     TEST(test_sphere_1)
+    TEST(test_surface_1)
+    TEST(test_instanced_1)
     // TEST(test_axis_1)
     // TEST(test_axis_2)
     // TEST(test_axis_get)
@@ -66,3 +66,251 @@ int test_png_1(TstSuite* suite)
     FREE(rgb);
     return 0;
 }
+
+
+
+// Build an NPY file in memory, the returned buffer must be freed by the caller.
+static char* _make_npy(uint32_t version, const char* dict, DvzSize data_size, DvzSize* out_size)
+{
+    DvzSize preamble = version == 1 ? 10 : 12;
+    uint32_t header_len = (uint32_t)strlen(dict);
+    DvzSize size = preamble + header_len + data_size;
+    char* bytes = (char*)calloc(size, 1);
+    memcpy(bytes, "\x93NUMPY", 6);
+    bytes[6] = (char)version;
+    for (uint32_t i = 0; i < preamble - 8; i++)
+        bytes[8 + i] = (char)((header_len >> (8 * i)) & 0xFF);
+    memcpy(bytes + preamble, dict, header_len);
+    for (DvzSize i = 0; i < data_size; i++)
+        bytes[preamble + header_len + i] = (char)i;
+    *out_size = size;
+    return bytes;
+}
+
+
+
+int test_npy_header(TstSuite* suite)
+{
+    ANN(suite);
+    DvzNpyHeader header = {0};
+    DvzSize size = 0;
+
+    // Version 1, C order.
+    char* bytes = _make_npy(
+        1, "{'descr': '<f4', 'fortran_order': False, 'shape': (5, 3), }\n", 60, &size);
+    AT(dvz_npy_header(size, bytes, &header) == 0);
+    AT(header.version == 1);
+    AT(header.kind == 'f');
+    AT(header.item_size == 4);
+    AT(!header.big_endian);
+    AT(!header.fortran_order);
+    AT(header.ndim == 2);
+    AT(header.shape[0] == 5);
+    AT(header.shape[1] == 3);
+    AT(header.element_count == 15);
+    AT(header.data_size == 60);
+    AT(header.data_offset == size - 60);
+
+    // The parsed array data is copied.
+    char* data = dvz_parse_npy(size, bytes);
+    AT(data != NULL);
+    AT(memcmp(data, bytes + header.data_offset, 60) == 0);
+    FREE(data);
+
+    // Truncated data.
+    AT(dvz_npy_header(size - 1, bytes, &header) != 0);
+    FREE(bytes);
+
+    // Version 2, Fortran order, 1D and scalar shapes.
+    bytes = _make_npy(
+        2, "{'descr': '|u1', 'fortran_order': True, 'shape': (2, 3, 4), }\n", 24, &size);
+    AT(dvz_npy_header(size, bytes, &header) == 0);
+    AT(header.version == 2);
+    AT(header.kind == 'u');
+    AT(header.item_size == 1);
+    AT(header.fortran_order);
+    AT(header.ndim == 3);
+    AT(header.shape[2] == 4);
+    FREE(bytes);
+
+    bytes = _make_npy(3, "{'descr': '>i2', 'fortran_order': False, 'shape': (7,), }", 14, &size);
+    AT(dvz_npy_header(size, bytes, &header) == 0);
+    AT(header.big_endian);
+    AT(header.ndim == 1);
+    AT(header.shape[0] == 7);
+    FREE(bytes);
+
+    bytes = _make_npy(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (), }", 8, &size);
+    AT(dvz_npy_header(size, bytes, &header) == 0);
+    AT(header.ndim == 0);
+    AT(header.element_count == 1);
+    FREE(bytes);
+
+    // Structured dtypes are not supported.
+    bytes = _make_npy(
+        1, "{'descr': [('x', '<f4')], 'fortran_order': False, 'shape': (2,), }", 8, &size);
+    AT(dvz_npy_header(size, bytes, &header) != 0);
+    FREE(bytes);
+
+    // Reading from a file.
+    bytes = _make_npy(
+        1, "{'descr': '<u2', 'fortran_order': False, 'shape': (10,), }\n", 20, &size);
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test.npy", ARTIFACTS_DIR);
+    AT(dvz_write_bytes(path, "wb", size, (const uint8_t*)bytes) == 0);
+    DvzSize data_size = 0;
+    data = dvz_read_npy(path, &data_size);
+    AT(data != NULL);
+    AT(data_size == 20);
+    AT(memcmp(data, bytes + size - 20, 20) == 0);
+    FREE(data);
+    FREE(bytes);
+
+    return 0;
+}
+
+
+
+// Write a gzip member holding the data in stored (uncompressed) deflate blocks, optionally with
+// the BGZF extra field. Return the number of bytes written.
+static DvzSize _make_gz_member(uint8_t* out, DvzSize size, const uint8_t* data, bool bgzf)
+{
+    // CRC-32 of the data.
+    uint32_t crc = 0xFFFFFFFF;
+    for (DvzSize i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (uint32_t k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    crc = ~crc;
+
+    uint8_t header[18] = {0x1f, 0x8b, 8, bgzf ? 4 : 0, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2};
+    DvzSize n = bgzf ? 18 : 10;
+    memcpy(out, header, n);
+
+    // Stored blocks of at most 65535 bytes.
+    DvzSize pos = 0;
+    do
+    {
+        uint32_t len = (uint32_t)MIN(size - pos, 65535);
+        out[n++] = pos + len == size ? 1 : 0;
+        out[n++] = (uint8_t)(len & 0xFF);
+        out[n++] = (uint8_t)(len >> 8);
+        out[n++] = (uint8_t)(~len & 0xFF);
+        out[n++] = (uint8_t)((~len >> 8) & 0xFF);
+        memcpy(out + n, data + pos, len);
+        n += len;
+        pos += len;
+    } while (pos < size);
+
+    for (uint32_t i = 0; i < 4; i++)
+        out[n++] = (uint8_t)((crc >> (8 * i)) & 0xFF);
+    for (uint32_t i = 0; i < 4; i++)
+        out[n++] = (uint8_t)((size >> (8 * i)) & 0xFF);
+
+    // BSIZE: total block size minus 1.
+    if (bgzf)
+    {
+        out[16] = (uint8_t)((n - 1) & 0xFF);
+        out[17] = (uint8_t)((n - 1) >> 8);
+    }
+    return n;
+}
+
+
+
+typedef struct GzCheck GzCheck;
+struct GzCheck
+{
+    const uint8_t* data;
+    DvzSize chunk_size;
+    DvzSize offset;
+    uint32_t chunk_count;
+    uint32_t max_chunks;
+    bool ok;
+};
+
+static int _gz_check(DvzSize offset, DvzSize size, const void* chunk, void* user_data)
+{
+    GzCheck* check = (GzCheck*)user_data;
+    // The chunks should be contiguous, full except the last one, and match the original data.
+    if (offset != check->offset || size > check->chunk_size || (offset % check->chunk_size) != 0 ||
+        memcmp(chunk, check->data + offset, size) != 0)
+        check->ok = false;
+    check->offset += size;
+    check->chunk_count++;
+    return check->chunk_count >= check->max_chunks ? 1 : 0;
+}
+
+
+
+static int _check_gz_file(const char* path, DvzSize size, const uint8_t* data, DvzSize chunk_size)
+{
+    GzCheck check = {.data = data, .chunk_size = chunk_size, .max_chunks = UINT32_MAX, .ok = true};
+    AT(dvz_stream_gz(path, chunk_size, _gz_check, &check) == 0);
+    AT(check.ok);
+    AT(check.offset == size);
+    AT(check.chunk_count == (size + chunk_size - 1) / chunk_size);
+
+    // Stop after the first chunk.
+    GzCheck stop = {.data = data, .chunk_size = chunk_size, .max_chunks = 1, .ok = true};
+    AT(dvz_stream_gz(path, chunk_size, _gz_check, &stop) != 0);
+    AT(stop.ok);
+    AT(stop.chunk_count == 1);
+
+    DvzSize read_size = 0;
+    char* read = dvz_read_gz(path, &read_size);
+    AT(read != NULL);
+    AT(read_size == size);
+    AT(memcmp(read, data, size) == 0);
+    FREE(read);
+    return 0;
+}
+
+
+
+int test_gz_stream(TstSuite* suite)
+{
+#if HAS_ZLIB
+    DvzSize size = 1000000;
+    uint8_t* data = (uint8_t*)malloc(size);
+    for (DvzSize i = 0; i < size; i++)
+        data[i] = (uint8_t)((i * 7) ^ (i >> 9));
+    uint8_t* bytes = (uint8_t*)malloc(2 * size);
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/test.gz", ARTIFACTS_DIR);
+    DvzSize n = 0;
+
+    // Single member.
+    n = _make_gz_member(bytes, size, data, false);
+    AT(dvz_write_bytes(path, "wb", n, bytes) == 0);
+    AT(_check_gz_file(path, size, data, 100000) == 0);
+    AT(_check_gz_file(path, size, data, 300000) == 0);
+
+    // Several members.
+    n = _make_gz_member(bytes, 123456, data, false);
+    n += _make_gz_member(bytes + n, size - 123456, data + 123456, false);
+    AT(dvz_write_bytes(path, "wb", n, bytes) == 0);
+    AT(_check_gz_file(path, size, data, 100000) == 0);
+
+    // BGZF, with the empty end-of-file member.
+    n = 0;
+    for (DvzSize pos = 0; pos < size; pos += 60000)
+        n += _make_gz_member(bytes + n, MIN(60000, size - pos), data + pos, true);
+    n += _make_gz_member(bytes + n, 0, data, true);
+    AT(dvz_write_bytes(path, "wb", n, bytes) == 0);
+    AT(_check_gz_file(path, size, data, 100000) == 0);
+    AT(_check_gz_file(path, size, data, 30000) == 0);
+    AT(_check_gz_file(path, size, data, 2 * size) == 0);
+
+    // Truncated file.
+    AT(dvz_write_bytes(path, "wb", n / 2, bytes) == 0);
+    GzCheck check = {.data = data, .chunk_size = 100000, .max_chunks = UINT32_MAX, .ok = true};
+    AT(dvz_stream_gz(path, 100000, _gz_check, &check) != 0);
+
+    FREE(data);
+    FREE(bytes);
+#endif
+    return 0;
+}
@@ -27,6 +27,10 @@
 
 int test_png_1(TstSuite*);
 
+int test_npy_header(TstSuite*);
+
+int test_gz_stream(TstSuite*);
+
 
 
 #endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing video frame sink                                                                     */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_framesink.h"
+#include "fileio.h"
+#include "framesink.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static void _fill(uint32_t width, uint32_t height, uint32_t c, uint32_t k, uint8_t* pixels)
+{
+    for (uint32_t i = 0; i < width * height * c; i++)
+        pixels[i] = (uint8_t)((i * 7 + k * 13) % 256);
+}
+
+
+
+// Scalar reference of the YUV 4:2:0 conversion, one pixel at a time.
+static void _yuv420_ref(
+    uint32_t width, uint32_t height, const uint8_t* pixels, uint32_t c, uint8_t* yuv)
+{
+    uint32_t cw = (width + 1) / 2, ch = (height + 1) / 2;
+    uint8_t* u = yuv + width * height;
+    uint8_t* v = u + cw * ch;
+    for (uint32_t j = 0; j < height; j++)
+    {
+        for (uint32_t i = 0; i < width; i++)
+        {
+            const uint8_t* p = &pixels[(j * width + i) * c];
+            yuv[j * width + i] = (uint8_t)(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+        }
+    }
+    for (uint32_t j = 0; j < ch; j++)
+    {
+        for (uint32_t i = 0; i < cw; i++)
+        {
+            int32_t r = 0, g = 0, b = 0;
+            for (uint32_t dj = 0; dj < 2; dj++)
+            {
+                for (uint32_t di = 0; di < 2; di++)
+                {
+                    uint32_t x = MIN(2 * i + di, width - 1), y = MIN(2 * j + dj, height - 1);
+                    const uint8_t* p = &pixels[(y * width + x) * c];
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            u[j * cw + i] = (uint8_t)((-38 * r - 74 * g + 112 * b + 128 * 1024 + 512) >> 10);
+            v[j * cw + i] = (uint8_t)((112 * r - 94 * g - 18 * b + 128 * 1024 + 512) >> 10);
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+int test_framesink_1(TstSuite* suite)
+{
+    ANN(suite);
+
+    // Odd size to test the chroma subsampling on the borders.
+    uint32_t width = 37, height = 23, n = 10;
+    DvzSize yuv_size = dvz_yuv420_size(width, height);
+    AT(yuv_size == 37 * 23 + 2 * 19 * 12);
+
+    uint8_t* pixels = (uint8_t*)malloc(width * height * 4);
+    uint8_t* yuv = (uint8_t*)malloc(yuv_size);
+    uint8_t* ref = (uint8_t*)malloc(yuv_size);
+    ANN(pixels);
+    ANN(yuv);
+    ANN(ref);
+
+    // Conversion, with RGB and RGBA pixels.
+    for (uint32_t c = 3; c <= 4; c++)
+    {
+        _fill(width, height, c, c, pixels);
+        dvz_rgb_yuv420(width, height, pixels, c, yuv);
+        _yuv420_ref(width, height, pixels, c, ref);
+        AT(memcmp(yuv, ref, yuv_size) == 0);
+    }
+
+    // Pure colors.
+    memset(pixels, 255, width * height * 3);
+    dvz_rgb_yuv420(width, height, pixels, 3, yuv);
+    AT(yuv[0] == 235);
+    AT(yuv[width * height] == 128);
+    AT(yuv[yuv_size - 1] == 128);
+    memset(pixels, 0, width * height * 3);
+    dvz_rgb_yuv420(width, height, pixels, 3, yuv);
+    AT(yuv[0] == 16);
+    AT(yuv[width * height] == 128);
+
+    // Y4M stream, with more frames than the queue size.
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/framesink.y4m", ARTIFACTS_DIR);
+    DvzFrameSink* sink = dvz_frame_sink(path, width, height, 29.97, DVZ_VIDEO_FORMAT_Y4M);
+    ANN(sink);
+    AT(sink->fps_num == 2997);
+    AT(sink->fps_den == 100);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        // The buffer is reused as soon as the frame has been pushed.
+        _fill(width, height, 3, k, pixels);
+        dvz_frame_sink_push(sink, pixels, 3);
+    }
+    AT(dvz_frame_sink_wait(sink) == 0);
+    AT(sink->written == n);
+    dvz_frame_sink_destroy(sink);
+
+    DvzSize file_size = 0;
+    char* bytes = (char*)dvz_read_file(path, &file_size);
+    ANN(bytes);
+    const char* header = "YUV4MPEG2 W37 H23 F2997:100 Ip A1:1 C420jpeg\n";
+    DvzSize header_size = strlen(header);
+    AT(memcmp(bytes, header, header_size) == 0);
+    AT(file_size == header_size + n * (6 + yuv_size));
+
+    // Check the last frame.
+    _fill(width, height, 3, n - 1, pixels);
+    _yuv420_ref(width, height, pixels, 3, ref);
+    AT(memcmp(&bytes[file_size - yuv_size - 6], "FRAME\n", 6) == 0);
+    AT(memcmp(&bytes[file_size - yuv_size], ref, yuv_size) == 0);
+    FREE(bytes);
+
+    // Raw RGB stream from RGBA frames, the alpha channel is dropped.
+    snprintf(path, sizeof(path), "%s/framesink.rgb", ARTIFACTS_DIR);
+    sink = dvz_frame_sink(path, width, height, 0, DVZ_VIDEO_FORMAT_RGB);
+    ANN(sink);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        _fill(width, height, 4, k, pixels);
+        dvz_frame_sink_push(sink, pixels, 4);
+    }
+    // The queued frames are written before the sink is destroyed.
+    dvz_frame_sink_destroy(sink);
+
+    bytes = (char*)dvz_read_file(path, &file_size);
+    ANN(bytes);
+    DvzSize frame_size = width * height * 3;
+    AT(file_size == n * frame_size);
+    for (uint32_t i = 0; i < width * height; i++)
+    {
+        AT(memcmp(&bytes[(n - 1) * frame_size + 3 * i], &pixels[4 * i], 3) == 0);
+    }
+    FREE(bytes);
+
+    // Invalid outputs.
+    AT(dvz_frame_sink("/nonexistent/directory/video.y4m", width, height, 30, 0) == NULL);
+    AT(dvz_frame_sink_fd(-1, width, height, 30, DVZ_VIDEO_FORMAT_RGB) == NULL);
+
+    FREE(pixels);
+    FREE(yuv);
+    FREE(ref);
+    return 0;
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing image writer                                                                         */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "test_imwriter.h"
+#include "fileio.h"
+#include "imwriter.h"
+#include "test.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static uint32_t _read_be32(const uint8_t* bytes)
+{
+    return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 |
+           (uint32_t)bytes[3];
+}
+
+
+
+// Reference QOI decoder, following the specification, returning RGB pixels.
+static uint8_t* _decode_qoi(DvzSize size, const uint8_t* bytes, uint32_t* width, uint32_t* height)
+{
+    if (size < 14 + 8 || memcmp(bytes, "qoif", 4) != 0)
+        return NULL;
+    *width = _read_be32(bytes + 4);
+    *height = _read_be32(bytes + 8);
+    DvzSize count = (DvzSize)(*width) * (*height);
+    uint8_t* rgb = (uint8_t*)malloc(3 * count);
+    ANN(rgb);
+
+    uint8_t index[64][4] = {0};
+    uint8_t px[4] = {0, 0, 0, 255};
+    DvzSize pos = 14;
+    uint32_t run = 0;
+    for (DvzSize i = 0; i < count; i++)
+    {
+        if (run > 0)
+        {
+            run--;
+        }
+        else if (pos < size - 8)
+        {
+            uint8_t b = bytes[pos++];
+            if (b == 0xFE) // QOI_OP_RGB
+            {
+                memcpy(px, bytes + pos, 3);
+                pos += 3;
+            }
+            else if (b == 0xFF) // QOI_OP_RGBA
+            {
+                memcpy(px, bytes + pos, 4);
+                pos += 4;
+            }
+            else if ((b & 0xC0) == 0x00) // QOI_OP_INDEX
+            {
+                memcpy(px, index[b], 4);
+            }
+            else if ((b & 0xC0) == 0x40) // QOI_OP_DIFF
+            {
+                px[0] = (uint8_t)(px[0] + ((b >> 4) & 3) - 2);
+                px[1] = (uint8_t)(px[1] + ((b >> 2) & 3) - 2);
+                px[2] = (uint8_t)(px[2] + (b & 3) - 2);
+            }
+            else if ((b & 0xC0) == 0x80) // QOI_OP_LUMA
+            {
+                int dg = (b & 0x3F) - 32;
+                uint8_t b2 = bytes[pos++];
+                px[0] = (uint8_t)(px[0] + dg - 8 + (b2 >> 4));
+                px[1] = (uint8_t)(px[1] + dg);
+                px[2] = (uint8_t)(px[2] + dg - 8 + (b2 & 0x0F));
+            }
+            else // QOI_OP_RUN
+            {
+                run = b & 0x3F;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        memcpy(rgb + 3 * i, px, 3);
+    }
+    return rgb;
+}
+
+
+
+#if HAS_ZLIB
+static uint8_t _paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+}
+
+
+
+// Reference decoder of the 8-bit RGB non-interlaced PNG files written by the zlib encoder. The
+// IDAT chunks are inflated with dvz_read_gz(), which detects the zlib header.
+static uint8_t*
+_decode_png_zlib(DvzSize size, const uint8_t* bytes, uint32_t* width, uint32_t* height)
+{
+    if (size < 8 || memcmp(bytes, "\x89PNG\r\n\x1a\n", 8) != 0)
+        return NULL;
+
+    uint8_t* idat = (uint8_t*)malloc(size);
+    ANN(idat);
+    DvzSize idat_size = 0;
+    for (DvzSize pos = 8; pos + 12 <= size;)
+    {
+        uint32_t length = _read_be32(bytes + pos);
+        const uint8_t* data = bytes + pos + 8;
+        if (memcmp(bytes + pos + 4, "IHDR", 4) == 0)
+        {
+            *width = _read_be32(data);
+            *height = _read_be32(data + 4);
+            // 8-bit depth, RGB, no interlacing.
+            if (data[8] != 8 || data[9] != 2 || data[12] != 0)
+            {
+                FREE(idat);
+                return NULL;
+            }
+        }
+        else if (memcmp(bytes + pos + 4, "IDAT", 4) == 0)
+        {
+            memcpy(idat + idat_size, data, length);
+            idat_size += length;
+        }
+        pos += 12 + length;
+    }
+
+    char path[1024] = {0};
+    snprintf(path, sizeof(path), "%s/imwriter_idat.zz", ARTIFACTS_DIR);
+    dvz_write_bytes(path, "wb", idat_size, idat);
+    FREE(idat);
+    DvzSize raw_size = 0;
+    uint8_t* raw = (uint8_t*)dvz_read_gz(path, &raw_size);
+    DvzSize row_size = 3 * (DvzSize)(*width);
+    if (raw == NULL || raw_size != (*height) * (row_size + 1))
+    {
+        FREE(raw);
+        return NULL;
+    }
+
+    // Reverse the scanline filters.
+    uint8_t* rgb = (uint8_t*)malloc((*height) * row_size);
+    ANN(rgb);
+    for (uint32_t y = 0; y < *height; y++)
+    {
+        const uint8_t* src = raw + y * (row_size + 1);
+        uint8_t* row = rgb + y * row_size;
+        const uint8_t* prev = y > 0 ? row - row_size : NULL;
+        for (DvzSize i = 0; i < row_size; i++)
+        {
+            uint8_t a = i >= 3 ? row[i - 3] : 0;
+            uint8_t b = prev != NULL ? prev[i] : 0;
+            uint8_t c = prev != NULL && i >= 3 ? prev[i - 3] : 0;
+            uint8_t x = src[1 + i];
+            switch (src[0])
+            {
+            case DVZ_PNG_FILTER_SUB:
+                x = (uint8_t)(x + a);
+                break;
+            case DVZ_PNG_FILTER_UP:
+                x = (uint8_t)(x + b);
+                break;
+            case DVZ_PNG_FILTER_AVERAGE:
+                x = (uint8_t)(x + (a + b) / 2);
+                break;
+            case DVZ_PNG_FILTER_PAETH:
+                x = (uint8_t)(x + _paeth(a, b, c));
+                break;
+            default:
+                break;
+            }
+            row[i] = x;
+        }
+    }
+    FREE(raw);
+    return rgb;
+}
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+int test_imwriter_1(TstSuite* suite)
+{
+    ANN(suite);
+
+    uint32_t width = 64, height = 48, n = 12;
+    DvzSize size = width * height * 3;
+    uint8_t* rgb = (uint8_t*)calloc(size, 1);
+    ANN(rgb);
+
+    // Small capacity so that dvz_image_writer_push() blocks.
+    DvzImageWriter* writer = dvz_image_writer(2, 2);
+    char path[1024] = {0};
+    const char* ext[] = {"png", "qoi", "ppm"};
+    for (uint32_t k = 0; k < n; k++)
+    {
+        // The buffer is reused as soon as the image has been pushed.
+        for (DvzSize i = 0; i < size; i++)
+            rgb[i] = (uint8_t)((i / 3 + k) % 256);
+        snprintf(path, sizeof(path), "%s/imwriter_%02d.%s", ARTIFACTS_DIR, k, ext[k % 3]);
+        dvz_image_writer_push(writer, path, width, height, rgb);
+    }
+    AT(dvz_image_writer_wait(writer) == 0);
+    AT(writer->pending == 0);
+
+    // Check the files.
+    for (uint32_t k = 0; k < n; k++)
+    {
+        for (DvzSize i = 0; i < size; i++)
+            rgb[i] = (uint8_t)((i / 3 + k) % 256);
+        snprintf(path, sizeof(path), "%s/imwriter_%02d.%s", ARTIFACTS_DIR, k, ext[k % 3]);
+
+        DvzSize file_size = 0;
+        uint8_t* bytes = (uint8_t*)dvz_read_file(path, &file_size);
+        ANN(bytes);
+        AT(file_size > 0);
+
+        uint32_t w = 0, h = 0;
+        uint8_t* image = NULL;
+        if (k % 3 == 0)
+        {
+            image = dvz_load_png(file_size, bytes, &w, &h);
+        }
+        else if (k % 3 == 1)
+        {
+            image = _decode_qoi(file_size, bytes, &w, &h);
+        }
+        else
+        {
+            int iw = 0, ih = 0;
+            image = dvz_read_ppm(path, &iw, &ih);
+            w = (uint32_t)iw;
+            h = (uint32_t)ih;
+        }
+        ANN(image);
+        AT(w == width);
+        AT(h == height);
+        AT(memcmp(image, rgb, size) == 0);
+        FREE(image);
+        FREE(bytes);
+    }
+
+    // zlib PNG encoder, with each scanline filter.
+    for (int f = DVZ_PNG_FILTER_NONE; f <= DVZ_PNG_FILTER_ADAPTIVE; f++)
+    {
+        dvz_image_writer_png(writer, 6, (DvzPngFilter)f);
+        snprintf(path, sizeof(path), "%s/imwriter_zlib_%d.png", ARTIFACTS_DIR, f);
+        dvz_image_writer_push(writer, path, width, height, rgb);
+        AT(dvz_image_writer_wait(writer) == 0);
+
+        DvzSize file_size = 0;
+        uint8_t* bytes = (uint8_t*)dvz_read_file(path, &file_size);
+        ANN(bytes);
+        AT(file_size > 8);
+        AT(memcmp(bytes, "\x89PNG", 4) == 0);
+#if HAS_ZLIB
+        uint32_t w = 0, h = 0;
+        uint8_t* image = _decode_png_zlib(file_size, bytes, &w, &h);
+        ANN(image);
+        AT(w == width);
+        AT(h == height);
+        AT(memcmp(image, rgb, size) == 0);
+        FREE(image);
+#endif
+        FREE(bytes);
+    }
+
+    // Write errors are counted.
+    dvz_image_writer_push(writer, "/nonexistent/directory/image.png", width, height, rgb);
+    AT(dvz_image_writer_wait(writer) == 1);
+    AT(dvz_image_writer_wait(writer) == 0);
+
+    // The queued images are written before the writer is destroyed.
+    snprintf(path, sizeof(path), "%s/imwriter_last.ppm", ARTIFACTS_DIR);
+    remove(path);
+    dvz_image_writer_push(writer, path, width, height, rgb);
+    dvz_image_writer_destroy(writer);
+    int iw = 0, ih = 0;
+    uint8_t* image = dvz_read_ppm(path, &iw, &ih);
+    ANN(image);
+    AT(iw == (int)width);
+    AT(memcmp(image, rgb, size) == 0);
+    FREE(image);
+
+    // Synchronous write.
+    snprintf(path, sizeof(path), "%s/imwriter_sync.qoi", ARTIFACTS_DIR);
+    AT(dvz_write_image(path, width, height, rgb, -1, DVZ_PNG_FILTER_NONE) == 0);
+    DvzSize file_size = 0;
+    uint8_t* bytes = (uint8_t*)dvz_read_file(path, &file_size);
+    ANN(bytes);
+    uint32_t w = 0, h = 0;
+    image = _decode_qoi(file_size, bytes, &w, &h);
+    ANN(image);
+    AT(w == width);
+    AT(h == height);
+    AT(memcmp(image, rgb, size) == 0);
+    FREE(image);
+    FREE(bytes);
+    AT(dvz_write_image("/nonexistent/directory/image.ppm", width, height, rgb, -1, 0) != 0);
+
+    FREE(rgb);
+    return 0;
+}
@@ -31,6 +31,37 @@
 
 
 
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+typedef struct PipelineState PipelineState;
+struct PipelineState
+{
+    uint32_t count;
+    uint64_t frame_idx;
+    bool ordered;
+    uint8_t* last;
+};
+
+static void _readback_callback(DvzServer* server, DvzId canvas_id, DvzReadbackEvent ev)
+{
+    ANN(server);
+    PipelineState* state = (PipelineState*)ev.user_data;
+    ANN(state);
+
+    // The frames should be delivered in order.
+    state->ordered &= ev.frame_idx == state->count;
+    state->count++;
+    state->frame_idx = ev.frame_idx;
+
+    ASSERT(ev.width == WIDTH);
+    ASSERT(ev.height == HEIGHT);
+    memcpy(state->last, ev.rgb, WIDTH * HEIGHT * 3);
+}
+
+
+
 /*************************************************************************************************/
 /*  Server tests                                                                                 */
 /*************************************************************************************************/
@@ -63,3 +94,48 @@ int test_server_1(TstSuite* suite)
     dvz_server_destroy(server);
     return 0;
 }
+
+
+
+int test_server_pipeline(TstSuite* suite)
+{
+    ANN(suite);
+
+    DvzServer* server = dvz_server(0);
+    ANN(server);
+
+    DvzScene* scene = dvz_scene(NULL);
+    DvzFigure* figure = dvz_figure(scene, WIDTH, HEIGHT, 0);
+    DvzPanel* panel = dvz_panel(figure, 0, 0, WIDTH, HEIGHT);
+    dvz_demo_panel(panel);
+    dvz_scene_render(scene, server);
+    DvzId canvas_id = dvz_figure_id(figure);
+
+    PipelineState state = {.ordered = true};
+    state.last = (uint8_t*)calloc(WIDTH * HEIGHT, 3);
+    ANN(state.last);
+    dvz_server_pipeline(server, 3, _readback_callback, &state);
+
+    // Render more frames than the number of frames in flight.
+    uint32_t n = 10;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        AT(dvz_server_render(server, canvas_id, 0) == i);
+        dvz_server_poll(server);
+        AT(state.count + 3 >= i + 1);
+    }
+    dvz_server_wait(server);
+    AT(state.count == n);
+    AT(state.frame_idx == n - 1);
+    AT(state.ordered);
+
+    // The pipelined frames should be the same as the synchronously-rendered ones.
+    uint8_t* rgb = dvz_server_grab(server, canvas_id, 0);
+    ANN(rgb);
+    AT(memcmp(rgb, state.last, WIDTH * HEIGHT * 3) == 0);
+
+    FREE(state.last);
+    dvz_scene_destroy(scene);
+    dvz_server_destroy(server);
+    return 0;
+}
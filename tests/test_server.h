@@ -27,6 +27,8 @@
 
 int test_server_1(TstSuite*);
 
+int test_server_pipeline(TstSuite*);
+
 
 
 #endif
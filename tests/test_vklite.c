@@ -996,7 +996,7 @@ int test_vklite_indexed(TstSuite* suite)
     dvz_cmd_begin_renderpass(&cmds, 0, renderpass, framebuffers);
     dvz_cmd_viewport(&cmds, 0, (VkViewport){0, 0, WIDTH, HEIGHT, 0, 1});
     dvz_cmd_bind_vertex_buffer(&cmds, 0, 1, (DvzBufferRegions[]){br}, (DvzSize[]){0});
-    dvz_cmd_bind_index_buffer(&cmds, 0, bri, 0);
+    dvz_cmd_bind_index_buffer(&cmds, 0, bri, 0, VK_INDEX_TYPE_UINT32);
     dvz_cmd_bind_descriptors(&cmds, 0, &descriptors, 0);
     dvz_cmd_bind_graphics(&cmds, 0, &graphics);
     dvz_cmd_draw_indexed(&cmds, 0, 0, 0, n_vertices, 0, 1);
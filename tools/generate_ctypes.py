@@ -157,6 +157,10 @@ def map_type(type, enum_int=False, unsigned=None, ndpointer=True):
         else:
             return "ctypes.c_void_p"
 
+    elif type.endswith('**'):
+        # NOTE: pointer to pointer, typically an output argument (e.g. DvzArray** mask)
+        return f'ctypes.POINTER({map_type(type[:-1], unsigned=unsigned, ndpointer=False)})'
+
     elif type.endswith('*'):
         return cpointer_to_ndpointer(type, unsigned=unsigned, ndpointer=ndpointer)
 
@@ -303,6 +307,10 @@ def generate_ctypes_bindings(headers_json_path, output_path, version_path):
     frame = DvzAppFrameCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzFrameEvent)
     timer = DvzAppTimerCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzTimerEvent)
     resize = DvzAppResizeCallback = ctypes.CFUNCTYPE(None, P_(DvzApp), DvzId, DvzWindowEvent)
+    readback = DvzServerReadbackCallback = ctypes.CFUNCTYPE(
+        None, P_(DvzServer), DvzId, DvzReadbackEvent)
+    chunk = DvzChunkCallback = ctypes.CFUNCTYPE(
+        ctypes.c_int, DvzSize, DvzSize, ctypes.c_void_p, ctypes.c_void_p)
     DvzErrorCallback = ctypes.CFUNCTYPE(None, ctypes.c_char_p)
 
     """)